@@ -58,6 +58,9 @@ public:
 	/** wrapper for node instancing: TickTask */
 	void WrappedTickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) const;
 
+	/** @return time until TickTask needs to be called, FLT_MAX if task doesn't tick */
+	float GetNextNeededDeltaTime(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const;
+
 	/** wrapper for node instancing: OnTaskFinished */
 	void WrappedOnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) const;
 
@@ -99,6 +99,7 @@ public:
 	virtual bool IsRunning() const override;
 	virtual bool IsPaused() const override;
 	virtual void Cleanup() override;
+	virtual void HandleMessage(const FAIMessage& Message) override;
 	// End UBrainComponent overrides
 
 	// Begin UActorComponent overrides
@@ -161,6 +162,10 @@ public:
 	/** schedule execution flow update in next tick */
 	void ScheduleExecutionUpdate();
 
+	/** schedule next tick of component: 0 for next frame, FLT_MAX to stop ticking until execution flow needs an update
+	 *  (ignored when BehaviorTree.ScheduledTicks is disabled) */
+	void ScheduleNextTick(float NextNeededDeltaTime);
+
 	/** tries to find behavior tree instance in context */
 	int32 FindInstanceContainingNode(const UBTNode* Node) const;
 
@@ -276,6 +281,15 @@ protected:
 	static int32 NumSearchTimeCalls;
 #endif
 
+	/** tick interval configured on component before scheduling took over, -1 until captured */
+	float UserTickInterval;
+
+	/** game time of last tick, used to accumulate delta time over skipped frames, -1 until ticked */
+	float LastTickGameTime;
+
+	/** delta time of next scheduled tick, FLT_MAX when ticking is disabled */
+	float NextTickDeltaTime;
+
 	/** index of last active instance on stack */
 	uint16 ActiveInstanceIdx;
 
@@ -303,6 +317,9 @@ protected:
 	/** if set, execution requests will be postponed */
 	uint8 bIsPaused : 1;
 
+	/** @return time until active aux nodes or tasks need to be ticked: 0 if flow update is pending, FLT_MAX if nothing needs ticking */
+	float GetNextNeededTickDeltaTime();
+
 	/** push behavior tree instance on execution stack
 	 *	@NOTE: should never be called out-side of BT execution, meaning only BT tasks can push another BT instance! */
 	bool PushInstance(UBehaviorTree& TreeAsset);
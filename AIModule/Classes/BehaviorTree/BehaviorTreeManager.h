@@ -58,6 +58,9 @@ class AIMODULE_API UBehaviorTreeManager : public UObject
 	/** unregister behavior tree component from tracking */
 	void RemoveActiveComponent(UBehaviorTreeComponent& Component);
 
+	/** @return number of components with initialized trees */
+	int32 GetNumActiveComponents() const { return ActiveComponents.Num(); }
+
 	static UBehaviorTreeManager* GetCurrent(UWorld* World);
 	static UBehaviorTreeManager* GetCurrent(UObject* WorldContextObject);
 
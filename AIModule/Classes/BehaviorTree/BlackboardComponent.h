@@ -26,6 +26,21 @@
 
 class UBrainComponent;
 
+/**
+ *	Key ID checked against key type once, when it's created by UBlackboardComponent::GetTypedKey.
+ *	Values accessed with it skip all key type checks, so it must not be used after blackboard asset changes.
+ */
+template<class TDataClass>
+struct FBlackboardTypedKey
+{
+	FBlackboard::FKey KeyID;
+
+	FBlackboardTypedKey() : KeyID(FBlackboard::InvalidKey) {}
+	explicit FBlackboardTypedKey(FBlackboard::FKey InKeyID) : KeyID(InKeyID) {}
+
+	bool IsValid() const { return KeyID != FBlackboard::InvalidKey; }
+};
+
 namespace EBlackboardDescription
 {
 	enum Type
@@ -84,6 +99,13 @@ public:
 	/** resume observer change notifications and, optionally, process the queued observation list */
 	void ResumeObserverNotifications(bool bSendQueuedObserverNotifications);
 
+	/** notify observers about keys changed since last call, once per key in order of first change
+	 *  (observer notifications are collected in change journal while owned by behavior tree component, see BehaviorTree.BlackboardChangeJournal) */
+	void ProcessChangeJournal();
+
+	/** @return true if there are key changes waiting for ProcessChangeJournal call */
+	bool HasPendingChanges() const { return ChangeJournal.Num() > 0; }
+
 	/** pause change notifies and add them to queue */
 	UE_DEPRECATED(4.15, "Please call PauseObserverUpdates.")
 	void PauseUpdates();
@@ -204,6 +226,16 @@ public:
 	template<class TDataClass>
 	typename TDataClass::FDataType GetValue(FBlackboard::FKey KeyID) const;
 
+	/** @return typed key for given name, invalid if key doesn't exist or holds different type */
+	template<class TDataClass>
+	FBlackboardTypedKey<TDataClass> GetTypedKey(const FName& KeyName) const;
+
+	template<class TDataClass>
+	bool SetValue(FBlackboardTypedKey<TDataClass> Key, typename TDataClass::FDataType Value);
+
+	template<class TDataClass>
+	typename TDataClass::FDataType GetValue(FBlackboardTypedKey<TDataClass> Key) const;
+
 	/** get pointer to raw data for given key */
 	FORCEINLINE uint8* GetKeyRawData(const FName& KeyName) { return GetKeyRawData(GetKeyID(KeyName)); }
 	FORCEINLINE uint8* GetKeyRawData(FBlackboard::FKey KeyID) { return ValueMemory.Num() && ValueOffsets.IsValidIndex(KeyID) ? (ValueMemory.GetData() + ValueOffsets[KeyID]) : NULL; }
@@ -250,6 +282,15 @@ protected:
 	UPROPERTY(transient)
 	TArray<UBlackboardKeyType*> KeyInstances;
 
+	/** class of each key's type, used for type checks without going through asset's parent chain */
+	TArray<UClass*> KeyTypeClasses;
+
+	/** key type object handling each key's value: instance or template from asset */
+	TArray<UBlackboardKeyType*> KeyTypeObjects;
+
+	/** offsets in ValueMemory of each key's value, after instanced key header */
+	TArray<uint16> KeyDataOffsets;
+
 protected:
 	/** observers registered for blackboard keys */
 	mutable TMultiMap<uint8, FOnBlackboardChangeNotification> Observers;
@@ -260,15 +301,30 @@ protected:
 	/** queued key change notification, will be processed on ResumeUpdates call */
 	mutable TArray<uint8> QueuedUpdates;
 
+	/** keys changed since last ProcessChangeJournal call */
+	mutable TArray<FBlackboard::FKey> ChangeJournal;
+
+	/** flags of keys already stored in ChangeJournal */
+	mutable TBitArray<> JournaledKeys;
+
 	/** set when observation notifies are paused and shouldn't be passed to observers */
 	uint32 bPausedNotifies : 1;
 
 	/** reset to false every time a new BB asset is assigned to this component */
 	uint32 bSynchronizedKeyPopulated : 1;
 
+	/** set when cached brain component is a behavior tree, which processes change journal in every tick */
+	uint32 bCanJournalNotifies : 1;
+
 	/** notifies behavior tree decorators about change in blackboard */
 	void NotifyObservers(FBlackboard::FKey KeyID) const;
 
+	/** calls observers of given key */
+	void BroadcastKeyChange(FBlackboard::FKey KeyID) const;
+
+	/** caches per key type data used by typed accessors */
+	void CacheKeyTypes();
+
 	/** initializes parent chain in asset */
 	void InitializeParentChain(UBlackboardData* NewAsset);
 
@@ -294,8 +350,7 @@ FORCEINLINE bool UBlackboardComponent::HasValidAsset() const
 template<class TDataClass>
 bool UBlackboardComponent::IsKeyOfType(FBlackboard::FKey KeyID) const
 {
-	const FBlackboardEntry* EntryInfo = BlackboardAsset ? BlackboardAsset->GetKey(KeyID) : nullptr;
-	return (EntryInfo != nullptr) && (EntryInfo->KeyType != nullptr) && (EntryInfo->KeyType->GetClass() == TDataClass::StaticClass());
+	return KeyTypeClasses.IsValidIndex(KeyID) && (KeyTypeClasses[KeyID] == TDataClass::StaticClass());
 }
 
 template<class TDataClass>
@@ -308,48 +363,52 @@ bool UBlackboardComponent::SetValue(const FName& KeyName, typename TDataClass::F
 template<class TDataClass>
 bool UBlackboardComponent::SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value)
 {
-	const FBlackboardEntry* EntryInfo = BlackboardAsset ? BlackboardAsset->GetKey(KeyID) : nullptr;
-	if ((EntryInfo == nullptr) || (EntryInfo->KeyType == nullptr) || (EntryInfo->KeyType->GetClass() != TDataClass::StaticClass()))
+	if (!IsKeyOfType<TDataClass>(KeyID))
+	{
+		return false;
+	}
+
+	return SetValue<TDataClass>(FBlackboardTypedKey<TDataClass>(KeyID), Value);
+}
+
+template<class TDataClass>
+bool UBlackboardComponent::SetValue(FBlackboardTypedKey<TDataClass> Key, typename TDataClass::FDataType Value)
+{
+	const FBlackboard::FKey KeyID = Key.KeyID;
+	if (!ValueMemory.Num() || !KeyDataOffsets.IsValidIndex(KeyID))
 	{
 		return false;
 	}
 
-	const uint16 DataOffset = EntryInfo->KeyType->HasInstance() ? sizeof(FBlackboardInstancedKeyMemory) : 0;
-	uint8* RawData = GetKeyRawData(KeyID) + DataOffset;
-	if (RawData)
+	uint8* RawData = ValueMemory.GetData() + KeyDataOffsets[KeyID];
+	const bool bChanged = TDataClass::SetValue((TDataClass*)KeyTypeObjects[KeyID], RawData, Value);
+	if (bChanged)
 	{
-		UBlackboardKeyType* KeyOb = EntryInfo->KeyType->HasInstance() ? KeyInstances[KeyID] : EntryInfo->KeyType;
-		const bool bChanged = TDataClass::SetValue((TDataClass*)KeyOb, RawData, Value);
-		if (bChanged)
+		NotifyObservers(KeyID);
+		if (BlackboardAsset->HasSynchronizedKeys() && IsKeyInstanceSynced(KeyID))
 		{
-			NotifyObservers(KeyID);
-			if (BlackboardAsset->HasSynchronizedKeys() && IsKeyInstanceSynced(KeyID))
+			const FName KeyName = GetKeyName(KeyID);
+			UAISystem* AISystem = UAISystem::GetCurrentSafe(GetWorld());
+			for (auto Iter = AISystem->CreateBlackboardDataToComponentsIterator(*BlackboardAsset); Iter; ++Iter)
 			{
-				UAISystem* AISystem = UAISystem::GetCurrentSafe(GetWorld());
-				for (auto Iter = AISystem->CreateBlackboardDataToComponentsIterator(*BlackboardAsset); Iter; ++Iter)
+				UBlackboardComponent* OtherBlackboard = Iter.Value();
+				if (OtherBlackboard != nullptr && ShouldSyncWithBlackboard(*OtherBlackboard))
 				{
-					UBlackboardComponent* OtherBlackboard = Iter.Value();
-					if (OtherBlackboard != nullptr && ShouldSyncWithBlackboard(*OtherBlackboard))
+					const FBlackboard::FKey OtherKeyID = OtherBlackboard->GetKeyID(KeyName);
+					if (OtherBlackboard->KeyDataOffsets.IsValidIndex(OtherKeyID) && OtherBlackboard->ValueMemory.Num())
 					{
-						UBlackboardData* const OtherBlackboardAsset = OtherBlackboard->GetBlackboardAsset();
-						const int32 OtherKeyID = OtherBlackboardAsset ? OtherBlackboardAsset->GetKeyID(EntryInfo->EntryName) : FBlackboard::InvalidKey;
-						if (OtherKeyID != FBlackboard::InvalidKey)
-						{
-							UBlackboardKeyType* OtherKeyOb = EntryInfo->KeyType->HasInstance() ? OtherBlackboard->KeyInstances[OtherKeyID] : EntryInfo->KeyType;
-							uint8* OtherRawData = OtherBlackboard->GetKeyRawData(OtherKeyID) + DataOffset;
-
-							TDataClass::SetValue((TDataClass*)OtherKeyOb, OtherRawData, Value);
-							OtherBlackboard->NotifyObservers(OtherKeyID);
-						}
+						UBlackboardKeyType* OtherKeyOb = OtherBlackboard->KeyTypeObjects[OtherKeyID];
+						uint8* OtherRawData = OtherBlackboard->ValueMemory.GetData() + OtherBlackboard->KeyDataOffsets[OtherKeyID];
+
+						TDataClass::SetValue((TDataClass*)OtherKeyOb, OtherRawData, Value);
+						OtherBlackboard->NotifyObservers(OtherKeyID);
 					}
 				}
 			}
 		}
-
-		return true;
 	}
 
-	return false;
+	return true;
 }
 
 template<class TDataClass>
@@ -362,17 +421,31 @@ typename TDataClass::FDataType UBlackboardComponent::GetValue(const FName& KeyNa
 template<class TDataClass>
 typename TDataClass::FDataType UBlackboardComponent::GetValue(FBlackboard::FKey KeyID) const
 {
-	const FBlackboardEntry* EntryInfo = BlackboardAsset ? BlackboardAsset->GetKey(KeyID) : nullptr;
-	if ((EntryInfo == nullptr) || (EntryInfo->KeyType == nullptr) || (EntryInfo->KeyType->GetClass() != TDataClass::StaticClass()))
+	if (!IsKeyOfType<TDataClass>(KeyID))
 	{
 		return TDataClass::InvalidValue;
 	}
 
-	UBlackboardKeyType* KeyOb = EntryInfo->KeyType->HasInstance() ? KeyInstances[KeyID] : EntryInfo->KeyType;
-	const uint16 DataOffset = EntryInfo->KeyType->HasInstance() ? sizeof(FBlackboardInstancedKeyMemory) : 0;
+	return GetValue<TDataClass>(FBlackboardTypedKey<TDataClass>(KeyID));
+}
+
+template<class TDataClass>
+FBlackboardTypedKey<TDataClass> UBlackboardComponent::GetTypedKey(const FName& KeyName) const
+{
+	const FBlackboard::FKey KeyID = GetKeyID(KeyName);
+	return IsKeyOfType<TDataClass>(KeyID) ? FBlackboardTypedKey<TDataClass>(KeyID) : FBlackboardTypedKey<TDataClass>();
+}
+
+template<class TDataClass>
+typename TDataClass::FDataType UBlackboardComponent::GetValue(FBlackboardTypedKey<TDataClass> Key) const
+{
+	if (!ValueMemory.Num() || !KeyDataOffsets.IsValidIndex(Key.KeyID))
+	{
+		return TDataClass::InvalidValue;
+	}
 
-	const uint8* RawData = GetKeyRawData(KeyID) + DataOffset;
-	return RawData ? TDataClass::GetValue((TDataClass*)KeyOb, RawData) : TDataClass::InvalidValue;
+	const uint8* RawData = ValueMemory.GetData() + KeyDataOffsets[Key.KeyID];
+	return TDataClass::GetValue((TDataClass*)KeyTypeObjects[Key.KeyID], RawData);
 }
 
 
@@ -16,6 +16,7 @@
 
 class UEnvQuery;
 class UEnvQueryManager;
+class UEnvQueryNode;
 class UEnvQueryOption;
 class UEnvQueryTest;
 
@@ -239,6 +240,19 @@ class AIMODULE_API UEnvQueryManager : public UAISubsystem, public FSelfRegisteri
 	virtual bool Exec(UWorld* Inworld, const TCHAR* Cmd, FOutputDevice& Ar) override;
 	//~ End FExec Interface
 
+#if !(UE_BUILD_SHIPPING)
+	/** accumulates execution cost of a single generator or test step, reported by EnvQueryExecutionStats */
+	static void StoreStepExecutionStats(const UEnvQueryNode& StepNode, int32 NumProcessedItems, float ExecutionTime);
+
+	/** accumulates execution cost of a finished query, reported by EnvQueryExecutionStats */
+	static void StoreQueryExecutionStats(const FEnvQueryInstance& QueryInstance);
+
+	/** describes queries per second and per class cost of generators and tests, since the last reset */
+	static FString DescribeExecutionStats();
+
+	static void ResetExecutionStats();
+#endif // !UE_BUILD_SHIPPING
+
 protected:
 	friend UEnvQueryInstanceBlueprintWrapper;
 	TSharedPtr<FEnvQueryInstance> FindQueryInstance(const int32 QueryID);
@@ -60,6 +60,10 @@ protected:
 		TSubclassOf<UEnvQueryContext> LineFrom, TSubclassOf<UEnvQueryContext> LineTo, TSubclassOf<UEnvQueryContext> LineDirection, bool bUseDirectionContext,
 		const FVector& ItemLocation = FVector::ZeroVector, const FRotator& ItemRotation = FRotator::ZeroRotator) const;
 
+	/** scores items in batches, when only one line depends on the item and goes between the item and another context */
+	void RunBatchedTest(FEnvQueryInstance& QueryInstance, const FEnvDirection& ItemLine, bool bItemLineIsLineA, const TArray<FVector>& OtherLineDirs,
+		float MinThresholdValue, float MaxThresholdValue) const;
+
 	/** helper function: check if contexts are updated per item */
 	bool RequiresPerItemUpdates(TSubclassOf<UEnvQueryContext> LineFrom, TSubclassOf<UEnvQueryContext> LineTo, TSubclassOf<UEnvQueryContext> LineDirection, bool bUseDirectionContext) const;
 };
@@ -31,6 +31,9 @@ protected:
 
 	bool SatisfiesTest(IGameplayTagAssetInterface* ItemGameplayTagAssetInterface) const;
 
+	/** version reusing the caller's container for owned tags, to avoid allocating it for every item */
+	bool SatisfiesTest(IGameplayTagAssetInterface* ItemGameplayTagAssetInterface, FGameplayTagContainer& OwnedGameplayTags) const;
+
 	/**
 	 * Presave function. Gets called once before an object gets serialized for saving. This function is necessary
 	 * for save time computation as Serialize gets called three times per object from within SavePackage.
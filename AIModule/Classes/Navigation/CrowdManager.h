@@ -233,6 +233,11 @@ public:
 	/** adjust current position in path's corridor, starting test from PathStartIdx */
 	void AdjustAgentPathStart(const UCrowdFollowingComponent* AgentComponent, const FNavMeshPath* Path, int32& PathStartIdx) const;
 
+#if WITH_RECAST && !UE_BUILD_SHIPPING
+	/** simulate agents moving between random points on a standalone crowd, updated serially and in parallel batches, and log timings */
+	void BenchmarkCrowdUpdate(int32 NumAgents, int32 NumFrames) const;
+#endif
+
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 
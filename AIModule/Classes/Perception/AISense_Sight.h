@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/ObjectMacros.h"
 #include "GenericTeamAgentInterface.h"
+#include "WorldCollision.h"
 #include "Perception/AISense.h"
 #include "AISense_Sight.generated.h"
 
@@ -78,10 +79,12 @@ struct FAISightQuery
 	FVector LastSeenLocation;
 
 	uint64 bLastResult:1;
-	uint64 LastProcessedFrameNumber :63;
+	/** async line of sight trace has been requested for this query, and its result has not been processed yet */
+	uint64 bTracePending:1;
+	uint64 LastProcessedFrameNumber :62;
 
 	FAISightQuery(FPerceptionListenerID ListenerId = FPerceptionListenerID::InvalidID(), FAISightTarget::FTargetId Target = FAISightTarget::InvalidTargetId)
-		: ObserverId(ListenerId), TargetId(Target), Score(0), Importance(0), LastSeenLocation(FAISystem::InvalidLocation), bLastResult(false), LastProcessedFrameNumber(GFrameCounter)
+		: ObserverId(ListenerId), TargetId(Target), Score(0), Importance(0), LastSeenLocation(FAISystem::InvalidLocation), bLastResult(false), bTracePending(false), LastProcessedFrameNumber(GFrameCounter)
 	{
 	}
 
@@ -170,8 +173,28 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
 	float SightLimitQueryImportance;
 
+	/** If set, line of sight checks done by the sense itself are issued as async traces, and their results are processed on the next update.
+	 *	Targets implementing IAISightTargetInterface are still checked synchronously. */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
+	bool bUseAsyncLineOfSightTraces;
+
+	/** Used instead of MaxTracesPerTick when bUseAsyncLineOfSightTraces is set */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
+	int32 MaxAsyncTracesPerTick;
+
 	ECollisionChannel DefaultSightCollisionChannel;
 
+	struct FPendingLineOfSightTrace
+	{
+		FTraceHandle Handle;
+		FPerceptionListenerID ObserverId;
+		FAISightTarget::FTargetId TargetId;
+		FVector TargetLocation;
+		/** frame on which the query was processed before this trace was requested, used to measure detection latency */
+		uint64 PreviousProcessedFrameNumber;
+	};
+	TArray<FPendingLineOfSightTrace> PendingLineOfSightTraces;
+
 public:
 
 	virtual void PostInitProperties() override;
@@ -204,6 +227,12 @@ protected:
 
 	float CalcQueryImportance(const FPerceptionListener& Listener, const FVector& TargetLocation, const float SightRadiusSq) const;
 
+	/** applies results of async line of sight traces requested during the previous update */
+	void ProcessPendingLineOfSightTraces(UWorld& World);
+
+	/** registers outcome of a line of sight check done by the sense itself */
+	void OnLineOfSightResult(FAISightQuery& SightQuery, FPerceptionListener& Listener, AActor& TargetActor, const FVector& TargetLocation, bool bVisible, uint64 PreviousProcessedFrameNumber);
+
 	// Deprecated methods
 public:
 	UE_DEPRECATED(4.25, "Not needed anymore done automatically at the beginning of each update.")
@@ -68,6 +68,26 @@ void UBTAuxiliaryNode::WrappedTickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 	}
 }
 
+float UBTAuxiliaryNode::GetNextNeededDeltaTime(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	if (bNotifyTick || HasInstance())
+	{
+		const UBTAuxiliaryNode* NodeOb = HasInstance() ? static_cast<UBTAuxiliaryNode*>(GetNodeInstance(OwnerComp, NodeMemory)) : this;
+		if (NodeOb != nullptr && NodeOb->bNotifyTick)
+		{
+			if (NodeOb->bTickIntervals)
+			{
+				FBTAuxiliaryMemory* AuxMemory = GetSpecialNodeMemory<FBTAuxiliaryMemory>(NodeMemory);
+				return FMath::Max(0.0f, AuxMemory->NextTickRemainingTime);
+			}
+
+			return 0.0f;
+		}
+	}
+
+	return FLT_MAX;
+}
+
 void UBTAuxiliaryNode::SetNextTickTime(uint8* NodeMemory, float RemainingTime) const
 {
 	if (bTickIntervals)
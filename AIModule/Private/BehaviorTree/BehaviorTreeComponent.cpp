@@ -30,6 +30,52 @@ double UBehaviorTreeComponent::FrameSearchTime = 0.;
 int32 UBehaviorTreeComponent::NumSearchTimeCalls = 0;
 #endif
 
+static TAutoConsoleVariable<int32> CVarBTScheduledTicks(TEXT("BehaviorTree.ScheduledTicks"), 1,
+	TEXT("If set, behavior tree components tick only when active tasks or auxiliary nodes need it, or when execution flow needs an update.\n")
+	TEXT("Otherwise they tick every frame."));
+
+// Code for timing BT Tick
+static TAutoConsoleVariable<int32> CVarBTRecordTickTimes(TEXT("BehaviorTree.RecordTickTimes"), 0, TEXT("Record Tick Times Per Frame For Perf Stats, see BehaviorTree.DumpTickStats"));
+#if !UE_BUILD_SHIPPING
+namespace FBehaviorTreeTickStats
+{
+	static double FrameTickTime = 0.;
+	static int32 NumFrameTicks = 0;
+
+	static double TotalTickTime = 0.;
+	static int64 TotalNumTicks = 0;
+	static int64 TotalNumFrames = 0;
+
+	static void DumpCommand(const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			TotalTickTime = 0.;
+			TotalNumTicks = 0;
+			TotalNumFrames = 0;
+			return;
+		}
+
+		const UBehaviorTreeManager* BTManager = UBehaviorTreeManager::GetCurrent(World);
+		const int32 NumAgents = BTManager ? BTManager->GetNumActiveComponents() : 0;
+		const double NumFrames = FMath::Max<double>(1., TotalNumFrames);
+
+		UE_LOG(LogBehaviorTree, Display, TEXT("Behavior tree tick stats over %lld frames (scheduled ticks: %s, recording: %s)"),
+			TotalNumFrames, CVarBTScheduledTicks.GetValueOnGameThread() ? TEXT("on") : TEXT("off"), CVarBTRecordTickTimes.GetValueOnGameThread() ? TEXT("on") : TEXT("off"));
+		UE_LOG(LogBehaviorTree, Display, TEXT("  %.3f ms per frame, %.1f ticks per frame, %.2f us per tick"),
+			TotalTickTime * 1000. / NumFrames, TotalNumTicks / NumFrames, TotalNumTicks ? TotalTickTime * 1000000. / TotalNumTicks : 0.);
+		UE_LOG(LogBehaviorTree, Display, TEXT("  %d active components, %.2f us per agent per frame, %.1f%% ticked per frame"),
+			NumAgents, NumAgents ? TotalTickTime * 1000000. / (NumFrames * NumAgents) : 0., NumAgents ? 100. * TotalNumTicks / (NumFrames * NumAgents) : 0.);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs DumpCmd(
+		TEXT("BehaviorTree.DumpTickStats"),
+		TEXT("Logs behavior tree tick cost per agent recorded while BehaviorTree.RecordTickTimes is set, compare with BehaviorTree.ScheduledTicks on and off.\n")
+		TEXT("Usage: BehaviorTree.DumpTickStats [reset]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(DumpCommand));
+}
+#endif
+
 struct FScopedBehaviorTreeLock
 {
 	FScopedBehaviorTreeLock(UBehaviorTreeComponent& InOwnerComp, uint8 InLockFlag) : OwnerComp(InOwnerComp), LockFlag(InLockFlag)
@@ -71,6 +117,9 @@ UBehaviorTreeComponent::UBehaviorTreeComponent(const FObjectInitializer& ObjectI
 	bWantsInitializeComponent = true; 
 	bIsRunning = false;
 	bIsPaused = false;
+	UserTickInterval = -1.f;
+	LastTickGameTime = -1.f;
+	NextTickDeltaTime = 0.f;
 
 	// Adding hook for bespoke framepro BT timings for BR
 #if !UE_BUILD_SHIPPING
@@ -157,6 +206,9 @@ EAILogicResuming::Type UBehaviorTreeComponent::ResumeLogic(const FString& Reason
 	{
 		bIsPaused = false;
 
+		// active tasks may need ticking again
+		ScheduleNextTick(0.0f);
+
 		if (SuperResumeResult == EAILogicResuming::Continue)
 		{
 			if (BlackboardComp)
@@ -434,6 +486,14 @@ void UBehaviorTreeComponent::Cleanup()
 	NodeInstances.Reset();
 }
 
+void UBehaviorTreeComponent::HandleMessage(const FAIMessage& Message)
+{
+	Super::HandleMessage(Message);
+
+	// messages are delivered to observers in next tick
+	ScheduleNextTick(0.0f);
+}
+
 void UBehaviorTreeComponent::OnTaskFinished(const UBTTaskNode* TaskNode, EBTNodeResult::Type TaskResult)
 {
 	if (TaskNode == NULL || InstanceStack.Num() == 0 || IsPendingKill())
@@ -524,6 +584,9 @@ void UBehaviorTreeComponent::OnTaskFinished(const UBTTaskNode* TaskNode, EBTNode
 		UpdateAbortingTasks();
 	}
 
+	// tick state of tasks may have changed outside of TickComponent
+	ScheduleNextTick(0.0f);
+
 	if (TreeStartInfo.HasPendingInitialize())
 	{
 		ProcessPendingInitialize();
@@ -810,6 +873,113 @@ static void FindCommonParent(const TArray<FBehaviorTreeInstance>& Instances, con
 void UBehaviorTreeComponent::ScheduleExecutionUpdate()
 {
 	bRequestedFlowUpdate = true;
+	ScheduleNextTick(0.0f);
+}
+
+void UBehaviorTreeComponent::ScheduleNextTick(const float NextNeededDeltaTime)
+{
+	// scheduling only changes tick interval, keep the one set up by user as lower bound
+	if (UserTickInterval < 0.0f)
+	{
+		UserTickInterval = GetComponentTickInterval();
+	}
+
+	if (CVarBTScheduledTicks.GetValueOnGameThread() == 0)
+	{
+		// restore regular ticking if scheduling got disabled in runtime
+		if (NextTickDeltaTime != 0.0f)
+		{
+			NextTickDeltaTime = 0.0f;
+			SetComponentTickInterval(UserTickInterval);
+			SetComponentTickEnabled(true);
+		}
+		return;
+	}
+
+	if (NextNeededDeltaTime == NextTickDeltaTime)
+	{
+		return;
+	}
+
+	// cooldown of already scheduled tick doesn't change with interval, it needs to be reset to tick sooner
+	const bool bTickSooner = NextNeededDeltaTime < NextTickDeltaTime;
+	NextTickDeltaTime = NextNeededDeltaTime;
+
+	if (NextTickDeltaTime == FLT_MAX)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	if (bTickSooner)
+	{
+		SetComponentTickEnabled(false);
+	}
+
+	SetComponentTickInterval(FMath::Max(NextTickDeltaTime, UserTickInterval));
+	SetComponentTickEnabled(true);
+}
+
+float UBehaviorTreeComponent::GetNextNeededTickDeltaTime()
+{
+	if (bRequestedFlowUpdate || bDeferredStopTree || MessagesToProcess.Num() > 0 || (BlackboardComp && BlackboardComp->HasPendingChanges()))
+	{
+		return 0.0f;
+	}
+
+	float NextNeededDeltaTime = FLT_MAX;
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceStack.Num(); InstanceIndex++)
+	{
+		FBehaviorTreeInstance& InstanceInfo = InstanceStack[InstanceIndex];
+		for (int32 AuxIndex = 0; AuxIndex < InstanceInfo.ActiveAuxNodes.Num(); AuxIndex++)
+		{
+			const UBTAuxiliaryNode* AuxNode = InstanceInfo.ActiveAuxNodes[AuxIndex];
+			uint8* NodeMemory = AuxNode->GetNodeMemory<uint8>(InstanceInfo);
+			NextNeededDeltaTime = FMath::Min(NextNeededDeltaTime, AuxNode->GetNextNeededDeltaTime(*this, NodeMemory));
+		}
+	}
+
+	if (InstanceStack.Num() == 0 || !bIsRunning || bIsPaused)
+	{
+		return NextNeededDeltaTime;
+	}
+
+	// same set of tasks as ticked by TickComponent
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceStack.Num(); InstanceIndex++)
+	{
+		FBehaviorTreeInstance& InstanceInfo = InstanceStack[InstanceIndex];
+		for (int32 TaskIndex = 0; TaskIndex < InstanceInfo.ParallelTasks.Num(); TaskIndex++)
+		{
+			const UBTTaskNode* ParallelTask = InstanceInfo.ParallelTasks[TaskIndex].TaskNode;
+			uint8* NodeMemory = ParallelTask->GetNodeMemory<uint8>(InstanceInfo);
+			NextNeededDeltaTime = FMath::Min(NextNeededDeltaTime, ParallelTask->GetNextNeededDeltaTime(*this, NodeMemory));
+		}
+	}
+
+	if (InstanceStack.IsValidIndex(ActiveInstanceIdx))
+	{
+		FBehaviorTreeInstance& ActiveInstance = InstanceStack[ActiveInstanceIdx];
+		if (ActiveInstance.ActiveNodeType == EBTActiveNode::ActiveTask ||
+			ActiveInstance.ActiveNodeType == EBTActiveNode::AbortingTask)
+		{
+			const UBTTaskNode* ActiveTask = (const UBTTaskNode*)ActiveInstance.ActiveNode;
+			uint8* NodeMemory = ActiveTask->GetNodeMemory<uint8>(ActiveInstance);
+			NextNeededDeltaTime = FMath::Min(NextNeededDeltaTime, ActiveTask->GetNextNeededDeltaTime(*this, NodeMemory));
+		}
+	}
+
+	if (InstanceStack.IsValidIndex(ActiveInstanceIdx + 1))
+	{
+		FBehaviorTreeInstance& LastInstance = InstanceStack.Last();
+		if (LastInstance.ActiveNodeType == EBTActiveNode::AbortingTask)
+		{
+			const UBTTaskNode* ActiveTask = (const UBTTaskNode*)LastInstance.ActiveNode;
+			uint8* NodeMemory = ActiveTask->GetNodeMemory<uint8>(LastInstance);
+			NextNeededDeltaTime = FMath::Min(NextNeededDeltaTime, ActiveTask->GetNextNeededDeltaTime(*this, NodeMemory));
+		}
+	}
+
+	return NextNeededDeltaTime;
 }
 
 void UBehaviorTreeComponent::RequestExecution(UBTCompositeNode* RequestedOn, int32 InstanceIdx, const UBTNode* RequestedBy,
@@ -1242,6 +1412,27 @@ void UBehaviorTreeComponent::ApplyDiscardedSearch()
 
 void UBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+	// tick function stops tracking time of last tick when it gets disabled or runs without interval,
+	// frames skipped before waking up or changing interval are not included in its delta time
+	if (CVarBTScheduledTicks.GetValueOnGameThread() != 0)
+	{
+		const float CurrentGameTime = GetWorld()->GetTimeSeconds();
+		if (LastTickGameTime >= 0.f)
+		{
+			const AActor* MyOwner = GetOwner();
+			DeltaTime = (CurrentGameTime - LastTickGameTime) * (MyOwner ? MyOwner->CustomTimeDilation : 1.f);
+		}
+		LastTickGameTime = CurrentGameTime;
+	}
+	else
+	{
+		LastTickGameTime = -1.f;
+	}
+
+#if !UE_BUILD_SHIPPING
+	FScopedSwitchedCountedDurationTimer ScopedSwitchedCountedDurationTimer(FBehaviorTreeTickStats::FrameTickTime, FBehaviorTreeTickStats::NumFrameTicks, CVarBTRecordTickTimes.GetValueOnGameThread() != 0);
+#endif
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	SCOPE_CYCLE_COUNTER(STAT_AI_Overall);
 	SCOPE_CYCLE_COUNTER(STAT_AI_BehaviorTree_Tick);
@@ -1264,6 +1455,12 @@ void UBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 		}
 	}
 
+	// send blackboard changes collected since last tick, execution requests from observing decorators are processed below
+	if (BlackboardComp)
+	{
+		BlackboardComp->ProcessChangeJournal();
+	}
+
 	if (bRequestedFlowUpdate)
 	{
 		ProcessExecutionRequest();
@@ -1271,6 +1468,7 @@ void UBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 
 	if (InstanceStack.Num() == 0 || !bIsRunning || bIsPaused)
 	{
+		ScheduleNextTick(GetNextNeededTickDeltaTime());
 		return;
 	}
 
@@ -1322,6 +1520,8 @@ void UBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 	{
 		StopTree(EBTStopMode::Safe);
 	}
+
+	ScheduleNextTick(GetNextNeededTickDeltaTime());
 }
 
 void UBehaviorTreeComponent::ProcessExecutionRequest()
@@ -2813,6 +3013,19 @@ void UBehaviorTreeComponent::EndFrame()
 		FrameSearchTime = 0.;
 		NumSearchTimeCalls = 0;
 	}
+
+	if (CVarBTRecordTickTimes.GetValueOnGameThread() != 0)
+	{
+		FPlatformMisc::CustomNamedStat("BehaviorTreeTickTimeFrameMs", static_cast<float>(FBehaviorTreeTickStats::FrameTickTime * 1000.), "BehaviorTree", "MilliSecs");
+		FPlatformMisc::CustomNamedStat("BehaviorTreeTickCallsFrame", static_cast<float>(FBehaviorTreeTickStats::NumFrameTicks), "BehaviorTree", "Count");
+
+		FBehaviorTreeTickStats::TotalTickTime += FBehaviorTreeTickStats::FrameTickTime;
+		FBehaviorTreeTickStats::TotalNumTicks += FBehaviorTreeTickStats::NumFrameTicks;
+		FBehaviorTreeTickStats::TotalNumFrames++;
+
+		FBehaviorTreeTickStats::FrameTickTime = 0.;
+		FBehaviorTreeTickStats::NumFrameTicks = 0;
+	}
 }
 #endif
 
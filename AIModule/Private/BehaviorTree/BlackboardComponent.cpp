@@ -2,6 +2,7 @@
 
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BrainComponent.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 #include "AIController.h"
 #include "BehaviorTree/BTNode.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
@@ -17,12 +18,17 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
 #include "Misc/RuntimeErrors.h"
 
+static TAutoConsoleVariable<int32> CVarBBChangeJournal(TEXT("BehaviorTree.BlackboardChangeJournal"), 1,
+	TEXT("If set, blackboard observer notifications are collected while owning behavior tree component is active, and sent once per changed key before its next tick.\n")
+	TEXT("Otherwise observers are notified on every value change."));
+
 UBlackboardComponent::UBlackboardComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	bWantsInitializeComponent = true;
 	bPausedNotifies = false;
 	bSynchronizedKeyPopulated = false;
+	bCanJournalNotifies = false;
 }
 
 void UBlackboardComponent::InitializeComponent()
@@ -39,6 +45,7 @@ void UBlackboardComponent::InitializeComponent()
 		{
 			BrainComp->CacheBlackboardComponent(this);
 		}
+		bCanJournalNotifies = Cast<UBehaviorTreeComponent>(BrainComp) != nullptr;
 	}
 
 	// Use DefaultBlackboardAsset if available.
@@ -89,6 +96,7 @@ void UBlackboardComponent::CacheBrainComponent(UBrainComponent& BrainComponent)
 	if (&BrainComponent != BrainComp)
 	{
 		BrainComp = &BrainComponent;
+		bCanJournalNotifies = Cast<UBehaviorTreeComponent>(BrainComp) != nullptr;
 	}
 }
 
@@ -145,6 +153,11 @@ bool UBlackboardComponent::InitializeBlackboard(UBlackboardData& NewAsset)
 	BlackboardAsset = &NewAsset;
 	ValueMemory.Reset();
 	ValueOffsets.Reset();
+	KeyTypeClasses.Reset();
+	KeyTypeObjects.Reset();
+	KeyDataOffsets.Reset();
+	ChangeJournal.Reset();
+	JournaledKeys.Reset();
 	bSynchronizedKeyPopulated = false;
 
 	bool bSuccess = true;
@@ -194,6 +207,9 @@ bool UBlackboardComponent::InitializeBlackboard(UBlackboardData& NewAsset)
 			KeyData->KeyType->InitializeKey(*this, InitList[Index].KeyID);
 		}
 
+		CacheKeyTypes();
+		JournaledKeys.Init(false, NumKeys);
+
 		// naive initial synchronization with one of already instantiated blackboards using the same BB asset
 		if (BlackboardAsset->HasSynchronizedKeys())
 		{
@@ -227,6 +243,28 @@ void UBlackboardComponent::DestroyValues()
 
 	ValueOffsets.Reset();
 	ValueMemory.Reset();
+	KeyTypeClasses.Reset();
+	KeyTypeObjects.Reset();
+	KeyDataOffsets.Reset();
+}
+
+void UBlackboardComponent::CacheKeyTypes()
+{
+	const int32 NumKeys = ValueOffsets.Num();
+	KeyTypeClasses.Reset(NumKeys);
+	KeyTypeObjects.Reset(NumKeys);
+	KeyDataOffsets.Reset(NumKeys);
+
+	for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+	{
+		const FBlackboardEntry* EntryInfo = BlackboardAsset->GetKey(KeyIndex);
+		UBlackboardKeyType* KeyType = EntryInfo ? EntryInfo->KeyType : nullptr;
+		const bool bHasInstance = KeyType && KeyType->HasInstance();
+
+		KeyTypeClasses.Add(KeyType ? KeyType->GetClass() : nullptr);
+		KeyTypeObjects.Add(bHasInstance ? KeyInstances[KeyIndex] : KeyType);
+		KeyDataOffsets.Add(ValueOffsets[KeyIndex] + (bHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0));
+	}
 }
 
 void UBlackboardComponent::PopulateSynchronizedKeys()
@@ -387,7 +425,7 @@ void UBlackboardComponent::ResumeObserverNotifications(bool bSendQueuedObserverN
 	{
 		for (int32 UpdateIndex = 0; UpdateIndex < QueuedUpdates.Num(); UpdateIndex++)
 		{
-			NotifyObservers(QueuedUpdates[UpdateIndex]);
+			BroadcastKeyChange(QueuedUpdates[UpdateIndex]);
 		}
 	}
 
@@ -405,12 +443,33 @@ void UBlackboardComponent::ResumeUpdates()
 
 	for (int32 UpdateIndex = 0; UpdateIndex < QueuedUpdates.Num(); UpdateIndex++)
 	{
-		NotifyObservers(QueuedUpdates[UpdateIndex]);
+		BroadcastKeyChange(QueuedUpdates[UpdateIndex]);
 	}
 
 	QueuedUpdates.Empty();
 }
 
+void UBlackboardComponent::ProcessChangeJournal()
+{
+	// observers can change more keys, they will be added at the end of journal and processed in the same loop
+	for (int32 JournalIndex = 0; JournalIndex < ChangeJournal.Num(); JournalIndex++)
+	{
+		const FBlackboard::FKey KeyID = ChangeJournal[JournalIndex];
+		JournaledKeys[KeyID] = false;
+
+		if (bPausedNotifies)
+		{
+			QueuedUpdates.AddUnique(KeyID);
+		}
+		else
+		{
+			BroadcastKeyChange(KeyID);
+		}
+	}
+
+	ChangeJournal.Reset();
+}
+
 void UBlackboardComponent::NotifyObservers(FBlackboard::FKey KeyID) const
 {
 	TMultiMap<uint8, FOnBlackboardChangeNotification>::TKeyIterator KeyIt(Observers, KeyID);
@@ -424,19 +483,35 @@ void UBlackboardComponent::NotifyObservers(FBlackboard::FKey KeyID) const
 		{
 			QueuedUpdates.AddUnique(KeyID);
 		}
-		else
+		else if (bCanJournalNotifies && JournaledKeys.IsValidIndex(KeyID) && BrainComp->IsActive() && CVarBBChangeJournal.GetValueOnGameThread())
 		{
-			for (; KeyIt; ++KeyIt)
+			// multiple changes of the same key are reported once, with the latest value
+			if (!JournaledKeys[KeyID])
 			{
-				const FOnBlackboardChangeNotification& ObserverDelegate = KeyIt.Value();
-				const bool bWantsToContinueObserving = ObserverDelegate.IsBound() && (ObserverDelegate.Execute(*this, KeyID) == EBlackboardNotificationResult::ContinueObserving);
+				JournaledKeys[KeyID] = true;
+				ChangeJournal.Add(KeyID);
 
-				if (bWantsToContinueObserving == false)
-				{
-					KeyIt.RemoveCurrent();
-				}
+				static_cast<UBehaviorTreeComponent*>(BrainComp)->ScheduleNextTick(0.0f);
 			}
 		}
+		else
+		{
+			BroadcastKeyChange(KeyID);
+		}
+	}
+}
+
+void UBlackboardComponent::BroadcastKeyChange(FBlackboard::FKey KeyID) const
+{
+	for (TMultiMap<uint8, FOnBlackboardChangeNotification>::TKeyIterator KeyIt(Observers, KeyID); KeyIt; ++KeyIt)
+	{
+		const FOnBlackboardChangeNotification& ObserverDelegate = KeyIt.Value();
+		const bool bWantsToContinueObserving = ObserverDelegate.IsBound() && (ObserverDelegate.Execute(*this, KeyID) == EBlackboardNotificationResult::ContinueObserving);
+
+		if (bWantsToContinueObserving == false)
+		{
+			KeyIt.RemoveCurrent();
+		}
 	}
 }
 
@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "EnvironmentQuery/EnvQueryBatchHelpers.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+
+namespace FEQSBatchHelpers
+{
+	void GatherItemLocations(const UEnvQueryTest& QueryTest, FEnvQueryInstance& QueryInstance, int32 StartItemIndex, int32 MaxItems, FItemLocationBatch& OutBatch)
+	{
+		OutBatch.ItemIndices.Reset();
+		OutBatch.X.Reset();
+		OutBatch.Y.Reset();
+		OutBatch.Z.Reset();
+
+		for (int32 ItemIndex = StartItemIndex; ItemIndex < QueryInstance.Items.Num() && OutBatch.ItemIndices.Num() < MaxItems; ItemIndex++)
+		{
+			if (QueryInstance.Items[ItemIndex].IsValid())
+			{
+				const FVector ItemLocation = QueryTest.GetItemLocation(QueryInstance, ItemIndex);
+				OutBatch.ItemIndices.Add(ItemIndex);
+				OutBatch.X.Add(ItemLocation.X);
+				OutBatch.Y.Add(ItemLocation.Y);
+				OutBatch.Z.Add(ItemLocation.Z);
+			}
+		}
+
+		// pad with copies of the last item, kernels work on groups of 4 and padded values are never read back
+		const int32 NumItems = OutBatch.ItemIndices.Num();
+		const int32 NumPadded = Align(NumItems, 4);
+		const FVector PadLocation = NumItems ? OutBatch.GetLocation(NumItems - 1) : FVector::ZeroVector;
+		for (int32 Idx = NumItems; Idx < NumPadded; Idx++)
+		{
+			OutBatch.X.Add(PadLocation.X);
+			OutBatch.Y.Add(PadLocation.Y);
+			OutBatch.Z.Add(PadLocation.Z);
+		}
+	}
+
+	void CalcDistances(EDistanceMode Mode, const FItemLocationBatch& Batch, const TArray<FVector>& ContextLocations, TArray<float>& OutValues)
+	{
+		const int32 NumPadded = Batch.NumPadded();
+		OutValues.SetNumUninitialized(NumPadded * ContextLocations.Num(), false);
+
+		for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
+		{
+			const FVector& ContextLocation = ContextLocations[ContextIndex];
+			const VectorRegister ContextX = VectorSetFloat1(ContextLocation.X);
+			const VectorRegister ContextY = VectorSetFloat1(ContextLocation.Y);
+			const VectorRegister ContextZ = VectorSetFloat1(ContextLocation.Z);
+			float* Values = OutValues.GetData() + ContextIndex * NumPadded;
+
+			for (int32 Idx = 0; Idx < NumPadded; Idx += 4)
+			{
+				const VectorRegister DeltaZ = VectorSubtract(ContextZ, VectorLoad(&Batch.Z[Idx]));
+				VectorRegister Result;
+
+				switch (Mode)
+				{
+					case EDistanceMode::Distance3D:
+					{
+						const VectorRegister DeltaX = VectorSubtract(ContextX, VectorLoad(&Batch.X[Idx]));
+						const VectorRegister DeltaY = VectorSubtract(ContextY, VectorLoad(&Batch.Y[Idx]));
+						Result = VectorAdd(VectorAdd(VectorMultiply(DeltaX, DeltaX), VectorMultiply(DeltaY, DeltaY)), VectorMultiply(DeltaZ, DeltaZ));
+						break;
+					}
+
+					case EDistanceMode::Distance2D:
+					{
+						const VectorRegister DeltaX = VectorSubtract(ContextX, VectorLoad(&Batch.X[Idx]));
+						const VectorRegister DeltaY = VectorSubtract(ContextY, VectorLoad(&Batch.Y[Idx]));
+						Result = VectorAdd(VectorMultiply(DeltaX, DeltaX), VectorMultiply(DeltaY, DeltaY));
+						break;
+					}
+
+					case EDistanceMode::DistanceZ:
+						Result = DeltaZ;
+						break;
+
+					default:
+						Result = VectorAbs(DeltaZ);
+						break;
+				}
+
+				VectorStore(Result, &Values[Idx]);
+			}
+
+			// square root is taken per value to match FVector::Size exactly
+			if (Mode == EDistanceMode::Distance3D || Mode == EDistanceMode::Distance2D)
+			{
+				for (int32 Idx = 0; Idx < NumPadded; Idx++)
+				{
+					Values[Idx] = FMath::Sqrt(Values[Idx]);
+				}
+			}
+		}
+	}
+
+	void CalcDotProducts(bool b2D, const FItemLocationBatch& Batch, const TArray<FVector>& ContextLocations, bool bItemIsLineStart,
+		const TArray<FVector>& FixedDirections, TArray<float>& OutValues)
+	{
+		const int32 NumPadded = Batch.NumPadded();
+		const int32 NumContexts = ContextLocations.Num();
+		OutValues.SetNumUninitialized(NumPadded * NumContexts * FixedDirections.Num(), false);
+
+		// CosineAngle2D flattens and normalizes both lines
+		TArray<FVector, TInlineAllocator<8>> Directions;
+		for (const FVector& Dir : FixedDirections)
+		{
+			FVector& FlatDir = Directions.Add_GetRef(Dir);
+			if (b2D)
+			{
+				FlatDir.Z = 0.f;
+				FlatDir.Normalize();
+			}
+		}
+
+		const VectorRegister One = GlobalVectorConstants::FloatOne;
+		const VectorRegister Zero = GlobalVectorConstants::FloatZero;
+		const VectorRegister Tolerance = VectorSetFloat1(SMALL_NUMBER);
+		const VectorRegister Sign = VectorSetFloat1(bItemIsLineStart ? -1.f : 1.f);
+
+		for (int32 ContextIndex = 0; ContextIndex < NumContexts; ContextIndex++)
+		{
+			const FVector& ContextLocation = ContextLocations[ContextIndex];
+			const VectorRegister ContextX = VectorSetFloat1(ContextLocation.X);
+			const VectorRegister ContextY = VectorSetFloat1(ContextLocation.Y);
+			const VectorRegister ContextZ = VectorSetFloat1(ContextLocation.Z);
+
+			for (int32 Idx = 0; Idx < NumPadded; Idx += 4)
+			{
+				// line goes from context to item, or the other way around (negation is exact)
+				VectorRegister DirX = VectorMultiply(VectorSubtract(VectorLoad(&Batch.X[Idx]), ContextX), Sign);
+				VectorRegister DirY = VectorMultiply(VectorSubtract(VectorLoad(&Batch.Y[Idx]), ContextY), Sign);
+				VectorRegister DirZ = VectorMultiply(VectorSubtract(VectorLoad(&Batch.Z[Idx]), ContextZ), Sign);
+
+				// FVector::GetSafeNormal
+				{
+					const VectorRegister SquareSum = VectorAdd(VectorAdd(VectorMultiply(DirX, DirX), VectorMultiply(DirY, DirY)), VectorMultiply(DirZ, DirZ));
+					const VectorRegister Scale = VectorSelect(VectorCompareEQ(SquareSum, One), One, VectorReciprocalSqrtAccurate(SquareSum));
+					const VectorRegister IsTooSmall = VectorCompareLT(SquareSum, Tolerance);
+					DirX = VectorSelect(IsTooSmall, Zero, VectorMultiply(DirX, Scale));
+					DirY = VectorSelect(IsTooSmall, Zero, VectorMultiply(DirY, Scale));
+					DirZ = VectorSelect(IsTooSmall, Zero, VectorMultiply(DirZ, Scale));
+				}
+
+				// FVector::Normalize of flattened direction
+				if (b2D)
+				{
+					const VectorRegister SquareSum = VectorAdd(VectorMultiply(DirX, DirX), VectorMultiply(DirY, DirY));
+					const VectorRegister Scale = VectorSelect(VectorCompareGT(SquareSum, Tolerance), VectorReciprocalSqrtAccurate(SquareSum), One);
+					DirX = VectorMultiply(DirX, Scale);
+					DirY = VectorMultiply(DirY, Scale);
+				}
+
+				for (int32 DirIndex = 0; DirIndex < Directions.Num(); DirIndex++)
+				{
+					const FVector& Dir = Directions[DirIndex];
+					VectorRegister Result = VectorAdd(VectorMultiply(DirX, VectorSetFloat1(Dir.X)), VectorMultiply(DirY, VectorSetFloat1(Dir.Y)));
+					if (!b2D)
+					{
+						Result = VectorAdd(Result, VectorMultiply(DirZ, VectorSetFloat1(Dir.Z)));
+					}
+
+					VectorStore(Result, OutValues.GetData() + (DirIndex * NumContexts + ContextIndex) * NumPadded + Idx);
+				}
+			}
+		}
+	}
+}
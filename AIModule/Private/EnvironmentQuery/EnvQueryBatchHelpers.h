@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+
+class UEnvQueryTest;
+
+/**
+ * Helpers for tests that score items in batches: locations of a run of valid items are gathered
+ * into contiguous arrays, scored with SIMD kernels, and the results are fed to the item iterator
+ * in iteration order, so that time slicing and filtering behave as they do with per item scoring.
+ */
+namespace FEQSBatchHelpers
+{
+	/** Number of items gathered at once, small enough for the time limit to be checked frequently */
+	static constexpr int32 MaxItemsPerBatch = 256;
+
+	/** Locations of a run of valid items, padded with copies of the last one up to a multiple of 4 */
+	struct FItemLocationBatch
+	{
+		TArray<int32> ItemIndices;
+		TArray<float> X;
+		TArray<float> Y;
+		TArray<float> Z;
+
+		int32 Num() const { return ItemIndices.Num(); }
+		int32 NumPadded() const { return X.Num(); }
+		FVector GetLocation(int32 BatchIndex) const { return FVector(X[BatchIndex], Y[BatchIndex], Z[BatchIndex]); }
+	};
+
+	/** Gathers locations of up to MaxItems valid items, starting with StartItemIndex (which must be valid) */
+	void GatherItemLocations(const UEnvQueryTest& QueryTest, FEnvQueryInstance& QueryInstance, int32 StartItemIndex, int32 MaxItems, FItemLocationBatch& OutBatch);
+
+	enum class EDistanceMode : uint8
+	{
+		Distance3D,
+		Distance2D,
+		DistanceZ,
+		DistanceAbsoluteZ,
+	};
+
+	/**
+	 * Computes distance from every item of the batch to every context location,
+	 * OutValues[ContextIndex * Batch.NumPadded() + BatchIndex]. Values match the ones computed by UEnvQueryTest_Distance.
+	 */
+	void CalcDistances(EDistanceMode Mode, const FItemLocationBatch& Batch, const TArray<FVector>& ContextLocations, TArray<float>& OutValues);
+
+	/**
+	 * Computes dot products between fixed directions and per item directions, going from every context location to the item
+	 * (or from the item to every context location when bItemIsLineStart is set), OutValues[(DirIndex * ContextLocations.Num() + ContextIndex) * Batch.NumPadded() + BatchIndex].
+	 * Per item directions are normalized with the same rules as FVector::GetSafeNormal, and in 2D mode both lines are
+	 * flattened and normalized as in FVector::CosineAngle2D.
+	 */
+	void CalcDotProducts(bool b2D, const FItemLocationBatch& Batch, const TArray<FVector>& ContextLocations, bool bItemIsLineStart,
+		const TArray<FVector>& FixedDirections, TArray<float>& OutValues);
+}
@@ -313,6 +313,10 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 	const bool bDoingLastTest = (CurrentTest >= OptionItem.Tests.Num() - 1);
 	bool bStepDone = true;
 	CurrentStepTimeLimit = TimeLimit;
+#if !(UE_BUILD_SHIPPING)
+	const UEnvQueryNode* StepNode = nullptr;
+	int32 StepProcessedItems = 0;
+#endif // !UE_BUILD_SHIPPING
 
 	if (CurrentTest < 0)
 	{
@@ -393,6 +397,11 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 #if USE_EQS_DEBUGGER
 		NumProcessedItems = Items.Num() - LastValidItems;
 #endif // USE_EQS_DEBUGGER
+
+#if !(UE_BUILD_SHIPPING)
+		StepNode = OptionItem.Generator;
+		StepProcessedItems = Items.Num();
+#endif // !UE_BUILD_SHIPPING
 	}
 	else if (OptionItem.Tests.IsValidIndex(CurrentTest))
 	{
@@ -438,6 +447,11 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 		{
 			FinalizeTest();
 		}
+
+#if !(UE_BUILD_SHIPPING)
+		StepNode = TestObject;
+		StepProcessedItems = CurrentTestStartingItem - ItemsAlreadyProcessed;
+#endif // !UE_BUILD_SHIPPING
 	}
 	else
 	{
@@ -448,6 +462,13 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 	const float StepExecutionTime = FPlatformTime::Seconds() - StepStartTime;
 	TotalExecutionTime += StepExecutionTime;
 
+#if !(UE_BUILD_SHIPPING)
+	if (StepNode)
+	{
+		UEnvQueryManager::StoreStepExecutionStats(*StepNode, StepProcessedItems, StepExecutionTime);
+	}
+#endif // !UE_BUILD_SHIPPING
+
 #if USE_EQS_DEBUGGER
 	if (bStoreDebugInfo)
 	{
@@ -769,6 +790,10 @@ void FEnvQueryInstance::PickSingleItem(int32 ItemIndex)
 
 void FEnvQueryInstance::FinalizeQuery()
 {
+#if !(UE_BUILD_SHIPPING)
+	UEnvQueryManager::StoreQueryExecutionStats(*this);
+#endif // !UE_BUILD_SHIPPING
+
 	if (NumValidItems > 0)
 	{
 		if (Mode == EEnvQueryRunMode::SingleResult)
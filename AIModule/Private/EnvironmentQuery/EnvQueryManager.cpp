@@ -55,6 +55,23 @@ DEFINE_STAT(STAT_AI_EQS_Debug_StoreStats);
 	TMap<FName, FEQSDebugger::FStatsInfo> UEnvQueryManager::DebuggerStats;
 #endif
 
+#if !(UE_BUILD_SHIPPING)
+namespace FEQSExecutionStats
+{
+	struct FNodeStats
+	{
+		int32 NumSteps = 0;
+		int64 NumProcessedItems = 0;
+		double ExecutionTime = 0.;
+	};
+
+	TMap<FName, FNodeStats> NodeStats;
+	int32 NumFinishedQueries = 0;
+	double QueriesExecutionTime = 0.;
+	double StartTime = 0.;
+}
+#endif // !UE_BUILD_SHIPPING
+
 
 //////////////////////////////////////////////////////////////////////////
 // FEnvQueryRequest
@@ -994,9 +1011,80 @@ bool UEnvQueryManager::Exec(UWorld* Inworld, const TCHAR* Cmd, FOutputDevice& Ar
 	}
 #endif
 
+#if !(UE_BUILD_SHIPPING)
+	if (FParse::Command(&Cmd, TEXT("EnvQueryExecutionStats")))
+	{
+		Ar.Log(DescribeExecutionStats());
+		if (FParse::Command(&Cmd, TEXT("reset")))
+		{
+			ResetExecutionStats();
+		}
+		return true;
+	}
+#endif // !UE_BUILD_SHIPPING
+
 	return false;
 }
 
+#if !(UE_BUILD_SHIPPING)
+void UEnvQueryManager::StoreStepExecutionStats(const UEnvQueryNode& StepNode, int32 NumProcessedItems, float ExecutionTime)
+{
+	check(IsInGameThread());
+
+	if (FEQSExecutionStats::StartTime == 0.)
+	{
+		FEQSExecutionStats::StartTime = FPlatformTime::Seconds();
+	}
+
+	FEQSExecutionStats::FNodeStats& Stats = FEQSExecutionStats::NodeStats.FindOrAdd(StepNode.GetClass()->GetFName());
+	Stats.NumSteps++;
+	Stats.NumProcessedItems += NumProcessedItems;
+	Stats.ExecutionTime += ExecutionTime;
+}
+
+void UEnvQueryManager::StoreQueryExecutionStats(const FEnvQueryInstance& QueryInstance)
+{
+	check(IsInGameThread());
+
+	FEQSExecutionStats::NumFinishedQueries++;
+	FEQSExecutionStats::QueriesExecutionTime += QueryInstance.TotalExecutionTime;
+}
+
+FString UEnvQueryManager::DescribeExecutionStats()
+{
+	const double Duration = (FEQSExecutionStats::StartTime > 0.) ? (FPlatformTime::Seconds() - FEQSExecutionStats::StartTime) : 0.;
+	FString Description = FString::Printf(TEXT("EQS execution stats over %.2fs: %d queries finished, %.1f queries/s, %.3f ms average execution time\n"),
+		Duration, FEQSExecutionStats::NumFinishedQueries,
+		(Duration > 0.) ? (FEQSExecutionStats::NumFinishedQueries / Duration) : 0.,
+		FEQSExecutionStats::NumFinishedQueries ? (FEQSExecutionStats::QueriesExecutionTime * 1000. / FEQSExecutionStats::NumFinishedQueries) : 0.);
+
+	TArray<FName> NodeNames;
+	FEQSExecutionStats::NodeStats.GetKeys(NodeNames);
+	NodeNames.Sort([](const FName& A, const FName& B)
+	{
+		return FEQSExecutionStats::NodeStats[A].ExecutionTime > FEQSExecutionStats::NodeStats[B].ExecutionTime;
+	});
+
+	for (const FName& NodeName : NodeNames)
+	{
+		const FEQSExecutionStats::FNodeStats& Stats = FEQSExecutionStats::NodeStats[NodeName];
+		Description += FString::Printf(TEXT("  %s: %d steps, %lld items, %.3f ms total, %.3f ms per step, %.3f us per item\n"),
+			*NodeName.ToString(), Stats.NumSteps, Stats.NumProcessedItems, Stats.ExecutionTime * 1000.,
+			Stats.NumSteps ? (Stats.ExecutionTime * 1000. / Stats.NumSteps) : 0.,
+			Stats.NumProcessedItems ? (Stats.ExecutionTime * 1000000. / Stats.NumProcessedItems) : 0.);
+	}
+
+	return Description;
+}
+
+void UEnvQueryManager::ResetExecutionStats()
+{
+	FEQSExecutionStats::NodeStats.Reset();
+	FEQSExecutionStats::NumFinishedQueries = 0;
+	FEQSExecutionStats::QueriesExecutionTime = 0.;
+	FEQSExecutionStats::StartTime = FPlatformTime::Seconds();
+}
+#endif // !UE_BUILD_SHIPPING
 
 //----------------------------------------------------------------------//
 // FEQSDebugger
@@ -3,31 +3,12 @@
 #include "EnvironmentQuery/Tests/EnvQueryTest_Distance.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvironmentQuery/EnvQueryBatchHelpers.h"
 
 #define ENVQUERYTEST_DISTANCE_NAN_DETECTION 1
 
 namespace
 {
-	FORCEINLINE float CalcDistance3D(const FVector& PosA, const FVector& PosB)
-	{
-		return (PosB - PosA).Size();
-	}
-
-	FORCEINLINE float CalcDistance2D(const FVector& PosA, const FVector& PosB)
-	{
-		return (PosB - PosA).Size2D();
-	}
-
-	FORCEINLINE float CalcDistanceZ(const FVector& PosA, const FVector& PosB)
-	{
-		return PosB.Z - PosA.Z;
-	}
-
-	FORCEINLINE float CalcDistanceAbsoluteZ(const FVector& PosA, const FVector& PosB)
-	{
-		return FMath::Abs(PosB.Z - PosA.Z);
-	}
-
 	FORCEINLINE void CheckItemLocationForNaN(const FVector& ItemLocation, UObject* QueryOwner, int32 Index, uint8 TestMode)
 	{
 #if ENVQUERYTEST_DISTANCE_NAN_DETECTION
@@ -71,68 +52,55 @@ void UEnvQueryTest_Distance::RunTest(FEnvQueryInstance& QueryInstance) const
 		return;
 	}
 
+	FEQSBatchHelpers::EDistanceMode DistanceMode = FEQSBatchHelpers::EDistanceMode::Distance3D;
 	switch (TestMode)
 	{
-		case EEnvTestDistance::Distance3D:	
-			for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
-			{
-				const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
-				CheckItemLocationForNaN(ItemLocation, QueryOwner, It.GetIndex(), TestMode);
-				for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
-				{
-					CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
-					const float Distance = CalcDistance3D(ItemLocation, ContextLocations[ContextIndex]);
-					It.SetScore(TestPurpose, FilterType, Distance, MinThresholdValue, MaxThresholdValue);
-				}
-			}
+		case EEnvTestDistance::Distance3D:
+			DistanceMode = FEQSBatchHelpers::EDistanceMode::Distance3D;
 			break;
 
-		case EEnvTestDistance::Distance2D:	
-			for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
-			{
-				const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
-				CheckItemLocationForNaN(ItemLocation, QueryOwner, It.GetIndex(), TestMode);
-				for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
-				{
-					CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
-					const float Distance = CalcDistance2D(ItemLocation, ContextLocations[ContextIndex]);
-					It.SetScore(TestPurpose, FilterType, Distance, MinThresholdValue, MaxThresholdValue);
-				}
-			}
+		case EEnvTestDistance::Distance2D:
+			DistanceMode = FEQSBatchHelpers::EDistanceMode::Distance2D;
 			break;
 
-		case EEnvTestDistance::DistanceZ:	
-			for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
-			{
-				const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
-				CheckItemLocationForNaN(ItemLocation, QueryOwner, It.GetIndex(), TestMode);
-				for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
-				{
-					CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
-					const float Distance = CalcDistanceZ(ItemLocation, ContextLocations[ContextIndex]);
-					It.SetScore(TestPurpose, FilterType, Distance, MinThresholdValue, MaxThresholdValue);
-				}
-			}
+		case EEnvTestDistance::DistanceZ:
+			DistanceMode = FEQSBatchHelpers::EDistanceMode::DistanceZ;
 			break;
 
 		case EEnvTestDistance::DistanceAbsoluteZ:
-			for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
-			{
-				const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
-				CheckItemLocationForNaN(ItemLocation, QueryOwner, It.GetIndex(), TestMode);
-				for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
-				{
-					CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
-					const float Distance = CalcDistanceAbsoluteZ(ItemLocation, ContextLocations[ContextIndex]);
-					It.SetScore(TestPurpose, FilterType, Distance, MinThresholdValue, MaxThresholdValue);
-				}
-			}
+			DistanceMode = FEQSBatchHelpers::EDistanceMode::DistanceAbsoluteZ;
 			break;
 
 		default:
 			checkNoEntry();
 			return;
 	}
+
+	for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
+	{
+		CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
+	}
+
+	// distances are computed for batches of items, and then fed to the iterator one item at a time
+	FEQSBatchHelpers::FItemLocationBatch Batch;
+	TArray<float> Distances;
+	FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+	while (It)
+	{
+		FEQSBatchHelpers::GatherItemLocations(*this, QueryInstance, It.GetIndex(), FEQSBatchHelpers::MaxItemsPerBatch, Batch);
+		FEQSBatchHelpers::CalcDistances(DistanceMode, Batch, ContextLocations, Distances);
+
+		const int32 NumPadded = Batch.NumPadded();
+		for (int32 BatchIndex = 0; BatchIndex < Batch.Num() && It; BatchIndex++, ++It)
+		{
+			checkSlow(It.GetIndex() == Batch.ItemIndices[BatchIndex]);
+			CheckItemLocationForNaN(Batch.GetLocation(BatchIndex), QueryOwner, It.GetIndex(), TestMode);
+			for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
+			{
+				It.SetScore(TestPurpose, FilterType, Distances[ContextIndex * NumPadded + BatchIndex], MinThresholdValue, MaxThresholdValue);
+			}
+		}
+	}
 }
 
 FText UEnvQueryTest_Distance::GetDescriptionTitle() const
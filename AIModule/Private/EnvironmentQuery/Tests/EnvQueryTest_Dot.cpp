@@ -4,6 +4,21 @@
 #include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Item.h"
+#include "EnvironmentQuery/EnvQueryBatchHelpers.h"
+
+namespace
+{
+	FORCEINLINE float FixupDotValue(float DotValue, bool bAbsoluteValue)
+	{
+		// invalid LineADirs, LineBDirs?
+		if (FMath::IsNaN(DotValue))
+		{
+			return 0.f;
+		}
+
+		return bAbsoluteValue ? FMath::Abs(DotValue) : DotValue;
+	}
+}
 
 UEnvQueryTest_Dot::UEnvQueryTest_Dot(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -56,6 +71,17 @@ void UEnvQueryTest_Dot::RunTest(FEnvQueryInstance& QueryInstance) const
 		}
 	}
 
+	// a line between the item and another context can be computed for batches of items, as long as the other line doesn't depend on the item
+	if (bUpdateLineAPerItem != bUpdateLineBPerItem && (TestMode == EEnvTestDot::Dot3D || TestMode == EEnvTestDot::Dot2D))
+	{
+		const FEnvDirection& ItemLine = bUpdateLineAPerItem ? LineA : LineB;
+		if (ItemLine.DirMode == EEnvDirection::TwoPoints && IsContextPerItem(ItemLine.LineFrom) != IsContextPerItem(ItemLine.LineTo))
+		{
+			RunBatchedTest(QueryInstance, ItemLine, bUpdateLineAPerItem, bUpdateLineAPerItem ? LineBDirs : LineADirs, MinThresholdValue, MaxThresholdValue);
+			return;
+		}
+	}
+
 	// loop through all items
 	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
 	{
@@ -98,18 +124,49 @@ void UEnvQueryTest_Dot::RunTest(FEnvQueryInstance& QueryInstance) const
 						UE_LOG(LogEQS, Error, TEXT("Invalid TestMode in EnvQueryTest_Dot in query %s!"), *QueryInstance.QueryName);
 						break;
 				}
-				
-				// invalid LineADirs, LineBDirs? 
-				if (FMath::IsNaN(DotValue))
-				{
-					DotValue = 0.f;
-				}
-				else if (bAbsoluteValue)
+
+				It.SetScore(TestPurpose, FilterType, FixupDotValue(DotValue, bAbsoluteValue), MinThresholdValue, MaxThresholdValue);
+			}
+		}
+	}
+}
+
+void UEnvQueryTest_Dot::RunBatchedTest(FEnvQueryInstance& QueryInstance, const FEnvDirection& ItemLine, bool bItemLineIsLineA, const TArray<FVector>& OtherLineDirs,
+	float MinThresholdValue, float MaxThresholdValue) const
+{
+	const bool bItemIsLineStart = IsContextPerItem(ItemLine.LineFrom);
+	TArray<FVector> ContextLocations;
+	QueryInstance.PrepareContext(bItemIsLineStart ? ItemLine.LineTo : ItemLine.LineFrom, ContextLocations);
+
+	const int32 NumContexts = ContextLocations.Num();
+	const int32 NumOtherDirs = OtherLineDirs.Num();
+
+	FEQSBatchHelpers::FItemLocationBatch Batch;
+	TArray<float> DotValues;
+	FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+	while (It)
+	{
+		FEQSBatchHelpers::GatherItemLocations(*this, QueryInstance, It.GetIndex(), FEQSBatchHelpers::MaxItemsPerBatch, Batch);
+		FEQSBatchHelpers::CalcDotProducts(TestMode == EEnvTestDot::Dot2D, Batch, ContextLocations, bItemIsLineStart, OtherLineDirs, DotValues);
+
+		const int32 NumPadded = Batch.NumPadded();
+		for (int32 BatchIndex = 0; BatchIndex < Batch.Num() && It; BatchIndex++, ++It)
+		{
+			checkSlow(It.GetIndex() == Batch.ItemIndices[BatchIndex]);
+
+			// keep the order of line pairs used by per item scoring
+			const int32 NumOuter = bItemLineIsLineA ? NumContexts : NumOtherDirs;
+			const int32 NumInner = bItemLineIsLineA ? NumOtherDirs : NumContexts;
+			for (int32 OuterIndex = 0; OuterIndex < NumOuter; OuterIndex++)
+			{
+				for (int32 InnerIndex = 0; InnerIndex < NumInner; InnerIndex++)
 				{
-					DotValue = FMath::Abs(DotValue);
-				}
+					const int32 DirIndex = bItemLineIsLineA ? InnerIndex : OuterIndex;
+					const int32 ContextIndex = bItemLineIsLineA ? OuterIndex : InnerIndex;
+					const float DotValue = DotValues[(DirIndex * NumContexts + ContextIndex) * NumPadded + BatchIndex];
 
-				It.SetScore(TestPurpose, FilterType, DotValue, MinThresholdValue, MaxThresholdValue);
+					It.SetScore(TestPurpose, FilterType, FixupDotValue(DotValue, bAbsoluteValue), MinThresholdValue, MaxThresholdValue);
+				}
 			}
 		}
 	}
@@ -74,6 +74,15 @@ bool UEnvQueryTest_GameplayTags::SatisfiesTest(IGameplayTagAssetInterface* ItemG
 	check(ItemGameplayTagAssetInterface != nullptr);
 
 	FGameplayTagContainer OwnedGameplayTags;
+	return SatisfiesTest(ItemGameplayTagAssetInterface, OwnedGameplayTags);
+}
+
+bool UEnvQueryTest_GameplayTags::SatisfiesTest(IGameplayTagAssetInterface* ItemGameplayTagAssetInterface, FGameplayTagContainer& OwnedGameplayTags) const
+{
+	check(ItemGameplayTagAssetInterface != nullptr);
+
+	// keep the allocated memory, the container is reused for all items
+	OwnedGameplayTags.Reset();
 	ItemGameplayTagAssetInterface->GetOwnedGameplayTags(OwnedGameplayTags);
 
 	return OwnedGameplayTags.MatchesQuery(TagQueryToMatch);
@@ -90,6 +99,8 @@ void UEnvQueryTest_GameplayTags::RunTest(FEnvQueryInstance& QueryInstance) const
 	BoolValue.BindData(QueryOwner, QueryInstance.QueryID);
 	bool bWantsValid = BoolValue.GetValue();
 
+	FGameplayTagContainer OwnedGameplayTags;
+
 	// loop through all items
 	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
 	{
@@ -97,7 +108,7 @@ void UEnvQueryTest_GameplayTags::RunTest(FEnvQueryInstance& QueryInstance) const
 		IGameplayTagAssetInterface* GameplayTagAssetInterface = Cast<IGameplayTagAssetInterface>(ItemActor);
 		if (GameplayTagAssetInterface != NULL)
 		{
-			bool bSatisfiesTest = SatisfiesTest(GameplayTagAssetInterface);
+			bool bSatisfiesTest = SatisfiesTest(GameplayTagAssetInterface, OwnedGameplayTags);
 
 			// bWantsValid is the basically the opposite of bInverseCondition in BTDecorator.  Possibly we should
 			// rename to make these more consistent.
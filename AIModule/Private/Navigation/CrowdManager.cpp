@@ -8,6 +8,7 @@
 #include "NavMesh/RecastNavMesh.h"
 #include "VisualLogger/VisualLogger.h"
 #include "AIModuleLog.h"
+#include "Async/TaskGraphInterfaces.h"
 
 #if WITH_RECAST
 #include "NavMesh/RecastHelpers.h"
@@ -95,6 +96,23 @@ namespace FCrowdDebug
 	const float LineThickness = 3.f;
 }
 
+namespace FCrowdParallelUpdate
+{
+	/** if set, per agent work of proximity, steering, avoidance and corridor steps is split into batches updated on task graph workers */
+	int32 Enable = 1;
+	FAutoConsoleVariableRef CVarEnable(TEXT("ai.crowd.ParallelUpdate"), Enable,
+		TEXT("Update crowd agents in parallel batches. Results are the same as serial update.\n0: Disable, 1: Enable"), ECVF_Default);
+
+	int32 MinAgentsPerBatch = 32;
+	FAutoConsoleVariableRef CVarMinAgentsPerBatch(TEXT("ai.crowd.ParallelUpdate.MinAgentsPerBatch"), MinAgentsPerBatch,
+		TEXT("Minimum number of crowd agents updated by a single parallel batch, requires ai.crowd.ParallelUpdate."), ECVF_Default);
+
+	int32 GetMaxWorkers()
+	{
+		return (Enable && FApp::ShouldUseThreadingForPerformance()) ? FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 : 1;
+	}
+}
+
 void FCrowdTickHelper::Tick(float DeltaTime)
 {
 #if WITH_EDITOR
@@ -233,6 +251,7 @@ void UCrowdManager::Tick(float DeltaTime)
 		if (NumActive)
 		{
 			MyNavData->BeginBatchQuery();
+			DetourCrowd->setParallelUpdate(FCrowdParallelUpdate::GetMaxWorkers(), FCrowdParallelUpdate::MinAgentsPerBatch);
 
 			for (auto It = ActiveAgents.CreateIterator(); It; ++It)
 			{
@@ -651,6 +670,152 @@ void UCrowdManager::AdjustAgentPathStart(const UCrowdFollowingComponent* AgentCo
 #endif
 }
 
+#if WITH_RECAST && !UE_BUILD_SHIPPING
+namespace FCrowdBenchmark
+{
+	FRandomStream RandomStream;
+
+	float GetRandomFraction()
+	{
+		return RandomStream.GetFraction();
+	}
+}
+
+void UCrowdManager::BenchmarkCrowdUpdate(int32 NumAgents, int32 NumFrames) const
+{
+	ARecastNavMesh* RecastNavData = Cast<ARecastNavMesh>(MyNavData);
+	dtNavMesh* NavMeshPtr = RecastNavData ? RecastNavData->GetRecastMesh() : nullptr;
+	if (NavMeshPtr == nullptr)
+	{
+		UE_LOG(LogCrowdFollowing, Warning, TEXT("Crowd benchmark requires a recast navmesh"));
+		return;
+	}
+
+	// proximity grid stores agent indices as 16 bit values
+	NumAgents = FMath::Clamp(NumAgents, 1, int32(MAX_uint16));
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	const dtQueryFilter* DefaultFilter = ((const FRecastQueryFilter*)MyNavData->GetDefaultQueryFilterImpl())->GetAsDetourQueryFilter();
+	dtNavMeshQuery* NavQuery = dtAllocNavMeshQuery();
+	NavQuery->init(NavMeshPtr, 2048);
+
+	TArray<FVector> StartLocations;
+	TArray<FVector> EndLocations;
+	TArray<dtPolyRef> EndPolys;
+	FCrowdBenchmark::RandomStream.Initialize(0x43524f57);
+	for (int32 Idx = 0; Idx < NumAgents; Idx++)
+	{
+		dtPolyRef StartPoly = 0, EndPoly = 0;
+		FVector StartPt, EndPt;
+		if (dtStatusSucceed(NavQuery->findRandomPoint(DefaultFilter, FCrowdBenchmark::GetRandomFraction, &StartPoly, &StartPt.X)) &&
+			dtStatusSucceed(NavQuery->findRandomPoint(DefaultFilter, FCrowdBenchmark::GetRandomFraction, &EndPoly, &EndPt.X)))
+		{
+			StartLocations.Add(StartPt);
+			EndLocations.Add(EndPt);
+			EndPolys.Add(EndPoly);
+		}
+	}
+	dtFreeNavMeshQuery(NavQuery);
+
+	dtCrowdAgentParams Params;
+	Params.userData = nullptr;
+	Params.radius = 34.0f;
+	Params.height = 176.0f;
+	Params.maxAcceleration = 2048.0f;
+	Params.maxSpeed = 600.0f;
+	Params.collisionQueryRange = 400.0f;
+	Params.pathOptimizationRange = 1000.0f;
+	Params.separationWeight = 2.0f;
+	Params.avoidanceQueryMultiplier = 1.0f;
+	Params.avoidanceGroup = 1;
+	Params.groupsToAvoid = MAX_uint32;
+	Params.groupsToIgnore = 0;
+	Params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+	Params.obstacleAvoidanceType = ECrowdAvoidanceQuality::Good;
+	Params.filter = 0;
+
+	const int32 MaxWorkers = FCrowdParallelUpdate::GetMaxWorkers();
+	const float DeltaTime = 1.0f / 30.0f;
+
+	// run 0 is serial, run 1 in parallel batches
+	TArray<FVector> FinalLocations[2];
+	double UpdateTime[2] = { 0.0, 0.0 };
+	int32 NumSamples[2] = { 0, 0 };
+	for (int32 Run = 0; Run < 2; Run++)
+	{
+		dtCrowd* Crowd = dtAllocCrowd();
+		Crowd->init(StartLocations.Num(), MaxAgentRadius, NavMeshPtr);
+		Crowd->setParallelUpdate(Run ? MaxWorkers : 1, FCrowdParallelUpdate::MinAgentsPerBatch);
+		Crowd->initAvoidance(MaxAvoidedAgents, MaxAvoidedWalls, 1);
+		for (int32 Idx = 0; Idx < AvoidanceConfig.Num() && Idx < DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS; Idx++)
+		{
+			const FCrowdAvoidanceConfig& ConfigInfo = AvoidanceConfig[Idx];
+
+			dtObstacleAvoidanceParams AvoidanceParams = *Crowd->getObstacleAvoidanceParams(Idx);
+			AvoidanceParams.velBias = ConfigInfo.VelocityBias;
+			AvoidanceParams.adaptiveDivs = ConfigInfo.AdaptiveDivisions;
+			AvoidanceParams.adaptiveRings = ConfigInfo.AdaptiveRings;
+			AvoidanceParams.adaptiveDepth = ConfigInfo.AdaptiveDepth;
+			Crowd->setObstacleAvoidanceParams(Idx, &AvoidanceParams);
+		}
+
+		for (int32 Idx = 0; Idx < StartLocations.Num(); Idx++)
+		{
+			const int32 AgentIndex = Crowd->addAgent(&StartLocations[Idx].X, Params, DefaultFilter);
+			if (AgentIndex >= 0)
+			{
+				Crowd->requestMoveTarget(AgentIndex, EndPolys[Idx], &EndLocations[Idx].X);
+			}
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Crowd->update(DeltaTime, nullptr);
+			NumSamples[Run] += Crowd->getVelocitySampleCount();
+		}
+		UpdateTime[Run] = FPlatformTime::Seconds() - StartTime;
+
+		for (int32 Idx = 0; Idx < Crowd->getAgentCount(); Idx++)
+		{
+			const dtCrowdAgent* Agent = Crowd->getAgent(Idx);
+			FinalLocations[Run].Add(Agent->active ? Recast2UnrealPoint(Agent->npos) : FVector::ZeroVector);
+		}
+
+		dtFreeCrowd(Crowd);
+	}
+
+	int32 NumMismatched = 0;
+	for (int32 Idx = 0; Idx < FinalLocations[0].Num(); Idx++)
+	{
+		NumMismatched += (FinalLocations[0][Idx] != FinalLocations[1][Idx]) ? 1 : 0;
+	}
+
+	UE_LOG(LogCrowdFollowing, Display, TEXT("Crowd benchmark: %d agents, %d frames, %d workers"), StartLocations.Num(), NumFrames, MaxWorkers);
+	UE_LOG(LogCrowdFollowing, Display, TEXT("  Serial: %.3f ms per frame, %d velocity samples"), UpdateTime[0] * 1000.0 / NumFrames, NumSamples[0]);
+	UE_LOG(LogCrowdFollowing, Display, TEXT("  Parallel: %.3f ms per frame, %d velocity samples, %.2fx"), UpdateTime[1] * 1000.0 / NumFrames, NumSamples[1],
+		UpdateTime[1] > 0.0 ? UpdateTime[0] / UpdateTime[1] : 0.0);
+	UE_CLOG(NumMismatched > 0, LogCrowdFollowing, Error, TEXT("  %d agents ended at different locations in serial and parallel update"), NumMismatched);
+}
+
+static void BenchmarkCrowdUpdateCommand(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumAgents = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5000;
+	const int32 NumFrames = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+
+	if (const UCrowdManager* CrowdManager = UCrowdManager::GetCurrent(World))
+	{
+		CrowdManager->BenchmarkCrowdUpdate(NumAgents, NumFrames);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkCrowdUpdateCmd(
+	TEXT("ai.crowd.Benchmark"),
+	TEXT("Simulates agents moving between random points of the crowd navmesh, compares serial and parallel crowd update times and checks that agents end at the same locations.\n")
+	TEXT("Usage: ai.crowd.Benchmark [NumAgents=5000] [NumFrames=300]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkCrowdUpdateCommand));
+#endif // WITH_RECAST && !UE_BUILD_SHIPPING
+
 void UCrowdManager::SetOffmeshConnectionPruning(bool bRemoveFromCorridor)
 {
 	bPruneStartedOffmeshConnections = bRemoveFromCorridor;
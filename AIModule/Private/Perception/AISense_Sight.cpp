@@ -27,10 +27,16 @@ DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Listener Update"), STAT_AI_Sen
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Register Target"), STAT_AI_Sense_Sight_RegisterTarget, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove By Listener"), STAT_AI_Sense_Sight_RemoveByListener, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove To Target"), STAT_AI_Sense_Sight_RemoveToTarget, STATGROUP_AI);
+DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Process Async Traces"), STAT_AI_Sense_Sight_ProcessAsyncTraces, STATGROUP_AI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Sense: Sight, Traces"), STAT_AI_Sense_Sight_Traces, STATGROUP_AI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perception Sense: Sight, Pending Async Traces"), STAT_AI_Sense_Sight_PendingTraces, STATGROUP_AI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Sense: Sight, Detections"), STAT_AI_Sense_Sight_Detections, STATGROUP_AI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Sense: Sight, Detection Latency (total frames)"), STAT_AI_Sense_Sight_DetectionLatency, STATGROUP_AI);
 
 
 static const int32 DefaultMaxTracesPerTick = 6;
 static const int32 DefaultMinQueriesPerTimeSliceCheck = 40;
+static const int32 DefaultMaxAsyncTracesPerTick = 64;
 
 //----------------------------------------------------------------------//
 // helpers
@@ -46,6 +52,12 @@ FORCEINLINE_DEBUGGABLE bool CheckIsTargetInSightPie(const FPerceptionListener& L
 	return false;
 }
 
+/** Identifies an observer/target pair, used to match async trace results to their sight queries */
+FORCEINLINE uint64 MakeSightQueryKey(const FPerceptionListenerID ObserverId, const FAISightTarget::FTargetId TargetId)
+{
+	return ((uint64)(uint32)ObserverId << 32) | TargetId;
+}
+
 enum class EForEachResult : uint8
 {
 	Break,
@@ -131,6 +143,8 @@ UAISense_Sight::UAISense_Sight(const FObjectInitializer& ObjectInitializer)
 	, HighImportanceQueryDistanceThreshold(300.f)
 	, MaxQueryImportance(60.f)
 	, SightLimitQueryImportance(10.f)
+	, bUseAsyncLineOfSightTraces(true)
+	, MaxAsyncTracesPerTick(DefaultMaxAsyncTracesPerTick)
 {
 	if (HasAnyFlags(RF_ClassDefaultObject) == false)
 	{
@@ -176,17 +190,129 @@ bool UAISense_Sight::ShouldAutomaticallySeeTarget(const FDigestedSightProperties
 	return false;
 }
 
+void UAISense_Sight::OnLineOfSightResult(FAISightQuery& SightQuery, FPerceptionListener& Listener, AActor& TargetActor, const FVector& TargetLocation, bool bVisible, uint64 PreviousProcessedFrameNumber)
+{
+	if (bVisible)
+	{
+		if (SightQuery.bLastResult == false)
+		{
+			INC_DWORD_STAT(STAT_AI_Sense_Sight_Detections);
+			INC_DWORD_STAT_BY(STAT_AI_Sense_Sight_DetectionLatency, GFrameCounter - PreviousProcessedFrameNumber);
+		}
+
+		Listener.RegisterStimulus(&TargetActor, FAIStimulus(*this, 1.f, TargetLocation, Listener.CachedLocation));
+		SightQuery.bLastResult = true;
+		SightQuery.LastSeenLocation = TargetLocation;
+	}
+	// communicate failure only if we've seen give actor before
+	else if (SightQuery.bLastResult == true)
+	{
+		Listener.RegisterStimulus(&TargetActor, FAIStimulus(*this, 0.f, TargetLocation, Listener.CachedLocation, FAIStimulus::SensingFailed));
+		SightQuery.bLastResult = false;
+		SightQuery.LastSeenLocation = FAISystem::InvalidLocation;
+	}
+
+	if (SightQuery.bLastResult == false)
+	{
+		SIGHT_LOG_LOCATION(Listener.Listener->GetOwner(), TargetLocation, 25.f, FColor::Red, TEXT(""));
+	}
+}
+
+void UAISense_Sight::ProcessPendingLineOfSightTraces(UWorld& World)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_ProcessAsyncTraces);
+
+	struct FTraceResult
+	{
+		int32 PendingIndex;
+		bool bVisible;
+		bool bExpired;
+	};
+
+	// results are available on the frame following the request, handles that are no longer valid
+	// belong to updates that were skipped, their queries simply get processed again
+	TMap<uint64, FTraceResult> Results;
+	FTraceDatum TraceDatum;
+	for (int32 PendingIndex = 0; PendingIndex < PendingLineOfSightTraces.Num(); PendingIndex++)
+	{
+		const FPendingLineOfSightTrace& PendingTrace = PendingLineOfSightTraces[PendingIndex];
+		const uint64 QueryKey = MakeSightQueryKey(PendingTrace.ObserverId, PendingTrace.TargetId);
+
+		if (World.QueryTraceData(PendingTrace.Handle, TraceDatum))
+		{
+			bool bVisible = true;
+			if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+			{
+				const FAISightTarget* Target = ObservedTargets.Find(PendingTrace.TargetId);
+				const AActor* TargetActor = Target ? Target->GetTargetActor() : nullptr;
+				const AActor* HitResultActor = TraceDatum.OutHits[0].Actor.Get();
+				bVisible = TargetActor && HitResultActor && HitResultActor->IsOwnedBy(TargetActor);
+			}
+			Results.Add(QueryKey, FTraceResult{ PendingIndex, bVisible, /*bExpired=*/false });
+		}
+		else if (!World.IsTraceHandleValid(PendingTrace.Handle, /*bOverlapTrace=*/false))
+		{
+			Results.Add(QueryKey, FTraceResult{ PendingIndex, /*bVisible=*/false, /*bExpired=*/true });
+		}
+	}
+
+	if (Results.Num() == 0)
+	{
+		return;
+	}
+
+	AIPerception::FListenerMap& ListenersMap = *GetListeners();
+	auto ApplyResult = [this, &Results, &ListenersMap](FAISightQuery& SightQuery)->EForEachResult
+	{
+		if (SightQuery.bTracePending)
+		{
+			const FTraceResult* Result = Results.Find(MakeSightQueryKey(SightQuery.ObserverId, SightQuery.TargetId));
+			if (Result)
+			{
+				SightQuery.bTracePending = false;
+
+				const FPendingLineOfSightTrace& PendingTrace = PendingLineOfSightTraces[Result->PendingIndex];
+				FPerceptionListener* Listener = ListenersMap.Find(SightQuery.ObserverId);
+				FAISightTarget* Target = ObservedTargets.Find(SightQuery.TargetId);
+				AActor* TargetActor = Target ? Target->Target.Get() : nullptr;
+				if (Result->bExpired == false && Listener && Listener->Listener.IsValid() && TargetActor)
+				{
+					OnLineOfSightResult(SightQuery, *Listener, *TargetActor, PendingTrace.TargetLocation, Result->bVisible, PendingTrace.PreviousProcessedFrameNumber);
+				}
+			}
+		}
+		return EForEachResult::Continue;
+	};
+	ForEach(SightQueriesInRange, ApplyResult);
+	ForEach(SightQueriesOutOfRange, ApplyResult);
+
+	// queries removed or regenerated while waiting don't need their results anymore
+	int32 NumRemaining = 0;
+	for (int32 PendingIndex = 0; PendingIndex < PendingLineOfSightTraces.Num(); PendingIndex++)
+	{
+		const FPendingLineOfSightTrace& PendingTrace = PendingLineOfSightTraces[PendingIndex];
+		const FTraceResult* Result = Results.Find(MakeSightQueryKey(PendingTrace.ObserverId, PendingTrace.TargetId));
+		if (Result == nullptr || Result->PendingIndex != PendingIndex)
+		{
+			PendingLineOfSightTraces[NumRemaining++] = PendingTrace;
+		}
+	}
+	PendingLineOfSightTraces.SetNum(NumRemaining, /*bAllowShrinking=*/false);
+}
+
 float UAISense_Sight::Update()
 {
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight);
 
-	const UWorld* World = GEngine->GetWorldFromContextObject(GetPerceptionSystem()->GetOuter(), EGetWorldErrorMode::LogAndReturnNull);
+	UWorld* World = GEngine->GetWorldFromContextObject(GetPerceptionSystem()->GetOuter(), EGetWorldErrorMode::LogAndReturnNull);
 
 	if (World == NULL)
 	{
 		return SuspendNextUpdate;
 	}
 
+	ProcessPendingLineOfSightTraces(*World);
+
 	// sort Sight Queries
 	{
 		auto RecalcScore = [](FAISightQuery& SightQuery)->EForEachResult
@@ -211,6 +337,7 @@ float UAISense_Sight::Update()
 	}
 
 	int32 TracesCount = 0;
+	const int32 MaxTracesThisTick = bUseAsyncLineOfSightTraces ? MaxAsyncTracesPerTick : MaxTracesPerTick;
 	int32 NumQueriesProcessed = 0;
 	double TimeSliceEnd = FPlatformTime::Seconds() + MaxTimeSlicePerTick;
 	bool bHitTimeSliceLimit = false;
@@ -271,10 +398,16 @@ float UAISense_Sight::Update()
 			// do not break here since that would bypass queue aging
 		}
 
-		if (TracesCount < MaxTracesPerTick && bHitTimeSliceLimit == false)
+		if (TracesCount < MaxTracesThisTick && bHitTimeSliceLimit == false)
 		{
 			bIsInRangeQuery ? ++InRangeItr : ++OutOfRangeItr;
 
+			// waiting for line of sight result, it will be processed on next update
+			if (SightQuery->bTracePending)
+			{
+				continue;
+			}
+
 			FPerceptionListener& Listener = ListenersMap[SightQuery->ObserverId];
 			FAISightTarget& Target = ObservedTargets[SightQuery->TargetId];
 
@@ -333,36 +466,27 @@ float UAISense_Sight::Update()
 					else
 					{
 						// we need to do tests ourselves
-						FHitResult HitResult;
-						const bool bHit = World->LineTraceSingleByChannel(HitResult, Listener.CachedLocation, TargetLocation
-							, DefaultSightCollisionChannel
-							, FCollisionQueryParams(SCENE_QUERY_STAT(AILineOfSight), true, ListenerPtr->GetBodyActor()));
-
+						const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AILineOfSight), true, ListenerPtr->GetBodyActor());
 						++TracesCount;
 
-						auto HitResultActorIsOwnedByTargetActor = [&HitResult, TargetActor]()
+						if (bUseAsyncLineOfSightTraces)
 						{
-							AActor* HitResultActor = HitResult.Actor.Get();
-							return (HitResultActor ? HitResultActor->IsOwnedBy(TargetActor) : false);
-						};
-
-						if (bHit == false || HitResultActorIsOwnedByTargetActor())
-						{
-							Listener.RegisterStimulus(TargetActor, FAIStimulus(*this, 1.f, TargetLocation, Listener.CachedLocation));
-							SightQuery->bLastResult = true;
-							SightQuery->LastSeenLocation = TargetLocation;
+							FPendingLineOfSightTrace& PendingTrace = PendingLineOfSightTraces.AddDefaulted_GetRef();
+							PendingTrace.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Listener.CachedLocation, TargetLocation, DefaultSightCollisionChannel, QueryParams);
+							PendingTrace.ObserverId = SightQuery->ObserverId;
+							PendingTrace.TargetId = SightQuery->TargetId;
+							PendingTrace.TargetLocation = TargetLocation;
+							PendingTrace.PreviousProcessedFrameNumber = SightQuery->LastProcessedFrameNumber;
+							SightQuery->bTracePending = true;
 						}
-						// communicate failure only if we've seen give actor before
-						else if (SightQuery->bLastResult == true)
+						else
 						{
-							Listener.RegisterStimulus(TargetActor, FAIStimulus(*this, 0.f, TargetLocation, Listener.CachedLocation, FAIStimulus::SensingFailed));
-							SightQuery->bLastResult = false;
-							SightQuery->LastSeenLocation = FAISystem::InvalidLocation;
-						}
+							FHitResult HitResult;
+							const bool bHit = World->LineTraceSingleByChannel(HitResult, Listener.CachedLocation, TargetLocation, DefaultSightCollisionChannel, QueryParams);
 
-						if (SightQuery->bLastResult == false)
-						{
-							SIGHT_LOG_LOCATION(ListenerPtr->GetOwner(), TargetLocation, 25.f, FColor::Red, TEXT(""));
+							AActor* HitResultActor = HitResult.Actor.Get();
+							const bool bVisible = (bHit == false || (HitResultActor && HitResultActor->IsOwnedBy(TargetActor)));
+							OnLineOfSightResult(*SightQuery, Listener, *TargetActor, TargetLocation, bVisible, SightQuery->LastProcessedFrameNumber);
 						}
 					}
 				}
@@ -401,6 +525,9 @@ float UAISense_Sight::Update()
 	}
 	NextOutOfRangeIndex = SightQueriesOutOfRange.Num() > 0 ? (NextOutOfRangeIndex + OutOfRangeItr) % SightQueriesOutOfRange.Num() : 0;
 
+	INC_DWORD_STAT_BY(STAT_AI_Sense_Sight_Traces, TracesCount);
+	SET_DWORD_STAT(STAT_AI_Sense_Sight_PendingTraces, PendingLineOfSightTraces.Num());
+
 #ifdef AISENSE_SIGHT_TIMESLICING_DEBUG
 	UE_LOG(LogAIPerception, VeryVerbose, TEXT("UAISense_Sight::Update processed %d sources in %f seconds [time slice limited? %d]"), NumQueriesProcessed, TimeSpent, bHitTimeSliceLimit ? 1 : 0);
 #else
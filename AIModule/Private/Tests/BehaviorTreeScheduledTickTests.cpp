@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/Composites/BTComposite_Sequence.h"
+#include "BehaviorTreeTestObjects.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBehaviorTreeScheduledTickServiceIntervalTest, "System.AI.BehaviorTree.ScheduledTicks.ServiceInterval", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+namespace BehaviorTreeScheduledTickTests
+{
+	static const float StepTime = 0.1f;
+
+	void TickWorld(UWorld* World, float Time)
+	{
+		while (Time > KINDA_SMALL_NUMBER)
+		{
+			World->Tick(ELevelTick::LEVELTICK_All, FMath::Min(Time, StepTime));
+			Time -= StepTime;
+
+			// required for subticking, tick functions run once per frame
+			GFrameCounter++;
+		}
+	}
+}
+
+// Service interval must not lose the time that passed while component was asleep, or before its tick got rescheduled to run sooner
+bool FBehaviorTreeScheduledTickServiceIntervalTest::RunTest(const FString& Parameters)
+{
+	using namespace BehaviorTreeScheduledTickTests;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->CreateAISystem();
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	const float ServiceInterval = 1.0f;
+
+	UBehaviorTree* TreeAsset = NewObject<UBehaviorTree>(GetTransientPackage());
+	UBTComposite_Sequence* RootNode = NewObject<UBTComposite_Sequence>(TreeAsset);
+	UTestBTService_Log* Service = NewObject<UTestBTService_Log>(TreeAsset);
+	Service->Interval = ServiceInterval;
+	RootNode->Services.Add(Service);
+	RootNode->Children.AddDefaulted_GetRef().ChildTask = NewObject<UTestBTTask_Latent>(TreeAsset);
+	TreeAsset->RootNode = RootNode;
+
+	AAIController* Controller = World->SpawnActor<AAIController>();
+	UBehaviorTreeComponent* BTComp = NewObject<UBehaviorTreeComponent>(Controller);
+	BTComp->RegisterComponent();
+
+	const float StartTime = World->GetTimeSeconds();
+	BTComp->StartTree(*TreeAsset, EBTExecutionMode::SingleRun);
+	TestTrue(TEXT("Tree is running"), BTComp->IsRunning());
+
+	// service is the only node that needs ticking, component sleeps until its interval passes
+	TickWorld(World, ServiceInterval * 0.5f);
+	TestEqual(TEXT("Service ticks before its interval"), Service->TickGameTimes.Num(), 0);
+
+	// messages wake up component in next frame, restarting its tick function
+	FAIMessage::Send(BTComp, FAIMessage(TEXT("Test.WakeUp"), nullptr));
+
+	TickWorld(World, ServiceInterval);
+	if (TestEqual(TEXT("Service ticks within one and a half of its interval"), Service->TickGameTimes.Num(), 1))
+	{
+		const float TickTime = Service->TickGameTimes[0] - StartTime;
+		TestTrue(FString::Printf(TEXT("Service ticks after its interval (%.2fs)"), TickTime), TickTime >= ServiceInterval - KINDA_SMALL_NUMBER);
+		TestTrue(FString::Printf(TEXT("Service ticks no later than one frame after its interval (%.2fs)"), TickTime), TickTime <= ServiceInterval + StepTime + KINDA_SMALL_NUMBER);
+		TestTrue(FString::Printf(TEXT("Service delta time covers its interval (%.2fs)"), Service->TickDeltaTimes[0]), Service->TickDeltaTimes[0] >= ServiceInterval - KINDA_SMALL_NUMBER);
+	}
+
+	BTComp->StopTree();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BehaviorTreeTestObjects.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Engine/World.h"
+
+UTestBTService_Log::UTestBTService_Log(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	RandomDeviation = 0.0f;
+}
+
+void UTestBTService_Log::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	TickGameTimes.Add(OwnerComp.GetWorld()->GetTimeSeconds());
+	TickDeltaTimes.Add(DeltaSeconds);
+}
+
+EBTNodeResult::Type UTestBTTask_Latent::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	return EBTNodeResult::InProgress;
+}
@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BehaviorTreeTestObjects.generated.h"
+
+/** Service recording game time and delta time of every tick */
+UCLASS(MinimalAPI, HideDropdown)
+class UTestBTService_Log : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	UTestBTService_Log(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	TArray<float> TickGameTimes;
+	TArray<float> TickDeltaTimes;
+
+protected:
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};
+
+/** Task that stays in progress without ticking */
+UCLASS(MinimalAPI, HideDropdown)
+class UTestBTTask_Latent : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+};
@@ -1098,6 +1098,7 @@ private:
 		double				TotalCheckpointReplicationTimeSeconds;		// Total time it took to write all replicated objects across all frames
 		bool				bWriteCheckpointOffset;
 		int32				TotalCheckpointSaveFrames;					// Total number of frames used to save a checkpoint
+		double				TotalGuidCacheSaveTimeSeconds;				// Total time it took to resolve and write the net guid cache across all frames
 		FArchivePos			CheckpointOffset;
 		uint32				GuidCacheSize;
 
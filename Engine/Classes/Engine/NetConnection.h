@@ -1272,6 +1272,11 @@ public:
 	 */
 	ENGINE_API uint32 GetOutTotalNotifiedPackets() const { return OutTotalNotifiedPackets; }
 
+	/**
+	 * Get the full PacketId of the last sent packet for which we have received a delivery notification (delivered or not)
+	 */
+	int32 GetLastNotifiedPacketId() const { return LastNotifiedPacketId; }
+
 	/** Sends the NMT_Challenge message */
 	void SendChallengeControlMessage();
 
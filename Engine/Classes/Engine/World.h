@@ -1659,6 +1659,19 @@ public:
 	 */
 	bool LineTraceSingleByChannel(struct FHitResult& OutHit,const FVector& Start,const FVector& End,ECollisionChannel TraceChannel,const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
 
+	/**
+	 *  Trace rays against the world using a specific channel and return the first blocking hit of each
+	 *  Same results as LineTraceSingleByChannel for each ray, but coherent rays are traversed together
+	 *  @param  OutHits         First blocking hit found for each ray, OutHits[Index] for ray from Starts[Index] to Ends[Index]
+	 *  @param  Starts          Start locations of the rays
+	 *  @param  Ends            End locations of the rays, same number as Starts
+	 *  @param  TraceChannel    The 'channel' that these rays are in, used to determine which components to hit
+	 *  @param  Params          Additional parameters used for all traces
+	 * 	@param 	ResponseParam	ResponseContainer to be used for all traces
+	 *  @return number of rays with a blocking hit
+	 */
+	int32 LineTraceSingleBatchByChannel(TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
+
 	/**
 	 *  Trace a ray against the world using object types and return the first blocking hit
 	 *  @param  OutHit          First blocking hit found
@@ -12,6 +12,7 @@
 #include "Physics/PhysicsInterfaceUtils.h"
 #include "Collision/CollisionConversions.h"
 #include "PhysicsEngine/ScopedSQHitchRepeater.h"
+#include "GameFramework/PlayerController.h"
 #include "PhysicsInterfaceDeclaresCore.h"
 
 #if PHYSICS_INTERFACE_PHYSX
@@ -117,6 +118,7 @@ struct FRaycastSQAdditionalInputs
 };
 
 void LowLevelRaycast(FPhysScene& Scene, const FVector& Start, const FVector& Dir, float DeltaMag, FPhysicsHitCallback<FHitRaycast>& HitBuffer, EHitFlags OutputFlags, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams);
+void LowLevelRaycastBatch(FPhysScene& Scene, TArrayView<const FVector> Starts, TArrayView<const FVector> Dirs, TArrayView<const float> DeltaMags, TArrayView<FPhysicsHitCallback<FHitRaycast>* const> HitBuffers, EHitFlags OutputFlags, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams);
 void LowLevelSweep(FPhysScene& Scene, const FPhysicsGeometry& Geom, const FTransform& StartTM, const FVector& Dir, float DeltaMag, FPhysicsHitCallback<FHitSweep>& HitBuffer, EHitFlags OutputFlags, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams);
 void LowLevelOverlap(FPhysScene& Scene, const FPhysicsGeometry& Geom, const FTransform& GeomPose, FPhysicsHitCallback<FHitOverlap>& HitBuffer, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams);
 
@@ -463,6 +465,110 @@ bool FGenericPhysicsInterface::RaycastSingle(const UWorld* World, struct FHitRes
 
 
 
+int32 FGenericPhysicsInterface::RaycastSingleBatch(const UWorld* World, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Collision_SceneQueryTotal);
+	SCOPE_CYCLE_COUNTER(STAT_Collision_RaycastSingle);
+	CSV_SCOPED_TIMING_STAT(SceneQuery, RaycastSingleBatch);
+	FScopeCycleCounter Counter(Params.StatId);
+
+	using TCastTraits = TSQTraits<FHitRaycast, ESweepOrRay::Raycast, ESingleMultiOrTest::Single>;
+	check(Starts.Num() == Ends.Num());
+
+	OutHits.Reset(Starts.Num());
+	for (int32 RayIndex = 0; RayIndex < Starts.Num(); RayIndex++)
+	{
+		FHitResult& OutHit = OutHits.AddDefaulted_GetRef();
+		OutHit.TraceStart = Starts[RayIndex];
+		OutHit.TraceEnd = Ends[RayIndex];
+	}
+
+	if ((World == NULL) || (World->GetPhysicsScene() == NULL))
+	{
+		return 0;
+	}
+
+	// all rays share filtering, single queries ignore touches
+	FCollisionFilterData Filter = CreateQueryFilterData(TraceChannel, Params.bTraceComplex, ResponseParams.CollisionResponse, Params, ObjectParams, false);
+	FCollisionQueryFilterCallback QueryCallback(Params, false);
+	QueryCallback.bIgnoreTouches = true;
+
+	const FQueryFilterData QueryFilterData = MakeQueryFilterData(Filter, TCastTraits::GetQueryFlags(), Params);
+	FQueryDebugParams DebugParams;
+#if !(UE_BUILD_TEST || UE_BUILD_SHIPPING) && WITH_CHAOS
+	DebugParams.bDebugQuery = Params.bDebugQuery;
+#endif
+
+	// zero length rays never hit, same as RaycastSingle
+	TArray<int32> RayIndices;
+	TArray<FVector> QueryStarts;
+	TArray<FVector> QueryDirs;
+	TArray<float> QueryDeltaMags;
+	TArray<TCastTraits::THitBuffer> HitBuffers;
+	TArray<FPhysicsHitCallback<FHitRaycast>*> HitBufferPtrs;
+	RayIndices.Reserve(Starts.Num());
+	QueryStarts.Reserve(Starts.Num());
+	QueryDirs.Reserve(Starts.Num());
+	QueryDeltaMags.Reserve(Starts.Num());
+	HitBuffers.Reserve(Starts.Num());
+	HitBufferPtrs.Reserve(Starts.Num());
+
+	for (int32 RayIndex = 0; RayIndex < Starts.Num(); RayIndex++)
+	{
+		const FVector Delta = Ends[RayIndex] - Starts[RayIndex];
+		const float DeltaSize = Delta.Size();
+		if (!FMath::IsNearlyZero(DeltaSize))
+		{
+			RayIndices.Add(RayIndex);
+			QueryStarts.Add(Starts[RayIndex]);
+			QueryDirs.Add(Delta / DeltaSize);
+			QueryDeltaMags.Add(DeltaSize);
+			HitBufferPtrs.Add(&HitBuffers.AddDefaulted_GetRef());
+		}
+	}
+
+	FPhysScene& PhysScene = *World->GetPhysicsScene();
+	{
+		FScopeHelper ChaosLockedScope;
+		FScopedSceneReadLock SceneLocks(PhysScene);
+		LowLevelRaycastBatch(PhysScene, QueryStarts, QueryDirs, QueryDeltaMags, HitBufferPtrs, TCastTraits::GetHitFlags(), TCastTraits::GetQueryFlags(), Filter, QueryFilterData, &QueryCallback, DebugParams);
+	}
+
+	int32 NumBlockingHits = 0;
+	for (int32 QueryIndex = 0; QueryIndex < RayIndices.Num(); QueryIndex++)
+	{
+		TCastTraits::THitBuffer& HitBuffer = HitBuffers[QueryIndex];
+		if (!GetHasBlock(HitBuffer))
+		{
+			continue;
+		}
+
+		const int32 RayIndex = RayIndices[QueryIndex];
+		bool bBlockingHit = true;
+		const float MinBlockingDistance = GetDistance(*GetBlock(HitBuffer));
+		const bool bSuccess = ConvertTraceResults(bBlockingHit, World, 1, GetBlock(HitBuffer), QueryDeltaMags[QueryIndex], Filter, OutHits[RayIndex], Starts[RayIndex], Ends[RayIndex], *FRaycastSQAdditionalInputs().GetGeometry(), FTransform(Starts[RayIndex]), MinBlockingDistance, Params.bReturnFaceIndex, Params.bReturnPhysicalMaterial) == EConvertQueryResult::Valid;
+
+		if (!bSuccess)
+		{
+			UE_LOG(LogCollision, Error, TEXT("RaycastSingleBatch resulted in a NaN/INF in PHit!"));
+		}
+
+		NumBlockingHits += bBlockingHit ? 1 : 0;
+	}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (World->DebugDrawSceneQueries(Params.TraceTag))
+	{
+		for (int32 RayIndex = 0; RayIndex < Starts.Num(); RayIndex++)
+		{
+			TCastTraits::DrawTraces(World, Starts[RayIndex], Ends[RayIndex], nullptr, nullptr, OutHits[RayIndex]);
+		}
+	}
+#endif //!(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+	return NumBlockingHits;
+}
+
 bool FGenericPhysicsInterface::RaycastMulti(const UWorld* World, TArray<struct FHitResult>& OutHits, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Collision_SceneQueryTotal);
@@ -662,4 +768,79 @@ bool FGenericPhysicsInterface::GeomOverlapMulti(const UWorld* World, const FColl
 	FTransform GeomTransform(InRotation, InPosition);
 	FPhysicsShapeAdapter Adaptor(GeomTransform.GetRotation(), InGeom);
 	return GeomOverlapMultiImp<EQueryInfo::GatherAll>(World, Adaptor.GetGeometry(), InGeom, Adaptor.GetGeomPose(GeomTransform.GetTranslation()), OutOverlaps, TraceChannel, Params, ResponseParams, ObjectParams);
-}
\ No newline at end of file
+}
+//////////////////////////////////////////////////////////////////////////
+// BATCH BENCHMARK
+
+#if !UE_BUILD_SHIPPING
+// Args: [NumRays] [Length]
+static void BatchRaycastBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumRays = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4096;
+	const float Length = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10000.f;
+
+	// rays fan out of the first player's view point, as most gameplay traces would
+	FVector Origin = FVector::ZeroVector;
+	FRotator ViewRotation = FRotator::ZeroRotator;
+	if (APlayerController* PlayerController = World->GetFirstPlayerController())
+	{
+		PlayerController->GetPlayerViewPoint(Origin, ViewRotation);
+	}
+
+	FRandomStream RandomStream(NumRays);
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	Starts.Reserve(NumRays);
+	Ends.Reserve(NumRays);
+	for (int32 RayIndex = 0; RayIndex < NumRays; RayIndex++)
+	{
+		const FVector Start = Origin + RandomStream.GetUnitVector() * RandomStream.FRandRange(0.f, 100.f);
+		const FVector Dir = FMath::VRandCone(ViewRotation.Vector(), PI * 0.25f);
+		Starts.Add(Start);
+		Ends.Add(Start + Dir * Length);
+	}
+
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(BatchRaycastBenchmark));
+
+	TArray<FHitResult> SingleHits;
+	SingleHits.SetNum(NumRays);
+	const double SingleStartTime = FPlatformTime::Seconds();
+	for (int32 RayIndex = 0; RayIndex < NumRays; RayIndex++)
+	{
+		World->LineTraceSingleByChannel(SingleHits[RayIndex], Starts[RayIndex], Ends[RayIndex], ECC_Visibility, Params);
+	}
+	const double SingleTime = FPlatformTime::Seconds() - SingleStartTime;
+
+	TArray<FHitResult> BatchHits;
+	const double BatchStartTime = FPlatformTime::Seconds();
+	const int32 NumBatchBlockingHits = World->LineTraceSingleBatchByChannel(BatchHits, Starts, Ends, ECC_Visibility, Params);
+	const double BatchTime = FPlatformTime::Seconds() - BatchStartTime;
+
+	int32 NumMismatches = 0;
+	for (int32 RayIndex = 0; RayIndex < NumRays; RayIndex++)
+	{
+		const FHitResult& SingleHit = SingleHits[RayIndex];
+		const FHitResult& BatchHit = BatchHits[RayIndex];
+		if (SingleHit.bBlockingHit != BatchHit.bBlockingHit || SingleHit.Component != BatchHit.Component || !FMath::IsNearlyEqual(SingleHit.Distance, BatchHit.Distance, KINDA_SMALL_NUMBER))
+		{
+			NumMismatches++;
+		}
+	}
+
+	UE_LOG(LogCollision, Log, TEXT("BatchRaycastBenchmark: %d rays of length %.0f, %d blocking hits"), NumRays, Length, NumBatchBlockingHits);
+	UE_LOG(LogCollision, Log, TEXT("  Single: %.3f ms, %.0f rays/s"), SingleTime * 1000.0, SingleTime > 0.0 ? NumRays / SingleTime : 0.0);
+	UE_LOG(LogCollision, Log, TEXT("  Batch:  %.3f ms, %.0f rays/s"), BatchTime * 1000.0, BatchTime > 0.0 ? NumRays / BatchTime : 0.0);
+	UE_LOG(LogCollision, Log, TEXT("  Mismatches: %d"), NumMismatches);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BatchRaycastBenchmarkCommand(
+	TEXT("p.Chaos.SQ.BatchRaycastBenchmark"),
+	TEXT("Times random rays from the player view point traced one at a time and as a batch, and compares their results. Args: [NumRays] [Length]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BatchRaycastBenchmark)
+);
+#endif // !UE_BUILD_SHIPPING
@@ -23,6 +23,9 @@
 int32 ForceStandardSQ = 0;
 FAutoConsoleVariableRef CVarForceStandardSQ(TEXT("p.ForceStandardSQ"), ForceStandardSQ, TEXT("If enabled, we force the standard scene query even if custom SQ structure is enabled"));
 
+int32 ChaosSQBatchQueries = 1;
+FAutoConsoleVariableRef CVarChaosSQBatchQueries(TEXT("p.Chaos.SQ.BatchQueries"), ChaosSQBatchQueries, TEXT("If enabled, batched scene queries traverse coherent queries together in packets, otherwise they run one at a time"));
+
 
 #if !UE_BUILD_SHIPPING
 int32 SerializeSQs = 0;
@@ -219,6 +222,41 @@ void LowLevelRaycast(FPhysScene& Scene, const FVector& Start, const FVector& Dir
 #endif
 }
 
+void LowLevelRaycastBatch(FPhysScene& Scene, TArrayView<const FVector> Starts, TArrayView<const FVector> Dirs, TArrayView<const float> DeltaMags, TArrayView<FPhysicsHitCallback<FHitRaycast>* const> HitBuffers, EHitFlags OutputFlags, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams)
+{
+	check(Starts.Num() == Dirs.Num() && Starts.Num() == DeltaMags.Num() && Starts.Num() == HitBuffers.Num());
+
+#if !defined(PHYSICS_INTERFACE_PHYSX) || !PHYSICS_INTERFACE_PHYSX
+	// sq captures are made per query, so capturing falls back to single queries
+#if !UE_BUILD_SHIPPING
+	const bool bCaptureSQs = !!SerializeSQs && !!EnableRaycastSQCapture;
+#else
+	const bool bCaptureSQs = false;
+#endif
+	if (!!ChaosSQBatchQueries && !bCaptureSQs)
+	{
+		if (const auto& SolverAccelerationStructure = Scene.GetScene().GetSpacialAcceleration())
+		{
+			TArray<FChaosSQBatchRaycast> Raycasts;
+			Raycasts.Reserve(Starts.Num());
+			for (int32 QueryIndex = 0; QueryIndex < Starts.Num(); QueryIndex++)
+			{
+				Raycasts.Add({ Starts[QueryIndex], Dirs[QueryIndex], DeltaMags[QueryIndex], HitBuffers[QueryIndex] });
+			}
+
+			FChaosSQAccelerator SQAccelerator(*SolverAccelerationStructure);
+			SQAccelerator.RaycastBatch(Raycasts, OutputFlags, QueryFilterData, *QueryCallback, DebugParams);
+		}
+		return;
+	}
+#endif
+
+	for (int32 QueryIndex = 0; QueryIndex < Starts.Num(); QueryIndex++)
+	{
+		LowLevelRaycast(Scene, Starts[QueryIndex], Dirs[QueryIndex], DeltaMags[QueryIndex], *HitBuffers[QueryIndex], OutputFlags, QueryFlags, Filter, QueryFilterData, QueryCallback, DebugParams);
+	}
+}
+
 void LowLevelSweep(FPhysScene& Scene, const FPhysicsGeometry& QueryGeom, const FTransform& StartTM, const FVector& Dir, float DeltaMag, FPhysicsHitCallback<FHitSweep>& HitBuffer, EHitFlags OutputFlags, FQueryFlags QueryFlags, const FCollisionFilterData& Filter, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase* QueryCallback, const FQueryDebugParams& DebugParams)
 {
 #if !defined(PHYSICS_INTERFACE_PHYSX) || !PHYSICS_INTERFACE_PHYSX
@@ -20,6 +20,7 @@
 #include "Net/NetworkGranularMemoryLogging.h"
 #include "Misc/ScopeExit.h"
 #include "Net/Core/Trace/NetTrace.h"
+#include "Net/Core/Trace/NetPropertyTrace.h"
 
 DECLARE_CYCLE_STAT(TEXT("Custom Delta Property Rep Time"), STAT_NetReplicateCustomDeltaPropTime, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("ReceiveRPC"), STAT_NetReceiveRPC, STATGROUP_Game);
@@ -1163,8 +1164,25 @@ bool FObjectReplicator::ReceivedRPC(FNetBitReader& Reader, const FReplicationFla
 		// Use the replication layout to receive the rpc parameter values
 		TSharedPtr<FRepLayout> FuncRepLayout = Connection->Driver->GetFunctionRepLayout(Function);
 
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		const uint64 ReceiveStartCycles = FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+		uint64 ProcessCycles = 0;
+#endif
+
 		FuncRepLayout->ReceivePropertiesForRPC(Object, Function, OwningChannel, Reader, Parms, UnmappedGuids);
 
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		const uint64 ReceiveCycles = ReceiveStartCycles != 0 ? FPlatformTime::Cycles64() - ReceiveStartCycles : 0;
+
+		ON_SCOPE_EXIT
+		{
+			if (ReceiveStartCycles != 0)
+			{
+				FNetPropertyTrace::TraceReceivedRPC(Function->GetOwnerClass()->GetFName(), FunctionName, Reader.GetNumBits(), ReceiveCycles, ProcessCycles);
+			}
+		};
+#endif
+
 		if (Reader.IsError())
 		{
 			UE_LOG(LogRep, Error, TEXT("ReceivedRPC: ReceivePropertiesForRPC - Reader.IsError() == true: Function: %s, Object: %s"), *FunctionName.ToString(), *Object->GetFullName());
@@ -1209,6 +1227,9 @@ bool FObjectReplicator::ReceivedRPC(FNetBitReader& Reader, const FReplicationFla
 			RPC_ResetLastFailedReason();
 
 			// Call the function.
+#if UE_NET_PROPERTY_TRACE_ENABLED
+			FNetPropertyTraceScopedCycles ScopedProcessCycles(ProcessCycles);
+#endif
 			Object->ProcessEvent(Function, Parms);
 		}
 
@@ -1494,8 +1515,29 @@ void FObjectReplicator::ReplicateCustomDeltaProperties( FNetBitWriter & Bunch, F
 		//-----------------------------------------
 		//	Do delta serialization on dynamic properties
 		//-----------------------------------------
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		const uint64 DeltaStartCycles = FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+#endif
+
 		const bool WroteSomething = SendCustomDeltaProperty(Object, CustomDeltaProperty, TempBitWriter, NewState, OldState);
 
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		if (DeltaStartCycles != 0)
+		{
+			// Delta serialization compares and writes in a single pass, so the cost is only attributed to serialization when something was sent
+			const uint64 DeltaCycles = FPlatformTime::Cycles64() - DeltaStartCycles;
+
+			if (WroteSomething)
+			{
+				FNetPropertyTrace::TraceSerialize(Object->GetClass()->GetFName(), Property->GetFName(), TempBitWriter.GetNumBits(), DeltaCycles);
+			}
+			else
+			{
+				FNetPropertyTrace::TraceCompare(Object->GetClass()->GetFName(), Property->GetFName(), DeltaCycles);
+			}
+		}
+#endif
+
 		if ( !WroteSomething )
 		{
 			continue;
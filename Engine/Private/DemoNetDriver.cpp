@@ -2109,6 +2109,7 @@ void UDemoNetDriver::SaveCheckpoint()
 	CheckpointSaveContext.TotalCheckpointSaveTimeSeconds = 0;
 	CheckpointSaveContext.TotalCheckpointReplicationTimeSeconds = 0;
 	CheckpointSaveContext.TotalCheckpointSaveFrames = 0;
+	CheckpointSaveContext.TotalGuidCacheSaveTimeSeconds = 0;
 
 	LastCheckpointTime = DemoCurrentTime;
 
@@ -2315,9 +2316,14 @@ void UDemoNetDriver::TickCheckpoint()
 				case ECheckpointSaveState_SerializeGuidCache:
 				{
 					SCOPED_NAMED_EVENT(UDemoNetDriver_SerializeGuidCache, FColor::Green);
+					CSV_SCOPED_TIMING_STAT(Basic, DemoSerializeGuidCacheTime);
+
+					const double GuidCacheStartTime = FPlatformTime::Seconds();
 
 					// Save the current guid cache
 					bExecuteNextState = SerializeGuidCache(Params, CheckpointArchive);
+
+					CheckpointSaveContext.TotalGuidCacheSaveTimeSeconds += (FPlatformTime::Seconds() - GuidCacheStartTime);
 					if (bExecuteNextState)
 					{
 						CheckpointSaveContext.CheckpointSaveState = ECheckpointSaveState_SerializeNetFieldExportGroupMap;
@@ -2412,8 +2418,12 @@ void UDemoNetDriver::TickCheckpoint()
 
 		const float TotalCheckpointTimeInMS = CheckpointSaveContext.TotalCheckpointReplicationTimeSeconds * 1000.0f;
 		const float TotalCheckpointTimeWithOverheadInMS = CheckpointSaveContext.TotalCheckpointSaveTimeSeconds * 1000.0f;
+		const float TotalGuidCacheTimeInMS = CheckpointSaveContext.TotalGuidCacheSaveTimeSeconds * 1000.0f;
+
+		UE_LOG(LogDemo, Log, TEXT("Finished checkpoint. Actors: %i, GuidCacheSize: %i, TotalSize: %i, TotalCheckpointSaveFrames: %i, TotalCheckpointTimeInMS: %2.2f, TotalCheckpointTimeWithOverheadInMS: %2.2f, TotalGuidCacheTimeInMS: %2.2f"), GetNetworkObjectList().GetActiveObjects().Num(), CheckpointSaveContext.GuidCacheSize, TotalCheckpointSize, CheckpointSaveContext.TotalCheckpointSaveFrames, TotalCheckpointTimeInMS, TotalCheckpointTimeWithOverheadInMS, TotalGuidCacheTimeInMS);
 
-		UE_LOG(LogDemo, Log, TEXT("Finished checkpoint. Actors: %i, GuidCacheSize: %i, TotalSize: %i, TotalCheckpointSaveFrames: %i, TotalCheckpointTimeInMS: %2.2f, TotalCheckpointTimeWithOverheadInMS: %2.2f"), GetNetworkObjectList().GetActiveObjects().Num(), CheckpointSaveContext.GuidCacheSize, TotalCheckpointSize, CheckpointSaveContext.TotalCheckpointSaveFrames, TotalCheckpointTimeInMS, TotalCheckpointTimeWithOverheadInMS);
+		CSV_CUSTOM_STAT(Basic, DemoCheckpointSaveTimeMS, TotalCheckpointTimeWithOverheadInMS, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Basic, DemoCheckpointGuidCacheTimeMS, TotalGuidCacheTimeInMS, ECsvCustomStatOp::Set);
 
 		// we are done, out
 		CheckpointSaveContext.CheckpointSaveState = ECheckpointSaveState_Idle;
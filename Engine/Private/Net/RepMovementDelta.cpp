@@ -0,0 +1,976 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/RepMovementDelta.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "EngineLogs.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+
+static int32 GRepMovementDeltaEnable = 1;
+static FAutoConsoleVariableRef CVarRepMovementDeltaEnable(
+	TEXT("net.RepMovementDelta.Enable"),
+	GRepMovementDeltaEnable,
+	TEXT("If disabled, FRepMovementDelta always sends absolute states, instead of delta encoding against the last acknowledged state."));
+
+
+/**
+ * FRepMovementDeltaBaseState
+ */
+
+/** Per connection send bookkeeping, shared by every base state in a chain so that it is unaffected by NAK rollback */
+struct FRepMovementDeltaSendContext
+{
+	/** The identifier given to the next state written. Never rolled back, so identifiers are never reused within the history window. */
+	uint8 NextStateId = 0;
+};
+
+class FRepMovementDeltaBaseState : public INetDeltaBaseState
+{
+public:
+	struct FSentState
+	{
+		FQuantizedRepMovement State;
+
+		/** OutPacketId at the time the state was written */
+		int32 FirstPacketId = INDEX_NONE;
+
+		/** The last packet the state could have been sent in, or INDEX_NONE if packets have not been flushed since it was written */
+		int32 LastPacketId = INDEX_NONE;
+
+		uint8 StateId = 0;
+	};
+
+	virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+	{
+		FRepMovementDeltaBaseState* Other = static_cast<FRepMovementDeltaBaseState*>(OtherState);
+
+		if (History.Num() != Other->History.Num())
+		{
+			return false;
+		}
+
+		return History.Num() == 0 || (History.Last().StateId == Other->History.Last().StateId && History.Last().State == Other->History.Last().State);
+	}
+
+	virtual void CountBytes(FArchive& Ar) const override
+	{
+		Ar.CountBytes(sizeof(*this), sizeof(*this));
+		History.CountBytes(Ar);
+	}
+
+	TSharedPtr<FRepMovementDeltaSendContext> SendContext;
+
+	/** States sent and not rolled back by a NAK, oldest first */
+	TArray<FSentState, TInlineAllocator<8>> History;
+};
+
+
+/**
+ * Quantization
+ */
+
+namespace RepMovementDeltaPrivate
+{
+	/** Quantized values are clamped so that residuals between any two values fit in an int32 */
+	static constexpr int32 MaxQuantizedValue = (1 << 30) - 1;
+
+	/** Range of the three smallest components of a normalized quaternion */
+	static constexpr float SmallestThreeRange = 0.707106781f;
+
+	static int32 GetVectorScale(EVectorQuantization QuantizationLevel)
+	{
+		switch (QuantizationLevel)
+		{
+			case EVectorQuantization::RoundTwoDecimals:
+			{
+				return 100;
+			}
+
+			case EVectorQuantization::RoundOneDecimal:
+			{
+				return 10;
+			}
+
+			default:
+			{
+				return 1;
+			}
+		}
+	}
+
+	static int32 GetRotationScale(ERotatorQuantization QuantizationLevel)
+	{
+		const int32 RotationBits = (QuantizationLevel == ERotatorQuantization::ShortComponents) ? 15 : 9;
+
+		return (1 << (RotationBits - 1)) - 1;
+	}
+
+	static int32 QuantizeValue(float Value, int32 Scale)
+	{
+		const float Scaled = FMath::Clamp(Value * (float)Scale, (float)-MaxQuantizedValue, (float)MaxQuantizedValue);
+
+		return FMath::RoundToInt(Scaled);
+	}
+
+	static FIntVector QuantizeVector(const FVector& Value, int32 Scale)
+	{
+		if (Value.ContainsNaN())
+		{
+			logOrEnsureNanError(TEXT("FQuantizedRepMovement: Value contains NaN, clearing for safety."));
+			return FIntVector::ZeroValue;
+		}
+
+		return FIntVector(QuantizeValue(Value.X, Scale), QuantizeValue(Value.Y, Scale), QuantizeValue(Value.Z, Scale));
+	}
+
+	static FVector DequantizeVector(const FIntVector& Value, int32 Scale)
+	{
+		const float InvScale = 1.f / (float)Scale;
+
+		return FVector((float)Value.X * InvScale, (float)Value.Y * InvScale, (float)Value.Z * InvScale);
+	}
+
+	static uint32 ZigZagEncode(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	static int32 ZigZagDecode(uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+
+	/**
+	 * Writes three integers using a shared, variable bit width:
+	 * a 3 bit mask of non-zero components, then (if any are non-zero) a 5 bit width, then each non-zero zigzag encoded component.
+	 */
+	static void WriteVarWidthVector(FArchive& Ar, const FIntVector& Value)
+	{
+		uint32 Encoded[3] = { ZigZagEncode(Value.X), ZigZagEncode(Value.Y), ZigZagEncode(Value.Z) };
+		uint8 NonZeroMask = 0;
+		uint32 Combined = 0;
+
+		for (int32 Idx = 0; Idx < 3; ++Idx)
+		{
+			if (Encoded[Idx] != 0)
+			{
+				NonZeroMask |= (1 << Idx);
+				Combined |= Encoded[Idx];
+			}
+		}
+
+		Ar.SerializeBits(&NonZeroMask, 3);
+
+		if (NonZeroMask != 0)
+		{
+			const uint32 Width = FMath::FloorLog2(Combined) + 1;
+			uint32 WidthMinusOne = Width - 1;
+
+			Ar.SerializeBits(&WidthMinusOne, 5);
+
+			for (int32 Idx = 0; Idx < 3; ++Idx)
+			{
+				if (NonZeroMask & (1 << Idx))
+				{
+					Ar.SerializeBits(&Encoded[Idx], Width);
+				}
+			}
+		}
+	}
+
+	static FIntVector ReadVarWidthVector(FArchive& Ar)
+	{
+		uint32 Encoded[3] = { 0, 0, 0 };
+		uint8 NonZeroMask = 0;
+
+		Ar.SerializeBits(&NonZeroMask, 3);
+
+		if ((NonZeroMask & 0x7) != 0)
+		{
+			uint32 WidthMinusOne = 0;
+
+			Ar.SerializeBits(&WidthMinusOne, 5);
+
+			const uint32 Width = (WidthMinusOne & 0x1F) + 1;
+			const uint32 Mask = (Width == 32) ? 0xFFFFFFFF : ((1U << Width) - 1);
+
+			for (int32 Idx = 0; Idx < 3; ++Idx)
+			{
+				if (NonZeroMask & (1 << Idx))
+				{
+					Ar.SerializeBits(&Encoded[Idx], Width);
+					Encoded[Idx] &= Mask;
+				}
+			}
+		}
+
+		return FIntVector(ZigZagDecode(Encoded[0]), ZigZagDecode(Encoded[1]), ZigZagDecode(Encoded[2]));
+	}
+}
+
+
+/**
+ * FQuantizedRepMovement
+ */
+
+void FQuantizedRepMovement::Quantize(const FRepMovement& Movement)
+{
+	using namespace RepMovementDeltaPrivate;
+
+	const int32 LocationScale = GetVectorScale(Movement.LocationQuantizationLevel);
+	const int32 VelocityScale = GetVectorScale(Movement.VelocityQuantizationLevel);
+	const int32 RotationScale = GetRotationScale(Movement.RotationQuantizationLevel);
+
+	Location = QuantizeVector(Movement.Location, LocationScale);
+	LinearVelocity = QuantizeVector(Movement.LinearVelocity, VelocityScale);
+	AngularVelocity = Movement.bRepPhysics ? QuantizeVector(Movement.AngularVelocity, VelocityScale) : FIntVector::ZeroValue;
+	bSimulatedPhysicSleep = Movement.bSimulatedPhysicSleep;
+	bRepPhysics = Movement.bRepPhysics;
+
+	FQuat Quat = Movement.Rotation.Quaternion();
+	Quat.Normalize();
+
+	float Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+	int32 LargestIdx = 0;
+
+	for (int32 Idx = 1; Idx < 4; ++Idx)
+	{
+		if (FMath::Abs(Components[Idx]) > FMath::Abs(Components[LargestIdx]))
+		{
+			LargestIdx = Idx;
+		}
+	}
+
+	// Q and -Q represent the same rotation, so flip to keep the reconstructed (largest) component positive
+	const float Sign = (Components[LargestIdx] < 0.f) ? -1.f : 1.f;
+	int32 SmallIdx = 0;
+
+	for (int32 Idx = 0; Idx < 4; ++Idx)
+	{
+		if (Idx != LargestIdx)
+		{
+			const float Normalized = FMath::Clamp((Components[Idx] * Sign) / SmallestThreeRange, -1.f, 1.f);
+
+			Rotation[SmallIdx++] = FMath::RoundToInt(Normalized * (float)RotationScale);
+		}
+	}
+
+	RotationLargestIndex = (uint8)LargestIdx;
+}
+
+void FQuantizedRepMovement::Dequantize(FRepMovement& OutMovement) const
+{
+	using namespace RepMovementDeltaPrivate;
+
+	const int32 LocationScale = GetVectorScale(OutMovement.LocationQuantizationLevel);
+	const int32 VelocityScale = GetVectorScale(OutMovement.VelocityQuantizationLevel);
+	const float InvRotationScale = 1.f / (float)GetRotationScale(OutMovement.RotationQuantizationLevel);
+
+	OutMovement.Location = DequantizeVector(Location, LocationScale);
+	OutMovement.LinearVelocity = DequantizeVector(LinearVelocity, VelocityScale);
+	OutMovement.AngularVelocity = bRepPhysics ? DequantizeVector(AngularVelocity, VelocityScale) : FVector::ZeroVector;
+	OutMovement.bSimulatedPhysicSleep = bSimulatedPhysicSleep;
+	OutMovement.bRepPhysics = bRepPhysics;
+
+	float Components[4];
+	float SumSquares = 0.f;
+	int32 SmallIdx = 0;
+
+	for (int32 Idx = 0; Idx < 4; ++Idx)
+	{
+		if (Idx != RotationLargestIndex)
+		{
+			const float Value = (float)Rotation[SmallIdx++] * InvRotationScale * SmallestThreeRange;
+
+			Components[Idx] = Value;
+			SumSquares += Value * Value;
+		}
+	}
+
+	Components[RotationLargestIndex & 0x3] = FMath::Sqrt(FMath::Max(0.f, 1.f - SumSquares));
+
+	FQuat Quat(Components[0], Components[1], Components[2], Components[3]);
+	Quat.Normalize();
+
+	OutMovement.Rotation = Quat.Rotator();
+}
+
+bool FQuantizedRepMovement::operator==(const FQuantizedRepMovement& Other) const
+{
+	return Location == Other.Location &&
+			LinearVelocity == Other.LinearVelocity &&
+			AngularVelocity == Other.AngularVelocity &&
+			Rotation == Other.Rotation &&
+			RotationLargestIndex == Other.RotationLargestIndex &&
+			bSimulatedPhysicSleep == Other.bSimulatedPhysicSleep &&
+			bRepPhysics == Other.bRepPhysics;
+}
+
+
+/**
+ * RepMovementDelta
+ */
+
+void RepMovementDelta::WriteState(FArchive& Ar, uint8 StateId, const FQuantizedRepMovement& State, uint8 BaseId, const FQuantizedRepMovement* Base,
+									ERotatorQuantization RotationQuantizationLevel)
+{
+	using namespace RepMovementDeltaPrivate;
+
+	check(Ar.IsSaving());
+
+	uint8 bHasBase = (Base != nullptr) ? 1 : 0;
+	uint8 Flags = (State.bSimulatedPhysicSleep << 0) | (State.bRepPhysics << 1);
+
+	Ar.SerializeBits(&StateId, StateIdBits);
+	Ar.SerializeBits(&bHasBase, 1);
+
+	if (bHasBase)
+	{
+		uint8 BaseOffset = StateId - BaseId;
+
+		check(BaseOffset > 0 && BaseOffset < HistorySize);
+
+		Ar.SerializeBits(&BaseOffset, BaseOffsetBits);
+	}
+
+	Ar.SerializeBits(&Flags, 2);
+
+	WriteVarWidthVector(Ar, bHasBase ? State.Location - Base->Location : State.Location);
+
+	uint8 bRotationDelta = (bHasBase && Base->RotationLargestIndex == State.RotationLargestIndex) ? 1 : 0;
+
+	Ar.SerializeBits(&bRotationDelta, 1);
+
+	if (bRotationDelta)
+	{
+		WriteVarWidthVector(Ar, State.Rotation - Base->Rotation);
+	}
+	else
+	{
+		uint8 LargestIndex = State.RotationLargestIndex;
+		const int32 RotationBits = FMath::FloorLog2(GetRotationScale(RotationQuantizationLevel)) + 2;
+
+		Ar.SerializeBits(&LargestIndex, 2);
+
+		for (int32 Idx = 0; Idx < 3; ++Idx)
+		{
+			uint32 Encoded = ZigZagEncode(State.Rotation[Idx]);
+
+			Ar.SerializeBits(&Encoded, RotationBits);
+		}
+	}
+
+	WriteVarWidthVector(Ar, bHasBase ? State.LinearVelocity - Base->LinearVelocity : State.LinearVelocity);
+
+	if (State.bRepPhysics)
+	{
+		WriteVarWidthVector(Ar, bHasBase ? State.AngularVelocity - Base->AngularVelocity : State.AngularVelocity);
+	}
+}
+
+bool RepMovementDelta::ReadState(FArchive& Ar, uint8& OutStateId, FQuantizedRepMovement& OutState,
+									TFunctionRef<const FQuantizedRepMovement*(uint8 BaseId)> FindBase, ERotatorQuantization RotationQuantizationLevel)
+{
+	using namespace RepMovementDeltaPrivate;
+
+	check(Ar.IsLoading());
+
+	// The stream is always read in full even if the base is unknown, so that the reader stays in a valid position
+	static const FQuantizedRepMovement ZeroState;
+	const FQuantizedRepMovement* Base = &ZeroState;
+	bool bFoundBase = true;
+	uint8 StateId = 0;
+	uint8 bHasBase = 0;
+	uint8 Flags = 0;
+
+	Ar.SerializeBits(&StateId, StateIdBits);
+	Ar.SerializeBits(&bHasBase, 1);
+
+	if (bHasBase & 1)
+	{
+		uint8 BaseOffset = 0;
+
+		Ar.SerializeBits(&BaseOffset, BaseOffsetBits);
+
+		BaseOffset &= (1 << BaseOffsetBits) - 1;
+
+		const FQuantizedRepMovement* FoundBase = (BaseOffset != 0) ? FindBase((uint8)(StateId - BaseOffset)) : nullptr;
+
+		if (FoundBase != nullptr)
+		{
+			Base = FoundBase;
+		}
+		else
+		{
+			bFoundBase = false;
+		}
+	}
+
+	Ar.SerializeBits(&Flags, 2);
+
+	OutState.bSimulatedPhysicSleep = (Flags & (1 << 0)) ? 1 : 0;
+	OutState.bRepPhysics = (Flags & (1 << 1)) ? 1 : 0;
+	OutState.Location = Base->Location + ReadVarWidthVector(Ar);
+
+	uint8 bRotationDelta = 0;
+
+	Ar.SerializeBits(&bRotationDelta, 1);
+
+	if (bRotationDelta & 1)
+	{
+		OutState.RotationLargestIndex = Base->RotationLargestIndex;
+		OutState.Rotation = Base->Rotation + ReadVarWidthVector(Ar);
+	}
+	else
+	{
+		uint8 LargestIndex = 0;
+		const int32 RotationBits = FMath::FloorLog2(GetRotationScale(RotationQuantizationLevel)) + 2;
+		const uint32 Mask = (1U << RotationBits) - 1;
+
+		Ar.SerializeBits(&LargestIndex, 2);
+
+		OutState.RotationLargestIndex = LargestIndex & 0x3;
+
+		for (int32 Idx = 0; Idx < 3; ++Idx)
+		{
+			uint32 Encoded = 0;
+
+			Ar.SerializeBits(&Encoded, RotationBits);
+
+			OutState.Rotation[Idx] = ZigZagDecode(Encoded & Mask);
+		}
+	}
+
+	OutState.LinearVelocity = Base->LinearVelocity + ReadVarWidthVector(Ar);
+	OutState.AngularVelocity = OutState.bRepPhysics ? Base->AngularVelocity + ReadVarWidthVector(Ar) : FIntVector::ZeroValue;
+
+	OutStateId = StateId;
+
+	return bFoundBase && !Ar.IsError();
+}
+
+
+/**
+ * FRepMovementDelta
+ */
+
+bool FRepMovementDelta::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	using namespace RepMovementDelta;
+	typedef FRepMovementDeltaBaseState::FSentState FSentState;
+
+	if (DeltaParms.Writer != nullptr)
+	{
+		FBitWriter& Writer = *DeltaParms.Writer;
+		FRepMovementDeltaBaseState* OldState = static_cast<FRepMovementDeltaBaseState*>(DeltaParms.OldState);
+		UNetConnection* Connection = DeltaParms.Connection;
+		FQuantizedRepMovement Current;
+
+		Current.Quantize(Movement);
+
+		TSharedPtr<FRepMovementDeltaBaseState> NewState = MakeShared<FRepMovementDeltaBaseState>();
+
+		if (OldState == nullptr)
+		{
+			// Initial state creation (see FObjectReplicator::InitRecentProperties) - this is never sent,
+			// so start with an empty history, which forces an absolute state on the first real send.
+			NewState->SendContext = MakeShared<FRepMovementDeltaSendContext>();
+			*DeltaParms.NewState = NewState;
+
+			WriteState(Writer, 0, Current, 0, nullptr, Movement.RotationQuantizationLevel);
+
+			return true;
+		}
+
+		if (OldState->History.Num() > 0 && OldState->History.Last().State == Current)
+		{
+			return false;
+		}
+
+		NewState->SendContext = OldState->SendContext.IsValid() ? OldState->SendContext : MakeShared<FRepMovementDeltaSendContext>();
+		NewState->History = OldState->History;
+
+		TArray<FSentState, TInlineAllocator<8>>& History = NewState->History;
+		const uint8 StateId = NewState->SendContext->NextStateId++;
+
+		// States outside the receivers history window can't be referenced anymore
+		while (History.Num() > 0 && (uint8)(StateId - History[0].StateId) >= HistorySize)
+		{
+			History.RemoveAt(0, 1, false);
+		}
+
+		int32 BaseIdx = INDEX_NONE;
+		const bool bAllowDelta = GRepMovementDeltaEnable != 0 && Connection != nullptr && !DeltaParms.bInternalAck;
+
+		if (bAllowDelta)
+		{
+			for (FSentState& Sent : History)
+			{
+				// Packets are flushed at the end of every frame, so any packet sent after the state was written bounds where it went
+				if (Sent.LastPacketId == INDEX_NONE && Connection->OutPacketId > Sent.FirstPacketId)
+				{
+					Sent.LastPacketId = Connection->OutPacketId - 1;
+				}
+			}
+
+			// A state that is still in the history once all of its packets are notified was delivered - a NAK would have rolled it back
+			for (int32 Idx = History.Num() - 1; Idx >= 0; --Idx)
+			{
+				if (History[Idx].LastPacketId != INDEX_NONE && Connection->GetLastNotifiedPacketId() >= History[Idx].LastPacketId)
+				{
+					BaseIdx = Idx;
+					break;
+				}
+			}
+
+			// Acknowledged states older than the newest acknowledged state will never be used as a base again
+			if (BaseIdx > 0)
+			{
+				History.RemoveAt(0, BaseIdx, false);
+				BaseIdx = 0;
+			}
+		}
+
+		const FSentState* Base = (BaseIdx != INDEX_NONE) ? &History[BaseIdx] : nullptr;
+
+		WriteState(Writer, StateId, Current, Base != nullptr ? Base->StateId : 0, Base != nullptr ? &Base->State : nullptr,
+					Movement.RotationQuantizationLevel);
+
+		FSentState& NewSent = History.AddDefaulted_GetRef();
+
+		NewSent.State = Current;
+		NewSent.StateId = StateId;
+		NewSent.FirstPacketId = (Connection != nullptr) ? Connection->OutPacketId : INDEX_NONE;
+
+		*DeltaParms.NewState = NewState;
+
+		return true;
+	}
+	else if (DeltaParms.Reader != nullptr)
+	{
+		FBitReader& Reader = *DeltaParms.Reader;
+
+		if (ReceivedHistory.Num() != HistorySize)
+		{
+			ReceivedHistory.SetNum(HistorySize);
+		}
+
+		auto FindBase = [this](uint8 BaseId) -> const FQuantizedRepMovement*
+		{
+			const FReceivedState& Received = ReceivedHistory[BaseId % HistorySize];
+
+			return (Received.bValid && Received.StateId == BaseId) ? &Received.State : nullptr;
+		};
+
+		uint8 StateId = 0;
+		FQuantizedRepMovement State;
+
+		if (!ReadState(Reader, StateId, State, FindBase, Movement.RotationQuantizationLevel))
+		{
+			if (Reader.IsError())
+			{
+				UE_LOG(LogNet, Warning, TEXT("FRepMovementDelta::NetDeltaSerialize: Failed to read movement state."));
+				return false;
+			}
+
+			// The stream was consumed, so the bunch is still valid - just skip this state
+			UE_LOG(LogNet, Warning, TEXT("FRepMovementDelta::NetDeltaSerialize: Received state %i references an unknown base state, ignoring."), StateId);
+			return true;
+		}
+
+		FReceivedState& Slot = ReceivedHistory[StateId % HistorySize];
+
+		Slot.State = State;
+		Slot.StateId = StateId;
+		Slot.bValid = true;
+
+		State.Dequantize(Movement);
+
+		return true;
+	}
+
+	return false;
+}
+
+
+/**
+ * Movement trace recording and bandwidth benchmark.
+ *
+ * Traces are CSV files with one row per actor per frame:
+ *		Time,ActorId,LocX,LocY,LocZ,Pitch,Yaw,Roll,VelX,VelY,VelZ
+ */
+
+namespace RepMovementDeltaPrivate
+{
+	struct FMovementTraceSample
+	{
+		double Time = 0.0;
+		FRepMovement Movement;
+	};
+
+	typedef TMap<int32, TArray<FMovementTraceSample>> FMovementTrace;
+
+	static bool LoadMovementTrace(const FString& Filename, FMovementTrace& OutTrace)
+	{
+		TArray<FString> Lines;
+
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			return false;
+		}
+
+		TArray<FString> Values;
+
+		for (const FString& Line : Lines)
+		{
+			Values.Reset();
+			Line.ParseIntoArray(Values, TEXT(","));
+
+			if (Values.Num() < 11 || !Values[0].IsNumeric())
+			{
+				continue;
+			}
+
+			FMovementTraceSample& Sample = OutTrace.FindOrAdd(FCString::Atoi(*Values[1])).AddDefaulted_GetRef();
+
+			Sample.Time = FCString::Atod(*Values[0]);
+			Sample.Movement.Location = FVector(FCString::Atof(*Values[2]), FCString::Atof(*Values[3]), FCString::Atof(*Values[4]));
+			Sample.Movement.Rotation = FRotator(FCString::Atof(*Values[5]), FCString::Atof(*Values[6]), FCString::Atof(*Values[7]));
+			Sample.Movement.LinearVelocity = FVector(FCString::Atof(*Values[8]), FCString::Atof(*Values[9]), FCString::Atof(*Values[10]));
+		}
+
+		return OutTrace.Num() > 0;
+	}
+
+	/** Generates walking characters, with stops, turns and jumps, when no recorded trace is available */
+	static void GenerateSyntheticMovementTrace(FMovementTrace& OutTrace, int32 NumActors, float Duration, float FrameRate)
+	{
+		FRandomStream Random(0x5EED);
+		const float DeltaTime = 1.f / FrameRate;
+
+		for (int32 ActorId = 0; ActorId < NumActors; ++ActorId)
+		{
+			TArray<FMovementTraceSample>& Samples = OutTrace.Add(ActorId);
+			FVector Location(Random.FRandRange(-50000.f, 50000.f), Random.FRandRange(-50000.f, 50000.f), 100.f);
+			float Yaw = Random.FRandRange(-180.f, 180.f);
+			float Speed = 0.f;
+			float VerticalVelocity = 0.f;
+
+			for (float Time = 0.f; Time < Duration; Time += DeltaTime)
+			{
+				if (Random.FRand() < 0.01f)
+				{
+					Speed = (Random.FRand() < 0.3f) ? 0.f : Random.FRandRange(200.f, 600.f);
+				}
+
+				if (Speed > 0.f && Random.FRand() < 0.05f)
+				{
+					Yaw = FRotator::NormalizeAxis(Yaw + Random.FRandRange(-45.f, 45.f));
+				}
+
+				if (Location.Z <= 100.f && Speed > 0.f && Random.FRand() < 0.005f)
+				{
+					VerticalVelocity = 420.f;
+				}
+
+				const FVector Velocity = FRotator(0.f, Yaw, 0.f).Vector() * Speed + FVector(0.f, 0.f, VerticalVelocity);
+
+				Location += Velocity * DeltaTime;
+
+				if (Location.Z > 100.f || VerticalVelocity > 0.f)
+				{
+					VerticalVelocity -= 980.f * DeltaTime;
+				}
+
+				if (Location.Z < 100.f)
+				{
+					Location.Z = 100.f;
+					VerticalVelocity = 0.f;
+				}
+
+				FMovementTraceSample& Sample = Samples.AddDefaulted_GetRef();
+
+				Sample.Time = Time;
+				Sample.Movement.Location = Location;
+				Sample.Movement.Rotation = FRotator(0.f, Yaw, 0.f);
+				Sample.Movement.LinearVelocity = Velocity;
+			}
+		}
+	}
+
+	struct FBenchmarkResult
+	{
+		uint64 AbsoluteBits = 0;
+		uint64 DeltaBits = 0;
+		int32 NumSends = 0;
+		int32 NumDeltaSends = 0;
+		int32 NumMismatches = 0;
+	};
+
+	/**
+	 * Replays a single actors samples through both FRepMovement::NetSerialize and the delta encoder,
+	 * simulating round trip time and packet loss for acknowledgement.
+	 */
+	static void BenchmarkActor(const TArray<FMovementTraceSample>& Samples, double RoundTripTime, float PacketLoss, FRandomStream& Random,
+								FBenchmarkResult& Result)
+	{
+		using namespace RepMovementDelta;
+
+		struct FPendingState
+		{
+			FQuantizedRepMovement State;
+			double AckTime = 0.0;
+			uint8 StateId = 0;
+			bool bLost = false;
+		};
+
+		TArray<FPendingState> SentHistory;
+		FQuantizedRepMovement LastSent;
+		FQuantizedRepMovement ReceivedStates[HistorySize];
+		uint8 ReceivedIds[HistorySize] = {};
+		bool bReceivedValid[HistorySize] = {};
+		bool bHasSent = false;
+		uint8 NextStateId = 0;
+
+		for (const FMovementTraceSample& Sample : Samples)
+		{
+			FQuantizedRepMovement Current;
+
+			Current.Quantize(Sample.Movement);
+
+			if (bHasSent && Current == LastSent)
+			{
+				continue;
+			}
+
+			bHasSent = true;
+			LastSent = Current;
+			Result.NumSends++;
+
+			{
+				FRepMovement Movement = Sample.Movement;
+				FBitWriter AbsoluteWriter(0, true);
+				bool bSuccess = true;
+
+				Movement.NetSerialize(AbsoluteWriter, nullptr, bSuccess);
+				Result.AbsoluteBits += AbsoluteWriter.GetNumBits();
+			}
+
+			const uint8 StateId = NextStateId++;
+
+			SentHistory.RemoveAll([StateId](const FPendingState& Pending) { return (uint8)(StateId - Pending.StateId) >= HistorySize; });
+
+			const FPendingState* Base = nullptr;
+
+			for (int32 Idx = SentHistory.Num() - 1; Idx >= 0; --Idx)
+			{
+				if (!SentHistory[Idx].bLost && SentHistory[Idx].AckTime <= Sample.Time)
+				{
+					Base = &SentHistory[Idx];
+					break;
+				}
+			}
+
+			FBitWriter DeltaWriter(0, true);
+
+			WriteState(DeltaWriter, StateId, Current, Base != nullptr ? Base->StateId : 0, Base != nullptr ? &Base->State : nullptr,
+						ERotatorQuantization::ByteComponents);
+
+			Result.DeltaBits += DeltaWriter.GetNumBits();
+			Result.NumDeltaSends += (Base != nullptr) ? 1 : 0;
+
+			FPendingState& Pending = SentHistory.AddDefaulted_GetRef();
+
+			Pending.State = Current;
+			Pending.StateId = StateId;
+			Pending.AckTime = Sample.Time + RoundTripTime;
+			Pending.bLost = Random.FRand() < PacketLoss;
+
+			if (!Pending.bLost)
+			{
+				FBitReader DeltaReader(DeltaWriter.GetData(), DeltaWriter.GetNumBits());
+				FQuantizedRepMovement Decoded;
+				uint8 DecodedId = 0;
+
+				auto FindBase = [&](uint8 BaseId) -> const FQuantizedRepMovement*
+				{
+					const int32 Slot = BaseId % HistorySize;
+
+					return (bReceivedValid[Slot] && ReceivedIds[Slot] == BaseId) ? &ReceivedStates[Slot] : nullptr;
+				};
+
+				if (!ReadState(DeltaReader, DecodedId, Decoded, FindBase, ERotatorQuantization::ByteComponents) || Decoded != Current)
+				{
+					Result.NumMismatches++;
+				}
+				else
+				{
+					const int32 Slot = DecodedId % HistorySize;
+
+					ReceivedStates[Slot] = Decoded;
+					ReceivedIds[Slot] = DecodedId;
+					bReceivedValid[Slot] = true;
+				}
+			}
+		}
+	}
+
+	static void RunMovementBenchmark(const TArray<FString>& Args)
+	{
+		FMovementTrace Trace;
+		FString TraceName = TEXT("Synthetic");
+
+		if (Args.Num() > 0 && !Args[0].IsNumeric())
+		{
+			if (!LoadMovementTrace(Args[0], Trace))
+			{
+				UE_LOG(LogNet, Warning, TEXT("Net.RepMovementDelta.Benchmark: Failed to load movement trace '%s'"), *Args[0]);
+				return;
+			}
+
+			TraceName = Args[0];
+		}
+		else
+		{
+			GenerateSyntheticMovementTrace(Trace, 200, 60.f, 30.f);
+		}
+
+		const int32 ArgOffset = (TraceName == TEXT("Synthetic")) ? 0 : 1;
+		const double RoundTripTime = (Args.Num() > ArgOffset) ? FCString::Atod(*Args[ArgOffset]) / 1000.0 : 0.1;
+		const float PacketLoss = (Args.Num() > ArgOffset + 1) ? FCString::Atof(*Args[ArgOffset + 1]) / 100.f : 0.01f;
+
+		FRandomStream Random(0x10552);
+		FBenchmarkResult Result;
+		double MinTime = MAX_dbl;
+		double MaxTime = -MAX_dbl;
+
+		for (TPair<int32, TArray<FMovementTraceSample>>& ActorPair : Trace)
+		{
+			TArray<FMovementTraceSample>& Samples = ActorPair.Value;
+
+			Samples.StableSort([](const FMovementTraceSample& A, const FMovementTraceSample& B) { return A.Time < B.Time; });
+
+			if (Samples.Num() > 0)
+			{
+				MinTime = FMath::Min(MinTime, Samples[0].Time);
+				MaxTime = FMath::Max(MaxTime, Samples.Last().Time);
+			}
+
+			BenchmarkActor(Samples, RoundTripTime, PacketLoss, Random, Result);
+		}
+
+		const double Duration = FMath::Max(MaxTime - MinTime, 0.001);
+		const double ActorSeconds = Duration * (double)Trace.Num();
+
+		UE_LOG(LogNet, Display, TEXT("RepMovementDelta benchmark: Trace: %s, Actors: %i, Duration: %.1fs, RTT: %.0fms, Loss: %.1f%%"),
+				*TraceName, Trace.Num(), Duration, RoundTripTime * 1000.0, PacketLoss * 100.f);
+		UE_LOG(LogNet, Display, TEXT("    Sends: %i (%.1f%% delta encoded), Decode mismatches: %i"),
+				Result.NumSends, Result.NumSends > 0 ? 100.f * Result.NumDeltaSends / Result.NumSends : 0.f, Result.NumMismatches);
+		UE_LOG(LogNet, Display, TEXT("    FRepMovement:      %.1f bits/actor/sec"), (double)Result.AbsoluteBits / ActorSeconds);
+		UE_LOG(LogNet, Display, TEXT("    FRepMovementDelta: %.1f bits/actor/sec (%.1f%%)"), (double)Result.DeltaBits / ActorSeconds,
+				Result.AbsoluteBits > 0 ? 100.0 * (double)Result.DeltaBits / (double)Result.AbsoluteBits : 0.0);
+	}
+
+	/** Records ReplicatedMovement of every movement replicating actor, each frame */
+	class FMovementTraceRecorder
+	{
+	public:
+		FMovementTraceRecorder(UWorld* InWorld, float InDuration, const FString& InFilename)
+			: World(InWorld)
+			, Filename(InFilename)
+			, StartTime(FPlatformTime::Seconds())
+			, Duration(InDuration)
+		{
+			Output = TEXT("Time,ActorId,LocX,LocY,LocZ,Pitch,Yaw,Roll,VelX,VelY,VelZ\n");
+			TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMovementTraceRecorder::Tick));
+		}
+
+		~FMovementTraceRecorder()
+		{
+			FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		}
+
+		static TUniquePtr<FMovementTraceRecorder> ActiveRecorder;
+
+	private:
+		bool Tick(float DeltaTime)
+		{
+			const double Time = FPlatformTime::Seconds() - StartTime;
+			UWorld* CurWorld = World.Get();
+
+			if (CurWorld != nullptr && Time < Duration)
+			{
+				for (TActorIterator<AActor> It(CurWorld); It; ++It)
+				{
+					if (It->GetIsReplicated() && It->IsReplicatingMovement())
+					{
+						const FRepMovement& Movement = It->GetReplicatedMovement();
+
+						Output += FString::Printf(TEXT("%.4f,%u,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f\n"), Time, It->GetUniqueID(),
+									Movement.Location.X, Movement.Location.Y, Movement.Location.Z,
+									Movement.Rotation.Pitch, Movement.Rotation.Yaw, Movement.Rotation.Roll,
+									Movement.LinearVelocity.X, Movement.LinearVelocity.Y, Movement.LinearVelocity.Z);
+					}
+				}
+
+				return true;
+			}
+
+			const bool bSaved = FFileHelper::SaveStringToFile(Output, *Filename);
+
+			UE_LOG(LogNet, Display, TEXT("Net.RepMovementDelta.RecordTrace: %s movement trace '%s'"), bSaved ? TEXT("Saved") : TEXT("Failed to save"), *Filename);
+
+			// Deferred, as deleting the recorder removes the ticker currently executing
+			TickerHandle.Reset();
+			FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float) { ActiveRecorder.Reset(); return false; }));
+
+			return false;
+		}
+
+	private:
+		TWeakObjectPtr<UWorld> World;
+		FString Filename;
+		FString Output;
+		FDelegateHandle TickerHandle;
+		double StartTime;
+		double Duration;
+	};
+
+	TUniquePtr<FMovementTraceRecorder> FMovementTraceRecorder::ActiveRecorder;
+}
+
+FAutoConsoleCommand RepMovementDeltaBenchmark(TEXT("Net.RepMovementDelta.Benchmark"),
+	TEXT("Compares FRepMovement and FRepMovementDelta bandwidth, in bits per actor per second, over a recorded movement trace." \
+		 "\nUsage:" \
+		 "\nNet.RepMovementDelta.Benchmark [TraceFile] [RoundTripTimeMS] [PacketLossPercent]" \
+		 "\nA synthetic trace is used when no trace file is specified."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RepMovementDeltaPrivate::RunMovementBenchmark));
+
+FAutoConsoleCommandWithWorldAndArgs RepMovementDeltaRecordTrace(TEXT("Net.RepMovementDelta.RecordTrace"),
+	TEXT("Records the replicated movement of all movement replicating actors into a trace file, for use with Net.RepMovementDelta.Benchmark." \
+		 "\nUsage:" \
+		 "\nNet.RepMovementDelta.RecordTrace Seconds [TraceFile]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		using namespace RepMovementDeltaPrivate;
+
+		if (Args.Num() < 1 || World == nullptr)
+		{
+			UE_LOG(LogConsoleResponse, Display, TEXT("Missing some parameters"));
+			return;
+		}
+
+		const float Duration = FCString::Atof(*Args[0]);
+		const FString Filename = (Args.Num() > 1) ? Args[1] :
+									FPaths::ProjectSavedDir() / TEXT("NetTraces") / FString::Printf(TEXT("Movement_%s.csv"), *FDateTime::Now().ToString());
+
+		FMovementTraceRecorder::ActiveRecorder = MakeUnique<FMovementTraceRecorder>(World, Duration, Filename);
+	}));
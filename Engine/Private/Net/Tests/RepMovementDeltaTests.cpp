@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Net/RepMovementDelta.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRepMovementDeltaTest, "Net.RepMovementDeltaTest", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+struct FRepMovementDeltaTestUtil
+{
+	static FQuantizedRepMovement MakeState(const FVector& Location, const FRotator& Rotation, const FVector& Velocity)
+	{
+		FRepMovement Movement;
+
+		Movement.Location = Location;
+		Movement.Rotation = Rotation;
+		Movement.LinearVelocity = Velocity;
+
+		FQuantizedRepMovement State;
+		State.Quantize(Movement);
+
+		return State;
+	}
+
+	static bool RoundTrip(const FQuantizedRepMovement& State, const FQuantizedRepMovement* Base, int64& OutNumBits)
+	{
+		FBitWriter Writer(0, true);
+
+		RepMovementDelta::WriteState(Writer, 5, State, 4, Base, ERotatorQuantization::ByteComponents);
+
+		OutNumBits = Writer.GetNumBits();
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		FQuantizedRepMovement Decoded;
+		uint8 DecodedId = 0;
+
+		auto FindBase = [Base](uint8 BaseId) -> const FQuantizedRepMovement*
+		{
+			return BaseId == 4 ? Base : nullptr;
+		};
+
+		return RepMovementDelta::ReadState(Reader, DecodedId, Decoded, FindBase, ERotatorQuantization::ByteComponents) && DecodedId == 5 && Decoded == State;
+	}
+};
+
+bool FRepMovementDeltaTest::RunTest(const FString& Parameters)
+{
+	const FQuantizedRepMovement Base = FRepMovementDeltaTestUtil::MakeState(FVector(12345.f, -5432.f, 100.f), FRotator(0.f, 90.f, 0.f), FVector(300.f, 0.f, 0.f));
+	const FQuantizedRepMovement Moved = FRepMovementDeltaTestUtil::MakeState(FVector(12355.f, -5432.f, 100.f), FRotator(0.f, 92.f, 0.f), FVector(300.f, 0.f, 0.f));
+
+	// Absolute
+	{
+		int64 NumBits = 0;
+
+		TestTrue(TEXT("Absolute state round trips"), FRepMovementDeltaTestUtil::RoundTrip(Moved, nullptr, NumBits));
+	}
+
+	// Delta
+	{
+		int64 AbsoluteBits = 0;
+		int64 DeltaBits = 0;
+
+		FRepMovementDeltaTestUtil::RoundTrip(Moved, nullptr, AbsoluteBits);
+
+		TestTrue(TEXT("Delta state round trips"), FRepMovementDeltaTestUtil::RoundTrip(Moved, &Base, DeltaBits));
+		TestTrue(TEXT("Delta state is smaller than absolute state"), DeltaBits < AbsoluteBits);
+	}
+
+	// Quantization
+	{
+		FRepMovement Movement;
+		Movement.Location = FVector(-1000.4f, 2000.6f, 3.f);
+		Movement.Rotation = FRotator(10.f, -45.f, 5.f);
+
+		FQuantizedRepMovement State;
+		State.Quantize(Movement);
+
+		FRepMovement Restored;
+		State.Dequantize(Restored);
+
+		TestTrue(TEXT("Location quantized to whole numbers"), Restored.Location.Equals(FVector(-1000.f, 2001.f, 3.f)));
+		TestTrue(TEXT("Rotation restored within tolerance"), Restored.Rotation.Quaternion().AngularDistance(Movement.Rotation.Quaternion()) < FMath::DegreesToRadians(1.f));
+	}
+
+	// Unknown base
+	{
+		FBitWriter Writer(0, true);
+
+		RepMovementDelta::WriteState(Writer, 5, Moved, 4, &Base, ERotatorQuantization::ByteComponents);
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		FQuantizedRepMovement Decoded;
+		uint8 DecodedId = 0;
+
+		TestFalse(TEXT("Unknown base is reported"), RepMovementDelta::ReadState(Reader, DecodedId, Decoded, [](uint8) { return (const FQuantizedRepMovement*)nullptr; }, ERotatorQuantization::ByteComponents));
+		TestFalse(TEXT("Unknown base leaves reader valid"), Reader.IsError());
+		TestEqual(TEXT("Unknown base consumes the full state"), Reader.GetPosBits(), Writer.GetNumBits());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
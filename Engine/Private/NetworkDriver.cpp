@@ -58,6 +58,7 @@
 #include "NetworkingDistanceConstants.h"
 #include "Engine/ChildConnection.h"
 #include "Net/Core/Trace/NetTrace.h"
+#include "Net/Core/Trace/NetPropertyTrace.h"
 #include "Misc/ScopeExit.h"
 #include "Net/DataChannel.h"
 #include "GameFramework/PlayerState.h"
@@ -1208,6 +1209,13 @@ void UNetDriver::TickFlush(float DeltaSeconds)
 
 	// Update the lag state
 	UpdateNetworkLagState();
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+	if (FNetPropertyTrace::IsEnabled())
+	{
+		FNetPropertyTrace::EndFrame();
+	}
+#endif
 }
 
 void UNetDriver::UpdateNetworkLagState()
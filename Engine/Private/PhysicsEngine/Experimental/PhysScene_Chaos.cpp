@@ -1920,6 +1920,14 @@ int32 FPhysScene_ChaosInterface::DirtyElementCount(Chaos::ISpatialAccelerationCo
 		{
 			DirtyElements += AABBTreeBV->NumDirtyElements();
 		}
+		else if (const auto WideAABBTree = SubStructure->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>>())
+		{
+			DirtyElements += WideAABBTree->NumDirtyElements();
+		}
+		else if (const auto WideAABBTree8 = SubStructure->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>>())
+		{
+			DirtyElements += WideAABBTree8->NumDirtyElements();
+		}
 	}
 	return DirtyElements;
 }
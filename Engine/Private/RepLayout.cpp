@@ -23,6 +23,7 @@
 #include "Templates/AndOrNot.h"
 #include "PushModelPerNetDriverState.h"
 #include "Net/Core/Trace/NetTrace.h"
+#include "Net/Core/Trace/NetPropertyTrace.h"
 
 DECLARE_CYCLE_STAT(TEXT("RepLayout AddPropertyCmd"), STAT_RepLayout_AddPropertyCmd, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("RepLayout InitFromObjectClass"), STAT_RepLayout_InitFromObjectClass, STATGROUP_Game);
@@ -283,6 +284,15 @@ namespace UE4_RepLayout_Private
 		return GNetworkProfiler.IsComparisonTrackingEnabled();
 #else
 		return false;
+#endif
+	}
+
+	static bool IsPropertyTraceEnabled()
+	{
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		return FNetPropertyTrace::IsEnabled();
+#else
+		return false;
 #endif
 	}
 }
@@ -1146,6 +1156,8 @@ struct FComparePropertiesSharedParams
 	const TBitArray<>* const PushModelProperties = nullptr;
 	const bool bValidateProperties = false;
 	const bool bIsNetworkProfilerActive = false;
+	const bool bIsPropertyTraceActive = false;
+	const FName OwnerName;
 #if (WITH_PUSH_VALIDATION_SUPPORT || USE_NETWORK_PROFILER)
 	TBitArray<> PropertiesCompared;
 	TBitArray<> PropertiesChanged;
@@ -1261,8 +1273,19 @@ namespace UE4_RepLayout_Private
 		const FComparePropertiesSharedParams& SharedParams,
 		FComparePropertiesStackParams& StackParams)
 	{
+	#if UE_NET_PROPERTY_TRACE_ENABLED
+		const uint64 CompareStartCycles = SharedParams.bIsPropertyTraceActive ? FPlatformTime::Cycles64() : 0;
+	#endif
+
 		const bool bDidPropertyChange = CompareParentProperty(ParentIndex, SharedParams, StackParams);
 
+	#if UE_NET_PROPERTY_TRACE_ENABLED
+		if (SharedParams.bIsPropertyTraceActive)
+		{
+			FNetPropertyTrace::TraceCompare(SharedParams.OwnerName, SharedParams.Parents[ParentIndex].CachedPropertyName, FPlatformTime::Cycles64() - CompareStartCycles);
+		}
+	#endif
+
 	#if USE_NETWORK_PROFILER
 		if (SharedParams.bIsNetworkProfilerActive)
 		{
@@ -1510,7 +1533,9 @@ bool FRepLayout::CompareProperties(
 		/*PushModelState=*/UE4_RepLayout_Private::GetPerNetDriverState(RepChangelistState),
 		/*PushModelProperties=*/ LocalPushModelProperties,	
 		/*bValidateProperties=*/GbPushModelValidateProperties,
-		/*bIsNetworkProfilerActive=*/UE4_RepLayout_Private::IsNetworkProfilerComparisonTrackingEnabled()
+		/*bIsNetworkProfilerActive=*/UE4_RepLayout_Private::IsNetworkProfilerComparisonTrackingEnabled(),
+		/*bIsPropertyTraceActive=*/UE4_RepLayout_Private::IsPropertyTraceEnabled(),
+		/*OwnerName=*/Owner->GetFName()
 	};
 
 	FComparePropertiesStackParams StackParams{
@@ -2443,6 +2468,10 @@ void FRepLayout::SendProperties_r(
 
 			UE_LOG(LogRepProperties, VeryVerbose, TEXT("SerializeProperties_r: SharedSerialization - Handle=%d, Guid=%s"), HandleIterator.Handle, *SharedPropInfo->Guid.ToString());
 			GNumSharedSerializationHit++;
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+			const uint64 SerializeStartCycles = FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+#endif
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 			if (GNetVerifyShareSerializedData != 0)
 			{
@@ -2480,6 +2509,14 @@ void FRepLayout::SendProperties_r(
 			}
 
 			NETWORK_PROFILER(GNetworkProfiler.TrackReplicateProperty(ParentCmd.Property, SharedPropInfo->PropBitLength, nullptr));
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+			if (SerializeStartCycles != 0)
+			{
+				// The cost of the shared serialization itself is paid once, in BuildSharedSerialization, this is only the copy.
+				FNetPropertyTrace::TraceSerialize(Owner->GetFName(), ParentCmd.CachedPropertyName, SharedPropInfo->PropBitLength, FPlatformTime::Cycles64() - SerializeStartCycles);
+			}
+#endif
 		}
 		else
 		{
@@ -2490,6 +2527,10 @@ void FRepLayout::SendProperties_r(
 
 			const int32 NumStartBits = Writer.GetNumBits();
 
+#if UE_NET_PROPERTY_TRACE_ENABLED
+			const uint64 SerializeStartCycles = FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+#endif
+
 			// This property changed, so send it
 			Cmd.Property->NetSerializeItem(Writer, Writer.PackageMap, const_cast<uint8*>(Data.Data));
 			UE_LOG(LogRepProperties, VeryVerbose, TEXT("SerializeProperties_r: NetSerializeItem"));
@@ -2498,6 +2539,13 @@ void FRepLayout::SendProperties_r(
 
 			NETWORK_PROFILER(GNetworkProfiler.TrackReplicateProperty(ParentCmd.Property, NumEndBits - NumStartBits, nullptr));
 
+#if UE_NET_PROPERTY_TRACE_ENABLED
+			if (SerializeStartCycles != 0)
+			{
+				FNetPropertyTrace::TraceSerialize(Owner->GetFName(), ParentCmd.CachedPropertyName, NumEndBits - NumStartBits, FPlatformTime::Cycles64() - SerializeStartCycles);
+			}
+#endif
+
 #ifdef ENABLE_PROPERTY_CHECKSUMS
 			if (bDoChecksum)
 			{
@@ -6135,6 +6183,11 @@ void FRepLayout::SendPropertiesForRPC(
 
 	if (!IsEmpty())
 	{
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		const int64 NumStartBits = Writer.GetNumBits();
+		const uint64 SerializeStartCycles = FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+#endif
+
 		if (Channel->Connection->IsInternalAck())
 		{
 			TArray<uint16> Changed;
@@ -6182,6 +6235,13 @@ void FRepLayout::SendPropertiesForRPC(
 				}
 			}
 		}	
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+		if (SerializeStartCycles != 0)
+		{
+			FNetPropertyTrace::TraceSentRPC(Function->GetOwnerClass()->GetFName(), Function->GetFName(), Writer.GetNumBits() - NumStartBits, FPlatformTime::Cycles64() - SerializeStartCycles);
+		}
+#endif
 	}
 }
 
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "Engine/EngineTypes.h"
+
+#include "RepMovementDelta.generated.h"
+
+/**
+ * FRepMovement in quantized integer form.
+ * This is the unit that the delta movement serializer keeps history of, and encodes residuals between.
+ *
+ * Rotation is stored using smallest-three quaternion packing: the index of the largest quaternion component,
+ * and the remaining three components quantized (the largest is reconstructed from the unit length constraint).
+ */
+struct ENGINE_API FQuantizedRepMovement
+{
+	FIntVector Location = FIntVector::ZeroValue;
+	FIntVector LinearVelocity = FIntVector::ZeroValue;
+	FIntVector AngularVelocity = FIntVector::ZeroValue;
+	FIntVector Rotation = FIntVector::ZeroValue;
+	uint8 RotationLargestIndex = 3;
+	uint8 bSimulatedPhysicSleep : 1;
+	uint8 bRepPhysics : 1;
+
+	FQuantizedRepMovement()
+		: bSimulatedPhysicSleep(0)
+		, bRepPhysics(0)
+	{
+	}
+
+	/** Quantizes the movement, using the quantization levels it specifies */
+	void Quantize(const FRepMovement& Movement);
+
+	/** Restores the movement values, using the quantization levels specified by the output movement */
+	void Dequantize(FRepMovement& OutMovement) const;
+
+	bool operator==(const FQuantizedRepMovement& Other) const;
+
+	bool operator!=(const FQuantizedRepMovement& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+namespace RepMovementDelta
+{
+	/** Number of bits used for state identifiers */
+	static constexpr uint32 StateIdBits = 8;
+
+	/** Number of received states the receiving side retains, and therefore the maximum distance between a state and its base */
+	static constexpr uint32 HistorySize = 32;
+
+	/** Number of bits used to encode the distance between a state and its base */
+	static constexpr uint32 BaseOffsetBits = 5;
+
+	/**
+	 * Writes a state, delta encoded against Base when specified (otherwise absolute).
+	 *
+	 * @param Ar			The archive to write to
+	 * @param StateId		Identifier of the state being written
+	 * @param State			The state to write
+	 * @param BaseId		Identifier of the base state (ignored if Base is null). Must be within HistorySize of StateId.
+	 * @param Base			The base state to delta against, known by the receiver, or nullptr
+	 * @param RotationQuantizationLevel	Determines the precision of the smallest-three quaternion components
+	 */
+	ENGINE_API void WriteState(FArchive& Ar, uint8 StateId, const FQuantizedRepMovement& State, uint8 BaseId, const FQuantizedRepMovement* Base,
+								ERotatorQuantization RotationQuantizationLevel);
+
+	/**
+	 * Reads a state written by WriteState.
+	 *
+	 * @param Ar			The archive to read from
+	 * @param OutStateId	Identifier of the state that was read
+	 * @param OutState		The state that was read
+	 * @param FindBase		Looks up a previously received state by identifier, returning nullptr if it is not known
+	 * @param RotationQuantizationLevel	Must match the level used when writing
+	 * @return				False if the stream is corrupt, or referenced an unknown base
+	 */
+	ENGINE_API bool ReadState(FArchive& Ar, uint8& OutStateId, FQuantizedRepMovement& OutState,
+								TFunctionRef<const FQuantizedRepMovement*(uint8 BaseId)> FindBase, ERotatorQuantization RotationQuantizationLevel);
+}
+
+/**
+ * Delta-compressed alternative to FRepMovement.
+ *
+ * Each send is encoded as a variable bit width residual against the most recent state the receiving connection is known to have,
+ * or absolute if there is no such state (initial replication, packet loss, and all replay/InternalAck connections).
+ *
+ * Acknowledgement comes from the custom delta property retirement system (see DataReplication.cpp): sent states live in the
+ * INetDeltaBaseState history, a NAK restores the history from before the lost send, and a state is treated as acknowledged
+ * once every packet it could have been sent in has been notified by FNetPacketNotify, without it having been rolled back.
+ */
+USTRUCT()
+struct ENGINE_API FRepMovementDelta
+{
+	GENERATED_BODY()
+
+	/** The replicated movement, including the quantization settings */
+	UPROPERTY(Transient)
+	FRepMovement Movement;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+private:
+	struct FReceivedState
+	{
+		FQuantizedRepMovement State;
+		uint8 StateId = 0;
+		bool bValid = false;
+	};
+
+	/** States received from the server, indexed by StateId % HistorySize - only used on the receiving side */
+	TArray<FReceivedState> ReceivedHistory;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRepMovementDelta> : public TStructOpsTypeTraitsBase2<FRepMovementDelta>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
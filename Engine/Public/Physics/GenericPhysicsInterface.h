@@ -17,6 +17,13 @@ struct ENGINE_API FGenericPhysicsInterface
 	/** Trace a ray against the world and return the first blocking hit */
 	static bool RaycastSingle(const UWorld* World, struct FHitResult& OutHit, const FVector Start, const FVector End, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
 
+	/**
+	 *  Trace rays against the world and return the first blocking hit of each, OutHits[Index] for the ray from Starts[Index] to Ends[Index]
+	 *  Same results as RaycastSingle for each ray, but all rays share filtering and coherent rays are traversed together
+	 *  @return number of rays with a blocking hit
+	 */
+	static int32 RaycastSingleBatch(const UWorld* World, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
+
 
 	/**
 	*  Trace a ray against the world and return touching hits and then first blocking hit
@@ -2,6 +2,7 @@
 
 #include "Chaos/BoundingVolume.h"
 #include "Chaos/AABBTree.h"
+#include "Chaos/WideAABBTree.h"
 #include "UObject/ExternalPhysicsCustomObjectVersion.h"
 
 int FBoundingVolumeCVars::FilterFarBodies = 0;
@@ -36,6 +37,8 @@ namespace Chaos
 		case ESpatialAcceleration::BoundingVolume: return Ar.IsLoading() ? new TBoundingVolume<TPayloadType, T, d>() : nullptr;
 		case ESpatialAcceleration::AABBTree: return Ar.IsLoading() ? new TAABBTree<TPayloadType, TAABBTreeLeafArray<TPayloadType, T>, T>() : nullptr;
 		case ESpatialAcceleration::AABBTreeBV: return Ar.IsLoading() ? new TAABBTree<TPayloadType, TBoundingVolume<TPayloadType, T, 3>, T>() : nullptr;
+		case ESpatialAcceleration::WideAABBTree: return Ar.IsLoading() ? new TWideAABBTree<TPayloadType, T, 4>() : nullptr;
+		case ESpatialAcceleration::WideAABBTree8: return Ar.IsLoading() ? new TWideAABBTree<TPayloadType, T, 8>() : nullptr;
 		case ESpatialAcceleration::Collection: check(false);	//Collections must be serialized directly since they are variadic
 		default: check(false); return nullptr;
 		}
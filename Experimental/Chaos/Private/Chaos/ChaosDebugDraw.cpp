@@ -9,8 +9,10 @@
 #include "Chaos/Particle/ParticleUtilities.h"
 #include "Chaos/ParticleHandle.h"
 #include "Chaos/PBDCollisionConstraints.h"
+#include "Chaos/PBDConstraintGraph.h"
 #include "Chaos/PBDJointConstraints.h"
 #include "Chaos/PBDRigidParticles.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
 #include "Chaos/Sphere.h"
 #include "Chaos/Utilities.h"
 
@@ -522,5 +524,49 @@ namespace Chaos
 #endif
 		}
 
+		void DrawIslands(const FRigidTransform3& SpaceTransform, const FPBDConstraintGraph& Graph, const TArray<FIslandSolveStats>& IslandStats)
+		{
+#if CHAOS_DEBUG_DRAW
+			if (FDebugDrawQueue::IsDebugDrawingEnabled())
+			{
+				// Islands are colored from green to red by solve time, or by estimated cost when the time is not measured
+				int32 MaxCost = 1;
+				double MaxSeconds = 0;
+				for (const FIslandSolveStats& Stats : IslandStats)
+				{
+					MaxCost = FMath::Max(MaxCost, Stats.Cost);
+					MaxSeconds = FMath::Max(MaxSeconds, Stats.Seconds);
+				}
+
+				for (int32 Island = 0; Island < Graph.NumIslands(); ++Island)
+				{
+					FAABB3 Bounds = FAABB3::EmptyAABB();
+					bool bHasBounds = false;
+					for (const TGeometryParticleHandle<float, 3>* Particle : Graph.GetIslandParticles(Island))
+					{
+						// Static and kinematic particles can be shared by many islands
+						const TPBDRigidParticleHandle<float, 3>* Rigid = Particle->CastToRigidParticle();
+						if (Rigid && Rigid->HasBounds() && (Rigid->ObjectState() == EObjectStateType::Dynamic || Rigid->ObjectState() == EObjectStateType::Sleeping))
+						{
+							Bounds.GrowToInclude(Rigid->WorldSpaceInflatedBounds());
+							bHasBounds = true;
+						}
+					}
+					if (!bHasBounds || !IslandStats.IsValidIndex(Island))
+					{
+						continue;
+					}
+
+					const FIslandSolveStats& Stats = IslandStats[Island];
+					const float Scalar = (MaxSeconds > 0) ? (float)(Stats.Seconds / MaxSeconds) : (float)Stats.Cost / (float)MaxCost;
+					const FColor Color = FColor::MakeRedToGreenColorFromScalar(1.0f - Scalar);
+					const FVec3 Center = SpaceTransform.TransformPosition(Bounds.Center());
+					FDebugDrawQueue::GetInstance().DrawDebugBox(Center, 0.5f * Bounds.Extents(), SpaceTransform.GetRotation(), Color, false, KINDA_SMALL_NUMBER, DrawPriority, LineThickness);
+					FDebugDrawQueue::GetInstance().DrawDebugString(Center + (0.5f * Bounds.Extents().Z + FontHeight) * FVec3(0, 0, 1), FString::Printf(TEXT("%d: %dp %dc cost %d task %d %.3fms"), Island, Stats.NumParticles, Stats.NumConstraints, Stats.Cost, Stats.Batch, Stats.Seconds * 1000.0), nullptr, Color, KINDA_SMALL_NUMBER, false, FontScale);
+				}
+			}
+#endif
+		}
+
 	}
 }
@@ -1,8 +1,358 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Chaos/ChaosPerfTest.h"
+#include "Chaos/Box.h"
+#include "Chaos/PBDConstraintColor.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
+#include "Chaos/PBDRigidsSOAs.h"
+#include "ChaosLog.h"
+#include "HAL/IConsoleManager.h"
 
 #if CHAOS_PERF_TEST_ENABLED
 const TCHAR* FChaosScopedDurationTimeLogger::GlobalLabel = nullptr;
 EChaosPerfUnits FChaosScopedDurationTimeLogger::GlobalUnits = EChaosPerfUnits::S;
+
+namespace Chaos
+{
+	namespace PerfTestUtilities
+	{
+		void InitBoxParticle(TGeometryParticleHandle<FReal, 3>* Particle, const FVec3& X, const FVec3& HalfExtents, TArray<TUniquePtr<FImplicitObject>>& Geometries)
+		{
+			const TUniquePtr<FImplicitObject>& Geometry = Geometries.Add_GetRef(MakeUnique<TBox<FReal, 3>>(-HalfExtents, HalfExtents));
+			Particle->SetX(X);
+			Particle->SetR(FRotation3::Identity);
+			Particle->SetGeometry(MakeSerializable(Geometry));
+			Particle->SetHasBounds(true);
+			Particle->SetLocalBounds(Geometry->BoundingBox());
+			Particle->SetWorldSpaceInflatedBounds(Geometry->BoundingBox().TransformedAABB(FRigidTransform3(X, FRotation3::Identity)));
+			for (const TUniquePtr<TPerShapeData<FReal, 3>>& Shape : Particle->ShapesArray())
+			{
+				// Collision channel 0, colliding with channel 0
+				Shape->SimData.Word1 = 1;
+			}
+		}
+
+		void InitDynamicBoxParticle(TPBDRigidParticleHandle<FReal, 3>* Particle, const FVec3& X, const FVec3& HalfExtents, const FReal Mass, TArray<TUniquePtr<FImplicitObject>>& Geometries)
+		{
+			InitBoxParticle(Particle, X, HalfExtents, Geometries);
+
+			const FMatrix33 Inertia = TBox<FReal, 3>::GetInertiaTensor(Mass, HalfExtents * 2);
+			Particle->SetP(X);
+			Particle->SetQ(FRotation3::Identity);
+			Particle->SetM(Mass);
+			Particle->SetInvM(1 / Mass);
+			Particle->SetI(Inertia);
+			Particle->SetInvI(FMatrix33(1 / Inertia.M[0][0], 1 / Inertia.M[1][1], 1 / Inertia.M[2][2]));
+		}
+	}
+
+	namespace SolverStackingPerfTest
+	{
+		struct FResults
+		{
+			double SecondsPerStep = 0;
+			FReal MaxStackTopDrift = 0;
+			FReal MaxSpeed = 0;
+			TArray<FVec3> FinalPositions;
+		};
+
+		FResults Run(const int32 NumStacks, const int32 StackHeight, const int32 NumPileBoxes, const int32 NumSteps)
+		{
+			const FReal Dt = (FReal)1 / 60;
+			const FReal BoxMass = 100;
+			const FVec3 BoxHalfExtents(50);
+			const FReal BoxSpacing = 101;
+
+			// Geometries outlive the particles referencing them
+			TArray<TUniquePtr<FImplicitObject>> Geometries;
+			TPBDRigidsSOAs<FReal, 3> Particles;
+			FPBDRigidsEvolutionGBF Evolution(Particles);
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> Boxes;
+
+			const auto CreateBox = [&Evolution, &Boxes, &Geometries, BoxMass, &BoxHalfExtents](const FVec3& X)
+			{
+				TPBDRigidParticleHandle<FReal, 3>* Box = Evolution.CreateDynamicParticles(1)[0];
+				PerfTestUtilities::InitDynamicBoxParticle(Box, X, BoxHalfExtents, BoxMass, Geometries);
+				Boxes.Add(Box);
+				return Box;
+			};
+
+			// Ground with its top at Z = 0
+			PerfTestUtilities::InitBoxParticle(Evolution.CreateStaticParticles(1)[0], FVec3(0, 0, -50), FVec3(100000, 100000, 50), Geometries);
+
+			// Towers of boxes resting on each other, one island per tower
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> StackTops;
+			TArray<FVec3> StackTopStartPositions;
+			for (int32 StackIndex = 0; StackIndex < NumStacks; ++StackIndex)
+			{
+				for (int32 Level = 0; Level < StackHeight; ++Level)
+				{
+					TPBDRigidParticleHandle<FReal, 3>* Box = CreateBox(FVec3(StackIndex * 3 * BoxSpacing, -2000, BoxHalfExtents.Z + Level * 2 * BoxHalfExtents.Z));
+					if (Level == StackHeight - 1)
+					{
+						StackTops.Add(Box);
+						StackTopStartPositions.Add(Box->X());
+					}
+				}
+			}
+
+			// A pile of brick-like layers dropped on the ground, every box touches up to four boxes below: a single island with many colors
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> PileBoxes;
+			const int32 PileSide = FMath::Max(FMath::CeilToInt(FMath::Pow((float)NumPileBoxes, 1.f / 3.f)), 1);
+			for (int32 BoxIndex = 0; BoxIndex < NumPileBoxes; ++BoxIndex)
+			{
+				const int32 Layer = BoxIndex / (PileSide * PileSide);
+				const int32 Row = (BoxIndex / PileSide) % PileSide;
+				const int32 Column = BoxIndex % PileSide;
+				const FReal LayerOffset = (Layer % 2) ? BoxHalfExtents.X : 0;
+				PileBoxes.Add(CreateBox(FVec3(Column * BoxSpacing + LayerOffset, 2000 + Row * BoxSpacing + LayerOffset, BoxHalfExtents.Z + Layer * BoxSpacing)));
+			}
+
+			FResults Results;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Step = 0; Step < NumSteps; ++Step)
+			{
+				Evolution.AdvanceOneTimeStep(Dt);
+			}
+			Results.SecondsPerStep = (FPlatformTime::Seconds() - StartTime) / FMath::Max(NumSteps, 1);
+
+			for (int32 StackIndex = 0; StackIndex < StackTops.Num(); ++StackIndex)
+			{
+				Results.MaxStackTopDrift = FMath::Max(Results.MaxStackTopDrift, (StackTops[StackIndex]->X() - StackTopStartPositions[StackIndex]).Size());
+			}
+			for (TPBDRigidParticleHandle<FReal, 3>* Box : PileBoxes)
+			{
+				Results.MaxSpeed = FMath::Max(Results.MaxSpeed, Box->V().Size());
+			}
+			for (TPBDRigidParticleHandle<FReal, 3>* Box : Boxes)
+			{
+				Results.FinalPositions.Add(Box->X());
+			}
+
+			return Results;
+		}
+
+		void Log(const TCHAR* Name, const FResults& Results)
+		{
+			UE_LOG(LogChaos, Log, TEXT("%s: %.3f ms/step, max stack top drift %.2f, max pile speed %.2f"), Name, Results.SecondsPerStep * 1000.0, Results.MaxStackTopDrift, Results.MaxSpeed);
+		}
+
+		void SolverStackingPerfTestCommand(const TArray<FString>& Args)
+		{
+			const int32 NumStacks = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 8;
+			const int32 StackHeight = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10;
+			const int32 NumPileBoxes = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 0) : 1000;
+			const int32 NumSteps = Args.Num() > 3 ? FMath::Max(FCString::Atoi(*Args[3]), 1) : 300;
+			RunSolverStackingPerfTest(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		}
+
+#if !UE_BUILD_SHIPPING
+		static FAutoConsoleCommand SolverStackingPerfTestConsoleCommand(
+			TEXT("p.Chaos.SolverStackingPerfTest"),
+			TEXT("Simulates box towers and a box pile with constraint color batches solved serially and in parallel, logs time per step and stability.\n")
+			TEXT("Args: [NumStacks] [StackHeight] [NumPileBoxes] [NumSteps]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&SolverStackingPerfTestCommand));
+#endif
+	}
+
+	void RunSolverStackingPerfTest(const int32 NumStacks, const int32 StackHeight, const int32 NumPileBoxes, const int32 NumSteps)
+	{
+		using namespace SolverStackingPerfTest;
+
+		const int32 PrevMinParallelSize = ConstraintColorBatchMinParallelSize;
+		const int32 PrevDeterministic = ConstraintColorDeterministic;
+		const int32 PrevIslandBatching = ChaosSolverIslandBatching;
+
+		UE_LOG(LogChaos, Log, TEXT("Solver stacking perf test: %d stacks of %d boxes, pile of %d boxes, %d steps"), NumStacks, StackHeight, NumPileBoxes, NumSteps);
+
+		ConstraintColorDeterministic = 0;
+		ConstraintColorBatchMinParallelSize = MAX_int32;
+		const FResults SerialResults = Run(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		Log(TEXT("Serial color batches"), SerialResults);
+
+		ConstraintColorBatchMinParallelSize = PrevMinParallelSize;
+		const FResults ParallelResults = Run(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		Log(TEXT("Parallel color batches"), ParallelResults);
+
+		ChaosSolverIslandBatching = 0;
+		const FResults PerIslandResults = Run(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		Log(TEXT("Parallel color batches, one solver task per island"), PerIslandResults);
+		ChaosSolverIslandBatching = 1;
+
+		ConstraintColorDeterministic = 1;
+		const FResults DeterministicResults = Run(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		const FResults DeterministicRepeatResults = Run(NumStacks, StackHeight, NumPileBoxes, NumSteps);
+		Log(TEXT("Parallel color batches, deterministic coloring"), DeterministicResults);
+
+		ConstraintColorBatchMinParallelSize = PrevMinParallelSize;
+		ConstraintColorDeterministic = PrevDeterministic;
+		ChaosSolverIslandBatching = PrevIslandBatching;
+
+		FReal MaxRepeatDifference = 0;
+		for (int32 Index = 0; Index < FMath::Min(DeterministicResults.FinalPositions.Num(), DeterministicRepeatResults.FinalPositions.Num()); ++Index)
+		{
+			MaxRepeatDifference = FMath::Max(MaxRepeatDifference, (DeterministicResults.FinalPositions[Index] - DeterministicRepeatResults.FinalPositions[Index]).Size());
+		}
+
+		UE_LOG(LogChaos, Log, TEXT("Parallel speedup %.2fx, island batching speedup %.2fx, deterministic coloring overhead %.2fx, max difference between deterministic runs %f"),
+			SerialResults.SecondsPerStep / FMath::Max(ParallelResults.SecondsPerStep, (double)SMALL_NUMBER),
+			PerIslandResults.SecondsPerStep / FMath::Max(ParallelResults.SecondsPerStep, (double)SMALL_NUMBER),
+			DeterministicResults.SecondsPerStep / FMath::Max(ParallelResults.SecondsPerStep, (double)SMALL_NUMBER),
+			MaxRepeatDifference);
+	}
+
+	namespace SleepingParticlesPerfTest
+	{
+		struct FResults
+		{
+			int32 NumActive = 0;
+			double SecondsPerStep = 0;
+			double SecondsPerActiveIteration = 0;
+			int32 ActiveCacheLines = 0;
+			double WakeSeconds = 0;
+			double SleepSeconds = 0;
+		};
+
+		/** Distinct cache lines holding the position and velocity of the particles, what iterating them reads at least */
+		int32 CountCacheLines(const TParticleView<TPBDRigidParticles<FReal, 3>>& View)
+		{
+			TSet<UPTRINT> CacheLines;
+			for (const auto& Particle : View)
+			{
+				CacheLines.Add(reinterpret_cast<UPTRINT>(&Particle.X()) / PLATFORM_CACHE_LINE_SIZE);
+				CacheLines.Add(reinterpret_cast<UPTRINT>(&Particle.V()) / PLATFORM_CACHE_LINE_SIZE);
+			}
+			return CacheLines.Num();
+		}
+
+		FResults Run(const int32 NumDebris, const int32 NumAwake, const int32 NumSteps)
+		{
+			const FReal Dt = (FReal)1 / 60;
+			const FReal DebrisMass = 10;
+			const FVec3 DebrisHalfExtents(10);
+			const FReal DebrisSpacing = 40;
+			const int32 NumIterationPasses = 100;
+
+			// Geometries outlive the particles referencing them
+			TArray<TUniquePtr<FImplicitObject>> Geometries;
+			TPBDRigidsSOAs<FReal, 3> Particles;
+			FPBDRigidsEvolutionGBF Evolution(Particles);
+
+			const auto CreateDebris = [&Evolution, &Geometries, DebrisMass, &DebrisHalfExtents](const FVec3& X, const bool bStartSleeping)
+			{
+				TPBDRigidParticleParameters<FReal, 3> Params;
+				Params.bStartSleeping = bStartSleeping;
+				TPBDRigidParticleHandle<FReal, 3>* Debris = Evolution.CreateDynamicParticles(1, nullptr, Params)[0];
+				PerfTestUtilities::InitDynamicBoxParticle(Debris, X, DebrisHalfExtents, DebrisMass, Geometries);
+				return Debris;
+			};
+
+			// Ground with its top at Z = 0
+			PerfTestUtilities::InitBoxParticle(Evolution.CreateStaticParticles(1)[0], FVec3(0, 0, -50), FVec3(100000, 100000, 50), Geometries);
+
+			// Settled debris resting apart on the ground, the awake pieces fall from above on a separate part of the ground,
+			// created interleaved like the pieces of a fracture that only partly settled
+			const int32 NumPieces = NumDebris + NumAwake;
+			const int32 DebrisSide = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)NumDebris)), 1);
+			const int32 AwakeSide = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)NumAwake)), 1);
+			TArray<TGeometryParticleHandle<FReal, 3>*> SleepingDebris;
+			int32 DebrisIndex = 0;
+			int32 AwakeIndex = 0;
+			for (int32 PieceIndex = 0; PieceIndex < NumPieces; ++PieceIndex)
+			{
+				if (AwakeIndex < NumAwake && (DebrisIndex == NumDebris || (int64)PieceIndex * NumAwake >= (int64)AwakeIndex * NumPieces))
+				{
+					CreateDebris(FVec3((AwakeIndex % AwakeSide) * DebrisSpacing, -(1 + AwakeIndex / AwakeSide) * DebrisSpacing, 200), false);
+					++AwakeIndex;
+				}
+				else
+				{
+					SleepingDebris.Add(CreateDebris(FVec3((DebrisIndex % DebrisSide) * DebrisSpacing, (DebrisIndex / DebrisSide) * DebrisSpacing, DebrisHalfExtents.Z), true));
+					++DebrisIndex;
+				}
+			}
+
+			FResults Results;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Step = 0; Step < NumSteps; ++Step)
+			{
+				Evolution.AdvanceOneTimeStep(Dt);
+			}
+			Results.SecondsPerStep = (FPlatformTime::Seconds() - StartTime) / FMath::Max(NumSteps, 1);
+
+			// What the per particle passes of a step read for the awake particles
+			const TParticleView<TPBDRigidParticles<FReal, 3>>& ActiveParticles = Particles.GetActiveParticlesView();
+			Results.NumActive = ActiveParticles.Num();
+			Results.ActiveCacheLines = CountCacheLines(ActiveParticles);
+			FVec3 Sum(0);
+			const double IterationStartTime = FPlatformTime::Seconds();
+			for (int32 Pass = 0; Pass < NumIterationPasses; ++Pass)
+			{
+				for (const auto& Particle : ActiveParticles)
+				{
+					Sum += Particle.X() + Particle.V() * Dt;
+				}
+			}
+			Results.SecondsPerActiveIteration = (FPlatformTime::Seconds() - IterationStartTime) / NumIterationPasses;
+			UE_LOG(LogChaos, VeryVerbose, TEXT("Active particles checksum %s"), *Sum.ToString());
+
+			// The whole debris field woken up, by an explosion say, and put back to sleep
+			const double WakeStartTime = FPlatformTime::Seconds();
+			Particles.ActivateParticles(SleepingDebris);
+			Results.WakeSeconds = FPlatformTime::Seconds() - WakeStartTime;
+
+			const double SleepStartTime = FPlatformTime::Seconds();
+			Particles.DeactivateParticles(SleepingDebris);
+			Results.SleepSeconds = FPlatformTime::Seconds() - SleepStartTime;
+
+			return Results;
+		}
+
+		void Log(const TCHAR* Name, const FResults& Results)
+		{
+			UE_LOG(LogChaos, Log, TEXT("%s: %.3f ms/step, %d active particles iterated in %.1f us over %d cache lines, debris woken up in %.3f ms and put to sleep in %.3f ms"),
+				Name, Results.SecondsPerStep * 1000.0, Results.NumActive, Results.SecondsPerActiveIteration * 1000000.0, Results.ActiveCacheLines, Results.WakeSeconds * 1000.0, Results.SleepSeconds * 1000.0);
+		}
+
+		void SleepingParticlesPerfTestCommand(const TArray<FString>& Args)
+		{
+			const int32 NumDebris = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 20000;
+			const int32 NumAwake = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 0) : 500;
+			const int32 NumSteps = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 60;
+			RunSleepingParticlesPerfTest(NumDebris, NumAwake, NumSteps);
+		}
+
+#if !UE_BUILD_SHIPPING
+		static FAutoConsoleCommand SleepingParticlesPerfTestConsoleCommand(
+			TEXT("p.Chaos.SleepingParticlesPerfTest"),
+			TEXT("Simulates a few falling pieces among many settled debris pieces with and without sleeping particles kept apart from the awake ones, logs step time, awake particle iteration time and cache lines, and wake up time.\n")
+			TEXT("Args: [NumDebris] [NumAwake] [NumSteps]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&SleepingParticlesPerfTestCommand));
+#endif
+	}
+
+	void RunSleepingParticlesPerfTest(const int32 NumDebris, const int32 NumAwake, const int32 NumSteps)
+	{
+		using namespace SleepingParticlesPerfTest;
+
+		const int32 PrevSleepingColdStorage = Chaos_Particles_SleepingColdStorage;
+
+		UE_LOG(LogChaos, Log, TEXT("Sleeping particles perf test: %d settled debris pieces, %d awake pieces, %d steps"), NumDebris, NumAwake, NumSteps);
+
+		Chaos_Particles_SleepingColdStorage = 0;
+		const FResults SharedResults = Run(NumDebris, NumAwake, NumSteps);
+		Log(TEXT("Sleeping particles with the awake ones"), SharedResults);
+
+		Chaos_Particles_SleepingColdStorage = 1;
+		const FResults ColdResults = Run(NumDebris, NumAwake, NumSteps);
+		Log(TEXT("Sleeping particles apart"), ColdResults);
+
+		Chaos_Particles_SleepingColdStorage = PrevSleepingColdStorage;
+
+		UE_LOG(LogChaos, Log, TEXT("Step speedup %.2fx, awake particle iteration speedup %.2fx, awake particle cache lines %.2fx fewer"),
+			SharedResults.SecondsPerStep / FMath::Max(ColdResults.SecondsPerStep, (double)SMALL_NUMBER),
+			SharedResults.SecondsPerActiveIteration / FMath::Max(ColdResults.SecondsPerActiveIteration, (double)SMALL_NUMBER),
+			(double)SharedResults.ActiveCacheLines / FMath::Max(ColdResults.ActiveCacheLines, 1));
+	}
+}
 #endif
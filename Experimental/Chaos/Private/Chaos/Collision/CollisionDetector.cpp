@@ -10,6 +10,7 @@ namespace Chaos
 	DEFINE_STAT(STAT_Collisions_BroadPhase);
 	DEFINE_STAT(STAT_Collisions_SpatialBroadPhase);
 	DEFINE_STAT(STAT_Collisions_Filtering);
+	DEFINE_STAT(STAT_Collisions_SweepAndPrune);
 #if CHAOS_ENABLE_STAT_NARROWPHASE
 	DEFINE_STAT(STAT_Collisions_NarrowPhase);
 #endif
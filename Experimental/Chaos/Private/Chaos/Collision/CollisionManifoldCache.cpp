@@ -0,0 +1,291 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#include "Chaos/Collision/CollisionManifoldCache.h"
+#include "Chaos/CollisionResolution.h"
+#include "Chaos/ParticleHandle.h"
+#include "ChaosStats.h"
+#include "HAL/IConsoleManager.h"
+
+namespace Chaos
+{
+	extern int32 Chaos_Collision_UseAccumulatedImpulseClipSolve;
+
+	int32 Chaos_Collision_ManifoldCache_Enabled = 1;
+	FAutoConsoleVariableRef CVarChaosCollisionManifoldCacheEnabled(TEXT("p.Chaos.Collision.ManifoldCache.Enabled"), Chaos_Collision_ManifoldCache_Enabled, TEXT("Reuse contacts of the previous frame for particle pairs that did not move relative to each other"));
+
+	float Chaos_Collision_ManifoldCache_PositionThreshold = 0.2f;
+	FAutoConsoleVariableRef CVarChaosCollisionManifoldCachePositionThreshold(TEXT("p.Chaos.Collision.ManifoldCache.PositionThreshold"), Chaos_Collision_ManifoldCache_PositionThreshold, TEXT("Relative translation (cm) of a particle pair since its contacts were generated, above which they get regenerated"));
+
+	float Chaos_Collision_ManifoldCache_RotationThreshold = 0.01f;
+	FAutoConsoleVariableRef CVarChaosCollisionManifoldCacheRotationThreshold(TEXT("p.Chaos.Collision.ManifoldCache.RotationThreshold"), Chaos_Collision_ManifoldCache_RotationThreshold, TEXT("Relative rotation (radians) of a particle pair since its contacts were generated, above which they get regenerated"));
+
+	float Chaos_Collision_ManifoldCache_WarmStartFactor = 1.0f;
+	FAutoConsoleVariableRef CVarChaosCollisionManifoldCacheWarmStartFactor(TEXT("p.Chaos.Collision.ManifoldCache.WarmStartFactor"), Chaos_Collision_ManifoldCache_WarmStartFactor, TEXT("Fraction of the previous frame accumulated impulse contacts start with. Only used by the accumulated impulse clip solve (p.Chaos.Collision.UseAccumulatedImpulseClipSolve)"));
+
+	DECLARE_DWORD_COUNTER_STAT(TEXT("ManifoldCache::Hits"), STAT_Collisions_ManifoldCacheHits, STATGROUP_ChaosCollision);
+	DECLARE_DWORD_COUNTER_STAT(TEXT("ManifoldCache::Misses"), STAT_Collisions_ManifoldCacheMisses, STATGROUP_ChaosCollision);
+	DECLARE_FLOAT_COUNTER_STAT(TEXT("ManifoldCache::HitRate (%)"), STAT_Collisions_ManifoldCacheHitRate, STATGROUP_ChaosCollision);
+	DECLARE_FLOAT_COUNTER_STAT(TEXT("ManifoldCache::NarrowPhaseTimeSaved (ms)"), STAT_Collisions_ManifoldCacheTimeSaved, STATGROUP_ChaosCollision);
+
+	namespace ManifoldCacheHelpers
+	{
+		template<typename T_CONSTRAINTS>
+		void SetManifoldRelativeTransforms(T_CONSTRAINTS& Constraints, const TGeometryParticleHandle<FReal, 3>* Particle0, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1)
+		{
+			for (FCollisionConstraintBase& Constraint : Constraints)
+			{
+				Constraint.ManifoldRelativeTransform = (Constraint.Particle[0] == Particle0) ? Transform1.GetRelativeTransform(Transform0) : Transform0.GetRelativeTransform(Transform1);
+			}
+		}
+	}
+
+	FCollisionManifoldCache::FCollisionManifoldCache()
+		: bEnabled(false)
+		, NumHits(0)
+		, NumMisses(0)
+		, NumTouchingMisses(0)
+		, HitCycles(0)
+		, MissCycles(0)
+		, TouchingMissCycles(0)
+		, AverageTouchingMissSeconds(0)
+	{
+	}
+
+	void FCollisionManifoldCache::Build(TArray<FRigidBodyPointContactConstraint>& InOutPointConstraints, const TArray<FRigidBodySweptPointContactConstraint>& SweptPointConstraints, TArray<FRigidBodyMultiPointContactConstraint>& InOutMultiPointConstraints)
+	{
+		Reset();
+
+		bEnabled = (Chaos_Collision_ManifoldCache_Enabled != 0);
+		if (bEnabled)
+		{
+			Swap(PointConstraints, InOutPointConstraints);
+			Swap(MultiPointConstraints, InOutMultiPointConstraints);
+
+			NextPointConstraint.SetNumUninitialized(PointConstraints.Num());
+			for (int32 ConstraintIndex = 0; ConstraintIndex < PointConstraints.Num(); ++ConstraintIndex)
+			{
+				FEntry& Entry = FindOrAddEntry(PointConstraints[ConstraintIndex]);
+				NextPointConstraint[ConstraintIndex] = Entry.FirstPointConstraint;
+				Entry.FirstPointConstraint = ConstraintIndex;
+			}
+
+			NextMultiPointConstraint.SetNumUninitialized(MultiPointConstraints.Num());
+			for (int32 ConstraintIndex = 0; ConstraintIndex < MultiPointConstraints.Num(); ++ConstraintIndex)
+			{
+				FEntry& Entry = FindOrAddEntry(MultiPointConstraints[ConstraintIndex]);
+				NextMultiPointConstraint[ConstraintIndex] = Entry.FirstMultiPointConstraint;
+				Entry.FirstMultiPointConstraint = ConstraintIndex;
+			}
+
+			for (const FRigidBodySweptPointContactConstraint& Constraint : SweptPointConstraints)
+			{
+				FindOrAddEntry(Constraint).bCanRestore = false;
+			}
+		}
+
+		InOutPointConstraints.Reset();
+		InOutMultiPointConstraints.Reset();
+	}
+
+	void FCollisionManifoldCache::Reset()
+	{
+		Entries.Reset();
+		PointConstraints.Reset();
+		MultiPointConstraints.Reset();
+		NextPointConstraint.Reset();
+		NextMultiPointConstraint.Reset();
+	}
+
+	FCollisionManifoldCache::FEntry& FCollisionManifoldCache::FindOrAddEntry(const FCollisionConstraintBase& Constraint)
+	{
+		const FKey Key = MakeKey(Constraint.Particle[0], Constraint.Particle[1]);
+		if (FEntry* Entry = Entries.Find(Key))
+		{
+			return *Entry;
+		}
+
+		FEntry& Entry = Entries.Add(Key);
+		Entry.Geometry[0] = Key.Key->Geometry().Get();
+		Entry.Geometry[1] = Key.Value->Geometry().Get();
+		return Entry;
+	}
+
+	FReal FCollisionManifoldCache::GetWarmStartFactor() const
+	{
+		// Other solves do not clip against the accumulated impulse, so they could not correct a starting impulse
+		return Chaos_Collision_UseAccumulatedImpulseClipSolve ? FMath::Clamp(Chaos_Collision_ManifoldCache_WarmStartFactor, 0.0f, 1.0f) : (FReal)0;
+	}
+
+	bool FCollisionManifoldCache::RestoreConstraints(FCollisionConstraintsArray& NewConstraints, FGeometryParticleHandle* Particle0, FGeometryParticleHandle* Particle1, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1, const FReal CullDistance) const
+	{
+		if (!bEnabled)
+		{
+			return false;
+		}
+
+		const FKey Key = MakeKey(Particle0, Particle1);
+		const FEntry* Entry = Entries.Find(Key);
+		if (!Entry || !Entry->bCanRestore)
+		{
+			return false;
+		}
+
+		if ((Entry->Geometry[0] != Key.Key->Geometry().Get()) || (Entry->Geometry[1] != Key.Value->Geometry().Get()))
+		{
+			return false;
+		}
+
+		// All contacts of a pair are generated together, the first one tells how far the pair moved since
+		const FCollisionConstraintBase& FirstConstraint = (Entry->FirstPointConstraint != INDEX_NONE) ? (const FCollisionConstraintBase&)PointConstraints[Entry->FirstPointConstraint] : (const FCollisionConstraintBase&)MultiPointConstraints[Entry->FirstMultiPointConstraint];
+		const bool bFirstSwapped = (FirstConstraint.Particle[0] != Particle0);
+		const FRigidTransform3 RelativeTransform = bFirstSwapped ? Transform0.GetRelativeTransform(Transform1) : Transform1.GetRelativeTransform(Transform0);
+
+		const FVec3 DeltaTranslation = RelativeTransform.GetTranslation() - FirstConstraint.ManifoldRelativeTransform.GetTranslation();
+		if (DeltaTranslation.SizeSquared() > FMath::Square(Chaos_Collision_ManifoldCache_PositionThreshold))
+		{
+			return false;
+		}
+		if (RelativeTransform.GetRotation().AngularDistance(FirstConstraint.ManifoldRelativeTransform.GetRotation()) > Chaos_Collision_ManifoldCache_RotationThreshold)
+		{
+			return false;
+		}
+
+		const FReal WarmStartFactor = GetWarmStartFactor();
+
+		for (int32 ConstraintIndex = Entry->FirstPointConstraint; ConstraintIndex != INDEX_NONE; ConstraintIndex = NextPointConstraint[ConstraintIndex])
+		{
+			FRigidBodyPointContactConstraint Constraint = PointConstraints[ConstraintIndex];
+			Constraint.ConstraintHandle = nullptr;
+			Constraint.AccumulatedImpulse *= WarmStartFactor;
+
+			const bool bSwapped = (Constraint.Particle[0] != Particle0);
+			Constraint.ResetPhi(CullDistance);
+			Collisions::UpdateConstraintFromGeometry<ECollisionUpdateType::Deepest>(Constraint, bSwapped ? Transform1 : Transform0, bSwapped ? Transform0 : Transform1, CullDistance);
+			NewConstraints.TryAdd(CullDistance, Constraint);
+		}
+
+		for (int32 ConstraintIndex = Entry->FirstMultiPointConstraint; ConstraintIndex != INDEX_NONE; ConstraintIndex = NextMultiPointConstraint[ConstraintIndex])
+		{
+			FRigidBodyMultiPointContactConstraint Constraint = MultiPointConstraints[ConstraintIndex];
+			Constraint.ConstraintHandle = nullptr;
+			Constraint.AccumulatedImpulse *= WarmStartFactor;
+
+			// The manifold is in shape space and still valid at this pose, only select its best point
+			const bool bSwapped = (Constraint.Particle[0] != Particle0);
+			Constraint.ResetPhi(CullDistance);
+			Collisions::UpdateConstraintFromManifold(Constraint, bSwapped ? Transform1 : Transform0, bSwapped ? Transform0 : Transform1, CullDistance);
+			NewConstraints.TryAdd(CullDistance, Constraint);
+		}
+
+		return true;
+	}
+
+	const FCollisionConstraintBase* FCollisionManifoldCache::FindCachedConstraint(const FEntry& Entry, const FCollisionConstraintBase& Constraint) const
+	{
+		if (Constraint.GetType() == FCollisionConstraintBase::FType::SinglePoint)
+		{
+			for (int32 ConstraintIndex = Entry.FirstPointConstraint; ConstraintIndex != INDEX_NONE; ConstraintIndex = NextPointConstraint[ConstraintIndex])
+			{
+				const FRigidBodyPointContactConstraint& CachedConstraint = PointConstraints[ConstraintIndex];
+				if ((CachedConstraint.Particle[0] == Constraint.Particle[0]) && CachedConstraint.ContainsManifold(Constraint.Manifold.Implicit[0], Constraint.Manifold.Implicit[1]))
+				{
+					return &CachedConstraint;
+				}
+			}
+		}
+		else if (Constraint.GetType() == FCollisionConstraintBase::FType::MultiPoint)
+		{
+			for (int32 ConstraintIndex = Entry.FirstMultiPointConstraint; ConstraintIndex != INDEX_NONE; ConstraintIndex = NextMultiPointConstraint[ConstraintIndex])
+			{
+				const FRigidBodyMultiPointContactConstraint& CachedConstraint = MultiPointConstraints[ConstraintIndex];
+				if ((CachedConstraint.Particle[0] == Constraint.Particle[0]) && CachedConstraint.ContainsManifold(Constraint.Manifold.Implicit[0], Constraint.Manifold.Implicit[1]))
+				{
+					return &CachedConstraint;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	void FCollisionManifoldCache::WarmStartConstraints(FCollisionConstraintsArray& NewConstraints, const FGeometryParticleHandle* Particle0, const FGeometryParticleHandle* Particle1) const
+	{
+		if (!bEnabled || (NewConstraints.Num() == 0))
+		{
+			return;
+		}
+
+		const FReal WarmStartFactor = GetWarmStartFactor();
+		if (WarmStartFactor == 0)
+		{
+			return;
+		}
+
+		const FEntry* Entry = Entries.Find(MakeKey(Particle0, Particle1));
+		if (!Entry)
+		{
+			return;
+		}
+
+		// Swept contacts are not warm started, their first iteration is split at the time of impact
+		for (FRigidBodyPointContactConstraint& Constraint : NewConstraints.SinglePointConstraints)
+		{
+			if (const FCollisionConstraintBase* CachedConstraint = FindCachedConstraint(*Entry, Constraint))
+			{
+				Constraint.AccumulatedImpulse = CachedConstraint->AccumulatedImpulse * WarmStartFactor;
+			}
+		}
+		for (FRigidBodyMultiPointContactConstraint& Constraint : NewConstraints.MultiPointConstraints)
+		{
+			if (const FCollisionConstraintBase* CachedConstraint = FindCachedConstraint(*Entry, Constraint))
+			{
+				Constraint.AccumulatedImpulse = CachedConstraint->AccumulatedImpulse * WarmStartFactor;
+			}
+		}
+	}
+
+	void FCollisionManifoldCache::SetManifoldRelativeTransforms(FCollisionConstraintsArray& NewConstraints, const FGeometryParticleHandle* Particle0, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1)
+	{
+		ManifoldCacheHelpers::SetManifoldRelativeTransforms(NewConstraints.SinglePointConstraints, Particle0, Transform0, Transform1);
+		ManifoldCacheHelpers::SetManifoldRelativeTransforms(NewConstraints.SinglePointSweptConstraints, Particle0, Transform0, Transform1);
+		ManifoldCacheHelpers::SetManifoldRelativeTransforms(NewConstraints.MultiPointConstraints, Particle0, Transform0, Transform1);
+	}
+
+	void FCollisionManifoldCache::RecordMiss(uint32 Cycles, bool bGeneratedConstraints)
+	{
+		NumMisses++;
+		MissCycles += Cycles;
+		if (bGeneratedConstraints)
+		{
+			NumTouchingMisses++;
+			TouchingMissCycles += Cycles;
+		}
+	}
+
+	void FCollisionManifoldCache::FinalizeStats()
+	{
+		Stats.NumHits = NumHits.Load();
+		Stats.NumMisses = NumMisses.Load();
+		Stats.HitSeconds = FPlatformTime::ToSeconds64(HitCycles.Load());
+		Stats.MissSeconds = FPlatformTime::ToSeconds64(MissCycles.Load());
+
+		// Hits replace misses that would have generated contacts, compare against those rather than against all misses
+		const int32 FrameTouchingMisses = NumTouchingMisses.Load();
+		if (FrameTouchingMisses > 0)
+		{
+			const double FrameTouchingMissSeconds = FPlatformTime::ToSeconds64(TouchingMissCycles.Load()) / FrameTouchingMisses;
+			AverageTouchingMissSeconds = (AverageTouchingMissSeconds > 0) ? FMath::Lerp(AverageTouchingMissSeconds, FrameTouchingMissSeconds, 0.1) : FrameTouchingMissSeconds;
+		}
+		Stats.SavedSeconds = FMath::Max(0.0, Stats.NumHits * AverageTouchingMissSeconds - Stats.HitSeconds);
+
+		SET_DWORD_STAT(STAT_Collisions_ManifoldCacheHits, Stats.NumHits);
+		SET_DWORD_STAT(STAT_Collisions_ManifoldCacheMisses, Stats.NumMisses);
+		SET_FLOAT_STAT(STAT_Collisions_ManifoldCacheHitRate, Stats.GetHitRate() * 100.0f);
+		SET_FLOAT_STAT(STAT_Collisions_ManifoldCacheTimeSaved, Stats.SavedSeconds * 1000.0);
+
+		NumHits = 0;
+		NumMisses = 0;
+		NumTouchingMisses = 0;
+		HitCycles = 0;
+		MissCycles = 0;
+		TouchingMissCycles = 0;
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/Collision/NarrowPhase.h"
+#include "Chaos/Collision/CollisionContext.h"
+#include "Chaos/Convex.h"
+#include "Chaos/GJK.h"
+#include "ChaosLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace Chaos
+{
+	int32 Chaos_Collision_BatchedNarrowPhase = 1;
+	FAutoConsoleVariableRef CVarChaosCollisionBatchedNarrowPhase(TEXT("p.Chaos.Collision.BatchedNarrowPhase"), Chaos_Collision_BatchedNarrowPhase, TEXT("Whether the narrow phase sorts the pairs of a particle by shape types and runs the GJK of convex pairs in batches."));
+
+#if !UE_BUILD_SHIPPING
+	namespace NarrowPhaseBenchmark
+	{
+		/** Counts the contacts it receives, and sums their depths so that two runs can be compared */
+		struct FCountingReceiver
+		{
+			int32 NumConstraints = 0;
+			double SumPhi = 0;
+
+			void ReceiveCollisions(const FCollisionConstraintsArray& Constraints)
+			{
+				NumConstraints += Constraints.Num();
+				for (const FRigidBodyPointContactConstraint& Constraint : Constraints.SinglePointConstraints)
+				{
+					SumPhi += Constraint.GetPhi();
+				}
+				for (const FRigidBodyMultiPointContactConstraint& Constraint : Constraints.MultiPointConstraints)
+				{
+					SumPhi += Constraint.GetPhi();
+				}
+			}
+		};
+
+		TUniquePtr<FConvex> MakeRandomConvex(FRandomStream& RandomStream, const int32 NumVertices, const FReal Radius)
+		{
+			TParticles<FReal, 3> Points;
+			Points.AddParticles(NumVertices);
+			for (int32 Idx = 0; Idx < NumVertices; ++Idx)
+			{
+				Points.X(Idx) = FVec3(RandomStream.GetUnitVector()) * Radius * RandomStream.FRandRange(0.8f, 1.f);
+			}
+			return MakeUnique<FConvex>(Points);
+		}
+
+		void NarrowPhaseBenchmark(const TArray<FString>& Args)
+		{
+			const int32 NumPairs = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+			const int32 NumVertices = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 4) : 32;
+			const int32 NumHulls = 16;
+			const FReal Radius = 50;
+
+			FRandomStream RandomStream(42);
+			TArray<TUniquePtr<FImplicitObject>> Hulls;
+			for (int32 HullIndex = 0; HullIndex < NumHulls; ++HullIndex)
+			{
+				Hulls.Add(MakeRandomConvex(RandomStream, NumVertices, Radius));
+			}
+
+			// pairs from deeply overlapping to a little apart, like the pairs of a pile
+			TArray<FRigidTransform3> Transforms;
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				Transforms.Add(FRigidTransform3(FVec3(0), FRotation3::FromIdentity()));
+				Transforms.Add(FRigidTransform3(FVec3(RandomStream.GetUnitVector()) * RandomStream.FRandRange(1.2f * Radius, 2.2f * Radius), FRotation3(FQuat(FVector(RandomStream.GetUnitVector()), RandomStream.FRandRange(0, PI)))));
+			}
+			const auto GetHull = [&Hulls](const int32 PairIndex, const int32 Side) -> const FConvex&
+			{
+				return *Hulls[(PairIndex * 2 + Side) % Hulls.Num()]->GetObject<FConvex>();
+			};
+
+			// Support mapping: one vertex at a time against four at a time
+			int32 NumSupportMismatches = 0;
+			double ScalarSupportSeconds = 0;
+			double SIMDSupportSeconds = 0;
+			{
+				TArray<FVec3> Directions;
+				for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+				{
+					Directions.Add(RandomStream.GetUnitVector());
+				}
+
+				int32 Checksum = 0;
+				double StartTime = FPlatformTime::Seconds();
+				for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+				{
+					Checksum += GetHull(PairIndex, 0).GetSupportVertexScalar(Directions[PairIndex]);
+				}
+				ScalarSupportSeconds = FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+				{
+					Checksum -= GetHull(PairIndex, 0).GetSupportVertexSIMD(Directions[PairIndex]);
+				}
+				SIMDSupportSeconds = FPlatformTime::Seconds() - StartTime;
+				UE_LOG(LogChaos, Verbose, TEXT("Support checksum %d"), Checksum);
+
+				for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+				{
+					const FConvex& Hull = GetHull(PairIndex, 0);
+					NumSupportMismatches += (Hull.GetSupportVertexScalar(Directions[PairIndex]) != Hull.GetSupportVertexSIMD(Directions[PairIndex])) ? 1 : 0;
+				}
+			}
+
+			// GJK: one pair at a time against batches
+			using FQuery = TGJKPenetrationQuery<FReal, FConvex, FConvex>;
+			TArray<FQuery> Queries;
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				Queries.Add(FQuery{ &GetHull(PairIndex, 0), &GetHull(PairIndex, 1), Transforms[PairIndex * 2 + 1].GetRelativeTransform(Transforms[PairIndex * 2]) });
+			}
+
+			TArray<TGJKPenetrationResult<FReal>> SequentialResults;
+			TArray<TGJKPenetrationResult<FReal>> BatchResults;
+			SequentialResults.SetNumZeroed(NumPairs);
+			BatchResults.SetNumZeroed(NumPairs);
+
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				TGJKPenetrationResult<FReal>& Result = SequentialResults[PairIndex];
+				Result.bResult = GJKPenetration<true>(*Queries[PairIndex].A, *Queries[PairIndex].B, Queries[PairIndex].BToATM, Result.Penetration, Result.ClosestA, Result.ClosestB, Result.Normal, (FReal)0, FVec3(1, 0, 0), (FReal)0, &Result.NumIterations);
+			}
+			const double SequentialGJKSeconds = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			GJKPenetrationBatch<true>(TArrayView<const FQuery>(Queries), TArrayView<TGJKPenetrationResult<FReal>>(BatchResults));
+			const double BatchGJKSeconds = FPlatformTime::Seconds() - StartTime;
+
+			int32 NumGJKMismatches = 0;
+			int32 NumPenetrating = 0;
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				const TGJKPenetrationResult<FReal>& Sequential = SequentialResults[PairIndex];
+				const TGJKPenetrationResult<FReal>& Batch = BatchResults[PairIndex];
+				NumGJKMismatches += (Sequential.bResult != Batch.bResult || Sequential.Penetration != Batch.Penetration || Sequential.Normal != Batch.Normal) ? 1 : 0;
+				NumPenetrating += (Sequential.bResult && Sequential.Penetration > 0) ? 1 : 0;
+			}
+
+			// Narrow phase: the particles of a pile of convexes, per pair against sorted and batched
+			TPBDRigidsSOAs<FReal, 3> Particles;
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> Dynamics = Particles.CreateDynamicParticles(NumPairs * 2);
+			TArray<FNarrowPhasePair> Pairs;
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				for (int32 Side = 0; Side < 2; ++Side)
+				{
+					TPBDRigidParticleHandle<FReal, 3>* Particle = Dynamics[PairIndex * 2 + Side];
+					const FRigidTransform3& Transform = Transforms[PairIndex * 2 + Side];
+					Particle->SetX(Transform.GetTranslation());
+					Particle->SetP(Transform.GetTranslation());
+					Particle->SetR(Transform.GetRotation());
+					Particle->SetQ(Transform.GetRotation());
+					Particle->SetGeometry(MakeSerializable(Hulls[(PairIndex * 2 + Side) % Hulls.Num()]));
+				}
+				Pairs.Add(FNarrowPhasePair{ Dynamics[PairIndex * 2], Dynamics[PairIndex * 2 + 1], 0 });
+			}
+
+			FCollisionContext Context;
+			Context.bFilteringEnabled = false;
+			FNarrowPhase NarrowPhase(Context);
+			CollisionStats::FStatData StatData(false);
+
+			const int32 SavedBatchedNarrowPhase = Chaos_Collision_BatchedNarrowPhase;
+			FCountingReceiver PerPairReceiver;
+			FCountingReceiver BatchedReceiver;
+
+			Chaos_Collision_BatchedNarrowPhase = 0;
+			StartTime = FPlatformTime::Seconds();
+			NarrowPhase.GenerateCollisions(TArrayView<const FNarrowPhasePair>(Pairs), 0, PerPairReceiver, StatData);
+			const double PerPairSeconds = FPlatformTime::Seconds() - StartTime;
+
+			Chaos_Collision_BatchedNarrowPhase = 1;
+			StartTime = FPlatformTime::Seconds();
+			NarrowPhase.GenerateCollisions(TArrayView<const FNarrowPhasePair>(Pairs), 0, BatchedReceiver, StatData);
+			const double BatchedSeconds = FPlatformTime::Seconds() - StartTime;
+
+			Chaos_Collision_BatchedNarrowPhase = SavedBatchedNarrowPhase;
+
+			UE_LOG(LogChaos, Log, TEXT("Narrow phase benchmark: %d convex pairs (%d penetrating), %d vertices per hull"), NumPairs, NumPenetrating, NumVertices);
+			UE_LOG(LogChaos, Log, TEXT("  Support: scalar %.3f ms, SIMD %.3f ms"), ScalarSupportSeconds * 1000.0, SIMDSupportSeconds * 1000.0);
+			UE_LOG(LogChaos, Log, TEXT("  GJKPenetration: sequential %.3f ms, batches of %d %.3f ms"), SequentialGJKSeconds * 1000.0, GJKBatchWidth, BatchGJKSeconds * 1000.0);
+			UE_LOG(LogChaos, Log, TEXT("  FNarrowPhase: per pair %.3f ms, sorted and batched %.3f ms, %d contacts"), PerPairSeconds * 1000.0, BatchedSeconds * 1000.0, BatchedReceiver.NumConstraints);
+
+			// the batched paths compute the same thing in another order, any difference is a bug
+			if (NumSupportMismatches > 0 || NumGJKMismatches > 0)
+			{
+				UE_LOG(LogChaos, Warning, TEXT("SIMD support differs on %d directions, batched GJK differs on %d pairs"), NumSupportMismatches, NumGJKMismatches);
+			}
+			if (PerPairReceiver.NumConstraints != BatchedReceiver.NumConstraints || PerPairReceiver.SumPhi != BatchedReceiver.SumPhi)
+			{
+				UE_LOG(LogChaos, Warning, TEXT("Batched narrow phase generated %d contacts (total phi %f), per pair %d (total phi %f)"), BatchedReceiver.NumConstraints, BatchedReceiver.SumPhi, PerPairReceiver.NumConstraints, PerPairReceiver.SumPhi);
+			}
+		}
+
+		static FAutoConsoleCommand NarrowPhaseBenchmarkCommand(
+			TEXT("p.Chaos.NarrowPhaseBenchmark"),
+			TEXT("Compares the scalar and SIMD convex support mapping, sequential and batched GJK, and per pair and batched narrow phase on random convex pairs.\n")
+			TEXT("Args: [NumPairs] [NumVertices]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&NarrowPhaseBenchmark));
+	}
+#endif
+}
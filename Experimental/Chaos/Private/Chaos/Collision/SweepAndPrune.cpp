@@ -0,0 +1,518 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/Collision/SweepAndPrune.h"
+#include "Chaos/AABBTree.h"
+#include "Chaos/PBDRigidsSOAs.h"
+#include "ChaosLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace Chaos
+{
+	int32 Chaos_BroadPhase_SweepAndPrune = 0;
+	FAutoConsoleVariableRef CVarChaosBroadPhaseSweepAndPrune(TEXT("p.Chaos.BroadPhase.SweepAndPrune"), Chaos_BroadPhase_SweepAndPrune, TEXT("Whether new solvers find overlapping pairs with an incremental sweep and prune instead of querying the spatial acceleration structure for every moving particle."));
+
+	FSweepAndPrune::FSweepAndPrune()
+		: UpdateStamp(0)
+		, NumNewProxies(0)
+		, NumRigidChanges(0)
+		, NumSwaps(0)
+		, bRebuilt(false)
+	{
+	}
+
+	void FSweepAndPrune::BeginUpdate()
+	{
+		UpdateStamp++;
+		NumNewProxies = 0;
+		NumRigidChanges = 0;
+		NumSwaps = 0;
+		bRebuilt = false;
+		AddedPairs.Reset();
+		AddedPairKeys.Reset();
+		RemovedPairs.Reset();
+		RemovedPairKeys.Reset();
+	}
+
+	void FSweepAndPrune::UpdateProxy(FParticleHandle* Particle, const TAABB<FReal, 3>& Bounds, const bool bIsRigid)
+	{
+		if (const int32* ExistingProxyIndex = ProxyIndices.Find(Particle))
+		{
+			FProxy& Proxy = Proxies[*ExistingProxyIndex];
+			Proxy.Bounds = Bounds;
+			Proxy.UpdateStamp = UpdateStamp;
+			if (Proxy.bIsRigid != bIsRigid)
+			{
+				// no endpoint swap tells which pairs this changes, EndUpdate sweeps from scratch
+				Proxy.bIsRigid = bIsRigid;
+				NumRigidChanges++;
+			}
+			return;
+		}
+
+		const int32 ProxyIndex = FreeProxies.Num() ? FreeProxies.Pop(false) : Proxies.AddUninitialized();
+		Proxies[ProxyIndex] = FProxy{ Particle, Bounds, UpdateStamp, bIsRigid };
+		ProxyIndices.Add(Particle, ProxyIndex);
+
+		// appended endpoints get sorted into place with the others in EndUpdate
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Endpoints[Axis].Emplace(Bounds.Min()[Axis], ProxyIndex, false);
+			Endpoints[Axis].Emplace(Bounds.Max()[Axis], ProxyIndex, true);
+		}
+		NumNewProxies++;
+	}
+
+	void FSweepAndPrune::EndUpdate()
+	{
+		RemoveStaleProxies();
+
+		// new endpoints travel across the whole arrays, past a few proxies sorting from scratch is cheaper
+		if (NumRigidChanges > 0 || NumNewProxies > FMath::Max(8, (int32)FMath::FloorLog2(FMath::Max(ProxyIndices.Num(), 1))))
+		{
+			Rebuild();
+			return;
+		}
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			for (FEndpoint& Endpoint : Endpoints[Axis])
+			{
+				const FProxy& Proxy = Proxies[Endpoint.GetProxyIndex()];
+				Endpoint.Value = Endpoint.IsMax() ? Proxy.Bounds.Max()[Axis] : Proxy.Bounds.Min()[Axis];
+			}
+			SortAxis(Axis);
+		}
+
+		CancelTransientPairs();
+	}
+
+	void FSweepAndPrune::Reset()
+	{
+		Proxies.Reset();
+		FreeProxies.Reset();
+		ProxyIndices.Reset();
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Endpoints[Axis].Reset();
+		}
+		Pairs.Reset();
+		PairKeys.Reset();
+		PairIndices.Reset();
+		AddedPairs.Reset();
+		AddedPairKeys.Reset();
+		RemovedPairs.Reset();
+		RemovedPairKeys.Reset();
+		NumNewProxies = 0;
+		NumRigidChanges = 0;
+		NumSwaps = 0;
+		bRebuilt = false;
+	}
+
+	SIZE_T FSweepAndPrune::GetAllocatedSize() const
+	{
+		SIZE_T Size = Proxies.GetAllocatedSize() + FreeProxies.GetAllocatedSize() + ProxyIndices.GetAllocatedSize();
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Size += Endpoints[Axis].GetAllocatedSize();
+		}
+		Size += Pairs.GetAllocatedSize() + PairKeys.GetAllocatedSize() + PairIndices.GetAllocatedSize();
+		Size += AddedPairs.GetAllocatedSize() + AddedPairKeys.GetAllocatedSize() + RemovedPairs.GetAllocatedSize() + RemovedPairKeys.GetAllocatedSize();
+		return Size;
+	}
+
+	void FSweepAndPrune::RemoveStaleProxies()
+	{
+		TBitArray<> IsStale;
+		int32 NumStale = 0;
+		for (int32 ProxyIndex = 0; ProxyIndex < Proxies.Num(); ProxyIndex++)
+		{
+			const bool bStale = Proxies[ProxyIndex].Particle && Proxies[ProxyIndex].UpdateStamp != UpdateStamp;
+			IsStale.Add(bStale);
+			NumStale += bStale ? 1 : 0;
+		}
+
+		if (NumStale == 0)
+		{
+			return;
+		}
+
+		// backwards so that pairs swapped into removed slots were visited already
+		for (int32 PairIndex = Pairs.Num() - 1; PairIndex >= 0; PairIndex--)
+		{
+			const uint64 Key = PairKeys[PairIndex];
+			if (IsStale[(int32)(Key >> 32)] || IsStale[(int32)(Key & 0xFFFFFFFF)])
+			{
+				RemovePairAt(PairIndex);
+			}
+		}
+
+		// stable removal keeps the arrays sorted
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Endpoints[Axis].RemoveAll([&IsStale](const FEndpoint& Endpoint) { return IsStale[Endpoint.GetProxyIndex()]; });
+		}
+
+		for (int32 ProxyIndex = 0; ProxyIndex < Proxies.Num(); ProxyIndex++)
+		{
+			if (IsStale[ProxyIndex])
+			{
+				ProxyIndices.Remove(Proxies[ProxyIndex].Particle);
+				Proxies[ProxyIndex].Particle = nullptr;
+				FreeProxies.Add(ProxyIndex);
+			}
+		}
+	}
+
+	void FSweepAndPrune::SortAxis(const int32 Axis)
+	{
+		// Every swap puts two endpoints in the order of their current values. A min moving below a max means the
+		// intervals now overlap on this axis, a max moving below a min means they are now apart. Overlap tests use the
+		// current bounds of all axes, so the pair set is right once all axes are sorted, whatever the order of the swaps.
+		TArray<FEndpoint>& AxisEndpoints = Endpoints[Axis];
+		for (int32 Index = 1; Index < AxisEndpoints.Num(); Index++)
+		{
+			const FEndpoint Endpoint = AxisEndpoints[Index];
+			int32 InsertIndex = Index;
+			while (InsertIndex > 0 && Endpoint < AxisEndpoints[InsertIndex - 1])
+			{
+				const FEndpoint& Other = AxisEndpoints[InsertIndex - 1];
+				if (!Endpoint.IsMax() && Other.IsMax())
+				{
+					if (CanOverlap(Endpoint.GetProxyIndex(), Other.GetProxyIndex()))
+					{
+						AddPair(Endpoint.GetProxyIndex(), Other.GetProxyIndex());
+					}
+				}
+				else if (Endpoint.IsMax() && !Other.IsMax())
+				{
+					RemovePair(Endpoint.GetProxyIndex(), Other.GetProxyIndex());
+				}
+
+				AxisEndpoints[InsertIndex] = Other;
+				InsertIndex--;
+			}
+			AxisEndpoints[InsertIndex] = Endpoint;
+			NumSwaps += Index - InsertIndex;
+		}
+	}
+
+	void FSweepAndPrune::Rebuild()
+	{
+		bRebuilt = true;
+
+		// sweep along the axis on which the proxies are spread the most, it has the fewest overlapping intervals
+		FVec3 CenterSum(0);
+		FVec3 CenterSquaredSum(0);
+		for (const FProxy& Proxy : Proxies)
+		{
+			if (Proxy.Particle)
+			{
+				const FVec3 Center = Proxy.Bounds.Center();
+				CenterSum += Center;
+				CenterSquaredSum += Center * Center;
+			}
+		}
+		const FReal NumProxies = (FReal)FMath::Max(ProxyIndices.Num(), 1);
+		const FVec3 Variance = CenterSquaredSum / NumProxies - (CenterSum / NumProxies) * (CenterSum / NumProxies);
+		const int32 SweepAxis = Variance.Max() == Variance[0] ? 0 : (Variance.Max() == Variance[1] ? 1 : 2);
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			for (FEndpoint& Endpoint : Endpoints[Axis])
+			{
+				const FProxy& Proxy = Proxies[Endpoint.GetProxyIndex()];
+				Endpoint.Value = Endpoint.IsMax() ? Proxy.Bounds.Max()[Axis] : Proxy.Bounds.Min()[Axis];
+			}
+			Endpoints[Axis].Sort();
+		}
+		NumSwaps = Endpoints[SweepAxis].Num();
+
+		TArray<uint64> NewPairKeys;
+		TArray<int32> ActiveProxies;
+		TArray<int32> ActivePositions;
+		ActivePositions.SetNumUninitialized(Proxies.Num());
+		for (const FEndpoint& Endpoint : Endpoints[SweepAxis])
+		{
+			const int32 ProxyIndex = Endpoint.GetProxyIndex();
+			if (Endpoint.IsMax())
+			{
+				const int32 Position = ActivePositions[ProxyIndex];
+				ActiveProxies.RemoveAtSwap(Position, 1, false);
+				if (Position < ActiveProxies.Num())
+				{
+					ActivePositions[ActiveProxies[Position]] = Position;
+				}
+			}
+			else
+			{
+				for (const int32 ActiveProxyIndex : ActiveProxies)
+				{
+					if (CanOverlap(ProxyIndex, ActiveProxyIndex))
+					{
+						NewPairKeys.Add(MakePairKey(ProxyIndex, ActiveProxyIndex));
+					}
+				}
+				ActivePositions[ProxyIndex] = ActiveProxies.Add(ProxyIndex);
+			}
+		}
+
+		// report the differences with the previous pairs, stale proxies were removed already so all keys refer to live proxies
+		NewPairKeys.Sort();
+		TArray<uint64> OldPairKeys = PairKeys;
+		OldPairKeys.Sort();
+
+		int32 OldIndex = 0;
+		int32 NewIndex = 0;
+		while (OldIndex < OldPairKeys.Num() || NewIndex < NewPairKeys.Num())
+		{
+			if (NewIndex == NewPairKeys.Num() || (OldIndex < OldPairKeys.Num() && OldPairKeys[OldIndex] < NewPairKeys[NewIndex]))
+			{
+				RemovedPairs.Add(MakePair(OldPairKeys[OldIndex]));
+				RemovedPairKeys.Add(OldPairKeys[OldIndex++]);
+			}
+			else if (OldIndex == OldPairKeys.Num() || NewPairKeys[NewIndex] < OldPairKeys[OldIndex])
+			{
+				AddedPairs.Add(MakePair(NewPairKeys[NewIndex]));
+				AddedPairKeys.Add(NewPairKeys[NewIndex++]);
+			}
+			else
+			{
+				OldIndex++;
+				NewIndex++;
+			}
+		}
+
+		PairKeys = MoveTemp(NewPairKeys);
+		Pairs.Reset(PairKeys.Num());
+		PairIndices.Reset();
+		for (const uint64 Key : PairKeys)
+		{
+			PairIndices.Add(Key, Pairs.Add(MakePair(Key)));
+		}
+	}
+
+	void FSweepAndPrune::AddPair(const int32 ProxyIndex0, const int32 ProxyIndex1)
+	{
+		// a pair can start overlapping on several axes in the same update
+		const uint64 Key = MakePairKey(ProxyIndex0, ProxyIndex1);
+		if (!PairIndices.Contains(Key))
+		{
+			const FOverlappingPair Pair = MakePair(Key);
+			PairIndices.Add(Key, Pairs.Add(Pair));
+			PairKeys.Add(Key);
+			AddedPairs.Add(Pair);
+			AddedPairKeys.Add(Key);
+		}
+	}
+
+	void FSweepAndPrune::RemovePair(const int32 ProxyIndex0, const int32 ProxyIndex1)
+	{
+		if (const int32* PairIndex = PairIndices.Find(MakePairKey(ProxyIndex0, ProxyIndex1)))
+		{
+			RemovePairAt(*PairIndex);
+		}
+	}
+
+	void FSweepAndPrune::RemovePairAt(const int32 PairIndex)
+	{
+		RemovedPairs.Add(Pairs[PairIndex]);
+		RemovedPairKeys.Add(PairKeys[PairIndex]);
+		PairIndices.Remove(PairKeys[PairIndex]);
+
+		Pairs.RemoveAtSwap(PairIndex, 1, false);
+		PairKeys.RemoveAtSwap(PairIndex, 1, false);
+		if (PairIndex < PairKeys.Num())
+		{
+			PairIndices[PairKeys[PairIndex]] = PairIndex;
+		}
+	}
+
+	void FSweepAndPrune::CancelTransientPairs()
+	{
+		// A pair can start and stop overlapping within an update (or the other way around) as its endpoints swap on
+		// several axes. Only the net change is reported, at most once per pair. Removed pairs keep the particles they
+		// were reported with, their proxies may be gone already.
+		if (AddedPairKeys.Num() == 0 || RemovedPairKeys.Num() == 0)
+		{
+			return;
+		}
+
+		TMap<uint64, int32> NetChanges;
+		for (const uint64 Key : AddedPairKeys)
+		{
+			NetChanges.FindOrAdd(Key)++;
+		}
+		for (const uint64 Key : RemovedPairKeys)
+		{
+			NetChanges.FindOrAdd(Key)--;
+		}
+
+		// reported entries are marked with twice their net change so that repeated ones are dropped
+		const auto FilterPairs = [&NetChanges](TArray<FOverlappingPair>& ReportedPairs, TArray<uint64>& ReportedKeys, const int32 KeptChange)
+		{
+			int32 NumKept = 0;
+			for (int32 Index = 0; Index < ReportedKeys.Num(); Index++)
+			{
+				int32& NetChange = NetChanges[ReportedKeys[Index]];
+				if (NetChange == KeptChange)
+				{
+					NetChange = 2 * KeptChange;
+					ReportedPairs[NumKept] = ReportedPairs[Index];
+					ReportedKeys[NumKept] = ReportedKeys[Index];
+					NumKept++;
+				}
+			}
+			ReportedPairs.SetNum(NumKept, false);
+			ReportedKeys.SetNum(NumKept, false);
+		};
+
+		FilterPairs(AddedPairs, AddedPairKeys, 1);
+		FilterPairs(RemovedPairs, RemovedPairKeys, -1);
+	}
+
+#if !UE_BUILD_SHIPPING
+	namespace SweepAndPruneBenchmark
+	{
+		/** Counts pairs with a dynamic body once, dynamics come after statics and only count bodies of lower index */
+		struct FPairCountingVisitor
+		{
+			int32 BodyIndex = 0;
+			int32 NumPairs = 0;
+
+			bool VisitOverlap(const TSpatialVisitorData<int32>& Instance)
+			{
+				NumPairs += (Instance.Payload < BodyIndex) ? 1 : 0;
+				return true;
+			}
+			bool VisitRaycast(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { return true; }
+			bool VisitSweep(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { return true; }
+			const void* GetQueryData() const { return nullptr; }
+		};
+
+		void SweepAndPruneBenchmark(const TArray<FString>& Args)
+		{
+			const int32 NumBodies = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 10000;
+			const int32 NumSteps = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100;
+			const int32 NumStatics = NumBodies / 10;
+			const int32 NumDynamics = NumBodies - NumStatics;
+			const FReal Dt = 1.f / 60.f;
+
+			TPBDRigidsSOAs<FReal, 3> Particles;
+			TArray<FSweepAndPrune::FParticleHandle*> Handles;
+			Handles.Reserve(NumBodies);
+			for (TGeometryParticleHandle<FReal, 3>* Handle : Particles.CreateStaticParticles(NumStatics))
+			{
+				Handles.Add(Handle);
+			}
+			for (TPBDRigidParticleHandle<FReal, 3>* Handle : Particles.CreateDynamicParticles(NumDynamics))
+			{
+				Handles.Add(Handle);
+			}
+
+			// statics over a large floor, dynamics in a slab above them moving a few centimeters per step
+			FRandomStream RandomStream(42);
+			const FReal WorldSize = 20000;
+			TArray<FVec3> Centers;
+			TArray<FVec3> HalfExtents;
+			TArray<FVec3> Velocities;
+			for (int32 BodyIndex = 0; BodyIndex < NumBodies; BodyIndex++)
+			{
+				const bool bStatic = BodyIndex < NumStatics;
+				Centers.Add(FVec3(RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize), bStatic ? RandomStream.FRandRange(0, 200) : RandomStream.FRandRange(0, 2000)));
+				HalfExtents.Add(bStatic ? FVec3(RandomStream.FRandRange(100, 500), RandomStream.FRandRange(100, 500), 50) : FVec3(RandomStream.FRandRange(25, 75)));
+				Velocities.Add(bStatic ? FVec3(0) : FVec3(RandomStream.GetUnitVector()) * RandomStream.FRandRange(0, 300));
+			}
+
+			FSweepAndPrune SweepAndPrune;
+			double SweepAndPruneSeconds = 0;
+			double FirstUpdateSeconds = 0;
+			double TreeBuildSeconds = 0;
+			double TreeQuerySeconds = 0;
+			int64 NumSwaps = 0;
+			int64 NumAddedPairs = 0;
+			int64 NumRemovedPairs = 0;
+			int32 NumMismatches = 0;
+			int32 NumPairs = 0;
+
+			using FAABBTree = TAABBTree<int32, TAABBTreeLeafArray<int32, FReal>, FReal>;
+
+			for (int32 Step = 0; Step <= NumSteps; Step++)
+			{
+				if (Step > 0)
+				{
+					for (int32 BodyIndex = NumStatics; BodyIndex < NumBodies; BodyIndex++)
+					{
+						Centers[BodyIndex] += Velocities[BodyIndex] * Dt;
+					}
+				}
+
+				TArray<TPayloadBoundsElement<int32, FReal>> Elements;
+				Elements.Reserve(NumBodies);
+				for (int32 BodyIndex = 0; BodyIndex < NumBodies; BodyIndex++)
+				{
+					Elements.Add(TPayloadBoundsElement<int32, FReal>{ BodyIndex, TAABB<FReal, 3>(Centers[BodyIndex] - HalfExtents[BodyIndex], Centers[BodyIndex] + HalfExtents[BodyIndex]) });
+				}
+
+				// the sweep and prune gets all bodies, like the broad phase
+				double StartTime = FPlatformTime::Seconds();
+				SweepAndPrune.BeginUpdate();
+				for (int32 BodyIndex = 0; BodyIndex < NumBodies; BodyIndex++)
+				{
+					SweepAndPrune.UpdateProxy(Handles[BodyIndex], Elements[BodyIndex].Bounds, BodyIndex >= NumStatics);
+				}
+				SweepAndPrune.EndUpdate();
+				const double UpdateSeconds = FPlatformTime::Seconds() - StartTime;
+
+				// the query path needs an up to date structure, then queries it for every moving body
+				StartTime = FPlatformTime::Seconds();
+				FAABBTree Tree(Elements, (int32)FAABBTree::DefaultMaxChildrenInLeaf, (int32)FAABBTree::DefaultMaxTreeDepth, (FReal)FAABBTree::DefaultMaxPayloadBounds, 0);
+				const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				FPairCountingVisitor Visitor;
+				for (int32 BodyIndex = NumStatics; BodyIndex < NumBodies; BodyIndex++)
+				{
+					Visitor.BodyIndex = BodyIndex;
+					Tree.Overlap(Elements[BodyIndex].Bounds, Visitor);
+				}
+				const double QuerySeconds = FPlatformTime::Seconds() - StartTime;
+
+				NumPairs = SweepAndPrune.GetOverlappingPairs().Num();
+				NumMismatches += (Visitor.NumPairs != NumPairs) ? 1 : 0;
+
+				// the first update builds everything, it is reported on its own
+				if (Step == 0)
+				{
+					FirstUpdateSeconds = UpdateSeconds;
+					continue;
+				}
+
+				SweepAndPruneSeconds += UpdateSeconds;
+				TreeBuildSeconds += BuildSeconds;
+				TreeQuerySeconds += QuerySeconds;
+				NumSwaps += SweepAndPrune.GetNumSwaps();
+				NumAddedPairs += SweepAndPrune.GetAddedPairs().Num();
+				NumRemovedPairs += SweepAndPrune.GetRemovedPairs().Num();
+			}
+
+			UE_LOG(LogChaos, Log, TEXT("Sweep and prune benchmark: %d statics, %d dynamics, %d steps, %d pairs at the end"), NumStatics, NumDynamics, NumSteps, NumPairs);
+			UE_LOG(LogChaos, Log, TEXT("  Sweep and prune: first update %.3f ms, then %.3f ms per step, %lld swaps, %.1f added and %.1f removed pairs per step, %llu bytes"),
+				FirstUpdateSeconds * 1000.0, SweepAndPruneSeconds * 1000.0 / NumSteps, NumSwaps / NumSteps, (double)NumAddedPairs / NumSteps, (double)NumRemovedPairs / NumSteps, (uint64)SweepAndPrune.GetAllocatedSize());
+			UE_LOG(LogChaos, Log, TEXT("  TAABBTree: build %.3f ms and queries %.3f ms per step"), TreeBuildSeconds * 1000.0 / NumSteps, TreeQuerySeconds * 1000.0 / NumSteps);
+
+			// both find the pairs of overlapping bounds with a dynamic body, any difference is a bug
+			if (NumMismatches > 0)
+			{
+				UE_LOG(LogChaos, Warning, TEXT("Sweep and prune pairs differ from TAABBTree pairs on %d steps"), NumMismatches);
+			}
+		}
+
+		static FAutoConsoleCommand SweepAndPruneBenchmarkCommand(
+			TEXT("p.Chaos.SweepAndPruneBenchmark"),
+			TEXT("Compares incremental sweep and prune updates against building and querying a TAABBTree for slowly moving bodies.\n")
+			TEXT("Args: [NumBodies] [NumSteps]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&SweepAndPruneBenchmark));
+	}
+#endif
+}
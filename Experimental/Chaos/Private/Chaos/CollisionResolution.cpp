@@ -370,16 +370,8 @@ namespace Chaos
 
 
 		template<class T, int d>
-		TContactPoint<T> ConvexConvexContactPoint(const FImplicitObject& A, const TRigidTransform<T, d>& ATM, const FImplicitObject& B, const TRigidTransform<T, d>& BTM, const T CullDistance)
+		void ResampleConvexConvexContactPoint(const FImplicitObject& B, const TRigidTransform<T, d>& BTM, TContactPoint<T>& ContactPoint)
 		{
-			TContactPoint<T> ContactPoint = Utilities::CastHelper(A, ATM, [&](const auto& ADowncast, const TRigidTransform<T,d>& AFullTM)
-			{
-				return Utilities::CastHelper(B, BTM, [&](const auto& BDowncast, const TRigidTransform<T,d>& BFullTM)
-				{
-					return GJKContactPoint(ADowncast, AFullTM, BDowncast, BFullTM, TVector<T, d>(1, 0, 0));
-				});
-			});
-
 			if (FMath::Abs(ContactPoint.Phi) < (T)(PHI_RESAMPLE_THRESHOLD))
 			{
 				// If GJKPenetration returns a phi of abs value < this number, we use PhiWithNormal to resample phi and normal.
@@ -389,6 +381,20 @@ namespace Chaos
 				ContactPoint.Phi = B.PhiWithNormal(ContactLocalB, ContactPoint.Normal);
 				ContactPoint.Normal = BTM.TransformVectorNoScale(ContactPoint.Normal);
 			}
+		}
+
+		template<class T, int d>
+		TContactPoint<T> ConvexConvexContactPoint(const FImplicitObject& A, const TRigidTransform<T, d>& ATM, const FImplicitObject& B, const TRigidTransform<T, d>& BTM, const T CullDistance)
+		{
+			TContactPoint<T> ContactPoint = Utilities::CastHelper(A, ATM, [&](const auto& ADowncast, const TRigidTransform<T,d>& AFullTM)
+			{
+				return Utilities::CastHelper(B, BTM, [&](const auto& BDowncast, const TRigidTransform<T,d>& BFullTM)
+				{
+					return GJKContactPoint(ADowncast, AFullTM, BDowncast, BFullTM, TVector<T, d>(1, 0, 0));
+				});
+			});
+
+			ResampleConvexConvexContactPoint(B, BTM, ContactPoint);
 
 			return ContactPoint;
 		}
@@ -405,12 +411,10 @@ namespace Chaos
 			});
 		}
 
+		/** Build the manifold from the nearest contact of the shapes, when it was already computed (see ConstructConvexConvexConstraintsBatch) */
 		template <typename T, int d>
-		void UpdateSingleShotManifold(TRigidBodyMultiPointContactConstraint<T, d>& Constraint, const TRigidTransform<T, d>& Transform0, const TRigidTransform<T, d>& Transform1, const T CullDistance)
+		void UpdateSingleShotManifold(TRigidBodyMultiPointContactConstraint<T, d>& Constraint, const TContactPoint<T>& ContactPoint, const TRigidTransform<T, d>& Transform0, const TRigidTransform<T, d>& Transform1, const T CullDistance)
 		{
-			// single shot manifolds for TConvex implicit object in the constraints implicit[0] position. 
-			TContactPoint<T> ContactPoint = ConvexConvexContactPoint(*Constraint.Manifold.Implicit[0], Transform0, *Constraint.Manifold.Implicit[1], Transform1, CullDistance);
-
 			// Cache the nearest point as the initial contact
 			Constraint.Manifold.Phi = ContactPoint.Phi;
 			Constraint.Manifold.Normal = ContactPoint.Normal;
@@ -446,6 +450,14 @@ namespace Chaos
 			}
 		}
 
+		template <typename T, int d>
+		void UpdateSingleShotManifold(TRigidBodyMultiPointContactConstraint<T, d>& Constraint, const TRigidTransform<T, d>& Transform0, const TRigidTransform<T, d>& Transform1, const T CullDistance)
+		{
+			// single shot manifolds for TConvex implicit object in the constraints implicit[0] position. 
+			const TContactPoint<T> ContactPoint = ConvexConvexContactPoint(*Constraint.Manifold.Implicit[0], Transform0, *Constraint.Manifold.Implicit[1], Transform1, CullDistance);
+			UpdateSingleShotManifold(Constraint, ContactPoint, Transform0, Transform1, CullDistance);
+		}
+
 		template <typename T, int d>
 		void UpdateIterativeManifold(TRigidBodyMultiPointContactConstraint<T, d>&  Constraint, const TRigidTransform<T, d>& Transform0, const TRigidTransform<T, d>& Transform1, const T CullDistance)
 		{
@@ -2522,6 +2534,113 @@ namespace Chaos
 		}
 
 
+		// Batched Convex-Convex
+
+		inline const FConvex* GetBatchableConvex(const FImplicitObject* Implicit)
+		{
+			// convexes colliding as level sets are dispatched by collision type in ConstructConstraintsImpl
+			if (Implicit && Implicit->IsConvex() && GetInnerType(Implicit->GetCollisionType()) != ImplicitObjectType::LevelSet)
+			{
+				if (Implicit->GetType() == FConvex::StaticType())
+				{
+					return Implicit->GetObject<FConvex>();
+				}
+				else if (Implicit->GetType() == TImplicitObjectInstanced<FConvex>::StaticType())
+				{
+					return Implicit->GetObject<const TImplicitObjectInstanced<FConvex>>()->GetInstancedObject();
+				}
+			}
+			return nullptr;
+		}
+
+		bool GetConvexConvexBatchPair(TGeometryParticleHandle<FReal, 3>* Particle0, TGeometryParticleHandle<FReal, 3>* Particle1, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1, const FReal CullDistance, const FCollisionContext& Context, FConvexConvexBatchPair& OutPair)
+		{
+			// Must match what ConstructConstraints does with the particle geometries, anything else takes the regular path
+			const FConvex* Convex0 = GetBatchableConvex(Particle0->Geometry().Get());
+			const FConvex* Convex1 = GetBatchableConvex(Particle1->Geometry().Get());
+			if (!Convex0 || !Convex1)
+			{
+				return false;
+			}
+
+			if (Context.bFilteringEnabled && !DoCollide(FConvex::StaticType(), Particle0->GetImplicitShape(Convex0), FConvex::StaticType(), Particle1->GetImplicitShape(Convex1)))
+			{
+				return false;
+			}
+
+			FReal LengthCCD = 0.0f;
+			FVec3 DirCCD(0.0f);
+			if (UseCCD(Particle0, Particle1, Convex0, DirCCD, LengthCCD))
+			{
+				return false;
+			}
+
+			OutPair.Particle0 = Particle0;
+			OutPair.Particle1 = Particle1;
+			OutPair.Convex0 = Convex0;
+			OutPair.Convex1 = Convex1;
+			OutPair.Transform0 = Transform0;
+			OutPair.Transform1 = Transform1;
+			OutPair.CullDistance = CullDistance;
+			return true;
+		}
+
+		void ConstructConvexConvexConstraintsBatch(const TArrayView<const FConvexConvexBatchPair>& Pairs, FCollisionConstraintsArray* NewConstraints)
+		{
+			using FQuery = TGJKPenetrationQuery<FReal, FConvex, FConvex>;
+
+			FQuery Queries[GJKBatchWidth];
+			TGJKPenetrationResult<FReal> Results[GJKBatchWidth];
+
+			for (int32 FirstPair = 0; FirstPair < Pairs.Num(); FirstPair += GJKBatchWidth)
+			{
+				const int32 NumPairs = FMath::Min(GJKBatchWidth, Pairs.Num() - FirstPair);
+				for (int32 Idx = 0; Idx < NumPairs; ++Idx)
+				{
+					const FConvexConvexBatchPair& Pair = Pairs[FirstPair + Idx];
+					Queries[Idx] = FQuery{ Pair.Convex0, Pair.Convex1, Pair.Transform1.GetRelativeTransform(Pair.Transform0) };
+				}
+
+				{
+					SCOPE_CYCLE_COUNTER_GJK();
+					GJKPenetrationBatch<true>(TArrayView<const FQuery>(Queries, NumPairs), TArrayView<TGJKPenetrationResult<FReal>>(Results, NumPairs));
+				}
+
+				// From here on the same as ConstructConvexConvexConstraints, with the contact point of GJKContactPoint from the batch
+				for (int32 Idx = 0; Idx < NumPairs; ++Idx)
+				{
+					const FConvexConvexBatchPair& Pair = Pairs[FirstPair + Idx];
+					const TGJKPenetrationResult<FReal>& Result = Results[Idx];
+
+					TContactPoint<FReal> ContactPoint;
+					if (ensure(Result.bResult))
+					{
+						ContactPoint.Location = Pair.Transform0.TransformPosition(Result.ClosestA);
+						ContactPoint.Normal = -Pair.Transform0.TransformVectorNoScale(Result.Normal);
+						ContactPoint.Phi = -Result.Penetration;
+					}
+					ResampleConvexConvexContactPoint(*Pair.Convex1, Pair.Transform1, ContactPoint);
+
+					const FRigidTransform3 ParticleImplicit0TM = Pair.Transform0.GetRelativeTransform(Collisions::GetTransform(Pair.Particle0));
+					const FRigidTransform3 ParticleImplicit1TM = Pair.Transform1.GetRelativeTransform(Collisions::GetTransform(Pair.Particle1));
+					if (Chaos_Collision_UseManifolds)
+					{
+						FRigidBodyMultiPointContactConstraint Constraint = FRigidBodyMultiPointContactConstraint(Pair.Particle0, Pair.Convex0, ParticleImplicit0TM, Pair.Particle1, Pair.Convex1, ParticleImplicit1TM, EContactShapesType::ConvexConvex);
+						UpdateSingleShotManifold(Constraint, ContactPoint, Pair.Transform0, Pair.Transform1, Pair.CullDistance);
+						UpdateConvexConvexConstraint(*Pair.Convex0, Pair.Transform0, *Pair.Convex1, Pair.Transform1, Pair.CullDistance, Constraint);
+						NewConstraints[FirstPair + Idx].TryAdd(Pair.CullDistance, Constraint);
+					}
+					else
+					{
+						FRigidBodyPointContactConstraint Constraint = FRigidBodyPointContactConstraint(Pair.Particle0, Pair.Convex0, ParticleImplicit0TM, Pair.Particle1, Pair.Convex1, ParticleImplicit1TM, EContactShapesType::ConvexConvex);
+						UpdateContactPoint(Constraint.Manifold, ContactPoint);
+						NewConstraints[FirstPair + Idx].TryAdd(Pair.CullDistance, Constraint);
+					}
+				}
+			}
+		}
+
+
 		template <typename GeometryA, typename GeometryB>
 		bool GetPairTOIHackImpl(const FImplicitObject& A, const FRigidTransform3& AStartTransform, const GeometryB& B, const FRigidTransform3& BTransform, const FVec3& Dir, const FReal Length, FReal& OutTOI, FVec3& OutNormal, FReal& OutPhi)
 		{
@@ -6,12 +6,17 @@
 #include "Chaos/ImplicitObjectScaled.h"
 #include "Chaos/Capsule.h"
 #include "Chaos/GeometryQueries.h"
+#include "Chaos/Framework/Parallel.h"
 #include "HAL/IConsoleManager.h"
 #include "HAL/PlatformMisc.h"
 #include "Chaos/Triangle.h"
+#include "ChaosLog.h"
+#include "Math/RandomStream.h"
 
 namespace Chaos
 {
+	int32 Chaos_HeightField_MinMaxHierarchy = 1;
+	FAutoConsoleVariableRef CVarChaosHeightFieldMinMaxHierarchy(TEXT("p.Chaos.HeightField.MinMaxHierarchy"), Chaos_HeightField_MinMaxHierarchy, TEXT("Whether heightfield raycasts, sweeps and overlaps cull with the min-max height hierarchy instead of walking the grid cell by cell."));
 
 	template<typename T>
 	class THeightfieldRaycastVisitor
@@ -1106,6 +1111,338 @@ namespace Chaos
 		return false;
 	}
 
+	template<typename T>
+	void THeightField<T>::BuildMinMaxHierarchy()
+	{
+		using StorageType = typename FDataType::StorageType;
+
+		MinMaxLevels.Reset();
+
+		const int32 NumCellsX = GeomData.NumCols - 1;
+		const int32 NumCellsY = GeomData.NumRows - 1;
+		if(NumCellsX <= 0 || NumCellsY <= 0)
+		{
+			return;
+		}
+
+		// Leaves from the heights at the corners of their cells
+		FMinMaxLevel& Leaves = MinMaxLevels.AddDefaulted_GetRef();
+		Leaves.NumX = FMath::DivideAndRoundUp(NumCellsX, MinMaxLeafCells);
+		Leaves.NumY = FMath::DivideAndRoundUp(NumCellsY, MinMaxLeafCells);
+		Leaves.Nodes.SetNumUninitialized(Leaves.NumX * Leaves.NumY);
+
+		PhysicsParallelFor(Leaves.NumY, [this, &Leaves, NumCellsX, NumCellsY](const int32 NodeY)
+		{
+			const int32 BeginY = NodeY * MinMaxLeafCells;
+			const int32 EndY = FMath::Min(BeginY + MinMaxLeafCells, NumCellsY);
+
+			for(int32 NodeX = 0; NodeX < Leaves.NumX; ++NodeX)
+			{
+				const int32 BeginX = NodeX * MinMaxLeafCells;
+				const int32 EndX = FMath::Min(BeginX + MinMaxLeafCells, NumCellsX);
+
+				FMinMaxHeights& Node = Leaves.Nodes[NodeY * Leaves.NumX + NodeX];
+				Node.Min = TNumericLimits<StorageType>::Max();
+				Node.Max = TNumericLimits<StorageType>::Min();
+
+				// The last cells reach the heights one past them
+				for(int32 Y = BeginY; Y <= EndY; ++Y)
+				{
+					const StorageType* Row = GeomData.Heights.GetData() + Y * GeomData.NumCols;
+					for(int32 X = BeginX; X <= EndX; ++X)
+					{
+						Node.Min = FMath::Min(Node.Min, Row[X]);
+						Node.Max = FMath::Max(Node.Max, Row[X]);
+					}
+				}
+			}
+		});
+
+		// Each level merges 2x2 nodes of the one below, until a single root is left
+		while(MinMaxLevels.Last().NumX > 1 || MinMaxLevels.Last().NumY > 1)
+		{
+			const int32 ChildLevel = MinMaxLevels.Num() - 1;
+			MinMaxLevels.AddDefaulted();
+			const FMinMaxLevel& Children = MinMaxLevels[ChildLevel];
+			FMinMaxLevel& Parents = MinMaxLevels[ChildLevel + 1];
+
+			Parents.NumX = FMath::DivideAndRoundUp(Children.NumX, 2);
+			Parents.NumY = FMath::DivideAndRoundUp(Children.NumY, 2);
+			Parents.Nodes.SetNumUninitialized(Parents.NumX * Parents.NumY);
+
+			for(int32 NodeY = 0; NodeY < Parents.NumY; ++NodeY)
+			{
+				for(int32 NodeX = 0; NodeX < Parents.NumX; ++NodeX)
+				{
+					FMinMaxHeights& Node = Parents.Nodes[NodeY * Parents.NumX + NodeX];
+					Node.Min = TNumericLimits<StorageType>::Max();
+					Node.Max = TNumericLimits<StorageType>::Min();
+
+					for(int32 ChildY = NodeY * 2; ChildY < FMath::Min(NodeY * 2 + 2, Children.NumY); ++ChildY)
+					{
+						for(int32 ChildX = NodeX * 2; ChildX < FMath::Min(NodeX * 2 + 2, Children.NumX); ++ChildX)
+						{
+							const FMinMaxHeights& Child = Children.Nodes[ChildY * Children.NumX + ChildX];
+							Node.Min = FMath::Min(Node.Min, Child.Min);
+							Node.Max = FMath::Max(Node.Max, Child.Max);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template<typename T>
+	TAABB<T, 3> THeightField<T>::GetMinMaxBoundsScaled(const int32 BeginX, const int32 BeginY, const int32 EndX, const int32 EndY, const typename FDataType::StorageType MinHeight, const typename FDataType::StorageType MaxHeight) const
+	{
+		// Same expansion as GetPoints, so that the bounds hold the triangles exactly
+		const TVector<T, 3> GridMin(BeginX, BeginY, GeomData.MinValue + MinHeight * GeomData.HeightPerUnit);
+		const TVector<T, 3> GridMax(EndX, EndY, GeomData.MinValue + MaxHeight * GeomData.HeightPerUnit);
+
+		// Grow from both corners in case the scale mirrors an axis
+		TAABB<T, 3> Bounds(GridMin * GeomData.Scale, GridMin * GeomData.Scale);
+		Bounds.GrowToInclude(GridMax * GeomData.Scale);
+		return Bounds;
+	}
+
+	template<typename T>
+	TAABB<T, 3> THeightField<T>::GetMinMaxNodeBoundsScaled(const int32 Level, const int32 NodeX, const int32 NodeY) const
+	{
+		const FMinMaxLevel& MinMaxLevel = MinMaxLevels[Level];
+		const FMinMaxHeights& Node = MinMaxLevel.Nodes[NodeY * MinMaxLevel.NumX + NodeX];
+		const int32 NodeCells = MinMaxLeafCells << Level;
+
+		const int32 EndX = FMath::Min((NodeX + 1) * NodeCells, GeomData.NumCols - 1);
+		const int32 EndY = FMath::Min((NodeY + 1) * NodeCells, GeomData.NumRows - 1);
+		return GetMinMaxBoundsScaled(NodeX * NodeCells, NodeY * NodeCells, EndX, EndY, Node.Min, Node.Max);
+	}
+
+	template<typename T>
+	TAABB<T, 3> THeightField<T>::GetMinMaxCellBoundsScaled(const int32 CellX, const int32 CellY) const
+	{
+		using StorageType = typename FDataType::StorageType;
+
+		const int32 Index = CellY * GeomData.NumCols + CellX;
+		const StorageType H0 = GeomData.Heights[Index];
+		const StorageType H1 = GeomData.Heights[Index + 1];
+		const StorageType H2 = GeomData.Heights[Index + GeomData.NumCols];
+		const StorageType H3 = GeomData.Heights[Index + GeomData.NumCols + 1];
+
+		const StorageType MinHeight = FMath::Min(FMath::Min(H0, H1), FMath::Min(H2, H3));
+		const StorageType MaxHeight = FMath::Max(FMath::Max(H0, H1), FMath::Max(H2, H3));
+		return GetMinMaxBoundsScaled(CellX, CellY, CellX + 1, CellY + 1, MinHeight, MaxHeight);
+	}
+
+	template<typename T>
+	bool THeightField<T>::UseMinMaxHierarchy() const
+	{
+		return Chaos_HeightField_MinMaxHierarchy != 0 && MinMaxLevels.Num() > 0;
+	}
+
+	template<typename T>
+	template<typename FVisitCell>
+	bool THeightField<T>::MinMaxCast(const TVector<T, 3>& StartPoint, const TVector<T, 3>& Dir, const T Length, const TVector<T, 3>& Inflation, FVisitCell VisitCell) const
+	{
+		struct FStackEntry
+		{
+			int32 Level;
+			int32 X;
+			int32 Y;
+			T ToI;
+		};
+
+		struct FHit
+		{
+			int32 X;
+			int32 Y;
+			T ToI;
+		};
+
+		T CurrentLength = Length;
+
+		// Data for fast box cast
+		TVector<T, 3> HitPoint;
+		T ToI;
+		bool bParallel[3];
+		TVector<T, 3> InvDir;
+
+		const T InvLength = 1 / Length;
+		for(int Axis = 0; Axis < 3; ++Axis)
+		{
+			bParallel[Axis] = FMath::IsNearlyZero(Dir[Axis], 1.e-8f);
+			InvDir[Axis] = bParallel[Axis] ? 0 : 1 / Dir[Axis];
+		}
+
+		const int32 NumCellsX = GeomData.NumCols - 1;
+		const int32 NumCellsY = GeomData.NumRows - 1;
+
+		const int32 RootLevel = MinMaxLevels.Num() - 1;
+		TAABB<T, 3> RootBounds = GetMinMaxNodeBoundsScaled(RootLevel, 0, 0);
+		RootBounds.ThickenSymmetrically(Inflation);
+		if(!RootBounds.RaycastFast(StartPoint, Dir, InvDir, bParallel, CurrentLength, InvLength, ToI, HitPoint))
+		{
+			return false;
+		}
+
+		// Children are pushed farthest first so that the nearest one is popped next
+		TArray<FStackEntry, TInlineAllocator<64>> Stack;
+		TArray<FHit, TInlineAllocator<MinMaxLeafCells * MinMaxLeafCells>> Hits;
+		Stack.Add({RootLevel, 0, 0, ToI});
+
+		while(Stack.Num() > 0)
+		{
+			const FStackEntry Entry = Stack.Pop(false);
+
+			// A nearer hit was found since the node was pushed
+			if(Entry.ToI > CurrentLength)
+			{
+				continue;
+			}
+
+			Hits.Reset();
+
+			if(Entry.Level == 0)
+			{
+				const int32 BeginX = Entry.X * MinMaxLeafCells;
+				const int32 BeginY = Entry.Y * MinMaxLeafCells;
+				const int32 EndX = FMath::Min(BeginX + MinMaxLeafCells, NumCellsX);
+				const int32 EndY = FMath::Min(BeginY + MinMaxLeafCells, NumCellsY);
+
+				for(int32 CellY = BeginY; CellY < EndY; ++CellY)
+				{
+					for(int32 CellX = BeginX; CellX < EndX; ++CellX)
+					{
+						TAABB<T, 3> CellBounds = GetMinMaxCellBoundsScaled(CellX, CellY);
+						CellBounds.ThickenSymmetrically(Inflation);
+						if(CellBounds.RaycastFast(StartPoint, Dir, InvDir, bParallel, CurrentLength, InvLength, ToI, HitPoint))
+						{
+							Hits.Add({CellX, CellY, ToI});
+						}
+					}
+				}
+
+				Hits.Sort([](const FHit& A, const FHit& B) { return A.ToI < B.ToI; });
+
+				for(const FHit& Hit : Hits)
+				{
+					if(Hit.ToI > CurrentLength)
+					{
+						break;
+					}
+
+					if(!VisitCell(Hit.Y * NumCellsX + Hit.X, CurrentLength))
+					{
+						return true;
+					}
+				}
+			}
+			else
+			{
+				const int32 ChildLevel = Entry.Level - 1;
+				const FMinMaxLevel& Children = MinMaxLevels[ChildLevel];
+
+				for(int32 ChildY = Entry.Y * 2; ChildY < FMath::Min(Entry.Y * 2 + 2, Children.NumY); ++ChildY)
+				{
+					for(int32 ChildX = Entry.X * 2; ChildX < FMath::Min(Entry.X * 2 + 2, Children.NumX); ++ChildX)
+					{
+						TAABB<T, 3> ChildBounds = GetMinMaxNodeBoundsScaled(ChildLevel, ChildX, ChildY);
+						ChildBounds.ThickenSymmetrically(Inflation);
+						if(ChildBounds.RaycastFast(StartPoint, Dir, InvDir, bParallel, CurrentLength, InvLength, ToI, HitPoint))
+						{
+							Hits.Add({ChildX, ChildY, ToI});
+						}
+					}
+				}
+
+				Hits.Sort([](const FHit& A, const FHit& B) { return A.ToI > B.ToI; });
+
+				for(const FHit& Hit : Hits)
+				{
+					Stack.Add({ChildLevel, Hit.X, Hit.Y, Hit.ToI});
+				}
+			}
+		}
+
+		return false;
+	}
+
+	template<typename T>
+	bool THeightField<T>::GetMinMaxIntersections(const TAABB<T, 3>& QueryBounds, TArray<TVector<int32, 2>>& OutIntersections) const
+	{
+		OutIntersections.Reset();
+
+		const int32 RootLevel = MinMaxLevels.Num() - 1;
+		if(!GetMinMaxNodeBoundsScaled(RootLevel, 0, 0).Intersects(QueryBounds))
+		{
+			return false;
+		}
+
+		const int32 NumCellsX = GeomData.NumCols - 1;
+		const int32 NumCellsY = GeomData.NumRows - 1;
+
+		struct FStackEntry
+		{
+			int32 Level;
+			int32 X;
+			int32 Y;
+		};
+
+		TArray<FStackEntry, TInlineAllocator<64>> Stack;
+		Stack.Add({RootLevel, 0, 0});
+
+		while(Stack.Num() > 0)
+		{
+			const FStackEntry Entry = Stack.Pop(false);
+
+			if(Entry.Level == 0)
+			{
+				const int32 BeginX = Entry.X * MinMaxLeafCells;
+				const int32 BeginY = Entry.Y * MinMaxLeafCells;
+				const int32 EndX = FMath::Min(BeginX + MinMaxLeafCells, NumCellsX);
+				const int32 EndY = FMath::Min(BeginY + MinMaxLeafCells, NumCellsY);
+
+				for(int32 CellY = BeginY; CellY < EndY; ++CellY)
+				{
+					for(int32 CellX = BeginX; CellX < EndX; ++CellX)
+					{
+						if(GetMinMaxCellBoundsScaled(CellX, CellY).Intersects(QueryBounds))
+						{
+							OutIntersections.Add(TVector<int32, 2>(CellX, CellY));
+						}
+					}
+				}
+			}
+			else
+			{
+				const FMinMaxLevel& Children = MinMaxLevels[Entry.Level - 1];
+
+				for(int32 ChildY = Entry.Y * 2; ChildY < FMath::Min(Entry.Y * 2 + 2, Children.NumY); ++ChildY)
+				{
+					for(int32 ChildX = Entry.X * 2; ChildX < FMath::Min(Entry.X * 2 + 2, Children.NumX); ++ChildX)
+					{
+						if(GetMinMaxNodeBoundsScaled(Entry.Level - 1, ChildX, ChildY).Intersects(QueryBounds))
+						{
+							Stack.Add({Entry.Level - 1, ChildX, ChildY});
+						}
+					}
+				}
+			}
+		}
+
+		return OutIntersections.Num() > 0;
+	}
+
+	template<typename T>
+	bool THeightField<T>::GetOverlapIntersections(const TAABB<T, 3>& QueryBounds, TArray<TVector<int32, 2>>& OutIntersections) const
+	{
+		if(UseMinMaxHierarchy())
+		{
+			return GetMinMaxIntersections(QueryBounds, OutIntersections);
+		}
+
+		return GetGridIntersections(FBounds2D(QueryBounds), OutIntersections);
+	}
+
 	template <typename T>
 	bool THeightField<T>::Raycast(const TVector<T, 3>& StartPoint, const TVector<T, 3>& Dir, const T Length, const T Thickness, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex) const
 	{
@@ -1113,7 +1450,24 @@ namespace Chaos
 
 		THeightfieldRaycastVisitor<T> Visitor(&GeomData, StartPoint, Dir, Thickness);
 
-		if(Thickness > 0)
+		if(UseMinMaxHierarchy())
+		{
+			if(Thickness > 0)
+			{
+				MinMaxCast(StartPoint, Dir, Length, TVector<T, 3>(Thickness), [&Visitor](const int32 CellIndex, T& CurrentLength)
+				{
+					return Visitor.VisitSweep(CellIndex, CurrentLength);
+				});
+			}
+			else if(Length >= 1e-4)
+			{
+				MinMaxCast(StartPoint, Dir, Length, TVector<T, 3>(0), [&Visitor](const int32 CellIndex, T& CurrentLength)
+				{
+					return Visitor.VisitRaycast(CellIndex, CurrentLength);
+				});
+			}
+		}
+		else if(Thickness > 0)
 		{
 			GridSweep(StartPoint, Dir, Length, TVector<T, 2>(Thickness), Visitor);
 		}
@@ -1203,14 +1557,10 @@ namespace Chaos
 		TAABB<T, 3> QueryBounds(Point, Point);
 		QueryBounds.Thicken(Thickness);
 
-		FBounds2D FlatQueryBounds;
-		FlatQueryBounds.Min = TVector<T, 2>(QueryBounds.Min()[0], QueryBounds.Min()[1]);
-		FlatQueryBounds.Max = TVector<T, 2>(QueryBounds.Max()[0], QueryBounds.Max()[1]);
-
 		TArray<TVector<int32, 2>> Intersections;
 		TVector<T, 3> Points[4];
 
-		GetGridIntersections(FlatQueryBounds, Intersections);
+		GetOverlapIntersections(QueryBounds, Intersections);
 
 		for(const TVector<int32, 2>& Cell : Intersections)
 		{
@@ -1267,14 +1617,10 @@ namespace Chaos
 		QueryBounds.Thicken(Thickness);
 		QueryBounds = QueryBounds.TransformedAABB(QueryTM);
 
-		FBounds2D FlatQueryBounds;
-		FlatQueryBounds.Min = TVector<T, 2>(QueryBounds.Min()[0], QueryBounds.Min()[1]);
-		FlatQueryBounds.Max = TVector<T, 2>(QueryBounds.Max()[0], QueryBounds.Max()[1]);
-
 		TArray<TVector<int32, 2>> Intersections;
 		TVector<T, 3> Points[4];
 
-		GetGridIntersections(FlatQueryBounds, Intersections);
+		GetOverlapIntersections(QueryBounds, Intersections);
 
 		T LocalContactPhi = FLT_MAX;
 		TVector<T, 3> LocalContactLocation, LocalContactNormal;
@@ -1370,6 +1716,14 @@ namespace Chaos
 	template <typename T>
 	template <typename QueryGeomType>
 	bool THeightField<T>::OverlapGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD) const
+	{
+		TArray<TVector<int32, 2>> Intersections;
+		return OverlapGeomImp(QueryGeom, QueryTM, Thickness, OutMTD, Intersections);
+	}
+
+	template <typename T>
+	template <typename QueryGeomType>
+	bool THeightField<T>::OverlapGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD, TArray<TVector<int32, 2>>& Intersections) const
 	{
 		if (OutMTD)
 		{
@@ -1417,14 +1771,9 @@ namespace Chaos
 		QueryBounds.Thicken(Thickness);
 		QueryBounds = QueryBounds.TransformedAABB(QueryTM);
 
-		FBounds2D FlatQueryBounds;
-		FlatQueryBounds.Min = TVector<T, 2>(QueryBounds.Min()[0], QueryBounds.Min()[1]);
-		FlatQueryBounds.Max = TVector<T, 2>(QueryBounds.Max()[0], QueryBounds.Max()[1]);
-
-		TArray<TVector<int32, 2>> Intersections;
 		TVector<T, 3> Points[4];
 
-		GetGridIntersections(FlatQueryBounds, Intersections);
+		GetOverlapIntersections(QueryBounds, Intersections);
 
 		bool bOverlaps = false;
 		for(const TVector<int32, 2>& Cell : Intersections)
@@ -1502,6 +1851,75 @@ namespace Chaos
 		return OverlapGeomImp(QueryGeom, QueryTM, Thickness, OutMTD);
 	}
 
+	template <typename T>
+	template <typename QueryGeomType>
+	int32 THeightField<T>::OverlapGeomBatchImp(TArrayView<const QueryGeomType* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		check(QueryGeoms.Num() == QueryTMs.Num() && QueryGeoms.Num() == OutOverlaps.Num());
+		check(OutMTDs.Num() == 0 || OutMTDs.Num() == QueryGeoms.Num());
+
+		// Shared by all queries, so that only the first one allocates
+		TArray<TVector<int32, 2>> Intersections;
+
+		int32 NumOverlaps = 0;
+		for(int32 QueryIndex = 0; QueryIndex < QueryGeoms.Num(); ++QueryIndex)
+		{
+			FMTDInfo* OutMTD = OutMTDs.Num() > 0 ? &OutMTDs[QueryIndex] : nullptr;
+			OutOverlaps[QueryIndex] = OverlapGeomImp(*QueryGeoms[QueryIndex], QueryTMs[QueryIndex], Thickness, OutMTD, Intersections);
+			NumOverlaps += OutOverlaps[QueryIndex] ? 1 : 0;
+		}
+
+		return NumOverlaps;
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TSphere<T, 3>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TBox<T, 3>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TCapsule<T>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const FConvex* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TSphere<T, 3>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TBox<T, 3>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TCapsule<T>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
+	template <typename T>
+	int32 THeightField<T>::OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<FConvex>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const
+	{
+		return OverlapGeomBatchImp(QueryGeoms, QueryTMs, Thickness, OutOverlaps, OutMTDs);
+	}
+
 	template <typename T>
 	template <typename QueryGeomType>
 	bool THeightField<T>::SweepGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& StartTM, const TVector<T, 3>& Dir, const T Length, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex, const T Thickness, bool bComputeMTD) const
@@ -1511,8 +1929,21 @@ namespace Chaos
 		const TAABB<T, 3> QueryBounds = QueryGeom.BoundingBox();
 		const TVector<T, 3> StartPoint = StartTM.TransformPositionNoScale(QueryBounds.Center());
 
-		const TVector<T, 3> Inflation3D = QueryBounds.Extents() * 0.5 + TVector<T, 3>(Thickness);
-		GridSweep(StartPoint, Dir, Length, TVector<T, 2>(Inflation3D[0], Inflation3D[1]), SQVisitor);
+		if(UseMinMaxHierarchy())
+		{
+			// The hierarchy tests in 3D so inflate by the rotated bounds of the query
+			const TAABB<T, 3> RotatedBounds = QueryBounds.TransformedAABB(TRigidTransform<T, 3>(TVector<T, 3>(0), StartTM.GetRotation()));
+			const TVector<T, 3> Inflation3D = RotatedBounds.Extents() * 0.5 + TVector<T, 3>(Thickness);
+			MinMaxCast(StartPoint, Dir, Length, Inflation3D, [&SQVisitor](const int32 CellIndex, T& CurrentLength)
+			{
+				return SQVisitor.VisitSweep(CellIndex, CurrentLength);
+			});
+		}
+		else
+		{
+			const TVector<T, 3> Inflation3D = QueryBounds.Extents() * 0.5 + TVector<T, 3>(Thickness);
+			GridSweep(StartPoint, Dir, Length, TVector<T, 2>(Inflation3D[0], Inflation3D[1]), SQVisitor);
+		}
 
 		if(SQVisitor.OutTime <= Length)
 		{
@@ -1699,9 +2130,202 @@ namespace Chaos
 		//MaxCorner *= {GeomData.Scale[0], GeomData.Scale[1]};
 
 		FlatGrid = TUniformGrid<T, 2>(MinCorner, MaxCorner, Cells);
+
+		BuildMinMaxHierarchy();
 	}
 
 }
 
 template class Chaos::THeightField<float>;
 
+
+#if !UE_BUILD_SHIPPING
+namespace Chaos
+{
+	namespace HeightFieldBenchmark
+	{
+		struct FQueryResult
+		{
+			bool bHit;
+			FReal Time;
+		};
+
+		bool ResultsDiffer(const FQueryResult& A, const FQueryResult& B)
+		{
+			return A.bHit != B.bHit || (A.bHit && !FMath::IsNearlyEqual(A.Time, B.Time, KINDA_SMALL_NUMBER * FMath::Max<FReal>(1, A.Time)));
+		}
+
+		int32 CountHits(const TArray<FQueryResult>& Results)
+		{
+			int32 NumHits = 0;
+			for (const FQueryResult& Result : Results)
+			{
+				NumHits += Result.bHit ? 1 : 0;
+			}
+			return NumHits;
+		}
+
+		void HeightFieldBenchmark(const TArray<FString>& Args)
+		{
+			const int32 NumVertices = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 8193;
+			const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1000;
+			const FVec3 Scale(100, 100, 1);
+
+			FRandomStream RandomStream(42);
+
+			// Rolling hills with some noise, offset like landscape heights
+			TArray<uint16> Heights;
+			Heights.SetNumUninitialized(NumVertices * NumVertices);
+			for (int32 Y = 0; Y < NumVertices; ++Y)
+			{
+				for (int32 X = 0; X < NumVertices; ++X)
+				{
+					const FReal Hills = FMath::Sin(X * 0.01f) * FMath::Cos(Y * 0.013f) * 8000 + FMath::Sin((X + Y) * 0.05f) * 1000;
+					Heights[Y * NumVertices + X] = (uint16)FMath::Clamp<int32>(32768 + (int32)Hills + RandomStream.RandRange(-50, 50), 0, 65535);
+				}
+			}
+			TArray<uint8> MaterialIndices;
+			MaterialIndices.Add(0);
+
+			double StartTime = FPlatformTime::Seconds();
+			THeightField<FReal> HeightField(MakeArrayView(Heights), MakeArrayView(MaterialIndices), NumVertices, NumVertices, Scale);
+			const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+			const TAABB<FReal, 3> Bounds = HeightField.BoundingBox();
+			const FReal TraceLength = Bounds.Extents()[0] * 0.25f;
+
+			// Long downward traces from above the terrain
+			TArray<FVec3> Starts;
+			TArray<FVec3> Dirs;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				Starts.Add(FVec3(RandomStream.FRandRange(Bounds.Min()[0], Bounds.Max()[0]), RandomStream.FRandRange(Bounds.Min()[1], Bounds.Max()[1]), Bounds.Max()[2] + 1000));
+				FVec3 Dir(RandomStream.GetUnitVector());
+				Dir[2] = -FMath::Abs(Dir[2]) - 0.05f;
+				Dirs.Add(FVec3(Dir.GetSafeNormal()));
+			}
+
+			// Shapes resting on the terrain, some above and some below it
+			TArray<FRigidTransform3> Transforms;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				const int32 X = RandomStream.RandRange(0, NumVertices - 1);
+				const int32 Y = RandomStream.RandRange(0, NumVertices - 1);
+				const FVec3 Position = FVec3(X, Y, HeightField.GetHeight(X, Y)) * Scale + FVec3(0, 0, RandomStream.FRandRange(-150, 150));
+				Transforms.Add(FRigidTransform3(Position, FRotation3(FQuat(FVector(RandomStream.GetUnitVector()), RandomStream.FRandRange(0, PI)))));
+			}
+
+			const TSphere<FReal, 3> Sphere(FVec3(0), 50);
+			const TCapsule<FReal> Capsule(FVec3(0, 0, -50), FVec3(0, 0, 50), 40);
+
+			const int32 SavedMinMaxHierarchy = Chaos_HeightField_MinMaxHierarchy;
+
+			const auto RunRaycasts = [&](const bool bMinMaxHierarchy, const FReal Thickness, TArray<FQueryResult>& OutResults) -> double
+			{
+				Chaos_HeightField_MinMaxHierarchy = bMinMaxHierarchy ? 1 : 0;
+				OutResults.SetNum(NumQueries);
+				const double RunStartTime = FPlatformTime::Seconds();
+				for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+				{
+					FVec3 Position, Normal;
+					int32 FaceIndex;
+					FQueryResult& Result = OutResults[QueryIndex];
+					Result.bHit = HeightField.Raycast(Starts[QueryIndex], Dirs[QueryIndex], TraceLength, Thickness, Result.Time, Position, Normal, FaceIndex);
+				}
+				return FPlatformTime::Seconds() - RunStartTime;
+			};
+
+			const auto RunSweeps = [&](const bool bMinMaxHierarchy, TArray<FQueryResult>& OutResults) -> double
+			{
+				Chaos_HeightField_MinMaxHierarchy = bMinMaxHierarchy ? 1 : 0;
+				OutResults.SetNum(NumQueries);
+				const double RunStartTime = FPlatformTime::Seconds();
+				for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+				{
+					FVec3 Position, Normal;
+					int32 FaceIndex;
+					FQueryResult& Result = OutResults[QueryIndex];
+					Result.bHit = HeightField.SweepGeom(Sphere, FRigidTransform3(Starts[QueryIndex], FRotation3::FromIdentity()), Dirs[QueryIndex], TraceLength, Result.Time, Position, Normal, FaceIndex);
+				}
+				return FPlatformTime::Seconds() - RunStartTime;
+			};
+
+			TArray<FQueryResult> GridResults;
+			TArray<FQueryResult> MinMaxResults;
+
+			const double GridRaycastSeconds = RunRaycasts(false, 0, GridResults);
+			const double MinMaxRaycastSeconds = RunRaycasts(true, 0, MinMaxResults);
+			int32 NumRaycastMismatches = 0;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				NumRaycastMismatches += ResultsDiffer(GridResults[QueryIndex], MinMaxResults[QueryIndex]) ? 1 : 0;
+			}
+			const int32 NumRaycastHits = CountHits(MinMaxResults);
+
+			const double GridThickRaycastSeconds = RunRaycasts(false, 20, GridResults);
+			const double MinMaxThickRaycastSeconds = RunRaycasts(true, 20, MinMaxResults);
+			int32 NumThickRaycastMismatches = 0;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				NumThickRaycastMismatches += ResultsDiffer(GridResults[QueryIndex], MinMaxResults[QueryIndex]) ? 1 : 0;
+			}
+
+			const double GridSweepSeconds = RunSweeps(false, GridResults);
+			const double MinMaxSweepSeconds = RunSweeps(true, MinMaxResults);
+			int32 NumSweepMismatches = 0;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				NumSweepMismatches += ResultsDiffer(GridResults[QueryIndex], MinMaxResults[QueryIndex]) ? 1 : 0;
+			}
+			const int32 NumSweepHits = CountHits(MinMaxResults);
+
+			// Character capsules: one query at a time over the grid against a batch culled by the hierarchy
+			TArray<const TCapsule<FReal>*> Capsules;
+			Capsules.Init(&Capsule, NumQueries);
+			TArray<bool> GridOverlaps;
+			TArray<bool> BatchOverlaps;
+			GridOverlaps.SetNumZeroed(NumQueries);
+			BatchOverlaps.SetNumZeroed(NumQueries);
+
+			Chaos_HeightField_MinMaxHierarchy = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				GridOverlaps[QueryIndex] = HeightField.OverlapGeom(Capsule, Transforms[QueryIndex], 0);
+			}
+			const double GridOverlapSeconds = FPlatformTime::Seconds() - StartTime;
+
+			Chaos_HeightField_MinMaxHierarchy = 1;
+			StartTime = FPlatformTime::Seconds();
+			const int32 NumOverlaps = HeightField.OverlapGeomBatch(TArrayView<const TCapsule<FReal>* const>(Capsules), TArrayView<const FRigidTransform3>(Transforms), 0, TArrayView<bool>(BatchOverlaps));
+			const double BatchOverlapSeconds = FPlatformTime::Seconds() - StartTime;
+
+			int32 NumOverlapMismatches = 0;
+			for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+			{
+				NumOverlapMismatches += (GridOverlaps[QueryIndex] != BatchOverlaps[QueryIndex]) ? 1 : 0;
+			}
+
+			Chaos_HeightField_MinMaxHierarchy = SavedMinMaxHierarchy;
+
+			UE_LOG(LogChaos, Log, TEXT("Heightfield benchmark: %dx%d vertices, %d queries, built in %.3f ms"), NumVertices, NumVertices, NumQueries, BuildSeconds * 1000.0);
+			UE_LOG(LogChaos, Log, TEXT("  Raycast: grid %.3f ms, min-max %.3f ms, %d hits"), GridRaycastSeconds * 1000.0, MinMaxRaycastSeconds * 1000.0, NumRaycastHits);
+			UE_LOG(LogChaos, Log, TEXT("  Thick raycast: grid %.3f ms, min-max %.3f ms"), GridThickRaycastSeconds * 1000.0, MinMaxThickRaycastSeconds * 1000.0);
+			UE_LOG(LogChaos, Log, TEXT("  Sphere sweep: grid %.3f ms, min-max %.3f ms, %d hits"), GridSweepSeconds * 1000.0, MinMaxSweepSeconds * 1000.0, NumSweepHits);
+			UE_LOG(LogChaos, Log, TEXT("  Capsule overlap: grid per query %.3f ms, min-max batch %.3f ms, %d overlaps"), GridOverlapSeconds * 1000.0, BatchOverlapSeconds * 1000.0, NumOverlaps);
+
+			// The hierarchy only culls cells that cannot be touched, a difference means one of the two walks missed a cell
+			if (NumRaycastMismatches > 0 || NumThickRaycastMismatches > 0 || NumSweepMismatches > 0 || NumOverlapMismatches > 0)
+			{
+				UE_LOG(LogChaos, Warning, TEXT("Min-max hierarchy differs from the grid on %d raycasts, %d thick raycasts, %d sweeps and %d overlaps"), NumRaycastMismatches, NumThickRaycastMismatches, NumSweepMismatches, NumOverlapMismatches);
+			}
+		}
+
+		static FAutoConsoleCommand HeightFieldBenchmarkCommand(
+			TEXT("p.Chaos.HeightFieldBenchmark"),
+			TEXT("Compares heightfield raycasts, sweeps and overlaps walking the grid against culling with the min-max hierarchy, on a generated landscape.\n")
+			TEXT("Args: [NumVertices per side] [NumQueries]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&HeightFieldBenchmark));
+	}
+}
+#endif
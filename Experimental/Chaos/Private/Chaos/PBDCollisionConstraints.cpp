@@ -17,6 +17,7 @@
 #include "Chaos/Levelset.h"
 #include "Chaos/Pair.h"
 #include "Chaos/PBDCollisionConstraintsContact.h"
+#include "Chaos/PBDConstraintColor.h"
 #include "Chaos/PBDRigidsSOAs.h"
 #include "Chaos/Sphere.h"
 #include "Chaos/Transform.h"
@@ -281,9 +282,10 @@ namespace Chaos
 		{
 			HandleAllocator.FreeHandle(Handle);
 		}
-		PointConstraints.Reset();
+
+		// Retiring contacts seed the next collision detection (resets PointConstraints and IterativeConstraints)
+		ManifoldCache.Build(PointConstraints, SweptPointConstraints, IterativeConstraints);
 		SweptPointConstraints.Reset();
-		IterativeConstraints.Reset();
 		Handles.Reset();
 #endif
 
@@ -569,7 +571,7 @@ namespace Chaos
 					bNeedsAnotherIterationAtomic.Store(true);
 				}
 
-			}, bDisableCollisionParallelFor);
+			}, bDisableCollisionParallelFor || (InConstraintHandles.Num() < ConstraintColorBatchMinParallelSize));
 		}
 
 		if (PostApplyCallback != nullptr)
@@ -586,7 +588,8 @@ namespace Chaos
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Collisions_ApplyPushOut);
 
-		bool bNeedsAnotherIteration = false;
+		TAtomic<bool> bNeedsAnotherIterationAtomic;
+		bNeedsAnotherIterationAtomic.Store(false);
 		if (MApplyPushOutPairIterations > 0)
 		{
 			PhysicsParallelFor(InConstraintHandles.Num(), [&](int32 ConstraintHandleIndex)
@@ -594,13 +597,21 @@ namespace Chaos
 				FConstraintContainerHandle* ConstraintHandle = InConstraintHandles[ConstraintHandleIndex];
 				check(ConstraintHandle != nullptr);
 
+				bool bNeedsAnotherIteration = false;
 				Collisions::TContactParticleParameters<T> ParticleParameters = { MCullDistance, MShapePadding, &MCollided };
 				Collisions::TContactIterationParameters<T> IterationParameters = { Dt, Iteration, NumIterations, MApplyPushOutPairIterations, ECollisionApplyType::None, &bNeedsAnotherIteration };
 				Collisions::ApplyPushOut(ConstraintHandle->GetContact(), IsTemporarilyStatic, IterationParameters, ParticleParameters);
 
-			}, bDisableCollisionParallelFor);
+				if (bNeedsAnotherIteration)
+				{
+					bNeedsAnotherIterationAtomic.Store(true);
+				}
+
+			}, bDisableCollisionParallelFor || (InConstraintHandles.Num() < ConstraintColorBatchMinParallelSize));
 		}
 
+		const bool bNeedsAnotherIteration = bNeedsAnotherIterationAtomic.Load();
+
 		if (PostApplyPushOutCallback != nullptr)
 		{
 			PostApplyPushOutCallback(Dt, InConstraintHandles, bNeedsAnotherIteration);
@@ -247,6 +247,50 @@ namespace Chaos
 			return AccumulatedImpulse;
 		}
 
+		// Apply the accumulated impulse a contact starts the frame with (warm start from the manifold cache),
+		// so that the accumulated impulse clip solve only has to correct it.
+		void ApplyContactWarmStart(const FCollisionContact& Contact,
+			TGenericParticleHandle<FReal, 3> Particle0,
+			TGenericParticleHandle<FReal, 3> Particle1,
+			const FContactIterationParameters& IterationParameters,
+			const FVec3& Impulse)
+		{
+			TPBDRigidParticleHandle<FReal, 3>* PBDRigid0 = Particle0->CastToRigidParticle();
+			TPBDRigidParticleHandle<FReal, 3>* PBDRigid1 = Particle1->CastToRigidParticle();
+
+			const bool bIsRigidDynamic0 = PBDRigid0 && PBDRigid0->ObjectState() == EObjectStateType::Dynamic;
+			const bool bIsRigidDynamic1 = PBDRigid1 && PBDRigid1->ObjectState() == EObjectStateType::Dynamic;
+
+			if (bIsRigidDynamic0)
+			{
+				FVec3 P0 = FParticleUtilities::GetCoMWorldPosition(Particle0);
+				FRotation3 Q0 = FParticleUtilities::GetCoMWorldRotation(Particle0);
+				const FMatrix33 WorldSpaceInvI1 = Utilities::ComputeWorldSpaceInertia(Q0, PBDRigid0->InvI());
+				const FVec3 DV = PBDRigid0->InvM() * Impulse;
+				const FVec3 DW = WorldSpaceInvI1 * FVec3::CrossProduct(Contact.Location - P0, Impulse);
+				PBDRigid0->V() += DV;
+				PBDRigid0->W() += DW;
+				P0 += (DV * IterationParameters.Dt);
+				Q0 += FRotation3::FromElements(DW, 0.f) * Q0 * IterationParameters.Dt * FReal(0.5);
+				Q0.Normalize();
+				FParticleUtilities::SetCoMWorldTransform(PBDRigid0, P0, Q0);
+			}
+			if (bIsRigidDynamic1)
+			{
+				FVec3 P1 = FParticleUtilities::GetCoMWorldPosition(Particle1);
+				FRotation3 Q1 = FParticleUtilities::GetCoMWorldRotation(Particle1);
+				const FMatrix33 WorldSpaceInvI2 = Utilities::ComputeWorldSpaceInertia(Q1, PBDRigid1->InvI());
+				const FVec3 DV = -PBDRigid1->InvM() * Impulse;
+				const FVec3 DW = WorldSpaceInvI2 * FVec3::CrossProduct(Contact.Location - P1, -Impulse);
+				PBDRigid1->V() += DV;
+				PBDRigid1->W() += DW;
+				P1 += (DV * IterationParameters.Dt);
+				Q1 += FRotation3::FromElements(DW, 0.f) * Q1 * IterationParameters.Dt * FReal(0.5);
+				Q1.Normalize();
+				FParticleUtilities::SetCoMWorldTransform(PBDRigid1, P1, Q1);
+			}
+		}
+
 		// Apply contacts, impulse clipping is done on delta impulses as apposed to Accumulated impulses
 		FVec3 ApplyContact(FCollisionContact& Contact,
 			TGenericParticleHandle<FReal, 3> Particle0, 
@@ -514,6 +558,27 @@ namespace Chaos
 			TGenericParticleHandle<FReal, 3> Particle0 = TGenericParticleHandle<FReal, 3>(Constraint.Particle[0]);
 			TGenericParticleHandle<FReal, 3> Particle1 = TGenericParticleHandle<FReal, 3>(Constraint.Particle[1]);
 
+			// What Apply algorithm should we use? Controlled by the solver, with forcable cvar override for now...
+			bool bUseVelocityMode = (IterationParameters.ApplyType == ECollisionApplyType::Velocity);
+			if (Chaos_Collision_ForceApplyType != 0)
+			{
+				bUseVelocityMode = (Chaos_Collision_ForceApplyType == (int32)ECollisionApplyType::Velocity);
+			}
+
+			// Contacts warm started by the manifold cache begin the frame with the impulse of the previous frame
+			if ((IterationParameters.Iteration == 0) && !Constraint.AccumulatedImpulse.IsZero())
+			{
+				if (bUseVelocityMode && Chaos_Collision_UseAccumulatedImpulseClipSolve)
+				{
+					ApplyContactWarmStart(Constraint.Manifold, Particle0, Particle1, IterationParameters, Constraint.AccumulatedImpulse);
+				}
+				else
+				{
+					// Only the accumulated impulse clip solve can correct a starting impulse, the others just report what they apply
+					Constraint.AccumulatedImpulse = FVec3(0);
+				}
+			}
+
 			for (int32 PairIt = 0; PairIt < IterationParameters.NumPairIterations; ++PairIt)
 			{
 				// Collision is already up-to-date on first iteration (we either just detected it, or updated it in DetectCollisions)
@@ -543,13 +608,6 @@ namespace Chaos
 				//   For example, and iterative constraint might have 4 penetrating points that need to be resolved. 
 				//
 
-				// What Apply algorithm should we use? Controlled by the solver, with forcable cvar override for now...
-				bool bUseVelocityMode = (IterationParameters.ApplyType == ECollisionApplyType::Velocity);
-				if (Chaos_Collision_ForceApplyType != 0)
-				{
-					bUseVelocityMode = (Chaos_Collision_ForceApplyType == (int32)ECollisionApplyType::Velocity);
-				}
-
 				if (bUseVelocityMode)
 				{
 					if (Chaos_Collision_UseAccumulatedImpulseClipSolve)
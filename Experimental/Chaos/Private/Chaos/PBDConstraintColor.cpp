@@ -11,6 +11,7 @@
 #include "ProfilingDebugging/ScopedTimers.h"
 #include "ChaosStats.h"
 #include "Containers/Queue.h"
+#include "HAL/IConsoleManager.h"
 #include "ChaosLog.h"
 
 #include <memory>
@@ -19,6 +20,15 @@
 
 using namespace Chaos;
 
+namespace Chaos
+{
+	int32 ConstraintColorBatchMinParallelSize = 16;
+	FAutoConsoleVariableRef CVarConstraintColorBatchMinParallelSize(TEXT("p.Chaos.Solver.ColorBatchMinParallelSize"), ConstraintColorBatchMinParallelSize, TEXT("Constraints of the same color and level are solved in parallel if there are at least this many of them, smaller batches are solved on the calling thread"));
+
+	int32 ConstraintColorDeterministic = 0;
+	FAutoConsoleVariableRef CVarConstraintColorDeterministic(TEXT("p.Chaos.Solver.DeterministicColoring"), ConstraintColorDeterministic, TEXT("If non-zero, constraints are colored in particle order so that colors (and solve order) do not depend on the order in which constraints were created"));
+}
+
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeColors"), STAT_Constraint_ComputeColor, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeContactGraph"), STAT_Constraint_ComputeContactGraph, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeIslandColoring"), STAT_Constraint_ComputeIslandColoring, STATGROUP_Chaos);
@@ -39,7 +49,21 @@ void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDCo
 	TSet<int32> ProcessedNodes;
 	TArray<int32> NodesToProcess;
 
-	for (const TGeometryParticleHandle<FReal, 3>* Particle :IslandParticles)
+	// Contacts are created by a parallel broadphase and arrive in any order. Visiting particles and their edges
+	// in particle order gives the same colors for the same configuration, whatever order constraints were added in.
+	const bool bDeterministic = (ConstraintColorDeterministic != 0);
+	TArray<TGeometryParticleHandle<FReal, 3>*> SortedIslandParticles;
+	TArray<int32> SortedEdges;
+	if (bDeterministic)
+	{
+		SortedIslandParticles = IslandParticles;
+		SortedIslandParticles.Sort([](const TGeometryParticleHandle<FReal, 3>& L, const TGeometryParticleHandle<FReal, 3>& R)
+		{
+			return L.UniqueIdx() < R.UniqueIdx();
+		});
+	}
+
+	for (const TGeometryParticleHandle<FReal, 3>* Particle : (bDeterministic ? SortedIslandParticles : IslandParticles))
 	{
 		if (!ConstraintGraph.ParticleToNodeIndex.Find(Particle))
 		{
@@ -65,7 +89,23 @@ void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDCo
 			NodesToProcess.SetNum(NodesToProcess.Num() - 1, /*bAllowShrinking=*/false);
 			ProcessedNodes.Add(NodeIndex);
 
-			for (const int32 EdgeIndex : GraphNode.Edges)
+			if (bDeterministic)
+			{
+				// Stable so that multiple constraints between the same particles keep the order they were generated in
+				SortedEdges = GraphNode.Edges;
+				SortedEdges.StableSort([&ConstraintGraph, NodeIndex](const int32 L, const int32 R)
+				{
+					const auto GetOtherParticleIdx = [&ConstraintGraph, NodeIndex](const int32 EdgeIndex)
+					{
+						const typename FPBDConstraintGraph::FGraphEdge& GraphEdge = ConstraintGraph.Edges[EdgeIndex];
+						const int32 OtherNodeIndex = (GraphEdge.FirstNode == NodeIndex) ? GraphEdge.SecondNode : GraphEdge.FirstNode;
+						return (OtherNodeIndex != INDEX_NONE) ? ConstraintGraph.Nodes[OtherNodeIndex].Particle->UniqueIdx().Idx : INDEX_NONE;
+					};
+					return GetOtherParticleIdx(L) < GetOtherParticleIdx(R);
+				});
+			}
+
+			for (const int32 EdgeIndex : (bDeterministic ? SortedEdges : GraphNode.Edges))
 			{
 				const typename FPBDConstraintGraph::FGraphEdge& GraphEdge = ConstraintGraph.Edges[EdgeIndex];
 				FGraphEdgeColor& ColorEdge = Edges[EdgeIndex];
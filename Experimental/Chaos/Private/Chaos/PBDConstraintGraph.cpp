@@ -447,6 +447,9 @@ void FPBDConstraintGraph::ComputeIslands(const TParticleView<TPBDRigidParticles<
 			}
 		}
 
+		// Woken up all at once after the loop, so the particle views are only rebuilt once
+		TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToActivate;
+
 		for (int32 Island = 0; Island < IslandToParticles.Num(); ++Island)
 		{
 			bool bIsSameIsland = true;
@@ -501,12 +504,12 @@ void FPBDConstraintGraph::ComputeIslands(const TParticleView<TPBDRigidParticles<
 							if (!PBDRigid->Disabled())	// todo: why is this needed? [we aren't handling enable/disable state changes properly so disabled particles end up in the graph.]
 							{
 								PBDRigid->SetSleeping(false);
-								Particles.ActivateParticle(Particle);
+								ParticlesToActivate.Add(Particle);
 							}
 						}
 						else
 						{
-							Particles.ActivateParticle(Particle);
+							ParticlesToActivate.Add(Particle);
 						}
 					}
 				}
@@ -518,6 +521,11 @@ void FPBDConstraintGraph::ComputeIslands(const TParticleView<TPBDRigidParticles<
 				IslandToData[OtherIsland].bIsIslandPersistant = bIsSameIsland;
 			}
 		}
+
+		if (ParticlesToActivate.Num())
+		{
+			Particles.ActivateParticles(ParticlesToActivate);
+		}
 	}
 
 	IslandToParticles.Reset();
@@ -67,4 +67,5 @@ namespace Chaos
 	template class TPBDConstraintIslandRule<TPBDPositionConstraints<float, 3>>;
 	template class TPBDConstraintIslandRule<TPBDRigidDynamicSpringConstraints<float, 3>>;
 	template class TPBDConstraintIslandRule<FPBDRigidSpringConstraints>;
+	template class TPBDConstraintColorBatchRule<FPBDJointConstraints>;
 }
\ No newline at end of file
@@ -2,10 +2,12 @@
 #include "Chaos/PBDJointConstraints.h"
 #include "Chaos/ChaosDebugDraw.h"
 #include "Chaos/DebugDrawQueue.h"
+#include "Chaos/Framework/Parallel.h"
 #include "Chaos/Joint/ChaosJointLog.h"
 #include "Chaos/Joint/PBDJointSolverGaussSeidel.h"
 #include "Chaos/Particle/ParticleUtilities.h"
 #include "Chaos/ParticleHandle.h"
+#include "Chaos/PBDConstraintColor.h"
 #include "Chaos/PBDJointConstraintUtilities.h"
 #include "Chaos/Utilities.h"
 #include "ChaosLog.h"
@@ -629,6 +631,91 @@ namespace Chaos
 	//
 	//////////////////////////////////////////////////////////////////////////
 
+	//////////////////////////////////////////////////////////////////////////
+	//
+	// Begin Color Batch API Solver. Iterate over batches of independent constraints, solving each batch in parallel.
+	//
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Calls SolveFunc(ConstraintIndex) for every constraint, batch after batch, and returns the number of active constraints */
+	template<typename TSolveFunc>
+	int32 SolveJointBatches(const TArray<FPBDJointConstraintHandle*>& InConstraintHandles, const TArray<int32>& InBatchEnds, const TSolveFunc& SolveFunc)
+	{
+		TAtomic<int32> NumActive;
+		NumActive.Store(0);
+
+		int32 BatchBegin = 0;
+		for (const int32 BatchEnd : InBatchEnds)
+		{
+			const int32 BatchSize = BatchEnd - BatchBegin;
+			PhysicsParallelFor(BatchSize, [&InConstraintHandles, &SolveFunc, &NumActive, BatchBegin](int32 BatchIndex)
+			{
+				const FJointSolverResult Result = SolveFunc(InConstraintHandles[BatchBegin + BatchIndex]->GetConstraintIndex());
+				if (Result.GetNumActive() > 0)
+				{
+					NumActive += Result.GetNumActive();
+				}
+			}, (BatchSize < ConstraintColorBatchMinParallelSize));
+			BatchBegin = BatchEnd;
+		}
+
+		return NumActive.Load();
+	}
+
+	bool FPBDJointConstraints::Apply(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const TArray<int32>& InBatchEnds, const int32 It, const int32 NumIts)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Joints_Apply);
+
+		// Handles are already ordered root to leaf by the rule, see TPBDConstraintColorBatchRule
+		if (PreApplyCallback != nullptr)
+		{
+			PreApplyCallback(Dt, InConstraintHandles);
+		}
+
+		int32 NumActive = 0;
+		if (Settings.ApplyPairIterations > 0)
+		{
+			NumActive = SolveJointBatches(InConstraintHandles, InBatchEnds, [this, Dt, It, NumIts](const int32 ConstraintIndex)
+			{
+				return SolvePosition_GaussSiedel(Dt, ConstraintIndex, Settings.ApplyPairIterations, It, NumIts);
+			});
+		}
+
+		if (PostApplyCallback != nullptr)
+		{
+			PostApplyCallback(Dt, InConstraintHandles);
+		}
+
+		return (NumActive > 0);
+	}
+
+	bool FPBDJointConstraints::ApplyPushOut(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const TArray<int32>& InBatchEnds, const int32 It, const int32 NumIts)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Joints_ApplyPushOut);
+
+		int32 NumActive = 0;
+		if (Settings.ApplyPushOutPairIterations > 0)
+		{
+			NumActive = SolveJointBatches(InConstraintHandles, InBatchEnds, [this, Dt, It, NumIts](const int32 ConstraintIndex)
+			{
+				return ProjectPosition_GaussSiedel(Dt, ConstraintIndex, Settings.ApplyPushOutPairIterations, It, NumIts);
+			});
+		}
+
+		if (PostProjectCallback != nullptr)
+		{
+			PostProjectCallback(Dt, InConstraintHandles);
+		}
+
+		return (NumActive > 0);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	//
+	// End Color Batch API Solver.
+	//
+	//////////////////////////////////////////////////////////////////////////
+
 
 	//////////////////////////////////////////////////////////////////////////
 	//
@@ -6,6 +6,7 @@
 #include "Chaos/PBDRigidsEvolutionGBF.h"
 #include "Chaos/ParticleHandle.h"
 #include "Chaos/SpatialAccelerationCollection.h"
+#include "Chaos/WideAABBTree.h"
 
 int32 ChaosRigidsEvolutionApplyAllowEarlyOutCVar = 1;
 FAutoConsoleVariableRef CVarChaosRigidsEvolutionApplyAllowEarlyOut(TEXT("p.ChaosRigidsEvolutionApplyAllowEarlyOut"), ChaosRigidsEvolutionApplyAllowEarlyOutCVar, TEXT("Allow Chaos Rigids Evolution apply iterations to early out when resolved.[def:1]"));
@@ -48,7 +49,7 @@ namespace Chaos
 		}
 	} ConfigSettings;
 
-	FAutoConsoleVariableRef CVarBroadphaseIsTree(TEXT("p.BroadphaseType"), ConfigSettings.BroadphaseType, TEXT(""));
+	FAutoConsoleVariableRef CVarBroadphaseIsTree(TEXT("p.BroadphaseType"), ConfigSettings.BroadphaseType, TEXT("5: 4-wide quantized AABB tree for static and bounding volume for dynamic bodies, 6: same with 8-wide tree"));
 	FAutoConsoleVariableRef CVarBoundingVolumeNumCells(TEXT("p.BoundingVolumeNumCells"), ConfigSettings.BVNumCells, TEXT(""));
 	FAutoConsoleVariableRef CVarMaxChildrenInLeaf(TEXT("p.MaxChildrenInLeaf"), ConfigSettings.MaxChildrenInLeaf, TEXT(""));
 	FAutoConsoleVariableRef CVarMaxTreeDepth(TEXT("p.MaxTreeDepth"), ConfigSettings.MaxTreeDepth, TEXT(""));
@@ -64,13 +65,15 @@ namespace Chaos
 		using BVType = TBoundingVolume<TAccelerationStructureHandle<FReal, 3>, FReal, 3>;
 		using AABBTreeType = TAABBTree<TAccelerationStructureHandle<FReal, 3>, TAABBTreeLeafArray<TAccelerationStructureHandle<FReal, 3>, FReal>, FReal>;
 		using AABBTreeOfGridsType = TAABBTree<TAccelerationStructureHandle<FReal, 3>, TBoundingVolume<TAccelerationStructureHandle<FReal, 3>, FReal, 3>, FReal>;
+		using WideAABBTreeType = TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>;
+		using WideAABBTree8Type = TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>;
 
 		TUniquePtr<ISpatialAccelerationCollection<TAccelerationStructureHandle<FReal, 3>, FReal, 3>> CreateEmptyCollection() override
 		{
 			TConstParticleView<FSpatialAccelerationCache> Empty;
 
 			const uint16 NumBuckets = ConfigSettings.BroadphaseType >= 3 ? 2 : 1;
-			auto Collection = new TSpatialAccelerationCollection<AABBTreeType, BVType, AABBTreeOfGridsType>();
+			auto Collection = new TSpatialAccelerationCollection<AABBTreeType, BVType, AABBTreeOfGridsType, WideAABBTreeType, WideAABBTree8Type>();
 
 			for (uint16 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)
 			{
@@ -103,10 +106,18 @@ namespace Chaos
 				{
 					return MakeUnique<AABBTreeOfGridsType>(Particles, ConfigSettings.AABBMaxChildrenInLeaf, ConfigSettings.AABBMaxTreeDepth, ConfigSettings.MaxPayloadSize);
 				}
+				else if (ConfigSettings.BroadphaseType == 5)
+				{
+					return MakeUnique<WideAABBTreeType>(Particles, ConfigSettings.MaxChildrenInLeaf, ConfigSettings.MaxTreeDepth, ConfigSettings.MaxPayloadSize);
+				}
+				else if (ConfigSettings.BroadphaseType == 6)
+				{
+					return MakeUnique<WideAABBTree8Type>(Particles, ConfigSettings.MaxChildrenInLeaf, ConfigSettings.MaxTreeDepth, ConfigSettings.MaxPayloadSize);
+				}
 			}
 			case 1:
 			{
-				ensure(ConfigSettings.BroadphaseType == 3 || ConfigSettings.BroadphaseType == 4);
+				ensure(ConfigSettings.BroadphaseType >= 3 && ConfigSettings.BroadphaseType <= 6);
 				return MakeUnique<BVType>(Particles, false, 0, ConfigSettings.BVNumCells, ConfigSettings.MaxPayloadSize);
 			}
 			default:
@@ -218,6 +229,18 @@ namespace Chaos
 			Collection->AddSubstructure(MoveTemp(Substructure), 0);
 			return Collection;
 		}
+		else if (Substructure->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>>())
+		{
+			auto Collection = MakeUnique<TSpatialAccelerationCollection<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>>>();
+			Collection->AddSubstructure(MoveTemp(Substructure), 0);
+			return Collection;
+		}
+		else if (Substructure->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>>())
+		{
+			auto Collection = MakeUnique<TSpatialAccelerationCollection<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>>>();
+			Collection->AddSubstructure(MoveTemp(Substructure), 0);
+			return Collection;
+		}
 		else
 		{
 			using AccelType = TAABBTree<TAccelerationStructureHandle<FReal, 3>, TBoundingVolume<TAccelerationStructureHandle<FReal, 3>, FReal, 3>, FReal>;
@@ -19,7 +19,9 @@
 #include "Chaos/DebugDrawQueue.h"
 #include "Misc/ScopeLock.h"
 #include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
 #include "HAL/FileManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 //PRAGMA_DISABLE_OPTIMIZATION
 
@@ -58,6 +60,21 @@ FAutoConsoleVariableRef CVarHackCCDVelThreshold(TEXT("p.Chaos.CCD.EnableThreshol
 float HackCCD_DepthThreshold = 0.05f;
 FAutoConsoleVariableRef CVarHackCCDDepthThreshold(TEXT("p.Chaos.CCD.DepthThreshold"), HackCCD_DepthThreshold, TEXT("When returning to TOI, leave this much contact depth (as a fraction of MinBounds)"));
 
+int32 ChaosSolverIslandBatching = 1;
+FAutoConsoleVariableRef CVarChaosSolverIslandBatching(TEXT("p.Chaos.Solver.IslandBatching"), ChaosSolverIslandBatching, TEXT("Whether islands are grouped into solver tasks by estimated cost, largest first, instead of one task per island."));
+
+int32 ChaosSolverIslandBatchCost = 256;
+FAutoConsoleVariableRef CVarChaosSolverIslandBatchCost(TEXT("p.Chaos.Solver.IslandBatchCost"), ChaosSolverIslandBatchCost, TEXT("Small islands are merged into a solver task until its estimated cost (constraints times iterations, plus particles) reaches this."));
+
+int32 ChaosSolverIslandStats = 0;
+FAutoConsoleVariableRef CVarChaosSolverIslandStats(TEXT("p.Chaos.Solver.IslandStats"), ChaosSolverIslandStats, TEXT("Measure the solve time of each island, for p.Chaos.Solver.DebugDrawIslands and the ChaosIslands csv category."));
+
+#if !UE_BUILD_SHIPPING
+// set from the console, consumed by the physics thread
+TAtomic<bool> bPendingIslandStatsDump(false);
+FAutoConsoleCommand DumpIslandStatsCommand(TEXT("p.Chaos.Solver.DumpIslandStats"), TEXT("Write the islands of the next step with their size, estimated cost, task and solve time to a csv file in the profiling directory."), FConsoleCommandDelegate::CreateLambda([]() { bPendingIslandStatsDump = true; }));
+#endif
+
 
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::AdvanceOneTimeStep"), STAT_Evolution_AdvanceOneTimeStep, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::Integrate"), STAT_Evolution_Integrate, STATGROUP_Chaos);
@@ -71,9 +88,12 @@ DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::DetectCollisions"), STAT_Evolut
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::UpdateConstraintPositionBasedState"), STAT_Evolution_UpdateConstraintPositionBasedState, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::CreateConstraintGraph"), STAT_Evolution_CreateConstraintGraph, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::CreateIslands"), STAT_Evolution_CreateIslands, STATGROUP_Chaos);
+DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::BuildIslandBatches"), STAT_Evolution_BuildIslandBatches, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::ParallelSolve"), STAT_Evolution_ParallelSolve, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDRigidsEvolutionGBF::DeactivateSleep"), STAT_Evolution_DeactivateSleep, STATGROUP_Chaos);
 
+CSV_DEFINE_CATEGORY(ChaosIslands, false);
+
 int32 SerializeEvolution = 0;
 FAutoConsoleVariableRef CVarSerializeEvolution(TEXT("p.SerializeEvolution"), SerializeEvolution, TEXT(""));
 
@@ -200,6 +220,14 @@ void MoveToTOIHack(FReal Dt, TTransientPBDRigidParticleHandle<FReal, 3>& Particl
 	{
 		MoveToTOIHackImpl(Dt, Particle, AABBTreeBV);
 	}
+	else if (const auto WideAABBTree = SpatialAcceleration->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>>())
+	{
+		MoveToTOIHackImpl(Dt, Particle, WideAABBTree);
+	}
+	else if (const auto WideAABBTree8 = SpatialAcceleration->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>>())
+	{
+		MoveToTOIHackImpl(Dt, Particle, WideAABBTree8);
+	}
 	else if (const auto Collection = SpatialAcceleration->template As<ISpatialAccelerationCollection<TAccelerationStructureHandle<FReal, 3>, FReal, 3>>())
 	{
 		Collection->CallMoveToTOIHack(Dt, Particle);
@@ -326,6 +354,18 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 		PreApplyCallback();
 	}
 
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Evolution_BuildIslandBatches);
+		BuildIslandBatches();
+	}
+
+#if !UE_BUILD_SHIPPING
+	const bool bDumpIslandStats = bPendingIslandStatsDump.Exchange(false);
+#else
+	const bool bDumpIslandStats = false;
+#endif
+	const bool bMeasureIslands = ChaosSolverIslandStats != 0 || bDumpIslandStats;
+
 	TArray<bool> SleepedIslands;
 	SleepedIslands.SetNum(GetConstraintGraph().NumIslands());
 	TArray<TArray<TPBDRigidParticleHandle<FReal, 3>*>> DisabledParticles;
@@ -334,7 +374,7 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 	if(Dt > 0)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Evolution_ParallelSolve);
-		PhysicsParallelFor(GetConstraintGraph().NumIslands(), [&](int32 Island) {
+		const auto SolveIsland = [&](const int32 Island) {
 			const TArray<TGeometryParticleHandle<FReal, 3>*>& IslandParticles = GetConstraintGraph().GetIslandParticles(Island);
 
 			{
@@ -397,9 +437,61 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 
 			// Turn off if not moving
 			SleepedIslands[Island] = GetConstraintGraph().SleepInactive(Island, PhysicsMaterials);
+		};
+
+		PhysicsParallelFor(GetNumIslandBatches(), [&](int32 Batch) {
+			for (int32 BatchIndex = IslandBatchStarts[Batch]; BatchIndex < IslandBatchStarts[Batch + 1]; ++BatchIndex)
+			{
+				const int32 Island = IslandBatchIslands[BatchIndex];
+				if (bMeasureIslands)
+				{
+					const double StartTime = FPlatformTime::Seconds();
+					SolveIsland(Island);
+					IslandStats[Island].Seconds = FPlatformTime::Seconds() - StartTime;
+				}
+				else
+				{
+					SolveIsland(Island);
+				}
+			}
 		});
 	}
 
+	CSV_CUSTOM_STAT(ChaosIslands, NumIslands, GetConstraintGraph().NumIslands(), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ChaosIslands, NumIslandBatches, GetNumIslandBatches(), ECsvCustomStatOp::Accumulate);
+	if (bMeasureIslands)
+	{
+		// The slowest task bounds the solve time from below however many workers there are
+		int32 MaxIslandCost = 0;
+		double MaxIslandSeconds = 0;
+		double MaxBatchSeconds = 0;
+		double TotalSeconds = 0;
+		for (int32 Batch = 0; Batch < GetNumIslandBatches(); ++Batch)
+		{
+			double BatchSeconds = 0;
+			for (int32 BatchIndex = IslandBatchStarts[Batch]; BatchIndex < IslandBatchStarts[Batch + 1]; ++BatchIndex)
+			{
+				const FIslandSolveStats& Stats = IslandStats[IslandBatchIslands[BatchIndex]];
+				MaxIslandCost = FMath::Max(MaxIslandCost, Stats.Cost);
+				MaxIslandSeconds = FMath::Max(MaxIslandSeconds, Stats.Seconds);
+				BatchSeconds += Stats.Seconds;
+			}
+			MaxBatchSeconds = FMath::Max(MaxBatchSeconds, BatchSeconds);
+			TotalSeconds += BatchSeconds;
+		}
+		CSV_CUSTOM_STAT(ChaosIslands, MaxIslandCost, MaxIslandCost, ECsvCustomStatOp::Max);
+		CSV_CUSTOM_STAT(ChaosIslands, MaxIslandMs, (float)(MaxIslandSeconds * 1000.0), ECsvCustomStatOp::Max);
+		CSV_CUSTOM_STAT(ChaosIslands, MaxIslandBatchMs, (float)(MaxBatchSeconds * 1000.0), ECsvCustomStatOp::Max);
+		CSV_CUSTOM_STAT(ChaosIslands, TotalIslandMs, (float)(TotalSeconds * 1000.0), ECsvCustomStatOp::Accumulate);
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (bDumpIslandStats)
+	{
+		DumpIslandStats();
+	}
+#endif
+
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Evolution_UnprepareConstraints);
 		UnprepareConstraints(Dt);
@@ -407,12 +499,23 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Evolution_DeactivateSleep);
+
+		// All the islands that fell asleep at once, so the particle views are only rebuilt once
+		TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToDeactivate;
 		for (int32 Island = 0; Island < GetConstraintGraph().NumIslands(); ++Island)
 		{
 			if (SleepedIslands[Island])
 			{
-				Particles.DeactivateParticles(GetConstraintGraph().GetIslandParticles(Island));
+				ParticlesToDeactivate.Append(GetConstraintGraph().GetIslandParticles(Island));
 			}
+		}
+		if (ParticlesToDeactivate.Num())
+		{
+			Particles.DeactivateParticles(ParticlesToDeactivate);
+		}
+
+		for (int32 Island = 0; Island < GetConstraintGraph().NumIslands(); ++Island)
+		{
 			for (const auto Particle : DisabledParticles[Island])
 			{
 				DisableParticle(Particle);
@@ -425,6 +528,90 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 	ParticleUpdatePosition(Particles.GetActiveParticlesView(), Dt);
 }
 
+void FPBDRigidsEvolutionGBF::BuildIslandBatches()
+{
+	const int32 NumIslands = GetConstraintGraph().NumIslands();
+	const int32 IterationCost = NumIterations + NumPushOutIterations;
+
+	IslandStats.SetNum(NumIslands);
+	IslandBatchIslands.SetNum(NumIslands);
+	for (int32 Island = 0; Island < NumIslands; ++Island)
+	{
+		FIslandSolveStats& Stats = IslandStats[Island];
+		Stats.NumParticles = GetConstraintGraph().GetIslandParticles(Island).Num();
+		Stats.NumConstraints = GetConstraintGraph().GetIslandConstraintData(Island).Num();
+		Stats.Cost = Stats.NumConstraints * IterationCost + Stats.NumParticles;
+		Stats.Batch = Island;
+		Stats.Seconds = 0;
+		IslandBatchIslands[Island] = Island;
+	}
+
+	IslandBatchStarts.Reset();
+	if (!ChaosSolverIslandBatching)
+	{
+		for (int32 Island = 0; Island <= NumIslands; ++Island)
+		{
+			IslandBatchStarts.Add(Island);
+		}
+		return;
+	}
+
+	// Largest first so that the long tasks start early, ties in island order so that the tasks do not change between runs
+	IslandBatchIslands.Sort([this](const int32 IslandA, const int32 IslandB)
+	{
+		const int32 CostA = IslandStats[IslandA].Cost;
+		const int32 CostB = IslandStats[IslandB].Cost;
+		return CostA > CostB || (CostA == CostB && IslandA < IslandB);
+	});
+
+	int32 BatchCost = 0;
+	for (int32 BatchIndex = 0; BatchIndex < NumIslands; ++BatchIndex)
+	{
+		FIslandSolveStats& Stats = IslandStats[IslandBatchIslands[BatchIndex]];
+		if (IslandBatchStarts.Num() == 0 || BatchCost + Stats.Cost > ChaosSolverIslandBatchCost)
+		{
+			IslandBatchStarts.Add(BatchIndex);
+			BatchCost = 0;
+		}
+		BatchCost += Stats.Cost;
+		Stats.Batch = IslandBatchStarts.Num() - 1;
+	}
+	IslandBatchStarts.Add(NumIslands);
+}
+
+void FPBDRigidsEvolutionGBF::DumpIslandStats() const
+{
+#if !UE_BUILD_SHIPPING
+	FString Csv = TEXT("Island,NumParticles,NumConstraints,Cost,Batch,Milliseconds\n");
+	for (int32 Island = 0; Island < IslandStats.Num(); ++Island)
+	{
+		const FIslandSolveStats& Stats = IslandStats[Island];
+		Csv += FString::Printf(TEXT("%d,%d,%d,%d,%d,%.4f\n"), Island, Stats.NumParticles, Stats.NumConstraints, Stats.Cost, Stats.Batch, Stats.Seconds * 1000.0);
+	}
+
+	const FString FullPathPrefix = FPaths::ProfilingDir() / TEXT("ChaosIslandStats");
+
+	static FCriticalSection CS;	//many evolutions could be running in parallel, write one at a time to avoid file conflicts
+	FScopeLock Lock(&CS);
+
+	int32 Tries = 0;
+	FString UseFileName;
+	do
+	{
+		UseFileName = FString::Printf(TEXT("%s_%d.csv"), *FullPathPrefix, Tries++);
+	} while (IFileManager::Get().FileExists(*UseFileName));
+
+	if (FFileHelper::SaveStringToFile(Csv, *UseFileName))
+	{
+		UE_LOG(LogChaos, Log, TEXT("%d islands in %d tasks written to %s"), IslandStats.Num(), GetNumIslandBatches(), *UseFileName);
+	}
+	else
+	{
+		UE_LOG(LogChaos, Warning, TEXT("Could not create file(%s)"), *UseFileName);
+	}
+#endif
+}
+
 FPBDRigidsEvolutionGBF::FPBDRigidsEvolutionGBF(TPBDRigidsSOAs<FReal, 3>& InParticles, int32 InNumIterations, int32 InNumPushoutIterations, bool InIsSingleThreaded)
 	: Base(InParticles, InNumIterations, InNumPushoutIterations, InIsSingleThreaded)
 	, Clustering(*this, Particles.GetClusteredParticles())
@@ -0,0 +1,10 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/PBDRigidsSOAs.h"
+#include "HAL/IConsoleManager.h"
+
+namespace Chaos
+{
+	int32 Chaos_Particles_SleepingColdStorage = 1;
+	FAutoConsoleVariableRef CVarChaosParticlesSleepingColdStorage(TEXT("p.Chaos.Particles.SleepingColdStorage"), Chaos_Particles_SleepingColdStorage, TEXT("Whether new solvers move sleeping rigid particles out of the dynamic particle arrays, so that the awake ones stay packed together."));
+}
@@ -0,0 +1,510 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/RewindData.h"
+#include "Chaos/ChaosPerfTest.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
+#include "ChaosLog.h"
+#include "ChaosStats.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("FRewindData::CaptureFrame"), STAT_Rewind_CaptureFrame, STATGROUP_Chaos);
+DECLARE_CYCLE_STAT(TEXT("FRewindData::Resimulate"), STAT_Rewind_Resimulate, STATGROUP_Chaos);
+
+namespace Chaos
+{
+	int32 Chaos_Rewind_ResimAffectedIslandsOnly = 1;
+	FAutoConsoleVariableRef CVarChaosRewindResimAffectedIslandsOnly(TEXT("p.Chaos.Rewind.ResimAffectedIslandsOnly"), Chaos_Rewind_ResimAffectedIslandsOnly, TEXT("Whether resimulations only simulate the islands of the corrected particles and replay the other particles from the history, instead of simulating all particles."));
+
+	void FRewindData::FFrame::Reset()
+	{
+		Entries.Reset();
+		Vectors.Reset();
+		Rotations.Reset();
+		ObjectStates.Reset();
+		Dt = 0;
+	}
+
+	void FRewindData::FFrame::Add(TPBDRigidParticleHandle<FReal, 3>* Particle, const FParticleDirtyFlags Dirty, const FParticleState& State)
+	{
+		FFrameEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Particle = Particle;
+		Entry.Dirty = Dirty;
+		Entry.VectorIndex = Vectors.Num();
+		Entry.RotationIndex = Rotations.Num();
+		Entry.ObjectStateIndex = ObjectStates.Num();
+
+		if (Dirty.IsDirty(EParticleFlags::X))
+		{
+			Vectors.Add(State.X);
+		}
+		if (Dirty.IsDirty(EParticleFlags::V))
+		{
+			Vectors.Add(State.V);
+		}
+		if (Dirty.IsDirty(EParticleFlags::W))
+		{
+			Vectors.Add(State.W);
+		}
+		if (Dirty.IsDirty(EParticleFlags::R))
+		{
+			Rotations.Add(State.R);
+		}
+		if (Dirty.IsDirty(EParticleFlags::ObjectState))
+		{
+			ObjectStates.Add(State.ObjectState);
+		}
+	}
+
+	FRewindData::FParticleState FRewindData::FFrame::Apply(const FFrameEntry& Entry, const FParticleState& Base) const
+	{
+		FParticleState State = Base;
+		int32 VectorIndex = Entry.VectorIndex;
+		if (Entry.Dirty.IsDirty(EParticleFlags::X))
+		{
+			State.X = Vectors[VectorIndex++];
+		}
+		if (Entry.Dirty.IsDirty(EParticleFlags::V))
+		{
+			State.V = Vectors[VectorIndex++];
+		}
+		if (Entry.Dirty.IsDirty(EParticleFlags::W))
+		{
+			State.W = Vectors[VectorIndex++];
+		}
+		if (Entry.Dirty.IsDirty(EParticleFlags::R))
+		{
+			State.R = Rotations[Entry.RotationIndex];
+		}
+		if (Entry.Dirty.IsDirty(EParticleFlags::ObjectState))
+		{
+			State.ObjectState = ObjectStates[Entry.ObjectStateIndex];
+		}
+		return State;
+	}
+
+	SIZE_T FRewindData::FFrame::GetAllocatedSize() const
+	{
+		return Entries.GetAllocatedSize() + Vectors.GetAllocatedSize() + Rotations.GetAllocatedSize() + ObjectStates.GetAllocatedSize();
+	}
+
+	FRewindData::FRewindData(const int32 InMaxFrames)
+		: Head(0)
+		, NumFrames(0)
+		, LastResimNumSimulated(0)
+		, LastResimNumReplayed(0)
+		, LastResimSeconds(0)
+	{
+		Frames.SetNum(FMath::Max(InMaxFrames, 1));
+	}
+
+	FRewindData::FParticleState FRewindData::GetState(TPBDRigidParticleHandle<FReal, 3>* Particle) const
+	{
+		FParticleState State{ Particle->X(), Particle->R(), Particle->V(), Particle->W(), Particle->ObjectState() };
+
+		// replayed particles are kept asleep, the history keeps the state they had when recorded
+		if (const EObjectStateType* ReplayedObjectState = ReplayedObjectStates.Find(Particle))
+		{
+			State.ObjectState = *ReplayedObjectState;
+		}
+		return State;
+	}
+
+	FParticleDirtyFlags FRewindData::Diff(const FParticleState& A, const FParticleState& B)
+	{
+		FParticleDirtyFlags Dirty;
+		if (A.X != B.X)
+		{
+			Dirty.MarkDirty(EParticleFlags::X);
+		}
+		if (A.R != B.R)
+		{
+			Dirty.MarkDirty(EParticleFlags::R);
+		}
+		if (A.V != B.V)
+		{
+			Dirty.MarkDirty(EParticleFlags::V);
+		}
+		if (A.W != B.W)
+		{
+			Dirty.MarkDirty(EParticleFlags::W);
+		}
+		if (A.ObjectState != B.ObjectState)
+		{
+			Dirty.MarkDirty(EParticleFlags::ObjectState);
+		}
+		return Dirty;
+	}
+
+	void FRewindData::SetState(FPBDRigidsEvolutionGBF& Evolution, TPBDRigidParticleHandle<FReal, 3>& Particle, const FParticleState& State)
+	{
+		Particle.SetX(State.X);
+		Particle.SetP(State.X);
+		Particle.SetR(State.R);
+		Particle.SetQ(State.R);
+		Particle.SetV(State.V);
+		Particle.SetW(State.W);
+		if (Particle.HasBounds())
+		{
+			Particle.SetWorldSpaceInflatedBounds(Particle.LocalBounds().TransformedAABB(FRigidTransform3(State.X, State.R)));
+		}
+		Evolution.DirtyParticle(Particle);
+	}
+
+	void FRewindData::CaptureFrame(FPBDRigidsEvolutionGBF& Evolution, const FReal Dt)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Rewind_CaptureFrame);
+
+		Head = (Head + 1) % Frames.Num();
+		NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+		FFrame& Frame = Frames[Head];
+		Frame.Reset();
+		Frame.Dt = Dt;
+
+		for (auto& Particle : Evolution.GetParticles().GetNonDisabledDynamicView())
+		{
+			TPBDRigidParticleHandle<FReal, 3>* Handle = Particle.Handle();
+			const FParticleState State = GetState(Handle);
+			if (FParticleState* LatestState = LatestStates.Find(Handle))
+			{
+				const FParticleDirtyFlags Dirty = Diff(*LatestState, State);
+				if (Dirty.IsDirty())
+				{
+					Frame.Add(Handle, Dirty, *LatestState);
+					*LatestState = State;
+				}
+			}
+			else
+			{
+				// New particle, rewinding past this frame leaves it where it is first seen
+				LatestStates.Add(Handle, State);
+			}
+		}
+	}
+
+	void FRewindData::Rewind(FPBDRigidsEvolutionGBF& Evolution, const int32 NumFramesToRewind, TArray<FFrame>& RedoFrames)
+	{
+		// Undo the frames on the latest states only, the particles are set once at the end
+		TSet<TPBDRigidParticleHandle<FReal, 3>*> RewoundParticles;
+		RedoFrames.SetNum(NumFramesToRewind);
+		for (int32 FramesAgo = 0; FramesAgo < NumFramesToRewind; ++FramesAgo)
+		{
+			const FFrame& Frame = Frames[GetFrameIndex(FramesAgo)];
+			FFrame& RedoFrame = RedoFrames[NumFramesToRewind - 1 - FramesAgo];
+			RedoFrame.Reset();
+			RedoFrame.Dt = Frame.Dt;
+			for (const FFrameEntry& Entry : Frame.Entries)
+			{
+				FParticleState& LatestState = LatestStates.FindChecked(Entry.Particle);
+				RedoFrame.Add(Entry.Particle, Entry.Dirty, LatestState);
+				LatestState = Frame.Apply(Entry, LatestState);
+				RewoundParticles.Add(Entry.Particle);
+			}
+		}
+		Head = GetFrameIndex(NumFramesToRewind);
+		NumFrames -= NumFramesToRewind;
+
+		TPBDRigidsSOAs<FReal, 3>& Particles = Evolution.GetParticles();
+		TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToSleep;
+		TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToWake;
+		for (TPBDRigidParticleHandle<FReal, 3>* Particle : RewoundParticles)
+		{
+			const FParticleState& State = LatestStates.FindChecked(Particle);
+			SetState(Evolution, *Particle, State);
+			if (State.ObjectState == EObjectStateType::Sleeping && Particle->ObjectState() == EObjectStateType::Dynamic)
+			{
+				ParticlesToSleep.Add(Particle);
+			}
+			else if (State.ObjectState == EObjectStateType::Dynamic && Particle->ObjectState() == EObjectStateType::Sleeping)
+			{
+				ParticlesToWake.Add(Particle);
+			}
+		}
+		if (ParticlesToSleep.Num() > 0)
+		{
+			Particles.DeactivateParticles(ParticlesToSleep);
+		}
+		if (ParticlesToWake.Num() > 0)
+		{
+			Particles.ActivateParticles(ParticlesToWake);
+		}
+	}
+
+	void FRewindData::SetLatestState(TPBDRigidParticleHandle<FReal, 3>* Particle, const FParticleState& State)
+	{
+		FParticleState* LatestState = LatestStates.Find(Particle);
+		if (LatestState == nullptr)
+		{
+			// Not seen yet, like in CaptureFrame rewinding past this frame leaves it where it is first seen
+			LatestStates.Add(Particle, State);
+			return;
+		}
+
+		if (NumFrames > 0)
+		{
+			// The latest frame holds the values from before its step of what changed during it, the other values are the
+			// latest ones, which are about to be replaced: merge them into a single entry with all values from before the step
+			FFrame& Frame = Frames[Head];
+			FParticleState StateBeforeFrame = *LatestState;
+			const int32 EntryIndex = Frame.Entries.IndexOfByPredicate([Particle](const FFrameEntry& Entry) { return Entry.Particle == Particle; });
+			if (EntryIndex != INDEX_NONE)
+			{
+				StateBeforeFrame = Frame.Apply(Frame.Entries[EntryIndex], StateBeforeFrame);
+				// the values of the entry stay unused in the arrays of the frame, the other entries keep their indices
+				Frame.Entries.RemoveAtSwap(EntryIndex, 1, false);
+			}
+
+			const FParticleDirtyFlags Dirty = Diff(StateBeforeFrame, State);
+			if (Dirty.IsDirty())
+			{
+				Frame.Add(Particle, Dirty, StateBeforeFrame);
+			}
+		}
+
+		*LatestState = State;
+	}
+
+	bool FRewindData::Resimulate(FPBDRigidsEvolutionGBF& Evolution, const int32 NumFramesToRewind, TArrayView<const FRewindCorrection> Corrections)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Rewind_Resimulate);
+
+		if (NumFramesToRewind < 1 || NumFramesToRewind > NumFrames)
+		{
+			return false;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TPBDRigidsSOAs<FReal, 3>& Particles = Evolution.GetParticles();
+
+		TArray<FFrame> RedoFrames;
+		Rewind(Evolution, NumFramesToRewind, RedoFrames);
+
+		// The corrections become the recorded state of the frame we resimulate from, rewinding past it undoes them
+		TSet<TPBDRigidParticleHandle<FReal, 3>*> CorrectedParticles;
+		for (const FRewindCorrection& Correction : Corrections)
+		{
+			TPBDRigidParticleHandle<FReal, 3>* Particle = Correction.Particle;
+			if (Particle->ObjectState() == EObjectStateType::Sleeping)
+			{
+				Particles.ActivateParticle(Particle);
+			}
+			const FParticleState State{ Correction.X, Correction.R, Correction.V, Correction.W, Particle->ObjectState() };
+			SetState(Evolution, *Particle, State);
+			SetLatestState(Particle, State);
+			CorrectedParticles.Add(Particle);
+		}
+
+		// Put everything else to sleep, to be replayed unless the islands of the corrected particles wake it up
+		if (Chaos_Rewind_ResimAffectedIslandsOnly)
+		{
+			TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToSleep;
+			for (auto& Particle : Particles.GetNonDisabledDynamicView())
+			{
+				TPBDRigidParticleHandle<FReal, 3>* Handle = Particle.Handle();
+				const EObjectStateType ObjectState = Handle->ObjectState();
+				if (!CorrectedParticles.Contains(Handle) && (ObjectState == EObjectStateType::Dynamic || ObjectState == EObjectStateType::Sleeping))
+				{
+					ReplayedObjectStates.Add(Handle, ObjectState);
+					if (ObjectState == EObjectStateType::Dynamic)
+					{
+						ParticlesToSleep.Add(Handle);
+					}
+				}
+			}
+			if (ParticlesToSleep.Num() > 0)
+			{
+				Particles.DeactivateParticles(ParticlesToSleep);
+			}
+		}
+
+		for (const FFrame& RedoFrame : RedoFrames)
+		{
+			Evolution.AdvanceOneTimeStep(RedoFrame.Dt);
+
+			if (ReplayedObjectStates.Num() > 0)
+			{
+				// The islands woke these up, they are simulated from now on
+				for (auto It = ReplayedObjectStates.CreateIterator(); It; ++It)
+				{
+					if (It.Key()->ObjectState() == EObjectStateType::Dynamic)
+					{
+						It.RemoveCurrent();
+					}
+				}
+
+				for (const FFrameEntry& Entry : RedoFrame.Entries)
+				{
+					if (EObjectStateType* ReplayedObjectState = ReplayedObjectStates.Find(Entry.Particle))
+					{
+						const FParticleState State = RedoFrame.Apply(Entry, GetState(Entry.Particle));
+						SetState(Evolution, *Entry.Particle, State);
+						*ReplayedObjectState = State.ObjectState;
+					}
+				}
+			}
+
+			CaptureFrame(Evolution, RedoFrame.Dt);
+		}
+
+		LastResimNumReplayed = ReplayedObjectStates.Num();
+		LastResimNumSimulated = Particles.GetNonDisabledDynamicView().Num() - LastResimNumReplayed;
+
+		TArray<TGeometryParticleHandle<FReal, 3>*> ParticlesToWake;
+		for (const TPair<TPBDRigidParticleHandle<FReal, 3>*, EObjectStateType>& ReplayedObjectState : ReplayedObjectStates)
+		{
+			if (ReplayedObjectState.Value == EObjectStateType::Dynamic)
+			{
+				ParticlesToWake.Add(ReplayedObjectState.Key);
+			}
+		}
+		if (ParticlesToWake.Num() > 0)
+		{
+			Particles.ActivateParticles(ParticlesToWake);
+		}
+		ReplayedObjectStates.Reset();
+
+		LastResimSeconds = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogChaos, Verbose, TEXT("Resimulated %d frames in %.3f ms: %d particles simulated, %d replayed"), NumFramesToRewind, LastResimSeconds * 1000.0, LastResimNumSimulated, LastResimNumReplayed);
+		return true;
+	}
+
+	void FRewindData::RemoveParticle(TPBDRigidParticleHandle<FReal, 3>* Particle)
+	{
+		LatestStates.Remove(Particle);
+		for (FFrame& Frame : Frames)
+		{
+			// the other entries keep their indices into the arrays of the frame
+			Frame.Entries.RemoveAllSwap([Particle](const FFrameEntry& Entry) { return Entry.Particle == Particle; });
+		}
+	}
+
+	void FRewindData::Reset()
+	{
+		for (FFrame& Frame : Frames)
+		{
+			Frame.Reset();
+		}
+		Head = 0;
+		NumFrames = 0;
+		LatestStates.Reset();
+	}
+
+	SIZE_T FRewindData::GetFrameAllocatedSize(const int32 FramesAgo) const
+	{
+		return FramesAgo < NumFrames ? Frames[GetFrameIndex(FramesAgo)].GetAllocatedSize() : 0;
+	}
+
+	SIZE_T FRewindData::GetAllocatedSize() const
+	{
+		SIZE_T Size = Frames.GetAllocatedSize() + LatestStates.GetAllocatedSize() + ReplayedObjectStates.GetAllocatedSize();
+		for (const FFrame& Frame : Frames)
+		{
+			Size += Frame.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+#if !UE_BUILD_SHIPPING && CHAOS_PERF_TEST_ENABLED
+	namespace RewindBenchmark
+	{
+		void RewindBenchmark(const TArray<FString>& Args)
+		{
+			const int32 NumStacks = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+			const int32 StackHeight = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 5;
+			const int32 MaxFrames = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 60;
+			const int32 NumFramesToRewind = Args.Num() > 3 ? FMath::Clamp(FCString::Atoi(*Args[3]), 1, MaxFrames) : FMath::Min(10, MaxFrames);
+			const FReal Dt = (FReal)1 / 60;
+			const FReal BoxMass = 100;
+			const FVec3 BoxHalfExtents(50);
+
+			TArray<TUniquePtr<FImplicitObject>> Geometries;
+			TPBDRigidsSOAs<FReal, 3> Particles;
+			FPBDRigidsEvolutionGBF Evolution(Particles);
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> Boxes;
+
+			// Ground with its top at Z = 0, and towers dropped on it a little apart, one island per tower
+			PerfTestUtilities::InitBoxParticle(Evolution.CreateStaticParticles(1)[0], FVec3(0, 0, -50), FVec3(100000, 100000, 50), Geometries);
+			const int32 NumColumns = FMath::CeilToInt(FMath::Sqrt((float)NumStacks));
+			for (int32 StackIndex = 0; StackIndex < NumStacks; ++StackIndex)
+			{
+				for (int32 Level = 0; Level < StackHeight; ++Level)
+				{
+					const FVec3 X((StackIndex % NumColumns) * 300, (StackIndex / NumColumns) * 300, BoxHalfExtents.Z + Level * 2 * BoxHalfExtents.Z + 10 * (Level + 1));
+					TPBDRigidParticleHandle<FReal, 3>* Box = Evolution.CreateDynamicParticles(1)[0];
+					PerfTestUtilities::InitDynamicBoxParticle(Box, X, BoxHalfExtents, BoxMass, Geometries);
+					Boxes.Add(Box);
+				}
+			}
+
+			// Fill the history twice over, the towers fall, settle and may go to sleep
+			FRewindData RewindData(MaxFrames);
+			const int32 NumSteps = MaxFrames * 2;
+			double CaptureSeconds = 0;
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Step = 0; Step < NumSteps; ++Step)
+			{
+				Evolution.AdvanceOneTimeStep(Dt);
+				const double CaptureStartTime = FPlatformTime::Seconds();
+				RewindData.CaptureFrame(Evolution, Dt);
+				CaptureSeconds += FPlatformTime::Seconds() - CaptureStartTime;
+			}
+			const double StepSeconds = FPlatformTime::Seconds() - StartTime - CaptureSeconds;
+
+			SIZE_T MaxFrameSize = 0;
+			SIZE_T TotalFrameSize = 0;
+			for (int32 FramesAgo = 0; FramesAgo < RewindData.GetNumFrames(); ++FramesAgo)
+			{
+				MaxFrameSize = FMath::Max(MaxFrameSize, RewindData.GetFrameAllocatedSize(FramesAgo));
+				TotalFrameSize += RewindData.GetFrameAllocatedSize(FramesAgo);
+			}
+			const SIZE_T FullSnapshotSize = Boxes.Num() * (sizeof(TPBDRigidParticleHandle<FReal, 3>*) + 3 * sizeof(FVec3) + sizeof(FRotation3) + sizeof(EObjectStateType));
+
+			// The top box of the first tower is knocked off, as if the server corrected it
+			TPBDRigidParticleHandle<FReal, 3>* CorrectedBox = Boxes[StackHeight - 1];
+			const FRewindCorrection Correction{ CorrectedBox, CorrectedBox->X(), CorrectedBox->R(), FVec3(500, 0, 0), FVec3(0) };
+
+			// Both resimulations start from the same rewound frame and correction
+			const int32 SavedResimAffectedIslandsOnly = Chaos_Rewind_ResimAffectedIslandsOnly;
+
+			Chaos_Rewind_ResimAffectedIslandsOnly = 1;
+			RewindData.Resimulate(Evolution, NumFramesToRewind, TArrayView<const FRewindCorrection>(&Correction, 1));
+			const double IslandsSeconds = RewindData.GetLastResimSeconds();
+			const int32 IslandsNumSimulated = RewindData.GetLastResimNumSimulated();
+			TArray<FVec3> IslandsPositions;
+			for (TPBDRigidParticleHandle<FReal, 3>* Box : Boxes)
+			{
+				IslandsPositions.Add(Box->X());
+			}
+
+			Chaos_Rewind_ResimAffectedIslandsOnly = 0;
+			RewindData.Resimulate(Evolution, NumFramesToRewind, TArrayView<const FRewindCorrection>(&Correction, 1));
+			const double AllSeconds = RewindData.GetLastResimSeconds();
+
+			Chaos_Rewind_ResimAffectedIslandsOnly = SavedResimAffectedIslandsOnly;
+
+			FReal MaxDifference = 0;
+			for (int32 BoxIndex = 0; BoxIndex < Boxes.Num(); ++BoxIndex)
+			{
+				MaxDifference = FMath::Max(MaxDifference, (Boxes[BoxIndex]->X() - IslandsPositions[BoxIndex]).Size());
+			}
+
+			UE_LOG(LogChaos, Log, TEXT("Rewind benchmark: %d towers of %d boxes, %d frames of history, rewinding %d frames"), NumStacks, StackHeight, MaxFrames, NumFramesToRewind);
+			UE_LOG(LogChaos, Log, TEXT("  Step %.3f ms, capture %.3f ms per frame"), StepSeconds * 1000.0 / NumSteps, CaptureSeconds * 1000.0 / NumSteps);
+			UE_LOG(LogChaos, Log, TEXT("  Frame memory: average %.1f KB, max %.1f KB, latest %.1f KB, full snapshot %.1f KB, total with latest states %.1f KB"),
+				TotalFrameSize / 1024.0 / FMath::Max(RewindData.GetNumFrames(), 1), MaxFrameSize / 1024.0, RewindData.GetFrameAllocatedSize(0) / 1024.0, FullSnapshotSize / 1024.0, RewindData.GetAllocatedSize() / 1024.0);
+			UE_LOG(LogChaos, Log, TEXT("  Resimulate: affected islands %.3f ms (%d boxes simulated), all particles %.3f ms"), IslandsSeconds * 1000.0, IslandsNumSimulated, AllSeconds * 1000.0);
+
+			// replayed particles do not feel the simulated ones until an island wakes them up, a difference shows how late that was
+			if (MaxDifference > 0)
+			{
+				UE_LOG(LogChaos, Warning, TEXT("Resimulating the affected islands only ends up to %f away from resimulating all particles"), MaxDifference);
+			}
+		}
+
+		static FAutoConsoleCommand RewindBenchmarkCommand(
+			TEXT("p.Chaos.RewindBenchmark"),
+			TEXT("Captures the history of box towers falling and settling, logs the memory per frame and the cost of resimulating after a correction, affected islands only and all particles.\n")
+			TEXT("Args: [NumStacks] [StackHeight] [MaxFrames] [NumFramesToRewind]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&RewindBenchmark));
+	}
+#endif
+}
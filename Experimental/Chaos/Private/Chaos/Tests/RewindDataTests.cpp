@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Chaos/ChaosPerfTest.h"
+#include "Chaos/ImplicitObject.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
+#include "Chaos/RewindData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && CHAOS_PERF_TEST_ENABLED
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosRewindDataCorrectionTest, "System.Chaos.RewindData.RewindPastCorrection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Rewinding past a correction restores the full state from before it, including the values the step before didn't change
+bool FChaosRewindDataCorrectionTest::RunTest(const FString& Parameters)
+{
+	using namespace Chaos;
+
+	const FReal Dt = (FReal)1 / 60;
+	const int32 NumSteps = 5;
+
+	TArray<TUniquePtr<FImplicitObject>> Geometries;
+	TPBDRigidsSOAs<FReal, 3> Particles;
+	FPBDRigidsEvolutionGBF Evolution(Particles);
+
+	// A box falling freely: position and linear velocity change every step, rotation and angular velocity never do
+	TPBDRigidParticleHandle<FReal, 3>* Box = Evolution.CreateDynamicParticles(1)[0];
+	PerfTestUtilities::InitDynamicBoxParticle(Box, FVec3(0, 0, 1000), FVec3(50), 100, Geometries);
+
+	FRewindData RewindData(NumSteps);
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		Evolution.AdvanceOneTimeStep(Dt);
+		RewindData.CaptureFrame(Evolution, Dt);
+	}
+
+	const FVec3 ExpectedX = Box->X();
+	const FRotation3 ExpectedR = Box->R();
+	const FVec3 ExpectedV = Box->V();
+	const FVec3 ExpectedW = Box->W();
+
+	// Spin the box two frames ago, its angular velocity wasn't recorded in the frame the correction is made in
+	const FRewindCorrection Correction{ Box, ExpectedX, ExpectedR, ExpectedV, FVec3(0, 0, 1) };
+	TestTrue(TEXT("Resimulate from a correction"), RewindData.Resimulate(Evolution, 2, TArrayView<const FRewindCorrection>(&Correction, 1)));
+	TestFalse(TEXT("Correction changes the resimulated rotation"), Box->R().Equals(ExpectedR, KINDA_SMALL_NUMBER));
+
+	// Rewind past the correction and resimulate the same steps without it, simulating the box rather than replaying it
+	const int32 SavedResimAffectedIslandsOnly = Chaos_Rewind_ResimAffectedIslandsOnly;
+	Chaos_Rewind_ResimAffectedIslandsOnly = 0;
+	TestTrue(TEXT("Resimulate past the correction"), RewindData.Resimulate(Evolution, NumSteps - 1, TArrayView<const FRewindCorrection>()));
+	Chaos_Rewind_ResimAffectedIslandsOnly = SavedResimAffectedIslandsOnly;
+
+	TestTrue(FString::Printf(TEXT("X is the uncorrected one (%s, expected %s)"), *Box->X().ToString(), *ExpectedX.ToString()), Box->X().Equals(ExpectedX, KINDA_SMALL_NUMBER));
+	TestTrue(FString::Printf(TEXT("R is the uncorrected one (%s, expected %s)"), *Box->R().ToString(), *ExpectedR.ToString()), Box->R().Equals(ExpectedR, KINDA_SMALL_NUMBER));
+	TestTrue(FString::Printf(TEXT("V is the uncorrected one (%s, expected %s)"), *Box->V().ToString(), *ExpectedV.ToString()), Box->V().Equals(ExpectedV, KINDA_SMALL_NUMBER));
+	TestTrue(FString::Printf(TEXT("W is the uncorrected one (%s, expected %s)"), *Box->W().ToString(), *ExpectedW.ToString()), Box->W().Equals(ExpectedW, KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("Box is still dynamic"), Box->ObjectState() == EObjectStateType::Dynamic);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && CHAOS_PERF_TEST_ENABLED
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Chaos/AABBTree.h"
+#include "Chaos/WideAABBTree.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosWideAABBTreeQueryTest, "System.Chaos.WideAABBTree.Queries", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace Chaos
+{
+	namespace WideAABBTreeTests
+	{
+		/** Collects every visited payload without shortening queries, so that all structures visit the same elements */
+		struct FCollectingVisitor
+		{
+			TArray<int32> Payloads;
+
+			bool VisitOverlap(const TSpatialVisitorData<int32>& Instance) { Payloads.Add(Instance.Payload); return true; }
+			bool VisitRaycast(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { Payloads.Add(Instance.Payload); return true; }
+			bool VisitSweep(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { Payloads.Add(Instance.Payload); return true; }
+			const void* GetQueryData() const { return nullptr; }
+		};
+
+		struct FQueryResults
+		{
+			TArray<TArray<int32>> Raycasts;
+			TArray<TArray<int32>> Overlaps;
+		};
+
+		template <typename TAcceleration>
+		FQueryResults RunQueries(const TAcceleration& Acceleration, const TArray<FVec3>& Starts, const TArray<FVec3>& Dirs, const TArray<FReal>& Lengths, const TArray<TAABB<FReal, 3>>& Bounds)
+		{
+			FQueryResults Results;
+			for (int32 QueryIdx = 0; QueryIdx < Starts.Num(); QueryIdx++)
+			{
+				FCollectingVisitor RaycastVisitor;
+				Acceleration.Raycast(Starts[QueryIdx], Dirs[QueryIdx], Lengths[QueryIdx], RaycastVisitor);
+				RaycastVisitor.Payloads.Sort();
+				Results.Raycasts.Add(MoveTemp(RaycastVisitor.Payloads));
+
+				FCollectingVisitor OverlapVisitor;
+				Acceleration.Overlap(Bounds[QueryIdx], OverlapVisitor);
+				OverlapVisitor.Payloads.Sort();
+				Results.Overlaps.Add(MoveTemp(OverlapVisitor.Payloads));
+			}
+			return Results;
+		}
+	}
+}
+
+// Wide trees visit the same elements as TAABBTree, and overlaps return exactly the elements whose bounds intersect the query
+bool FChaosWideAABBTreeQueryTest::RunTest(const FString& Parameters)
+{
+	using namespace Chaos;
+	using namespace Chaos::WideAABBTreeTests;
+
+	const int32 NumElements = 2000;
+	const int32 NumQueries = 200;
+	const FReal WorldSize = 10000;
+
+	FRandomStream RandomStream(1234);
+	TArray<TPayloadBoundsElement<int32, FReal>> Elements;
+	for (int32 ElementIdx = 0; ElementIdx < NumElements; ElementIdx++)
+	{
+		const FVec3 Center(RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize / 10));
+		const FVec3 HalfExtents(RandomStream.FRandRange(10, 200), RandomStream.FRandRange(10, 200), RandomStream.FRandRange(10, 100));
+		Elements.Add(TPayloadBoundsElement<int32, FReal>{ ElementIdx, TAABB<FReal, 3>(Center - HalfExtents, Center + HalfExtents) });
+	}
+
+	TArray<FVec3> Starts;
+	TArray<FVec3> Dirs;
+	TArray<FReal> Lengths;
+	TArray<TAABB<FReal, 3>> Bounds;
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; QueryIdx++)
+	{
+		Starts.Add(FVec3(RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize / 10)));
+		Dirs.Add(FVec3(RandomStream.GetUnitVector()));
+		Lengths.Add(RandomStream.FRandRange(100, 5000));
+		const FVec3 HalfExtents(RandomStream.FRandRange(50, 1000));
+		Bounds.Add(TAABB<FReal, 3>(Starts.Last() - HalfExtents, Starts.Last() + HalfExtents));
+	}
+
+	using FAABBTree = TAABBTree<int32, TAABBTreeLeafArray<int32, FReal>, FReal>;
+	const FAABBTree AABBTree(Elements, (int32)FAABBTree::DefaultMaxChildrenInLeaf, (int32)FAABBTree::DefaultMaxTreeDepth, (FReal)FAABBTree::DefaultMaxPayloadBounds, 0);
+	const TWideAABBTree<int32, FReal, 4> WideAABBTree(Elements);
+	const TWideAABBTree<int32, FReal, 8> WideAABBTree8(Elements);
+
+	const FQueryResults Expected = RunQueries(AABBTree, Starts, Dirs, Lengths, Bounds);
+	const FQueryResults WideResults = RunQueries(WideAABBTree, Starts, Dirs, Lengths, Bounds);
+	const FQueryResults Wide8Results = RunQueries(WideAABBTree8, Starts, Dirs, Lengths, Bounds);
+
+	int32 NumOverlapHits = 0;
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; QueryIdx++)
+	{
+		TArray<int32> Overlapping;
+		for (const TPayloadBoundsElement<int32, FReal>& Element : Elements)
+		{
+			if (Element.Bounds.Intersects(Bounds[QueryIdx]))
+			{
+				Overlapping.Add(Element.Payload);
+			}
+		}
+		NumOverlapHits += Overlapping.Num();
+
+		TestTrue(FString::Printf(TEXT("TAABBTree overlap %d matches brute force"), QueryIdx), Expected.Overlaps[QueryIdx] == Overlapping);
+		TestTrue(FString::Printf(TEXT("TWideAABBTree<4> overlap %d matches TAABBTree"), QueryIdx), WideResults.Overlaps[QueryIdx] == Expected.Overlaps[QueryIdx]);
+		TestTrue(FString::Printf(TEXT("TWideAABBTree<8> overlap %d matches TAABBTree"), QueryIdx), Wide8Results.Overlaps[QueryIdx] == Expected.Overlaps[QueryIdx]);
+		TestTrue(FString::Printf(TEXT("TWideAABBTree<4> raycast %d matches TAABBTree"), QueryIdx), WideResults.Raycasts[QueryIdx] == Expected.Raycasts[QueryIdx]);
+		TestTrue(FString::Printf(TEXT("TWideAABBTree<8> raycast %d matches TAABBTree"), QueryIdx), Wide8Results.Raycasts[QueryIdx] == Expected.Raycasts[QueryIdx]);
+	}
+
+	// make sure queries actually hit something, so that matching results mean something
+	TestTrue(TEXT("Overlap queries hit elements"), NumOverlapHits > 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,159 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/WideAABBTree.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+#if !UE_BUILD_SHIPPING
+namespace Chaos
+{
+	namespace WideAABBTreeBenchmark
+	{
+		/** Counts hits without shortening queries, so that all structures visit the same elements */
+		struct FCountingVisitor
+		{
+			int32 NumHits = 0;
+
+			bool VisitOverlap(const TSpatialVisitorData<int32>& Instance) { NumHits++; return true; }
+			bool VisitRaycast(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { NumHits++; return true; }
+			bool VisitSweep(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData) { NumHits++; return true; }
+			const void* GetQueryData() const { return nullptr; }
+		};
+
+		struct FQuery
+		{
+			FVec3 Start;
+			FVec3 Dir;
+			FReal Length;
+			TAABB<FReal, 3> Bounds;
+		};
+
+		struct FResults
+		{
+			double BuildSeconds = 0;
+			SIZE_T AllocatedSize = 0;
+			double RaycastSeconds = 0;
+			double SweepSeconds = 0;
+			double OverlapSeconds = 0;
+			int32 RaycastHits = 0;
+			int32 SweepHits = 0;
+			int32 OverlapHits = 0;
+		};
+
+		template <typename TAcceleration, typename BuildFuncType>
+		FResults Run(const TArray<FQuery>& Queries, const FVec3& SweepHalfExtents, const BuildFuncType& BuildFunc)
+		{
+			FResults Results;
+
+			double StartTime = FPlatformTime::Seconds();
+			TUniquePtr<TAcceleration> Acceleration = BuildFunc();
+			Results.BuildSeconds = FPlatformTime::Seconds() - StartTime;
+			Results.AllocatedSize = Acceleration->GetAllocatedSize();
+
+			FCountingVisitor RaycastVisitor;
+			StartTime = FPlatformTime::Seconds();
+			for (const FQuery& Query : Queries)
+			{
+				Acceleration->Raycast(Query.Start, Query.Dir, Query.Length, RaycastVisitor);
+			}
+			Results.RaycastSeconds = FPlatformTime::Seconds() - StartTime;
+			Results.RaycastHits = RaycastVisitor.NumHits;
+
+			FCountingVisitor SweepVisitor;
+			StartTime = FPlatformTime::Seconds();
+			for (const FQuery& Query : Queries)
+			{
+				Acceleration->Sweep(Query.Start, Query.Dir, Query.Length, SweepHalfExtents, SweepVisitor);
+			}
+			Results.SweepSeconds = FPlatformTime::Seconds() - StartTime;
+			Results.SweepHits = SweepVisitor.NumHits;
+
+			FCountingVisitor OverlapVisitor;
+			StartTime = FPlatformTime::Seconds();
+			for (const FQuery& Query : Queries)
+			{
+				Acceleration->Overlap(Query.Bounds, OverlapVisitor);
+			}
+			Results.OverlapSeconds = FPlatformTime::Seconds() - StartTime;
+			Results.OverlapHits = OverlapVisitor.NumHits;
+
+			return Results;
+		}
+
+		void Log(const TCHAR* Name, const FResults& Results, const int32 NumQueries)
+		{
+			UE_LOG(LogChaos, Log, TEXT("%s: build %.3f ms, %llu bytes"), Name, Results.BuildSeconds * 1000.0, (uint64)Results.AllocatedSize);
+			UE_LOG(LogChaos, Log, TEXT("  Raycast: %.3f ms, %.0f queries/s, %d hits"), Results.RaycastSeconds * 1000.0, NumQueries / FMath::Max(Results.RaycastSeconds, SMALL_NUMBER), Results.RaycastHits);
+			UE_LOG(LogChaos, Log, TEXT("  Sweep: %.3f ms, %.0f queries/s, %d hits"), Results.SweepSeconds * 1000.0, NumQueries / FMath::Max(Results.SweepSeconds, SMALL_NUMBER), Results.SweepHits);
+			UE_LOG(LogChaos, Log, TEXT("  Overlap: %.3f ms, %.0f queries/s, %d hits"), Results.OverlapSeconds * 1000.0, NumQueries / FMath::Max(Results.OverlapSeconds, SMALL_NUMBER), Results.OverlapHits);
+		}
+
+		void SpatialAccelerationBenchmark(const TArray<FString>& Args)
+		{
+			const int32 NumElements = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+			const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10000;
+
+			// boxes of varying size spread over a square kilometer, like a level of static geometry
+			FRandomStream RandomStream(42);
+			const FReal WorldSize = 100000;
+			TArray<TPayloadBoundsElement<int32, FReal>> Elements;
+			Elements.Reserve(NumElements);
+			for (int32 ElementIdx = 0; ElementIdx < NumElements; ElementIdx++)
+			{
+				const FVec3 Center(RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize / 10));
+				const FVec3 HalfExtents(RandomStream.FRandRange(10, 500), RandomStream.FRandRange(10, 500), RandomStream.FRandRange(10, 200));
+				Elements.Add(TPayloadBoundsElement<int32, FReal>{ ElementIdx, TAABB<FReal, 3>(Center - HalfExtents, Center + HalfExtents) });
+			}
+
+			TArray<FQuery> Queries;
+			Queries.Reserve(NumQueries);
+			for (int32 QueryIdx = 0; QueryIdx < NumQueries; QueryIdx++)
+			{
+				FQuery Query;
+				Query.Start = FVec3(RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize), RandomStream.FRandRange(0, WorldSize / 10));
+				Query.Dir = FVec3(RandomStream.GetUnitVector());
+				Query.Length = RandomStream.FRandRange(100, 5000);
+				const FVec3 HalfExtents(RandomStream.FRandRange(50, 1000));
+				Query.Bounds = TAABB<FReal, 3>(Query.Start - HalfExtents, Query.Start + HalfExtents);
+				Queries.Add(Query);
+			}
+
+			const FVec3 SweepHalfExtents(50);
+
+			using FAABBTree = TAABBTree<int32, TAABBTreeLeafArray<int32, FReal>, FReal>;
+			using FBV = TBoundingVolume<int32, FReal, 3>;
+			using FWideAABBTree = TWideAABBTree<int32, FReal, 4>;
+			using FWideAABBTree8 = TWideAABBTree<int32, FReal, 8>;
+
+			UE_LOG(LogChaos, Log, TEXT("Spatial acceleration benchmark: %d elements, %d queries of each type"), NumElements, NumQueries);
+
+			const FResults AABBTreeResults = Run<FAABBTree>(Queries, SweepHalfExtents, [&Elements]() { return MakeUnique<FAABBTree>(Elements, (int32)FAABBTree::DefaultMaxChildrenInLeaf, (int32)FAABBTree::DefaultMaxTreeDepth, (FReal)FAABBTree::DefaultMaxPayloadBounds, 0); });
+			Log(TEXT("TAABBTree"), AABBTreeResults, NumQueries);
+
+			const FResults BVResults = Run<FBV>(Queries, SweepHalfExtents, [&Elements]() { return MakeUnique<FBV>(Elements); });
+			Log(TEXT("TBoundingVolume"), BVResults, NumQueries);
+
+			const FResults WideResults = Run<FWideAABBTree>(Queries, SweepHalfExtents, [&Elements]() { return MakeUnique<FWideAABBTree>(Elements); });
+			Log(TEXT("TWideAABBTree<4>"), WideResults, NumQueries);
+
+			const FResults Wide8Results = Run<FWideAABBTree8>(Queries, SweepHalfExtents, [&Elements]() { return MakeUnique<FWideAABBTree8>(Elements); });
+			Log(TEXT("TWideAABBTree<8>"), Wide8Results, NumQueries);
+
+			// trees test elements the same way, any difference is a traversal bug
+			for (const FResults* Results : { &WideResults, &Wide8Results })
+			{
+				if (Results->RaycastHits != AABBTreeResults.RaycastHits || Results->SweepHits != AABBTreeResults.SweepHits || Results->OverlapHits != AABBTreeResults.OverlapHits)
+				{
+					UE_LOG(LogChaos, Warning, TEXT("Wide AABB tree hits differ from TAABBTree hits"));
+				}
+			}
+		}
+
+		static FAutoConsoleCommand SpatialAccelerationBenchmarkCommand(
+			TEXT("p.Chaos.SpatialAccelerationBenchmark"),
+			TEXT("Compares build time, memory and query times of TAABBTree, TBoundingVolume and TWideAABBTree over random boxes.\n")
+			TEXT("Args: [NumElements] [NumQueries]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&SpatialAccelerationBenchmark));
+	}
+}
+#endif
@@ -9,6 +9,7 @@
 #include "Chaos/ISpatialAcceleration.h"
 #include "Templates/Models.h"
 #include "Chaos/BoundingVolume.h"
+#include "Chaos/SpatialQueryPacket.h"
 
 struct FAABBTreeCVars
 {
@@ -135,6 +136,11 @@ struct TAABBTreeLeafArray : public TBoundsWrapperHelper<TPayloadType, T, bComput
 		return Elems.Num();
 	}
 
+	SIZE_T GetAllocatedSize() const
+	{
+		return Elems.GetAllocatedSize();
+	}
+
 	template <typename TSQVisitor, typename TQueryFastData>
 	bool RaycastFast(const TVector<T,3>& Start, TQueryFastData& QueryFastData, TSQVisitor& Visitor) const
 	{
@@ -429,6 +435,36 @@ public:
 		Overlap(QueryBounds, ProxyVisitor);
 	}
 
+	virtual void RaycastBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const override
+	{
+		ForEachSpatialQueryPacket(Queries, [this](TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>>& Packet)
+		{
+			RaycastPacketFast(Packet);
+		});
+	}
+
+	virtual void SweepBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const override
+	{
+		ForEachSpatialQueryPacket(Queries, [this](TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>>& Packet)
+		{
+			SweepPacketFast(Packet);
+		});
+	}
+
+	/** Raycasts all active lanes of the packet, clearing lanes whose visitor stops */
+	template <typename SQVisitor>
+	void RaycastPacketFast(TSpatialQueryPacket<SQVisitor>& Packet) const
+	{
+		QueryPacketImp<EAABBQueryType::Raycast>(Packet);
+	}
+
+	/** Sweeps all active lanes of the packet, clearing lanes whose visitor stops */
+	template <typename SQVisitor>
+	void SweepPacketFast(TSpatialQueryPacket<SQVisitor>& Packet) const
+	{
+		QueryPacketImp<EAABBQueryType::Sweep>(Packet);
+	}
+
 	template <typename SQVisitor>
 	void Overlap(const TAABB<T,3>& QueryBounds, SQVisitor& Visitor) const
 	{
@@ -587,6 +623,17 @@ public:
 		return GlobalPayloads;
 	}
 
+	/** @return memory allocated by the tree, its leaves and their elements */
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T AllocatedSize = Nodes.GetAllocatedSize() + Leaves.GetAllocatedSize() + DirtyElements.GetAllocatedSize() + GlobalPayloads.GetAllocatedSize() + PayloadToInfo.GetAllocatedSize();
+		for (const TLeafType& Leaf : Leaves)
+		{
+			AllocatedSize += Leaf.GetAllocatedSize();
+		}
+		return AllocatedSize;
+	}
+
 	virtual void Serialize(FChaosArchive& Ar) override
 	{
 		Ar.UsingCustomVersion(FExternalPhysicsCustomObjectVersion::GUID);
@@ -651,10 +698,10 @@ private:
 		*this = NewTree;
 	}
 
+	/** Visits elements kept out of the tree, @return false if the visitor stopped the query */
 	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
-	bool QueryImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, const TAABB<T,3>& QueryBounds, SQVisitor& Visitor) const
+	bool QueryGlobalAndDirtyImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, const TAABB<T,3>& QueryBounds, SQVisitor& Visitor) const
 	{
-		//QUICK_SCOPE_CYCLE_COUNTER(AABBTreeQueryImp);
 		TVector<T, 3> TmpPosition;
 		T TOI = 0;
 		const void* QueryData = Visitor.GetQueryData();
@@ -725,6 +772,21 @@ private:
 
 		}
 
+		return true;
+	}
+
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	bool QueryImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, const TAABB<T,3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		//QUICK_SCOPE_CYCLE_COUNTER(AABBTreeQueryImp);
+		if (!QueryGlobalAndDirtyImp<Query>(Start, CurData, QueryHalfExtents, QueryBounds, Visitor))
+		{
+			return false;
+		}
+
+		TVector<T, 3> TmpPosition;
+		T TOI = 0;
+
 		struct FNodeQueueEntry
 		{
 			int32 NodeIdx;
@@ -784,6 +846,97 @@ private:
 		return true;
 	}
 
+	/** Same traversal as QueryImp for every lane of the packet, testing node bounds against all lanes at once */
+	template <EAABBQueryType Query, typename SQVisitor>
+	void QueryPacketImp(TSpatialQueryPacket<SQVisitor>& Packet) const
+	{
+		static_assert(Query != EAABBQueryType::Overlap, "Overlaps are not traversed in packets");
+		constexpr bool bSweep = Query == EAABBQueryType::Sweep;
+
+		for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+		{
+			if ((Packet.ActiveLanes & (1 << Lane)) && !QueryGlobalAndDirtyImp<Query>(Packet.Starts[Lane], *Packet.CurDatas[Lane], Packet.QueryHalfExtents[Lane], TAABB<T, 3>(), *Packet.Visitors[Lane]))
+			{
+				Packet.ActiveLanes &= ~(1 << Lane);
+			}
+		}
+
+		if (Packet.ActiveLanes == 0)
+		{
+			return;
+		}
+
+		const FSpatialQueryPacketLanes Lanes(Packet, bSweep);
+
+		struct FPacketNodeQueueEntry
+		{
+			int32 NodeIdx;
+			uint32 LaneMask;
+			float TOI[SpatialQueryPacketWidth];
+		};
+
+		TArray<FPacketNodeQueueEntry> NodeStack;
+		NodeStack.Add(FPacketNodeQueueEntry{ 0, Packet.ActiveLanes, { 0, 0, 0, 0 } });
+		while (NodeStack.Num())
+		{
+			const FPacketNodeQueueEntry NodeEntry = NodeStack.Pop(false);
+
+			// lanes may have found closer hits or been stopped since the entry was pushed
+			uint32 LaneMask = NodeEntry.LaneMask & Packet.ActiveLanes;
+			for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+			{
+				if ((LaneMask & (1 << Lane)) && NodeEntry.TOI[Lane] > Packet.CurDatas[Lane]->CurrentLength)
+				{
+					LaneMask &= ~(1 << Lane);
+				}
+			}
+
+			if (LaneMask == 0)
+			{
+				continue;
+			}
+
+			const FNode& Node = Nodes[NodeEntry.NodeIdx];
+			if (Node.bLeaf)
+			{
+				const auto& Leaf = Leaves[Node.ChildrenNodes[0]];
+				for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+				{
+					if (LaneMask & (1 << Lane))
+					{
+						const bool bContinue = bSweep ? Leaf.SweepFast(Packet.Starts[Lane], *Packet.CurDatas[Lane], Packet.QueryHalfExtents[Lane], *Packet.Visitors[Lane])
+							: Leaf.RaycastFast(Packet.Starts[Lane], *Packet.CurDatas[Lane], *Packet.Visitors[Lane]);
+						if (!bContinue)
+						{
+							Packet.ActiveLanes &= ~(1 << Lane);
+						}
+					}
+				}
+
+				if (Packet.ActiveLanes == 0)
+				{
+					return;
+				}
+			}
+			else
+			{
+				const VectorRegister Lengths = LoadSpatialQueryPacketLengths(Packet);
+				for (int32 Idx = 0; Idx < 2; Idx++)
+				{
+					VectorRegister TOIs;
+					const uint32 HitLanes = Lanes.IntersectBounds(Node.ChildrenBounds[Idx], Lengths, TOIs) & LaneMask;
+					if (HitLanes)
+					{
+						FPacketNodeQueueEntry& ChildEntry = NodeStack.AddDefaulted_GetRef();
+						ChildEntry.NodeIdx = Node.ChildrenNodes[Idx];
+						ChildEntry.LaneMask = HitLanes;
+						VectorStore(TOIs, ChildEntry.TOI);
+					}
+				}
+			}
+		}
+	}
+
 	int32 GetNewWorkSnapshot()
 	{
 		if(WorkPoolFreeList.Num())
@@ -1257,5 +1410,17 @@ FArchive& operator<<(FChaosArchive& Ar, TAABBTree<TPayloadType, TLeafType, T, bM
 	return Ar;
 }
 
+template <typename TPayloadType, typename TLeafType, typename T, bool bMutable, typename SQVisitor>
+void SpatialAccelerationRaycastPacket(const TAABBTree<TPayloadType, TLeafType, T, bMutable>& AABBTree, TSpatialQueryPacket<SQVisitor>& Packet)
+{
+	AABBTree.RaycastPacketFast(Packet);
+}
+
+template <typename TPayloadType, typename TLeafType, typename T, bool bMutable, typename SQVisitor>
+void SpatialAccelerationSweepPacket(const TAABBTree<TPayloadType, TLeafType, T, bMutable>& AABBTree, TSpatialQueryPacket<SQVisitor>& Packet)
+{
+	AABBTree.SweepPacketFast(Packet);
+}
+
 
 }
@@ -258,6 +258,17 @@ public:
 		return MGlobalPayloads;
 	}
 
+	/** @return memory allocated by the grid cells and elements */
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T AllocatedSize = MGlobalPayloads.GetAllocatedSize() + MDirtyElements.GetAllocatedSize() + MPayloadInfo.GetAllocatedSize() + MElements.Num() * sizeof(TArray<FCellElement>);
+		for (int32 CellIdx = 0; CellIdx < MElements.Num(); ++CellIdx)
+		{
+			AllocatedSize += MElements[CellIdx].GetAllocatedSize();
+		}
+		return AllocatedSize;
+	}
+
 	virtual void Raycast(const TVector<T, d>& Start, const TVector<T, d>& Dir, const T Length, ISpatialVisitor<TPayloadType, T>& Visitor) const override
 	{
 		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
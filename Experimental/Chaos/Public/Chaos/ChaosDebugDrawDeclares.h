@@ -23,4 +23,8 @@ namespace Chaos
 	class FPBDJointConstraintHandle;
 
 	class FPBDJointConstraints;
+
+	class FPBDConstraintGraph;
+
+	struct FIslandSolveStats;
 }
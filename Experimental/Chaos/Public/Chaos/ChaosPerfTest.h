@@ -1,5 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 #pragma once
+#include "Chaos/Core.h"
+#include "Chaos/ParticleHandleFwd.h"
 #include "Misc/OutputDevice.h"
 #include "ProfilingDebugging/ScopedTimers.h"
 
@@ -62,6 +64,38 @@ struct FScopedChaosPerfTest
 
 #define CHAOS_PERF_TEST(x, units) FScopedChaosPerfTest Scope_##x(TEXT(#x), units);
 #define CHAOS_SCOPED_TIMER(x) FChaosScopedDurationTimeLogger Timer_##x(TEXT(#x));
+
+namespace Chaos
+{
+	class FImplicitObject;
+
+	namespace PerfTestUtilities
+	{
+		/** Gives Particle a box shape at X, colliding on channel 0. The box is added to Geometries, which has to outlive the particle. */
+		CHAOS_API void InitBoxParticle(TGeometryParticleHandle<FReal, 3>* Particle, const FVec3& X, const FVec3& HalfExtents, TArray<TUniquePtr<FImplicitObject>>& Geometries);
+
+		/** Same as InitBoxParticle, and sets up a solid box of Mass at rest at X. */
+		CHAOS_API void InitDynamicBoxParticle(TPBDRigidParticleHandle<FReal, 3>* Particle, const FVec3& X, const FVec3& HalfExtents, const FReal Mass, TArray<TUniquePtr<FImplicitObject>>& Geometries);
+	}
+
+	/**
+	 * Simulates towers of boxes and a pile of boxes on a static ground with constraint color batches solved serially,
+	 * in parallel, in parallel with one solver task per island and in parallel with deterministic coloring. Logs time
+	 * per step, stack top drift, residual speed and whether deterministic runs match. Changes the color batch and
+	 * island batching console variables while running.
+	 * Also available as p.Chaos.SolverStackingPerfTest.
+	 */
+	CHAOS_API void RunSolverStackingPerfTest(const int32 NumStacks, const int32 StackHeight, const int32 NumPileBoxes, const int32 NumSteps);
+
+	/**
+	 * Simulates a few falling pieces among many settled debris pieces, with sleeping particles kept with the awake ones
+	 * and apart from them. Logs time per step, the time and distinct cache lines read to iterate the awake particles,
+	 * and the time to wake up the debris all at once and put it back to sleep. Changes the sleeping cold storage
+	 * console variable while running.
+	 * Also available as p.Chaos.SleepingParticlesPerfTest.
+	 */
+	CHAOS_API void RunSleepingParticlesPerfTest(const int32 NumDebris, const int32 NumAwake, const int32 NumSteps);
+}
 #else
 #define CHAOS_PERF_TEST(x, units)
 #define CHAOS_SCOPED_TIMER(x)
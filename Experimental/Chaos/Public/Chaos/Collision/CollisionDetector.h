@@ -54,11 +54,14 @@ namespace Chaos
 
 			// Collision detection pipeline: BroadPhase -> NarrowPhase -> Receiver -> Container
 			// Receivers and NarrowPhase are assumed to be stateless atm. If we change that, they need to
-			// be passed into the constructor with the BroadPhase and Container.
+			// be passed into the constructor with the BroadPhase and Container. The NarrowPhase reads the
+			// Container's manifold cache, which is only written before and after detection.
 			FReceiver Receiver(CollisionContainer);
-			FNarrowPhase NarrowPhase(Context);
+			FNarrowPhase NarrowPhase(Context, &CollisionContainer.GetManifoldCache());
 			BroadPhase.ProduceOverlaps(Dt, NarrowPhase, Receiver, StatData);
 			Receiver.ProcessCollisions();
+
+			CollisionContainer.GetManifoldCache().FinalizeStats();
 		}
 
 	private:
@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/CollisionResolutionTypes.h"
+#include "Chaos/ParticleHandleFwd.h"
+#include "Templates/Atomic.h"
+
+namespace Chaos
+{
+	CHAOS_API extern int32 Chaos_Collision_ManifoldCache_Enabled;
+	CHAOS_API extern float Chaos_Collision_ManifoldCache_PositionThreshold;
+	CHAOS_API extern float Chaos_Collision_ManifoldCache_RotationThreshold;
+	CHAOS_API extern float Chaos_Collision_ManifoldCache_WarmStartFactor;
+
+	/**
+	 * Contacts of the previous frame, by particle pair, so that the narrow phase can reuse them.
+	 *
+	 * While a pair has not moved relative to the pose its contacts were generated at (within thresholds), the cached
+	 * manifolds are still valid: they are restored and only their contact point gets updated, skipping midphase and
+	 * manifold generation (GJK/EPA and clipping for convexes). Reuse only depends on geometry and relative pose,
+	 * so particle handles being recycled between frames cannot make it restore wrong contacts.
+	 *
+	 * Restored and regenerated contacts get the accumulated impulse of the matching cached contact as warm start.
+	 *
+	 * The cache is rebuilt on the physics thread once per frame, before collision detection, and is read-only while
+	 * the narrow phase runs in parallel.
+	 */
+	class CHAOS_API FCollisionManifoldCache
+	{
+	public:
+		using FGeometryParticleHandle = TGeometryParticleHandle<FReal, 3>;
+
+		/** Stats of the last collision detection */
+		struct FStats
+		{
+			int32 NumHits = 0;
+			int32 NumMisses = 0;
+			double HitSeconds = 0;
+			double MissSeconds = 0;
+			/** Estimated narrow phase time saved by hits, from the average cost of misses that generated contacts */
+			double SavedSeconds = 0;
+
+			float GetHitRate() const { return (NumHits + NumMisses > 0) ? (float)NumHits / (float)(NumHits + NumMisses) : 0.f; }
+		};
+
+		FCollisionManifoldCache();
+
+		/**
+		 * Replace the cached contacts with the contacts of the frame being retired.
+		 * The arrays are left empty, they get the allocations of the previous cache so that nothing gets copied or reallocated.
+		 */
+		void Build(TArray<FRigidBodyPointContactConstraint>& InOutPointConstraints, const TArray<FRigidBodySweptPointContactConstraint>& SweptPointConstraints, TArray<FRigidBodyMultiPointContactConstraint>& InOutMultiPointConstraints);
+
+		/** Remove all cached contacts */
+		void Reset();
+
+		/** Whether lookups are enabled for this frame (read from p.Chaos.Collision.ManifoldCache.Enabled at Build) */
+		bool IsEnabled() const { return bEnabled; }
+
+		/**
+		 * Restore the cached contacts of the pair if it has not moved since they were generated, updating their contact point.
+		 * Thread safe against other lookups.
+		 * @return true if the pair was served by the cache, NewConstraints then holds its contacts within CullDistance
+		 */
+		bool RestoreConstraints(FCollisionConstraintsArray& NewConstraints, FGeometryParticleHandle* Particle0, FGeometryParticleHandle* Particle1, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1, const FReal CullDistance) const;
+
+		/** Warm start contacts generated for a pair that was not served by the cache from its cached contacts on the same shapes. Thread safe. */
+		void WarmStartConstraints(FCollisionConstraintsArray& NewConstraints, const FGeometryParticleHandle* Particle0, const FGeometryParticleHandle* Particle1) const;
+
+		/** Record the pose that newly generated contacts are valid for, see RestoreConstraints */
+		static void SetManifoldRelativeTransforms(FCollisionConstraintsArray& NewConstraints, const FGeometryParticleHandle* Particle0, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1);
+
+		/** Accumulate narrow phase time of a pair. Thread safe. */
+		void RecordHit(uint32 Cycles) { NumHits++; HitCycles += Cycles; }
+		void RecordMiss(uint32 Cycles, bool bGeneratedConstraints);
+
+		/** Compute stats of the collision detection that just finished and publish them */
+		void FinalizeStats();
+
+		const FStats& GetStats() const { return Stats; }
+
+	private:
+		using FKey = TPair<const FGeometryParticleHandle*, const FGeometryParticleHandle*>;
+
+		struct FEntry
+		{
+			const FImplicitObject* Geometry[2];
+			int32 FirstPointConstraint = INDEX_NONE;
+			int32 FirstMultiPointConstraint = INDEX_NONE;
+			/** Pairs with swept contacts are left to the narrow phase, CCD needs a new sweep every frame */
+			bool bCanRestore = true;
+		};
+
+		static FKey MakeKey(const FGeometryParticleHandle* Particle0, const FGeometryParticleHandle* Particle1)
+		{
+			return (Particle0 < Particle1) ? FKey(Particle0, Particle1) : FKey(Particle1, Particle0);
+		}
+
+		FEntry& FindOrAddEntry(const FCollisionConstraintBase& Constraint);
+		const FCollisionConstraintBase* FindCachedConstraint(const FEntry& Entry, const FCollisionConstraintBase& Constraint) const;
+		FReal GetWarmStartFactor() const;
+
+		TMap<FKey, FEntry> Entries;
+
+		/** Cached contacts, pair entries link theirs through the Next arrays */
+		TArray<FRigidBodyPointContactConstraint> PointConstraints;
+		TArray<FRigidBodyMultiPointContactConstraint> MultiPointConstraints;
+		TArray<int32> NextPointConstraint;
+		TArray<int32> NextMultiPointConstraint;
+
+		bool bEnabled;
+
+		TAtomic<int32> NumHits;
+		TAtomic<int32> NumMisses;
+		TAtomic<int32> NumTouchingMisses;
+		TAtomic<uint64> HitCycles;
+		TAtomic<uint64> MissCycles;
+		TAtomic<uint64> TouchingMissCycles;
+
+		/** Smoothed cost of misses that generated contacts, used when a frame has hits only */
+		double AverageTouchingMissSeconds;
+
+		FStats Stats;
+	};
+}
@@ -1,9 +1,11 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 #pragma once
 
+#include "Chaos/Collision/CollisionManifoldCache.h"
 #include "Chaos/Collision/CollisionReceiver.h"
 #include "Chaos/Collision/StatsData.h"
 #include "Chaos/CollisionResolution.h"
+#include "Chaos/GJK.h"
 #include "Chaos/ParticleHandle.h"
 #include "Chaos/PBDCollisionConstraints.h"
 #include "Chaos/PBDRigidsSOAs.h"
@@ -21,16 +23,29 @@ namespace Chaos
 
 	class FCollisionContext;
 
+	CHAOS_API extern int32 Chaos_Collision_BatchedNarrowPhase;
+
+	/** A particle pair for the narrow phase to generate contacts for */
+	struct FNarrowPhasePair
+	{
+		TGeometryParticleHandle<FReal, 3>* Particle0;
+		TGeometryParticleHandle<FReal, 3>* Particle1;
+		/** The contact separation at which we ignore the constraint */
+		FReal CullDistance;
+	};
+
 	/**
 	 * Generate contact manifolds for particle pairs.
+	 * Pairs that did not move since the previous frame get their contacts from the manifold cache, if there is one.
 	 *
-	 * /see FAsyncCollisionReceiver, FSyncCollisionReceiver.
+	 * /see FAsyncCollisionReceiver, FSyncCollisionReceiver, FCollisionManifoldCache.
 	 */
 	class CHAOS_API FNarrowPhase
 	{
 	public:
-		FNarrowPhase(const FCollisionContext& InContext)
+		FNarrowPhase(const FCollisionContext& InContext, FCollisionManifoldCache* InManifoldCache = nullptr)
 			: Context(InContext)
+			, ManifoldCache(InManifoldCache)
 		{
 		}
 
@@ -50,14 +65,162 @@ namespace Chaos
 				//   determine if the constraint is already defined, and then opt out of 
 				//   the creation process. 
 				//
-				Collisions::ConstructConstraints<FReal, 3>(Particle0, Particle1, Particle0->Geometry().Get(), Particle1->Geometry().Get(), Collisions::GetTransform(Particle0), Collisions::GetTransform(Particle1), CullDistance, Context, NewConstraints);
+				const FRigidTransform3 Transform0 = Collisions::GetTransform(Particle0);
+				const FRigidTransform3 Transform1 = Collisions::GetTransform(Particle1);
+
+				if (ManifoldCache && ManifoldCache->IsEnabled())
+				{
+					const uint32 StartCycles = FPlatformTime::Cycles();
+					if (ManifoldCache->RestoreConstraints(NewConstraints, Particle0, Particle1, Transform0, Transform1, CullDistance))
+					{
+						ManifoldCache->RecordHit(FPlatformTime::Cycles() - StartCycles);
+					}
+					else
+					{
+						Collisions::ConstructConstraints<FReal, 3>(Particle0, Particle1, Particle0->Geometry().Get(), Particle1->Geometry().Get(), Transform0, Transform1, CullDistance, Context, NewConstraints);
+						ManifoldCache->RecordMiss(FPlatformTime::Cycles() - StartCycles, NewConstraints.Num() > 0);
+						FCollisionManifoldCache::SetManifoldRelativeTransforms(NewConstraints, Particle0, Transform0, Transform1);
+						ManifoldCache->WarmStartConstraints(NewConstraints, Particle0, Particle1);
+					}
+				}
+				else
+				{
+					Collisions::ConstructConstraints<FReal, 3>(Particle0, Particle1, Particle0->Geometry().Get(), Particle1->Geometry().Get(), Transform0, Transform1, CullDistance, Context, NewConstraints);
+					FCollisionManifoldCache::SetManifoldRelativeTransforms(NewConstraints, Particle0, Transform0, Transform1);
+				}
 
 				CHAOS_COLLISION_STAT(if (NewConstraints.Num()) { StatData.IncrementCountNP(NewConstraints.Num()); });
 				CHAOS_COLLISION_STAT(if (!NewConstraints.Num()) { StatData.IncrementRejectedNP(); });
 			}
 		}
 
+		/**
+		 * Generate the contacts of several pairs and pass those of each pair to the receiver.
+		 * With p.Chaos.Collision.BatchedNarrowPhase the pairs are processed sorted by shape types, and pairs of convexes
+		 * are batched (see Collisions::ConstructConvexConvexConstraintsBatch). Otherwise same as calling GenerateCollisions on every pair.
+		 */
+		template<typename T_RECEIVER>
+		void GenerateCollisions(const TArrayView<const FNarrowPhasePair>& Pairs, FReal Dt, T_RECEIVER& Receiver, CollisionStats::FStatData& StatData)
+		{
+			if (!Chaos_Collision_BatchedNarrowPhase || Pairs.Num() < 2)
+			{
+				for (const FNarrowPhasePair& Pair : Pairs)
+				{
+					FCollisionConstraintsArray NewConstraints;
+					GenerateCollisions(NewConstraints, Dt, Pair.Particle0, Pair.Particle1, Pair.CullDistance, StatData);
+					Receiver.ReceiveCollisions(NewConstraints);
+				}
+				return;
+			}
+
+			// Pairs with the same shape types next to each other, in their original order (pair index in the low bits)
+			TArray<uint64, TInlineAllocator<64>> SortedPairs;
+			SortedPairs.Reserve(Pairs.Num());
+			for (int32 PairIndex = 0; PairIndex < Pairs.Num(); ++PairIndex)
+			{
+				SortedPairs.Add(((uint64)GetShapePairKey(Pairs[PairIndex]) << 32) | (uint32)PairIndex);
+			}
+			SortedPairs.Sort();
+
+			FConvexConvexBatch Batch;
+			for (const uint64 SortedPair : SortedPairs)
+			{
+				const FNarrowPhasePair& Pair = Pairs[(int32)(SortedPair & 0xFFFFFFFF)];
+				if (Pair.Particle0 && Pair.Particle1)
+				{
+					const FRigidTransform3 Transform0 = Collisions::GetTransform(Pair.Particle0);
+					const FRigidTransform3 Transform1 = Collisions::GetTransform(Pair.Particle1);
+					if (Collisions::GetConvexConvexBatchPair(Pair.Particle0, Pair.Particle1, Transform0, Transform1, Pair.CullDistance, Context, Batch.Pairs[Batch.NumPairs]))
+					{
+						FCollisionConstraintsArray& NewConstraints = Batch.NewConstraints[Batch.NumPairs];
+						if (ManifoldCache && ManifoldCache->IsEnabled())
+						{
+							const uint32 StartCycles = FPlatformTime::Cycles();
+							if (ManifoldCache->RestoreConstraints(NewConstraints, Pair.Particle0, Pair.Particle1, Transform0, Transform1, Pair.CullDistance))
+							{
+								ManifoldCache->RecordHit(FPlatformTime::Cycles() - StartCycles);
+								FinishPair(NewConstraints, Receiver, StatData);
+								continue;
+							}
+						}
+
+						if (++Batch.NumPairs == GJKBatchWidth)
+						{
+							GenerateConvexConvexCollisions(Batch, Receiver, StatData);
+						}
+						continue;
+					}
+				}
+
+				FCollisionConstraintsArray NewConstraints;
+				GenerateCollisions(NewConstraints, Dt, Pair.Particle0, Pair.Particle1, Pair.CullDistance, StatData);
+				Receiver.ReceiveCollisions(NewConstraints);
+			}
+
+			GenerateConvexConvexCollisions(Batch, Receiver, StatData);
+		}
+
 	private:
+		/** Convex pairs waiting for a batch to fill up */
+		struct FConvexConvexBatch
+		{
+			Collisions::FConvexConvexBatchPair Pairs[GJKBatchWidth];
+			FCollisionConstraintsArray NewConstraints[GJKBatchWidth];
+			int32 NumPairs = 0;
+		};
+
+		static uint32 GetShapePairKey(const FNarrowPhasePair& Pair)
+		{
+			const FImplicitObject* Implicit0 = Pair.Particle0 ? Pair.Particle0->Geometry().Get() : nullptr;
+			const FImplicitObject* Implicit1 = Pair.Particle1 ? Pair.Particle1->Geometry().Get() : nullptr;
+			const uint32 Type0 = Implicit0 ? (uint32)GetInnerType(Implicit0->GetCollisionType()) : (uint32)ImplicitObjectType::Unknown;
+			const uint32 Type1 = Implicit1 ? (uint32)GetInnerType(Implicit1->GetCollisionType()) : (uint32)ImplicitObjectType::Unknown;
+			return (Type0 << 8) | Type1;
+		}
+
+		template<typename T_RECEIVER>
+		void GenerateConvexConvexCollisions(FConvexConvexBatch& Batch, T_RECEIVER& Receiver, CollisionStats::FStatData& StatData)
+		{
+			if (Batch.NumPairs == 0)
+			{
+				return;
+			}
+
+			SCOPE_CYCLE_COUNTER_NAROWPHASE();
+			const uint32 StartCycles = FPlatformTime::Cycles();
+			Collisions::ConstructConvexConvexConstraintsBatch(TArrayView<const Collisions::FConvexConvexBatchPair>(Batch.Pairs, Batch.NumPairs), Batch.NewConstraints);
+			const uint32 PairCycles = (FPlatformTime::Cycles() - StartCycles) / Batch.NumPairs;
+
+			for (int32 Idx = 0; Idx < Batch.NumPairs; ++Idx)
+			{
+				const Collisions::FConvexConvexBatchPair& Pair = Batch.Pairs[Idx];
+				FCollisionConstraintsArray& NewConstraints = Batch.NewConstraints[Idx];
+				if (ManifoldCache && ManifoldCache->IsEnabled())
+				{
+					ManifoldCache->RecordMiss(PairCycles, NewConstraints.Num() > 0);
+					FCollisionManifoldCache::SetManifoldRelativeTransforms(NewConstraints, Pair.Particle0, Pair.Transform0, Pair.Transform1);
+					ManifoldCache->WarmStartConstraints(NewConstraints, Pair.Particle0, Pair.Particle1);
+				}
+				else
+				{
+					FCollisionManifoldCache::SetManifoldRelativeTransforms(NewConstraints, Pair.Particle0, Pair.Transform0, Pair.Transform1);
+				}
+				FinishPair(NewConstraints, Receiver, StatData);
+			}
+
+			Batch.NumPairs = 0;
+		}
+
+		template<typename T_RECEIVER>
+		void FinishPair(FCollisionConstraintsArray& NewConstraints, T_RECEIVER& Receiver, CollisionStats::FStatData& StatData)
+		{
+			CHAOS_COLLISION_STAT(if (NewConstraints.Num()) { StatData.IncrementCountNP(NewConstraints.Num()); });
+			CHAOS_COLLISION_STAT(if (!NewConstraints.Num()) { StatData.IncrementRejectedNP(); });
+			Receiver.ReceiveCollisions(NewConstraints);
+			NewConstraints.Empty();
+		}
+
 		const FCollisionContext& Context;
+		FCollisionManifoldCache* ManifoldCache;
 	};
 }
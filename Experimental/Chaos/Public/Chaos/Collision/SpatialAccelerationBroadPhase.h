@@ -4,9 +4,11 @@
 #include "Chaos/Collision/BroadPhase.h"
 #include "Chaos/Collision/StatsData.h"
 #include "Chaos/Collision/NarrowPhase.h"
+#include "Chaos/Collision/SweepAndPrune.h"
 #include "Chaos/ISpatialAccelerationCollection.h"
 #include "Chaos/ParticleHandle.h"
 #include "Chaos/PBDRigidsSOAs.h"
+#include "Chaos/WideAABBTree.h"
 #include "Chaos/Capsule.h"
 #include "ChaosStats.h"
 
@@ -14,6 +16,7 @@ namespace Chaos
 {
 	DECLARE_CYCLE_STAT_EXTERN(TEXT("Collisions::BroadPhase"), STAT_Collisions_SpatialBroadPhase, STATGROUP_ChaosCollision, CHAOS_API);
 	DECLARE_CYCLE_STAT_EXTERN(TEXT("Collisions::Filtering"), STAT_Collisions_Filtering, STATGROUP_ChaosCollision, CHAOS_API);
+	DECLARE_CYCLE_STAT_EXTERN(TEXT("Collisions::SweepAndPrune"), STAT_Collisions_SweepAndPrune, STATGROUP_ChaosCollision, CHAOS_API);
 	
 	class FAsyncCollisionReceiver;
 
@@ -56,6 +59,9 @@ namespace Chaos
 	/**
 	 * A broad phase that iterates over particle and uses a spatial acceleration structure to output
 	 * potentially overlapping SpatialAccelerationHandles.
+	 *
+	 * Alternatively (see SetUseSweepAndPrune) pairs come from an incremental sweep and prune over the inflated bounds
+	 * of all particles, whose cost depends on how much bodies moved rather than on a query per simulated particle.
 	 */
 	class FSpatialAccelerationBroadPhase : public FBroadPhase
 	{
@@ -66,6 +72,7 @@ namespace Chaos
 			: FBroadPhase(InThickness, InVelocityInflation)
 			, Particles(InParticles)
 			, SpatialAcceleration(nullptr)
+			, bUseSweepAndPrune(Chaos_BroadPhase_SweepAndPrune != 0)
 		{
 		}
 
@@ -74,6 +81,20 @@ namespace Chaos
 			SpatialAcceleration = InSpatialAcceleration;
 		}
 
+		/** Whether pairs come from the sweep and prune instead of the spatial acceleration structure. Defaults to p.Chaos.BroadPhase.SweepAndPrune. */
+		void SetUseSweepAndPrune(const bool bInUseSweepAndPrune)
+		{
+			bUseSweepAndPrune = bInUseSweepAndPrune;
+			if (!bUseSweepAndPrune)
+			{
+				SweepAndPrune.Reset();
+			}
+		}
+
+		bool GetUseSweepAndPrune() const { return bUseSweepAndPrune; }
+
+		const FSweepAndPrune& GetSweepAndPrune() const { return SweepAndPrune; }
+
 		/**
 		 * Generate all overlapping pairs and pass them to the narrow phase.
 		 */
@@ -83,6 +104,12 @@ namespace Chaos
 			FAsyncCollisionReceiver& Receiver,
 			CollisionStats::FStatData& StatData)
 		{
+			if (bUseSweepAndPrune)
+			{
+				ProduceSweepAndPruneOverlaps(Dt, NarrowPhase, Receiver, StatData);
+				return;
+			}
+
 			if (!ensure(SpatialAcceleration))
 			{
 				// Must call SetSpatialAcceleration
@@ -101,6 +128,14 @@ namespace Chaos
 			{
 				ProduceOverlaps(Dt, *AABBTreeBV, NarrowPhase, Receiver, StatData);
 			}
+			else if (const auto WideAABBTree = SpatialAcceleration->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 4>>())
+			{
+				ProduceOverlaps(Dt, *WideAABBTree, NarrowPhase, Receiver, StatData);
+			}
+			else if (const auto WideAABBTree8 = SpatialAcceleration->template As<TWideAABBTree<TAccelerationStructureHandle<FReal, 3>, FReal, 8>>())
+			{
+				ProduceOverlaps(Dt, *WideAABBTree8, NarrowPhase, Receiver, StatData);
+			}
 			else if (const auto Collection = SpatialAcceleration->template As<ISpatialAccelerationCollection<TAccelerationStructureHandle<FReal, 3>, FReal, 3>>())
 			{
 				Collection->PBDComputeConstraintsLowLevel(Dt, *this, NarrowPhase, Receiver, StatData);
@@ -178,71 +213,170 @@ namespace Chaos
 				}
 
 				SCOPE_CYCLE_COUNTER(STAT_Collisions_Filtering);
+				FNarrowPhasePairs NarrowPhasePairs;
 				const int32 NumPotentials = PotentialIntersections.Num();
 				for (int32 i = 0; i < NumPotentials; ++i)
 				{
-					auto& Particle2 = *PotentialIntersections[i].GetGeometryParticleHandle_PhysicsThread();
-					const TGenericParticleHandle<FReal, 3> Particle2Generic(&Particle2);
+					ProducePairOverlaps(Dt, Particle1, *PotentialIntersections[i].GetGeometryParticleHandle_PhysicsThread(), bBody1Bounded, Box1Thickness, NarrowPhasePairs);
+				}
+				NarrowPhase.GenerateCollisions(TArrayView<const FNarrowPhasePair>(NarrowPhasePairs), Dt, Receiver, StatData);
+			}
 
-					// Broad Phase Culling
-					// CollisionGroup == 0 : Collide_With_Everything
-					// CollisionGroup == INDEX_NONE : Disabled collisions
-					// CollisionGroup_A != CollisionGroup_B : Skip Check
+			CHAOS_COLLISION_STAT(StatData.FinalizeData());
+		}
 
-					if (Particle1.CollisionGroup() == INDEX_NONE || Particle2Generic->CollisionGroup() == INDEX_NONE)
-					{
-						continue;
-					}
-					if (Particle1.CollisionGroup() && Particle2Generic->CollisionGroup() && Particle1.CollisionGroup() != Particle2Generic->CollisionGroup())
-					{
-						continue;
-					}
+		/** Pairs for the narrow phase, which processes those of a particle (or a chunk of sweep and prune pairs) together */
+		using FNarrowPhasePairs = TArray<FNarrowPhasePair, TInlineAllocator<16>>;
+
+		/** Sweep and prune pairs per parallel task */
+		static constexpr int32 SweepAndPrunePairsPerTask = 32;
+
+		/** Filters a potentially overlapping pair of a simulated particle and adds it to the pairs for the narrow phase */
+		template<typename T_PARTICLE1>
+		void ProducePairOverlaps(
+			FReal Dt,
+			T_PARTICLE1& Particle1,
+			TGeometryParticleHandle<FReal, 3>& Particle2,
+			const bool bBody1Bounded,
+			const FReal Box1Thickness,
+			FNarrowPhasePairs& OutNarrowPhasePairs)
+		{
+			const TGenericParticleHandle<FReal, 3> Particle2Generic(&Particle2);
 
-					if (!Particle1.Geometry() && !Particle2.Geometry())
-					{
-						continue;
-					}
+			// Broad Phase Culling
+			// CollisionGroup == 0 : Collide_With_Everything
+			// CollisionGroup == INDEX_NONE : Disabled collisions
+			// CollisionGroup_A != CollisionGroup_B : Skip Check
+
+			if (Particle1.CollisionGroup() == INDEX_NONE || Particle2Generic->CollisionGroup() == INDEX_NONE)
+			{
+				return;
+			}
+			if (Particle1.CollisionGroup() && Particle2Generic->CollisionGroup() && Particle1.CollisionGroup() != Particle2Generic->CollisionGroup())
+			{
+				return;
+			}
 
-					if (Particle1.Handle() == Particle2.Handle())
+			if (!Particle1.Geometry() && !Particle2.Geometry())
+			{
+				return;
+			}
+
+			if (Particle1.Handle() == Particle2.Handle())
+			{
+				return;
+			}
+
+			// HACK : This should not be happening if the disabled particles are properly removed from the active particles list. 
+			if (Particle1.Disabled() || Particle2Generic->Disabled())
+			{
+				return;
+			}
+
+
+			// Sleeping won't collide against another sleeping and sleeping vs dynamic gets picked up by the other direction.
+			const bool bIsParticle2Kinematic = Particle2.CastToKinematicParticle() &&
+				(Particle2.ObjectState() == EObjectStateType::Kinematic &&
+					(Particle2.CastToKinematicParticle()->V().SizeSquared() > 1e-4 ||
+						Particle2.Geometry()->GetType() == TCapsule<float>::StaticType()));
+			if (Particle1.ObjectState() == EObjectStateType::Sleeping && !bIsParticle2Kinematic)
+			{
+				return;
+			}
+
+			const bool bBody2Bounded = HasBoundingBox(Particle2);
+			const bool bIsParticle2Dynamic = Particle2.CastToRigidParticle() && Particle2.ObjectState() == EObjectStateType::Dynamic;
+			if (bBody1Bounded == bBody2Bounded && bIsParticle2Dynamic)
+			{
+				//no bidirectional constraints.
+				if (Particle2.ParticleID() > Particle1.ParticleID())
+				{
+					return;
+				}
+			}
+		
+			const FReal Box2Thickness = bIsParticle2Dynamic ? ComputeBoundsThickness(*Particle2.CastToRigidParticle(), Dt, BoundsThickness, BoundsThicknessVelocityInflation).Size()
+				: (bIsParticle2Kinematic ? ComputeBoundsThickness(*Particle2.CastToKinematicParticle(), Dt, BoundsThickness, BoundsThicknessVelocityInflation).Size() : (FReal)0);
+
+			OutNarrowPhasePairs.Add(FNarrowPhasePair{ Particle1.Handle(), Particle2.Handle(), FMath::Max(Box1Thickness, Box2Thickness) });
+		}
+
+		/** Sweep and prune pairs are unordered, this produces the pair of Particle1 against Particle2 if Particle1 is simulated */
+		void ProduceSimulatedPairOverlaps(
+			FReal Dt,
+			TGeometryParticleHandle<FReal, 3>* Particle1,
+			TGeometryParticleHandle<FReal, 3>* Particle2,
+			FNarrowPhasePairs& OutNarrowPhasePairs)
+		{
+			TPBDRigidParticleHandle<FReal, 3>* Rigid1 = Particle1->CastToRigidParticle();
+			if (Rigid1 && (Rigid1->ObjectState() == EObjectStateType::Dynamic || Rigid1->ObjectState() == EObjectStateType::Sleeping))
+			{
+				const bool bBody1Bounded = HasBoundingBox(*Rigid1);
+				const FReal Box1Thickness = ComputeBoundsThickness(*Rigid1, Dt, BoundsThickness, BoundsThicknessVelocityInflation).Size();
+				ProducePairOverlaps(Dt, *Rigid1, *Particle2, bBody1Bounded, Box1Thickness, OutNarrowPhasePairs);
+			}
+		}
+
+		void ProduceSweepAndPruneOverlaps(
+			FReal Dt,
+			FNarrowPhase& NarrowPhase,
+			FAsyncCollisionReceiver& Receiver,
+			CollisionStats::FStatData& StatData)
+		{
+			const bool bDisableParallelFor = StatData.IsEnabled() || bDisableCollisionParallelFor;
+
+			{
+				SCOPE_CYCLE_COUNTER(STAT_Collisions_SweepAndPrune);
+
+				UnboundedParticles.Reset();
+				SweepAndPrune.BeginUpdate();
+				for (auto& Particle : Particles.GetNonDisabledView())
+				{
+					if (Particle.HasBounds())
 					{
-						continue;
+						SweepAndPrune.UpdateProxy(Particle.Handle(), Particle.WorldSpaceInflatedBounds(), Particle.CastToRigidParticle() != nullptr);
 					}
-
-					// HACK : This should not be happening if the disabled particles are properly removed from the active particles list. 
-					if (Particle1.Disabled() || Particle2Generic->Disabled())
+					else
 					{
-						continue;
+						UnboundedParticles.Add(Particle.Handle());
 					}
+				}
+				SweepAndPrune.EndUpdate();
+
+				CHAOS_COLLISION_STAT(StatData.RecordBroadphasePotentials(SweepAndPrune.GetOverlappingPairs().Num()))
+			}
 
+			SCOPE_CYCLE_COUNTER(STAT_Collisions_Filtering);
 
-					// Sleeping won't collide against another sleeping and sleeping vs dynamic gets picked up by the other direction.
-					const bool bIsParticle2Kinematic = Particle2.CastToKinematicParticle() &&
-						(Particle2.ObjectState() == EObjectStateType::Kinematic &&
-							(Particle2.CastToKinematicParticle()->V().SizeSquared() > 1e-4 ||
-								Particle2.Geometry()->GetType() == TCapsule<float>::StaticType()));
-					if (Particle1.ObjectState() == EObjectStateType::Sleeping && !bIsParticle2Kinematic)
-					{
-						continue;
-					}
+			// the filtering lets only one direction of a pair through
+			const TArray<FSweepAndPrune::FOverlappingPair>& Pairs = SweepAndPrune.GetOverlappingPairs();
+			const int32 NumTasks = FMath::DivideAndRoundUp(Pairs.Num(), SweepAndPrunePairsPerTask);
+			PhysicsParallelFor(NumTasks, [&](int32 TaskIndex)
+			{
+				FNarrowPhasePairs NarrowPhasePairs;
+				const int32 EndPairIndex = FMath::Min((TaskIndex + 1) * SweepAndPrunePairsPerTask, Pairs.Num());
+				for (int32 PairIndex = TaskIndex * SweepAndPrunePairsPerTask; PairIndex < EndPairIndex; ++PairIndex)
+				{
+					const FSweepAndPrune::FOverlappingPair& Pair = Pairs[PairIndex];
+					ProduceSimulatedPairOverlaps(Dt, Pair.Particle0, Pair.Particle1, NarrowPhasePairs);
+					ProduceSimulatedPairOverlaps(Dt, Pair.Particle1, Pair.Particle0, NarrowPhasePairs);
+				}
+				NarrowPhase.GenerateCollisions(TArrayView<const FNarrowPhasePair>(NarrowPhasePairs), Dt, Receiver, StatData);
+			}, bDisableParallelFor);
 
-					const bool bBody2Bounded = HasBoundingBox(Particle2);
-					const bool bIsParticle2Dynamic = Particle2.CastToRigidParticle() && Particle2.ObjectState() == EObjectStateType::Dynamic;
-					if (bBody1Bounded == bBody2Bounded && bIsParticle2Dynamic)
+			// particles without bounds are in no pair, simulated particles test them like the global objects of acceleration structures
+			if (UnboundedParticles.Num())
+			{
+				Particles.GetNonDisabledDynamicView().ParallelFor(
+					[&](auto& Particle1, int32 ActiveIdxIdx)
 					{
-						//no bidirectional constraints.
-						if (Particle2.ParticleID() > Particle1.ParticleID())
+						FNarrowPhasePairs NarrowPhasePairs;
+						for (TGeometryParticleHandle<FReal, 3>* Particle2 : UnboundedParticles)
 						{
-							continue;
+							ProduceSimulatedPairOverlaps(Dt, Particle1.Handle(), Particle2, NarrowPhasePairs);
 						}
-					}
-				
-					const FReal Box2Thickness = bIsParticle2Dynamic ? ComputeBoundsThickness(*Particle2.CastToRigidParticle(), Dt, BoundsThickness, BoundsThicknessVelocityInflation).Size()
-						: (bIsParticle2Kinematic ? ComputeBoundsThickness(*Particle2.CastToKinematicParticle(), Dt, BoundsThickness, BoundsThicknessVelocityInflation).Size() : (FReal)0);
-
-					FCollisionConstraintsArray NewConstraints;
-					NarrowPhase.GenerateCollisions(NewConstraints, Dt, Particle1.Handle(), Particle2.Handle(), FMath::Max(Box1Thickness, Box2Thickness), StatData);
-					Receiver.ReceiveCollisions(NewConstraints);
-				}
+						NarrowPhase.GenerateCollisions(TArrayView<const FNarrowPhasePair>(NarrowPhasePairs), Dt, Receiver, StatData);
+					}, bDisableParallelFor);
 			}
 
 			CHAOS_COLLISION_STAT(StatData.FinalizeData());
@@ -250,6 +384,10 @@ namespace Chaos
 
 		const TPBDRigidsSOAs<FReal, 3>& Particles;
 		const FAccelerationStructure* SpatialAcceleration;
+
+		bool bUseSweepAndPrune;
+		FSweepAndPrune SweepAndPrune;
+		TArray<TGeometryParticleHandle<FReal, 3>*> UnboundedParticles;
 	};
 
 
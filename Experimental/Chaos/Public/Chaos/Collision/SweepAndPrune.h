@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/AABB.h"
+#include "Chaos/ParticleHandleFwd.h"
+
+namespace Chaos
+{
+	CHAOS_API extern int32 Chaos_BroadPhase_SweepAndPrune;
+
+	/**
+	 * Incremental sweep and prune over the three axes.
+	 *
+	 * Keeps the bounds endpoints of all proxies sorted per axis. Between updates bodies move little, so the arrays are
+	 * nearly sorted and an insertion sort puts them back in order with few swaps. Overlapping pairs only change when a
+	 * min endpoint swaps with a max endpoint, so the pair set is maintained from those swaps alone and the changes of an
+	 * update are available as added and removed pairs.
+	 *
+	 * Pairs of two proxies that are not rigid particles (statics and pure kinematics) are never reported.
+	 *
+	 * Usage each frame: BeginUpdate, UpdateProxy for all particles that should be in the broad phase, EndUpdate.
+	 * Particles that did not get an UpdateProxy since BeginUpdate are removed.
+	 */
+	class CHAOS_API FSweepAndPrune
+	{
+	public:
+		using FParticleHandle = TGeometryParticleHandle<FReal, 3>;
+
+		struct FOverlappingPair
+		{
+			FParticleHandle* Particle0;
+			FParticleHandle* Particle1;
+		};
+
+		FSweepAndPrune();
+
+		void BeginUpdate();
+
+		/**
+		 * Add the particle or update its bounds.
+		 * @param bIsRigid whether the particle can be simulated, pairs are only reported if one of their particles is. A change makes EndUpdate sort from scratch.
+		 */
+		void UpdateProxy(FParticleHandle* Particle, const TAABB<FReal, 3>& Bounds, const bool bIsRigid);
+
+		/** Remove particles that were not updated, sort the endpoints and update the overlapping pairs */
+		void EndUpdate();
+
+		/** Remove all proxies and pairs */
+		void Reset();
+
+		/** All overlapping pairs, in no particular order */
+		const TArray<FOverlappingPair>& GetOverlappingPairs() const { return Pairs; }
+
+		/** Pairs that started overlapping during the last update */
+		const TArray<FOverlappingPair>& GetAddedPairs() const { return AddedPairs; }
+
+		/** Pairs that stopped overlapping during the last update. Particles of pairs that were removed with their proxy may have been destroyed since. */
+		const TArray<FOverlappingPair>& GetRemovedPairs() const { return RemovedPairs; }
+
+		int32 GetNumProxies() const { return ProxyIndices.Num(); }
+
+		/** Endpoint swaps of the last update, or the number of endpoints when it rebuilt */
+		int32 GetNumSwaps() const { return NumSwaps; }
+
+		/** Whether the last update sorted from scratch instead of incrementally */
+		bool WasRebuilt() const { return bRebuilt; }
+
+		SIZE_T GetAllocatedSize() const;
+
+	private:
+		struct FProxy
+		{
+			FParticleHandle* Particle;
+			TAABB<FReal, 3> Bounds;
+			uint32 UpdateStamp;
+			bool bIsRigid;
+		};
+
+		struct FEndpoint
+		{
+			FReal Value;
+			/** Proxy index in the high bits, whether this is the max endpoint in the lowest bit */
+			uint32 Data;
+
+			FEndpoint() {}
+			FEndpoint(const FReal InValue, const int32 ProxyIndex, const bool bIsMax) : Value(InValue), Data(((uint32)ProxyIndex << 1) | (bIsMax ? 1 : 0)) {}
+
+			int32 GetProxyIndex() const { return (int32)(Data >> 1); }
+			bool IsMax() const { return (Data & 1) != 0; }
+
+			/** Min endpoints go first at equal values, so that touching bounds overlap like in TAABB::Intersects */
+			bool operator<(const FEndpoint& Other) const
+			{
+				return Value < Other.Value || (Value == Other.Value && IsMax() < Other.IsMax());
+			}
+		};
+
+		static uint64 MakePairKey(const int32 ProxyIndex0, const int32 ProxyIndex1)
+		{
+			return ProxyIndex0 < ProxyIndex1 ? (((uint64)ProxyIndex0 << 32) | (uint32)ProxyIndex1) : (((uint64)ProxyIndex1 << 32) | (uint32)ProxyIndex0);
+		}
+
+		FOverlappingPair MakePair(const uint64 Key) const
+		{
+			return FOverlappingPair{ Proxies[(int32)(Key >> 32)].Particle, Proxies[(int32)(Key & 0xFFFFFFFF)].Particle };
+		}
+
+		bool CanOverlap(const int32 ProxyIndex0, const int32 ProxyIndex1) const
+		{
+			const FProxy& Proxy0 = Proxies[ProxyIndex0];
+			const FProxy& Proxy1 = Proxies[ProxyIndex1];
+			return ProxyIndex0 != ProxyIndex1 && (Proxy0.bIsRigid || Proxy1.bIsRigid) && Proxy0.Bounds.Intersects(Proxy1.Bounds);
+		}
+
+		void RemoveStaleProxies();
+		void SortAxis(const int32 Axis);
+		void Rebuild();
+		void AddPair(const int32 ProxyIndex0, const int32 ProxyIndex1);
+		void RemovePair(const int32 ProxyIndex0, const int32 ProxyIndex1);
+		void RemovePairAt(const int32 PairIndex);
+		void CancelTransientPairs();
+
+		TArray<FProxy> Proxies;
+		TArray<int32> FreeProxies;
+		TMap<FParticleHandle*, int32> ProxyIndices;
+
+		TArray<FEndpoint> Endpoints[3];
+
+		/** Pairs and their keys at the same index, kept compact so that they can be processed in parallel */
+		TArray<FOverlappingPair> Pairs;
+		TArray<uint64> PairKeys;
+		TMap<uint64, int32> PairIndices;
+
+		/** Changes of the current update with their keys at the same index */
+		TArray<FOverlappingPair> AddedPairs;
+		TArray<uint64> AddedPairKeys;
+		TArray<FOverlappingPair> RemovedPairs;
+		TArray<uint64> RemovedPairKeys;
+
+		uint32 UpdateStamp;
+		int32 NumNewProxies;
+		int32 NumRigidChanges;
+		int32 NumSwaps;
+		bool bRebuilt;
+	};
+}
@@ -3,6 +3,7 @@
 
 #include "Chaos/CollisionResolutionTypes.h"
 #include "Chaos/CollisionResolutionUtil.h"
+#include "Containers/ArrayView.h"
 
 namespace Chaos
 {
@@ -208,6 +209,31 @@ namespace Chaos
 		template <typename T, int d>
 		void CHAOS_API ConstructConvexConvexConstraints(TGeometryParticleHandle<T, d>* Particle0, TGeometryParticleHandle<T, d>* Particle1, const FImplicitObject* Implicit0, const FImplicitObject* Implicit1, const TRigidTransform<T, d>& Transform0, const TRigidTransform<T, d>& Transform1, const T CullDistance, FCollisionConstraintsArray& NewConstraints);
 
+		/** A convex-convex particle pair for ConstructConvexConvexConstraintsBatch, see GetConvexConvexBatchPair */
+		struct FConvexConvexBatchPair
+		{
+			TGeometryParticleHandle<FReal, 3>* Particle0;
+			TGeometryParticleHandle<FReal, 3>* Particle1;
+			const FConvex* Convex0;
+			const FConvex* Convex1;
+			FRigidTransform3 Transform0;
+			FRigidTransform3 Transform1;
+			FReal CullDistance;
+		};
+
+		/**
+		 * Whether ConstructConstraints on the particle geometries would only call ConstructConvexConvexConstraints, once: both geometries
+		 * are an FConvex (possibly instanced, not scaled), the pair passes shape filtering and does not need CCD.
+		 * If so, OutPair is filled in for ConstructConvexConvexConstraintsBatch.
+		 */
+		CHAOS_API bool GetConvexConvexBatchPair(TGeometryParticleHandle<FReal, 3>* Particle0, TGeometryParticleHandle<FReal, 3>* Particle1, const FRigidTransform3& Transform0, const FRigidTransform3& Transform1, const FReal CullDistance, const FCollisionContext& Context, FConvexConvexBatchPair& OutPair);
+
+		/**
+		 * Same as ConstructConstraints on every pair, with the GJK of GJKBatchWidth pairs at a time running together (see GJKPenetrationBatch).
+		 * Contacts of Pairs[i] are added to NewConstraints[i].
+		 */
+		CHAOS_API void ConstructConvexConvexConstraintsBatch(const TArrayView<const FConvexConvexBatchPair>& Pairs, FCollisionConstraintsArray* NewConstraints);
+
 		//
 		// Convex-HeightField
 		//
@@ -126,6 +126,7 @@ namespace Chaos
 			, Type(InType)
 		{ 
 			ImplicitTransform[0] = TRigidTransform<T, d>::Identity; ImplicitTransform[1] = TRigidTransform<T,d>::Identity;
+			ManifoldRelativeTransform = TRigidTransform<T, d>::Identity;
 			Manifold.Implicit[0] = nullptr; Manifold.Implicit[1] = nullptr;
 			Particle[0] = nullptr; Particle[1] = nullptr; 
 		}
@@ -140,6 +141,7 @@ namespace Chaos
 			, Type(InType)
 		{
 			ImplicitTransform[0] = Transform0; ImplicitTransform[1] = Transform1;
+			ManifoldRelativeTransform = TRigidTransform<T, d>::Identity;
 			Manifold.Implicit[0] = Implicit0; Manifold.Implicit[1] = Implicit1;
 			Manifold.ShapesType = ShapesType;
 			Particle[0] = Particle0; Particle[1] = Particle1; 
@@ -181,6 +183,7 @@ namespace Chaos
 
 		TRigidTransform<T, d> ImplicitTransform[2]; // { Point, Volume }
 		FGeometryParticleHandle* Particle[2]; // { Point, Volume }
+		TRigidTransform<T, d> ManifoldRelativeTransform; // Particle[1] relative to Particle[0] when the manifold was generated, see FCollisionManifoldCache
 		TVector<T, d> AccumulatedImpulse;
 		FManifold Manifold;
 		int32 Timestamp;
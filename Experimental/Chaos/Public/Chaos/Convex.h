@@ -9,6 +9,7 @@
 #include "GJK.h"
 #include "ChaosCheck.h"
 #include "ChaosLog.h"
+#include "Math/VectorRegister.h"
 
 namespace Chaos
 {
@@ -32,6 +33,7 @@ namespace Chaos
 		    , LocalBoundingBox(MoveTemp(Other.LocalBoundingBox))
 			, Volume(MoveTemp(Other.Volume))
 			, CenterOfMass(MoveTemp(Other.CenterOfMass))
+			, SoAVertices(MoveTemp(Other.SoAVertices))
 		{}
 
 		// NOTE: This constructor will result in approximate COM and volume calculations, since it does
@@ -51,6 +53,8 @@ namespace Chaos
 			// For now we approximate COM and volume with the bounding box
 			CenterOfMass = LocalBoundingBox.GetCenterOfMass();
 			Volume = LocalBoundingBox.GetVolume();
+
+			BuildSoAVertices();
 		}
 
 		FConvex(const TParticles<FReal, 3>& InParticles)
@@ -66,6 +70,8 @@ namespace Chaos
 			FConvexBuilder::Build(InParticles, Planes, FaceIndices, SurfaceParticles, LocalBoundingBox);
 			CHAOS_ENSURE(Planes.Num() == FaceIndices.Num());
 			CalculateVolumeAndCenterOfMass(SurfaceParticles, FaceIndices, Volume, CenterOfMass);
+
+			BuildSoAVertices();
 		}
 
 		static constexpr EImplicitObjectType StaticType()
@@ -164,21 +170,12 @@ namespace Chaos
 
 		FVec3 Support(const FVec3& Direction, const FReal Thickness) const
 		{
-			FReal MaxDot = TNumericLimits<FReal>::Lowest();
 			int32 MaxVIdx = 0;
 			const int32 NumVertices = SurfaceParticles.Size();
 
 			if(ensure(NumVertices > 0))
 			{
-				for(int32 Idx = 0; Idx < NumVertices; ++Idx)
-				{
-					const FReal Dot = FVec3::DotProduct(SurfaceParticles.X(Idx), Direction);
-					if(Dot > MaxDot)
-					{
-						MaxDot = Dot;
-						MaxVIdx = Idx;
-					}
-				}
+				MaxVIdx = (SoAVertices.Num() > 0) ? GetSupportVertexSIMD(Direction) : GetSupportVertexScalar(Direction);
 			}
 			else
 			{
@@ -193,6 +190,72 @@ namespace Chaos
 			return SurfaceParticles.X(MaxVIdx);
 		}
 
+		/** Index of the first vertex with the largest dot product with Direction, one vertex at a time */
+		int32 GetSupportVertexScalar(const FVec3& Direction) const
+		{
+			FReal MaxDot = TNumericLimits<FReal>::Lowest();
+			int32 MaxVIdx = 0;
+			const int32 NumVertices = SurfaceParticles.Size();
+			for (int32 Idx = 0; Idx < NumVertices; ++Idx)
+			{
+				const FReal Dot = FVec3::DotProduct(SurfaceParticles.X(Idx), Direction);
+				if (Dot > MaxDot)
+				{
+					MaxDot = Dot;
+					MaxVIdx = Idx;
+				}
+			}
+			return MaxVIdx;
+		}
+
+		/** Same as GetSupportVertexScalar, four vertices at a time from the SoA copy of the vertices */
+		int32 GetSupportVertexSIMD(const FVec3& Direction) const
+		{
+			const VectorRegister DirX = VectorSetFloat1(Direction.X);
+			const VectorRegister DirY = VectorSetFloat1(Direction.Y);
+			const VectorRegister DirZ = VectorSetFloat1(Direction.Z);
+			const VectorRegister LaneStep = VectorSetFloat1((float)SoAVertexBlockWidth);
+
+			// per lane best dot and the index of its vertex (as float, exact for any hull size)
+			VectorRegister MaxDots = VectorSetFloat1(TNumericLimits<FReal>::Lowest());
+			VectorRegister MaxIndices = VectorZero();
+			VectorRegister Indices = MakeVectorRegister(0.f, 1.f, 2.f, 3.f);
+
+			const FReal* Block = SoAVertices.GetData();
+			const FReal* BlockEnd = Block + SoAVertices.Num();
+			for (; Block < BlockEnd; Block += 3 * SoAVertexBlockWidth)
+			{
+				const VectorRegister X = VectorLoadAligned(Block);
+				const VectorRegister Y = VectorLoadAligned(Block + SoAVertexBlockWidth);
+				const VectorRegister Z = VectorLoadAligned(Block + 2 * SoAVertexBlockWidth);
+				const VectorRegister Dots = VectorMultiplyAdd(Z, DirZ, VectorMultiplyAdd(Y, DirY, VectorMultiply(X, DirX)));
+
+				// strictly greater keeps the first vertex of the lane on ties, like the scalar loop
+				const VectorRegister IsGreater = VectorCompareGT(Dots, MaxDots);
+				MaxDots = VectorSelect(IsGreater, Dots, MaxDots);
+				MaxIndices = VectorSelect(IsGreater, Indices, MaxIndices);
+				Indices = VectorAdd(Indices, LaneStep);
+			}
+
+			MS_ALIGN(16) float LaneDots[SoAVertexBlockWidth] GCC_ALIGN(16);
+			MS_ALIGN(16) float LaneIndices[SoAVertexBlockWidth] GCC_ALIGN(16);
+			VectorStoreAligned(MaxDots, LaneDots);
+			VectorStoreAligned(MaxIndices, LaneIndices);
+
+			// across lanes the lowest index wins ties, so the result is the first vertex with the largest dot
+			int32 MaxLane = 0;
+			for (int32 Lane = 1; Lane < SoAVertexBlockWidth; ++Lane)
+			{
+				if (LaneDots[Lane] > LaneDots[MaxLane] || (LaneDots[Lane] == LaneDots[MaxLane] && LaneIndices[Lane] < LaneIndices[MaxLane]))
+				{
+					MaxLane = Lane;
+				}
+			}
+
+			// padding repeats the last vertex
+			return FMath::Min((int32)LaneIndices[MaxLane], (int32)SurfaceParticles.Size() - 1);
+		}
+
 		virtual FString ToString() const
 		{
 			return FString::Printf(TEXT("Convex"));
@@ -276,6 +339,11 @@ namespace Chaos
 				FConvexBuilder::Build(SurfaceParticles, Planes, FaceIndices, TempSurfaceParticles, LocalBoundingBox);
 				CalculateVolumeAndCenterOfMass(SurfaceParticles, FaceIndices, Volume, CenterOfMass);
 			}
+
+			if (Ar.IsLoading())
+			{
+				BuildSoAVertices();
+			}
 		}
 
 		virtual void Serialize(FChaosArchive& Ar) override
@@ -316,6 +384,7 @@ namespace Chaos
 		{
 			TArray<TArray<int32>> FaceIndices;
 			FConvexBuilder::Simplify(Planes, FaceIndices, SurfaceParticles, LocalBoundingBox);
+			BuildSoAVertices();
 		}
 
 		FVec3 GetCenter() const
@@ -324,10 +393,40 @@ namespace Chaos
 		}
 
 	private:
+		/** Vertices per block of SoAVertices, one per SIMD lane */
+		static constexpr int32 SoAVertexBlockWidth = 4;
+
+		/** Copy SurfaceParticles into SoAVertices, must be called whenever SurfaceParticles changes */
+		void BuildSoAVertices()
+		{
+			SoAVertices.Reset();
+
+			const int32 NumVertices = SurfaceParticles.Size();
+			if (NumVertices == 0)
+			{
+				return;
+			}
+
+			const int32 NumBlocks = (NumVertices + SoAVertexBlockWidth - 1) / SoAVertexBlockWidth;
+			SoAVertices.SetNumUninitialized(NumBlocks * 3 * SoAVertexBlockWidth);
+			for (int32 Idx = 0; Idx < NumBlocks * SoAVertexBlockWidth; ++Idx)
+			{
+				const FVec3& Vertex = SurfaceParticles.X(FMath::Min(Idx, NumVertices - 1));
+				FReal* Block = &SoAVertices[(Idx / SoAVertexBlockWidth) * 3 * SoAVertexBlockWidth];
+				const int32 Lane = Idx % SoAVertexBlockWidth;
+				Block[Lane] = Vertex.X;
+				Block[SoAVertexBlockWidth + Lane] = Vertex.Y;
+				Block[2 * SoAVertexBlockWidth + Lane] = Vertex.Z;
+			}
+		}
+
 		TArray<TPlaneConcrete<FReal, 3>> Planes;
 		TParticles<FReal, 3> SurfaceParticles;	//copy of the vertices that are just on the convex hull boundary
 		TAABB<FReal, 3> LocalBoundingBox;
 		float Volume;
 		FVec3 CenterOfMass;
+
+		/** SurfaceParticles in blocks of SoAVertexBlockWidth X, then Y, then Z, for Support. The last block is padded with the last vertex. */
+		TArray<FReal, TAlignedHeapAllocator<16>> SoAVertices;
 	};
 }
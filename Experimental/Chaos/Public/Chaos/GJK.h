@@ -8,6 +8,7 @@
 #include "Chaos/EPA.h"
 #include "ChaosCheck.h"
 #include "ChaosLog.h"
+#include "Containers/ArrayView.h"
 
 namespace Chaos
 {
@@ -87,52 +88,65 @@ namespace Chaos
 	}
 
 	
-	// This function will be faster if bNegativePenetrationSupport is false, so don't use the feature if not required
-	template <bool bNegativePenetrationSupport = false, typename T, typename TGeometryA, typename TGeometryB>
-	bool GJKPenetration(const TGeometryA& A, const TGeometryB& B, const TRigidTransform<T, 3>& BToATM, T& OutPenetration, TVec3<T>& OutClosestA, TVec3<T>& OutClosestB, TVec3<T>& OutNormal, const T InThicknessA = 0, const TVector<T, 3>& InitialDir = TVector<T, 3>(1, 0, 0), const T InThicknessB = 0, int32* OutNumIterations = nullptr)
+	/** Outcome of one GJKPenetration iteration */
+	enum class EGJKPenetrationStep : uint8
 	{
-		auto SupportAFunc = [&A](const TVec3<T>& V)
-		{
-			return A.Support2(V);
-		};
-
-		const TRotation<T, 3> AToBRotation = BToATM.GetRotation().Inverse();
-
+		Continue,
+		/** Converged (or gave up), the result is ready for TGJKPenetrationState::Finish */
+		Done,
+		/** Proved the shapes are separated (only without negative penetration support) */
+		Separated
+	};
 
-		auto SupportBFunc = [&B, &BToATM, &AToBRotation](const TVec3<T>& V)
+	/**
+	 * State of the GJK iterations of GJKPenetration, so that several queries can be advanced together (see GJKPenetrationBatch).
+	 * Supports are passed in A's local space, as in GJKPenetration.
+	 */
+	template <typename T>
+	struct TGJKPenetrationState
+	{
+		TVec3<T> V;
+		TVec3<T> As[4];
+		TVec3<T> Bs[4];
+		FSimplex SimplexIDs;
+		TVec3<T> Simplex[4];
+		T Barycentric[4];
+		T PrevDist2;
+		T ThicknessA;
+		T ThicknessB;
+		T Inflation;
+		int32 NumIterations;
+
+		static constexpr T Eps2 = 1e-6;
+
+		/** @param InThicknessA, InThicknessB the thicknesses including the geometry margins */
+		void Init(const TVec3<T>& InitialDir, const T InThicknessA, const T InThicknessB)
 		{
-			const TVector<T, 3> VInB = AToBRotation * V;
-			const TVector<T, 3> SupportBLocal = B.Support2(VInB);
-			return BToATM.TransformPositionNoScale(SupportBLocal);
-		};
+			//todo: refactor all of these similar functions
+			V = -InitialDir;
+			if (V.SafeNormalize() == 0)
+			{
+				V = TVec3<T>(-1, 0, 0);
+			}
 
-		//todo: refactor all of these similar functions
-		TVector<T, 3> V = -InitialDir;
-		if (V.SafeNormalize() == 0)
-		{
-			V = TVec3<T>(-1, 0, 0);
+			SimplexIDs = FSimplex();
+			for (int32 Idx = 0; Idx < 4; ++Idx)
+			{
+				Barycentric[Idx] = -1;	//not needed, but compiler warns
+			}
+			PrevDist2 = FLT_MAX;
+			ThicknessA = InThicknessA;
+			ThicknessB = InThicknessB;
+			Inflation = ThicknessA + ThicknessB + 1e-3;
+			NumIterations = 0;
 		}
 
-		TVec3<T> As[4];
-		TVec3<T> Bs[4];
-
-		FSimplex SimplexIDs;
-		TVector<T, 3> Simplex[4];
-		T Barycentric[4] = { -1,-1,-1,-1 };	//not needed, but compiler warns
-		bool bTerminate;
-		bool bNearZero = false;
-		int NumIterations = 0;
-		T PrevDist2 = FLT_MAX;
-		const T ThicknessA = A.GetMargin() + InThicknessA;
-		const T ThicknessB = B.GetMargin() + InThicknessB;
-		const T Inflation = ThicknessA + ThicknessB + 1e-3;
-		const T Inflation2 = Inflation * Inflation;
-		const T Eps2 = 1e-6;
-		do
+		template <bool bNegativePenetrationSupport, typename SupportALambda, typename SupportBLambda>
+		FORCEINLINE_DEBUGGABLE EGJKPenetrationStep Advance(const SupportALambda& SupportAFunc, const SupportBLambda& SupportBFunc)
 		{
 			if (!ensure(NumIterations++ < 32))	//todo: take this out
 			{
-				break;	//if taking too long just stop. This should never happen
+				return EGJKPenetrationStep::Done;	//if taking too long just stop. This should never happen
 			}
 			const TVector<T, 3> NegV = -V;
 			const TVector<T, 3> SupportA = SupportAFunc(NegV);
@@ -141,7 +155,7 @@ namespace Chaos
 
 			if (!bNegativePenetrationSupport && TVector<T, 3>::DotProduct(V, W) > Inflation)
 			{
-				return false;
+				return EGJKPenetrationStep::Separated;
 			}
 
 			SimplexIDs[SimplexIDs.NumVerts] = SimplexIDs.NumVerts;
@@ -152,97 +166,232 @@ namespace Chaos
 			V = SimplexFindClosestToOrigin(Simplex, SimplexIDs, Barycentric, As, Bs);
 
 			T NewDist2 = V.SizeSquared();
-			bNearZero = NewDist2 < Eps2;	//want to get the closest point for MTD
+			const bool bNearZero = NewDist2 < Eps2;	//want to get the closest point for MTD
 
 			//as simplices become degenerate we will stop making progress. This is a side-effect of precision, in that case take V as the current best approximation
 			//question: should we take previous v in case it's better?
 			const bool bMadeProgress = NewDist2 < PrevDist2;
-			bTerminate = bNearZero || !bMadeProgress;
+			const bool bTerminate = bNearZero || !bMadeProgress;
 
 			PrevDist2 = NewDist2;
 
-			if (!bTerminate)
+			if (bTerminate)
 			{
-				V /= FMath::Sqrt(NewDist2);
+				return EGJKPenetrationStep::Done;
 			}
 
-		} while (!bTerminate);
-
-		if (OutNumIterations != nullptr)
-		{
-			*OutNumIterations = NumIterations;
+			V /= FMath::Sqrt(NewDist2);
+			return EGJKPenetrationStep::Continue;
 		}
 
-		if (PrevDist2 > Eps2)
+		/** Compute the result once Advance returned Done. Runs EPA when the shapes (without thickness) overlap. */
+		template <bool bNegativePenetrationSupport, typename SupportALambda, typename SupportBLambda>
+		bool Finish(const SupportALambda& SupportAFunc, const SupportBLambda& SupportBFunc, T& OutPenetration, TVec3<T>& OutClosestA, TVec3<T>& OutClosestB, TVec3<T>& OutNormal) const
 		{
-			//generally this happens when shapes are inflated.
-			TVector<T, 3> ClosestA(0);
-			TVector<T, 3> ClosestBInA(0);
-
-			for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+			if (PrevDist2 > Eps2)
 			{
-				ClosestA += As[i] * Barycentric[i];
-				ClosestBInA += Bs[i] * Barycentric[i];
-			}
+				//generally this happens when shapes are inflated.
+				TVector<T, 3> ClosestA(0);
+				TVector<T, 3> ClosestBInA(0);
+
+				for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+				{
+					ClosestA += As[i] * Barycentric[i];
+					ClosestBInA += Bs[i] * Barycentric[i];
+				}
+
+				
+				const T PreDist = FMath::Sqrt(PrevDist2);
+				OutNormal = (ClosestBInA - ClosestA).GetUnsafeNormal();	//Note1: should we just use PreDist2? //Note2: we can just use -V.GetUnsafeNormal() here instead if it improves accuracy
+				T Penetration = ThicknessA + ThicknessB - PreDist;
+				if (!bNegativePenetrationSupport)
+				{
+					Penetration = FMath::Clamp<T>(Penetration, 0, TNumericLimits<T>::Max());
+				}
+				OutPenetration = Penetration;
+				OutClosestA = ClosestA + OutNormal * ThicknessA;
+				OutClosestB = ClosestBInA - OutNormal * ThicknessB;
 
-			
-			const T PreDist = FMath::Sqrt(PrevDist2);
-			OutNormal = (ClosestBInA - ClosestA).GetUnsafeNormal();	//Note1: should we just use PreDist2? //Note2: we can just use -V.GetUnsafeNormal() here instead if it improves accuracy
-			T Penetration = ThicknessA + ThicknessB - PreDist;
-			if (!bNegativePenetrationSupport)
+			}
+			else
 			{
-				Penetration = FMath::Clamp<T>(Penetration, 0, TNumericLimits<T>::Max());
+				TArray<TVec3<T>> VertsA;
+				TArray<TVec3<T>> VertsB;
+
+				VertsA.Reserve(8);
+				VertsB.Reserve(8);
+
+				for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+				{
+					VertsA.Add(As[i]);
+					VertsB.Add(Bs[i]);
+				}
+
+				T Penetration;
+				TVec3<T> MTD, ClosestA, ClosestBInA;
+				if (EPA(VertsA, VertsB, SupportAFunc, SupportBFunc, Penetration, MTD, ClosestA, ClosestBInA) != EPAResult::BadInitialSimplex)
+				{
+					OutNormal = MTD;
+					OutPenetration = Penetration + ThicknessA + ThicknessB;
+					OutClosestA = ClosestA + OutNormal * ThicknessA;
+					OutClosestB = ClosestBInA - OutNormal * ThicknessB;
+				}
+				else
+				{
+					//assume touching hit
+
+					ClosestA = TVec3<T>(0);
+					ClosestBInA = TVec3<T>(0);
+
+					for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+					{
+						ClosestA += As[i] * Barycentric[i];
+						ClosestBInA += Bs[i] * Barycentric[i];
+					}
+
+					OutPenetration = ThicknessA + ThicknessB;
+					OutNormal = MTD;
+					OutClosestA = ClosestA + OutNormal * ThicknessA;
+					OutClosestB = ClosestBInA - OutNormal * ThicknessB;
+					return OutPenetration > Eps2;
+				}
 			}
-			OutPenetration = Penetration;
-			OutClosestA = ClosestA + OutNormal * ThicknessA;
-			OutClosestB = ClosestBInA - OutNormal * ThicknessB;
 
+			return true;
 		}
-		else
+	};
+
+	// This function will be faster if bNegativePenetrationSupport is false, so don't use the feature if not required
+	template <bool bNegativePenetrationSupport = false, typename T, typename TGeometryA, typename TGeometryB>
+	bool GJKPenetration(const TGeometryA& A, const TGeometryB& B, const TRigidTransform<T, 3>& BToATM, T& OutPenetration, TVec3<T>& OutClosestA, TVec3<T>& OutClosestB, TVec3<T>& OutNormal, const T InThicknessA = 0, const TVector<T, 3>& InitialDir = TVector<T, 3>(1, 0, 0), const T InThicknessB = 0, int32* OutNumIterations = nullptr)
+	{
+		auto SupportAFunc = [&A](const TVec3<T>& V)
 		{
-			TArray<TVec3<T>> VertsA;
-			TArray<TVec3<T>> VertsB;
+			return A.Support2(V);
+		};
 
-			VertsA.Reserve(8);
-			VertsB.Reserve(8);
+		const TRotation<T, 3> AToBRotation = BToATM.GetRotation().Inverse();
 
-			for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+
+		auto SupportBFunc = [&B, &BToATM, &AToBRotation](const TVec3<T>& V)
+		{
+			const TVector<T, 3> VInB = AToBRotation * V;
+			const TVector<T, 3> SupportBLocal = B.Support2(VInB);
+			return BToATM.TransformPositionNoScale(SupportBLocal);
+		};
+
+		TGJKPenetrationState<T> State;
+		State.Init(InitialDir, A.GetMargin() + InThicknessA, B.GetMargin() + InThicknessB);
+
+		EGJKPenetrationStep Step;
+		do
+		{
+			Step = State.template Advance<bNegativePenetrationSupport>(SupportAFunc, SupportBFunc);
+		} while (Step == EGJKPenetrationStep::Continue);
+
+		if (Step == EGJKPenetrationStep::Separated)
+		{
+			return false;
+		}
+
+		if (OutNumIterations != nullptr)
+		{
+			*OutNumIterations = State.NumIterations;
+		}
+
+		return State.template Finish<bNegativePenetrationSupport>(SupportAFunc, SupportBFunc, OutPenetration, OutClosestA, OutClosestB, OutNormal);
+	}
+
+	/** Number of queries GJKPenetrationBatch advances together */
+	static constexpr int32 GJKBatchWidth = 4;
+
+	/** Input of GJKPenetrationBatch: the geometries and the transform of B in A's local space */
+	template <typename T, typename TGeometryA, typename TGeometryB>
+	struct TGJKPenetrationQuery
+	{
+		const TGeometryA* A;
+		const TGeometryB* B;
+		TRigidTransform<T, 3> BToATM;
+	};
+
+	/** Output of GJKPenetrationBatch, the values GJKPenetration returns through its out parameters */
+	template <typename T>
+	struct TGJKPenetrationResult
+	{
+		T Penetration;
+		TVec3<T> ClosestA;
+		TVec3<T> ClosestB;
+		TVec3<T> Normal;
+		int32 NumIterations;
+		/** What GJKPenetration returns */
+		bool bResult;
+	};
+
+	/**
+	 * Same as calling GJKPenetration on every query, but up to GJKBatchWidth queries iterate in lockstep.
+	 * The iterations of different queries are independent, interleaving them keeps several support mappings (memory
+	 * bound for large hulls) and simplex solves in flight instead of waiting on each query's dependency chain.
+	 * EPA, which few queries need, runs per query after the batch converged.
+	 */
+	template <bool bNegativePenetrationSupport = false, typename T, typename TGeometryA, typename TGeometryB>
+	void GJKPenetrationBatch(const TArrayView<const TGJKPenetrationQuery<T, TGeometryA, TGeometryB>>& Queries, const TArrayView<TGJKPenetrationResult<T>>& OutResults, const T InThicknessA = 0, const TVector<T, 3>& InitialDir = TVector<T, 3>(1, 0, 0), const T InThicknessB = 0)
+	{
+		check(OutResults.Num() >= Queries.Num());
+
+		TGJKPenetrationState<T> States[GJKBatchWidth];
+		TRotation<T, 3> AToBRotations[GJKBatchWidth];
+		EGJKPenetrationStep Steps[GJKBatchWidth];
+
+		for (int32 FirstQuery = 0; FirstQuery < Queries.Num(); FirstQuery += GJKBatchWidth)
+		{
+			const int32 NumLanes = FMath::Min(GJKBatchWidth, Queries.Num() - FirstQuery);
+
+			uint32 ActiveLanes = 0;
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
 			{
-				VertsA.Add(As[i]);
-				VertsB.Add(Bs[i]);
+				const TGJKPenetrationQuery<T, TGeometryA, TGeometryB>& Query = Queries[FirstQuery + Lane];
+				States[Lane].Init(InitialDir, Query.A->GetMargin() + InThicknessA, Query.B->GetMargin() + InThicknessB);
+				AToBRotations[Lane] = Query.BToATM.GetRotation().Inverse();
+				ActiveLanes |= 1 << Lane;
 			}
 
-			T Penetration;
-			TVec3<T> MTD, ClosestA, ClosestBInA;
-			if (EPA(VertsA, VertsB, SupportAFunc, SupportBFunc, Penetration, MTD, ClosestA, ClosestBInA) != EPAResult::BadInitialSimplex)
+			while (ActiveLanes)
 			{
-				OutNormal = MTD;
-				OutPenetration = Penetration + ThicknessA + ThicknessB;
-				OutClosestA = ClosestA + OutNormal * ThicknessA;
-				OutClosestB = ClosestBInA - OutNormal * ThicknessB;
+				for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+				{
+					if (ActiveLanes & (1 << Lane))
+					{
+						const TGJKPenetrationQuery<T, TGeometryA, TGeometryB>& Query = Queries[FirstQuery + Lane];
+						const TRotation<T, 3>& AToBRotation = AToBRotations[Lane];
+						auto SupportAFunc = [&Query](const TVec3<T>& V) { return Query.A->Support2(V); };
+						auto SupportBFunc = [&Query, &AToBRotation](const TVec3<T>& V) { return Query.BToATM.TransformPositionNoScale(Query.B->Support2(AToBRotation * V)); };
+
+						Steps[Lane] = States[Lane].template Advance<bNegativePenetrationSupport>(SupportAFunc, SupportBFunc);
+						if (Steps[Lane] != EGJKPenetrationStep::Continue)
+						{
+							ActiveLanes &= ~(1 << Lane);
+						}
+					}
+				}
 			}
-			else
-			{
-				//assume touching hit
-
-				ClosestA = TVec3<T>(0);
-				ClosestBInA = TVec3<T>(0);
 
-				for (int i = 0; i < SimplexIDs.NumVerts; ++i)
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+			{
+				const TGJKPenetrationQuery<T, TGeometryA, TGeometryB>& Query = Queries[FirstQuery + Lane];
+				const TRotation<T, 3>& AToBRotation = AToBRotations[Lane];
+				TGJKPenetrationResult<T>& Result = OutResults[FirstQuery + Lane];
+				Result.NumIterations = States[Lane].NumIterations;
+				if (Steps[Lane] == EGJKPenetrationStep::Separated)
 				{
-					ClosestA += As[i] * Barycentric[i];
-					ClosestBInA += Bs[i] * Barycentric[i];
+					Result.bResult = false;
+					continue;
 				}
 
-				OutPenetration = ThicknessA + ThicknessB;
-				OutNormal = MTD;
-				OutClosestA = ClosestA + OutNormal * ThicknessA;
-				OutClosestB = ClosestBInA - OutNormal * ThicknessB;
-				return OutPenetration > Eps2;
+				auto SupportAFunc = [&Query](const TVec3<T>& V) { return Query.A->Support2(V); };
+				auto SupportBFunc = [&Query, &AToBRotation](const TVec3<T>& V) { return Query.BToATM.TransformPositionNoScale(Query.B->Support2(AToBRotation * V)); };
+				Result.bResult = States[Lane].template Finish<bNegativePenetrationSupport>(SupportAFunc, SupportBFunc, Result.Penetration, Result.ClosestA, Result.ClosestB, Result.Normal);
 			}
 		}
-
-		return true;
 	}
 
 
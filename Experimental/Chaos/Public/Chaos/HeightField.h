@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Chaos/Array.h"
+#include "Containers/ArrayView.h"
 #include "ImplicitObject.h"
 #include "Box.h"
 #include "TriangleMeshImplicitObject.h"
@@ -68,6 +69,24 @@ namespace Chaos
 		bool OverlapGeom(const TImplicitObjectScaled<TCapsule<T>>& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD = nullptr) const;
 		bool OverlapGeom(const TImplicitObjectScaled<FConvex>& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD = nullptr) const;
 
+		/**
+		 * Overlap of many shapes against the heightfield, for example the wheels of vehicles or the capsules of characters.
+		 * Queries that are above or below the terrain under them are rejected by the min-max hierarchy without testing
+		 * any triangle, and all queries share the scratch of the cell search.
+		 * @param QueryGeoms, QueryTMs the shapes and their transforms, same number
+		 * @param OutOverlaps whether each query overlaps the heightfield, same number as the queries
+		 * @param OutMTDs if not empty, the deepest MTD of each query, same number as the queries
+		 * @return the number of queries that overlap
+		 */
+		int32 OverlapGeomBatch(TArrayView<const TSphere<T, 3>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TBox<T, 3>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TCapsule<T>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const FConvex* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TSphere<T, 3>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TBox<T, 3>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<TCapsule<T>>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+		int32 OverlapGeomBatch(TArrayView<const TImplicitObjectScaled<FConvex>* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs = TArrayView<FMTDInfo>()) const;
+
 		bool SweepGeom(const TSphere<T, 3>& QueryGeom, const TRigidTransform<T, 3>& StartTM, const TVector<T, 3>& Dir, const T Length, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex, const T Thickness = 0, bool bComputeMTD = false) const;
 		bool SweepGeom(const TBox<T, 3>& QueryGeom, const TRigidTransform<T, 3>& StartTM, const TVector<T, 3>& Dir, const T Length, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex, const T Thickness = 0, bool bComputeMTD = false) const;
 		bool SweepGeom(const TCapsule<T>& QueryGeom, const TRigidTransform<T, 3>& StartTM, const TVector<T, 3>& Dir, const T Length, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex, const T Thickness = 0, bool bComputeMTD = false) const;
@@ -540,6 +559,42 @@ namespace Chaos
 		// Cached when bounds are requested. Mutable to allow GetBounds to be logical const
 		mutable TAABB<T, 3> CachedBounds;
 
+		// Min and max stored height of the cells under a node of the min-max hierarchy
+		struct FMinMaxHeights
+		{
+			typename FDataType::StorageType Min;
+			typename FDataType::StorageType Max;
+		};
+
+		// One level of the min-max hierarchy, nodes in rows like the cells
+		struct FMinMaxLevel
+		{
+			TArray<FMinMaxHeights> Nodes;
+			int32 NumX = 0;
+			int32 NumY = 0;
+		};
+
+		// Number of cells along each axis under a leaf of the min-max hierarchy
+		static constexpr int32 MinMaxLeafCells = 4;
+
+		// Quadtree of the min and max heights over the cells. Level 0 holds the leaves and the last level the root.
+		// Rebuilt with the query data on load and after edits rather than serialized
+		TArray<FMinMaxLevel> MinMaxLevels;
+
+		void BuildMinMaxHierarchy();
+		TAABB<T, 3> GetMinMaxBoundsScaled(const int32 BeginX, const int32 BeginY, const int32 EndX, const int32 EndY, const typename FDataType::StorageType MinHeight, const typename FDataType::StorageType MaxHeight) const;
+		TAABB<T, 3> GetMinMaxNodeBoundsScaled(const int32 Level, const int32 NodeX, const int32 NodeY) const;
+		TAABB<T, 3> GetMinMaxCellBoundsScaled(const int32 CellX, const int32 CellY) const;
+		bool UseMinMaxHierarchy() const;
+
+		// Visits the cells whose bounds, inflated by Inflation, are hit by the ray. Nearer nodes and cells are visited first
+		template<typename FVisitCell>
+		bool MinMaxCast(const TVector<T, 3>& StartPoint, const TVector<T, 3>& Dir, const T Length, const TVector<T, 3>& Inflation, FVisitCell VisitCell) const;
+		// Cells whose 3D bounds overlap the query bounds
+		bool GetMinMaxIntersections(const TAABB<T, 3>& QueryBounds, TArray<TVector<int32, 2>>& OutIntersections) const;
+		// Cells that may touch the query bounds, from the min-max hierarchy when enabled
+		bool GetOverlapIntersections(const TAABB<T, 3>& QueryBounds, TArray<TVector<int32, 2>>& OutIntersections) const;
+
 		void CalcBounds();
 		void BuildQueryData();
 		
@@ -550,6 +605,12 @@ namespace Chaos
 		template <typename QueryGeomType>
 		bool OverlapGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD = nullptr) const;
 
+		template <typename QueryGeomType>
+		bool OverlapGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& QueryTM, const T Thickness, FMTDInfo* OutMTD, TArray<TVector<int32, 2>>& Intersections) const;
+
+		template <typename QueryGeomType>
+		int32 OverlapGeomBatchImp(TArrayView<const QueryGeomType* const> QueryGeoms, TArrayView<const TRigidTransform<T, 3>> QueryTMs, const T Thickness, TArrayView<bool> OutOverlaps, TArrayView<FMTDInfo> OutMTDs) const;
+
 		template <typename QueryGeomType>
 		bool SweepGeomImp(const QueryGeomType& QueryGeom, const TRigidTransform<T, 3>& StartTM, const TVector<T, 3>& Dir, const T Length, T& OutTime, TVector<T, 3>& OutPosition, TVector<T, 3>& OutNormal, int32& OutFaceIndex, const T Thickness, bool bComputeMTD) const;
 
@@ -143,6 +143,18 @@ public:
 	virtual const void* GetQueryData() const { return nullptr; }
 };
 
+/** A raycast or sweep of a batch, see ISpatialAcceleration::RaycastBatch and SweepBatch */
+template <typename TPayloadType, typename T>
+struct TSpatialBatchQuery
+{
+	TVector<T, 3> Start;
+	TVector<T, 3> Dir;
+	T Length;
+	/** Half extents of the swept bounds, ignored by raycasts */
+	TVector<T, 3> QueryHalfExtents = TVector<T, 3>(0);
+	ISpatialVisitor<TPayloadType, T>* Visitor = nullptr;
+};
+
 /**
  * Can be implemented by external, non-chaos systems to collect / render
  * debug information from spacial structures. When passed to the debug
@@ -170,9 +182,13 @@ enum ESpatialAcceleration
 	Collection,
 	Unknown,
 	//For custom types continue the enum after ESpatialAcceleration::Unknown
+
+	//Engine types added later use fixed values at the top of the range so they don't collide with custom types
+	WideAABBTree = 254,
+	WideAABBTree8 = 255,
 };
 
-using SpatialAccelerationType = uint8;	//see ESpatialAcceleration. Projects can add their own custom types by using enum values higher than ESpatialAcceleration::Unknown
+using SpatialAccelerationType = uint8;	//see ESpatialAcceleration. Projects can add their own custom types by using enum values higher than ESpatialAcceleration::Unknown and lower than ESpatialAcceleration::WideAABBTree
 
 template <typename TPayload>
 typename TEnableIf<!TIsPointer<TPayload>::Value, FUniqueIdx>::Type GetUniqueIdx(const TPayload& Payload)
@@ -254,6 +270,26 @@ public:
 	virtual void Sweep(const TVector<T, d>& Start, const TVector<T, d>& Dir, const T Length, const TVector<T, d> QueryHalfExtents, ISpatialVisitor<TPayloadType, T>& Visitor) const { check(false);}
 	virtual void Overlap(const TAABB<T, d>& QueryBounds, ISpatialVisitor<TPayloadType, T>& Visitor) const { check(false); }
 
+	/** Raycasts every query of the batch, with the same results as calling Raycast for each of them.
+		Structures supporting it traverse coherent queries together, in packets of SpatialQueryPacketWidth.
+	*/
+	virtual void RaycastBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const
+	{
+		for (const TSpatialBatchQuery<TPayloadType, T>& Query : Queries)
+		{
+			Raycast(Query.Start, Query.Dir, Query.Length, *Query.Visitor);
+		}
+	}
+
+	/** Sweeps every query of the batch, with the same results as calling Sweep for each of them. */
+	virtual void SweepBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const
+	{
+		for (const TSpatialBatchQuery<TPayloadType, T>& Query : Queries)
+		{
+			Sweep(Query.Start, Query.Dir, Query.Length, Query.QueryHalfExtents, *Query.Visitor);
+		}
+	}
+
 	virtual void RemoveElement(const TPayloadType& Payload)
 	{
 		check(false);	//not implemented
@@ -472,6 +508,15 @@ public:
 #endif
 	}
 
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T AllocatedSize = Entries.GetAllocatedSize();
+#if CHAOS_SERIALIZE_OUT 
+		AllocatedSize += KeysToSerializeOut.GetAllocatedSize();
+#endif
+		return AllocatedSize;
+	}
+
 	void Serialize(FChaosArchive& Ar)
 	{
 		bool bCanSerialize = Ar.IsLoading();
@@ -4,6 +4,7 @@
 #include "Chaos/CollisionResolutionTypes.h"
 #include "Chaos/CollisionResolutionTypes.h"
 #include "Chaos/Collision/CollisionApplyType.h"
+#include "Chaos/Collision/CollisionManifoldCache.h"
 #include "Chaos/ConstraintHandle.h"
 #include "Chaos/PBDConstraintContainer.h"
 #include "Framework/BufferedData.h"
@@ -274,6 +275,19 @@ public:
 		return PointConstraints.Num() + SweptPointConstraints.Num() + IterativeConstraints.Num();
 	}
 
+	/**
+	 * Contacts of the previous frame, rebuilt by Reset and used by the narrow phase to skip pairs that did not move
+	 */
+	FCollisionManifoldCache& GetManifoldCache()
+	{
+		return ManifoldCache;
+	}
+
+	const FCollisionManifoldCache& GetManifoldCache() const
+	{
+		return ManifoldCache;
+	}
+
 	FHandles& GetConstraintHandles()
 	{
 		return Handles;
@@ -317,6 +331,8 @@ private:
 	TArray<FConstraintContainerHandle*> Handles;
 	FConstraintHandleAllocator HandleAllocator;
 
+	FCollisionManifoldCache ManifoldCache;
+
 	TArrayCollectionArray<bool>& MCollided;
 	const TArrayCollectionArray<TSerializablePtr<FChaosPhysicsMaterial>>& MPhysicsMaterials;
 	int32 MApplyPairIterations;
@@ -8,6 +8,12 @@ namespace Chaos
 	class FPBDConstraintGraph;
 	class FConstraintHandle;
 
+	/** Constraints of the same color and level are solved in parallel when there are at least this many of them, see p.Chaos.Solver.ColorBatchMinParallelSize */
+	CHAOS_API extern int32 ConstraintColorBatchMinParallelSize;
+
+	/** Whether colors are assigned in particle order rather than constraint creation order, see p.Chaos.Solver.DeterministicColoring */
+	CHAOS_API extern int32 ConstraintColorDeterministic;
+
 	/**
 	 * Generates color information for a single constraint rule in a connection graph.
 	 * Edges with the same color are non-interacting and can safely be processed in parallel.
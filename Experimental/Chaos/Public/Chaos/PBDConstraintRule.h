@@ -419,6 +419,146 @@ namespace Chaos
 		FPBDConstraintColor GraphColor;
 	};
 
+	/**
+	 * Color-batched island rule. Constraints in an island are colored and ordered by constraint level (root to leaf),
+	 * contact graph level and color. Each run of constraints with the same keys is a batch of non-interacting constraints
+	 * which the container solves in parallel, while batches are solved in order. Islands may be updated in parallel.
+	 * Requires the container to have the Color Batch API (see FPBDJointConstraints) and handles to have GetConstraintLevel().
+	 */
+	template<typename T_CONSTRAINTS>
+	class CHAOS_API TPBDConstraintColorBatchRule : public TPBDConstraintGraphRuleImpl<T_CONSTRAINTS>
+	{
+		typedef TPBDConstraintGraphRuleImpl<T_CONSTRAINTS> Base;
+
+	public:
+		using FConstraints = T_CONSTRAINTS;
+		using FConstraintContainerHandle = typename FConstraints::FConstraintContainerHandle;
+		using FConstraintList = TArray<FConstraintContainerHandle*>;
+
+		TPBDConstraintColorBatchRule(FConstraints& InConstraints, int32 InPriority = 0)
+			: TPBDConstraintGraphRuleImpl<T_CONSTRAINTS>(InConstraints, InPriority)
+		{
+		}
+
+		virtual bool ApplyConstraints(const FReal Dt, int32 Island, const int32 It, const int32 NumIts) override
+		{
+			const FIslandBatches& Batches = IslandBatches[Island];
+			if (Batches.ConstraintHandles.Num())
+			{
+				return Constraints.Apply(Dt, Batches.ConstraintHandles, Batches.BatchEnds, It, NumIts);
+			}
+			return false;
+		}
+
+		virtual bool ApplyPushOut(const FReal Dt, int32 Island, const int32 It, const int32 NumIts) override
+		{
+			const FIslandBatches& Batches = IslandBatches[Island];
+			if (Batches.ConstraintHandles.Num())
+			{
+				return Constraints.ApplyPushOut(Dt, Batches.ConstraintHandles, Batches.BatchEnds, It, NumIts);
+			}
+			return false;
+		}
+
+		virtual void InitializeAccelerationStructures() override
+		{
+			GraphColor.InitializeColor(*ConstraintGraph);
+			IslandBatches.SetNum(ConstraintGraph->NumIslands());
+			for (FIslandBatches& Batches : IslandBatches)
+			{
+				Batches.ConstraintHandles.Reset();
+				Batches.BatchEnds.Reset();
+			}
+		}
+
+		virtual void UpdateAccelerationStructures(const int32 Island) override
+		{
+			GraphColor.ComputeColor(Island, *ConstraintGraph, ContainerId);
+
+			const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap = GraphColor.GetIslandLevelToColorToConstraintListMap(Island);
+			const int32 MaxColor = GraphColor.GetIslandMaxColor(Island);
+			const int32 MaxLevel = GraphColor.GetIslandMaxLevel(Island);
+
+			// Gathered in level and color order, so a stable sort on constraint level gives the full ordering
+			TArray<FBatchEntry> Entries;
+			for (int32 Level = 0; Level <= MaxLevel; ++Level)
+			{
+				for (int32 Color = 0; Color <= MaxColor; ++Color)
+				{
+					if (const FPBDConstraintColor::FConstraintList* ColorConstraints = LevelToColorToConstraintListMap[Level].Find(Color))
+					{
+						for (FConstraintHandle* ConstraintHandle : *ColorConstraints)
+						{
+							FConstraintContainerHandle* ContainerHandle = ConstraintHandle->As<FConstraintContainerHandle>();
+							Entries.Add({ ContainerHandle, ContainerHandle->GetConstraintLevel(), Level, Color });
+						}
+					}
+				}
+			}
+			Entries.StableSort([](const FBatchEntry& L, const FBatchEntry& R)
+			{
+				return L.ConstraintLevel < R.ConstraintLevel;
+			});
+
+			FIslandBatches& Batches = IslandBatches[Island];
+			Batches.ConstraintHandles.Reset(Entries.Num());
+			Batches.BatchEnds.Reset();
+			for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+			{
+				const FBatchEntry& Entry = Entries[EntryIndex];
+				if (EntryIndex > 0)
+				{
+					const FBatchEntry& PrevEntry = Entries[EntryIndex - 1];
+					if ((Entry.ConstraintLevel != PrevEntry.ConstraintLevel) || (Entry.Level != PrevEntry.Level) || (Entry.Color != PrevEntry.Color))
+					{
+						Batches.BatchEnds.Add(EntryIndex);
+					}
+				}
+				Batches.ConstraintHandles.Add(Entry.ConstraintHandle);
+			}
+			if (Entries.Num())
+			{
+				Batches.BatchEnds.Add(Entries.Num());
+			}
+		}
+
+		virtual void SetUseContactGraph(const bool bInUseContactGraph) override
+		{
+			GraphColor.SetUseContactGraph(bInUseContactGraph);
+		}
+
+		template<typename TVisitor>
+		void VisitIslandConstraints(const int32 Island, const TVisitor& Visitor) const
+		{
+			Visitor(IslandBatches[Island].ConstraintHandles);
+		}
+
+	private:
+		using Base::Constraints;
+		using Base::ConstraintGraph;
+		using Base::ContainerId;
+
+		struct FBatchEntry
+		{
+			FConstraintContainerHandle* ConstraintHandle;
+			int32 ConstraintLevel;
+			int32 Level;
+			int32 Color;
+		};
+
+		struct FIslandBatches
+		{
+			/** Island constraints, ordered so that constraints of a batch are contiguous */
+			FConstraintList ConstraintHandles;
+
+			/** One past the last index in ConstraintHandles of each batch */
+			TArray<int32> BatchEnds;
+		};
+
+		FPBDConstraintColor GraphColor;
+		TArray<FIslandBatches> IslandBatches;
+	};
+
 }
 
 // Only way to make this compile at the moment due to visibility attribute issues. TODO: Change this once a fix for this problem is applied.
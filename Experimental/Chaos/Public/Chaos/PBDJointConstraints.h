@@ -155,6 +155,17 @@ namespace Chaos
 		bool Apply(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const int32 It, const int32 NumIts);
 		bool ApplyPushOut(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const int32 It, const int32 NumIts);
 
+		//
+		// Color Batch Rule API
+		//
+
+		/**
+		 * Apply constraints in batches, in order. InBatchEnds holds one-past-the-end handle index of each batch.
+		 * Constraints in a batch must not share dynamic particles: they are solved in parallel.
+		 */
+		bool Apply(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const TArray<int32>& InBatchEnds, const int32 It, const int32 NumIts);
+		bool ApplyPushOut(const FReal Dt, const TArray<FConstraintContainerHandle*>& InConstraintHandles, const TArray<int32>& InBatchEnds, const int32 It, const int32 NumIts);
+
 
 	protected:
 		using Base::GetConstraintIndex;
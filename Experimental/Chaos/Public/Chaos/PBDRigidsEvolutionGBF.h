@@ -26,6 +26,21 @@ namespace Chaos
 	CHAOS_API extern float HackLinearDrag;
 	CHAOS_API extern float HackAngularDrag;
 
+	CHAOS_API extern int32 ChaosSolverIslandBatching;
+
+	/** Size, estimated cost and solve time of an island in the last step */
+	struct FIslandSolveStats
+	{
+		int32 NumParticles;
+		int32 NumConstraints;
+		/** Constraints times iterations, plus particles */
+		int32 Cost;
+		/** Task the island was solved in, the islands of a task are solved one after the other */
+		int32 Batch;
+		/** Only measured with p.Chaos.Solver.IslandStats */
+		double Seconds;
+	};
+
 	class FPBDRigidsEvolutionGBF;
 
 	using FPBDRigidsEvolutionCallback = TFunction<void()>;
@@ -119,6 +134,10 @@ namespace Chaos
 		const auto& GetRigidClustering() const { return Clustering; }
 		auto& GetRigidClustering() { return Clustering; }
 
+		/** Per island stats of the last step, indexed like the islands of the constraint graph */
+		const TArray<FIslandSolveStats>& GetIslandStats() const { return IslandStats; }
+		int32 GetNumIslandBatches() const { return FMath::Max(IslandBatchStarts.Num() - 1, 0); }
+
 		CHAOS_API inline void EndFrame(FReal Dt)
 		{
 			Particles.GetNonDisabledDynamicView().ParallelFor([&](auto& Particle, int32 Index) {
@@ -197,6 +216,16 @@ namespace Chaos
 		CHAOS_API void Serialize(FChaosArchive& Ar);
 
 	protected:
+		/**
+		 * Estimate the cost of the islands and group them into solver tasks, largest first. Small islands are merged
+		 * until a task reaches p.Chaos.Solver.IslandBatchCost, islands above it get a task of their own in which the
+		 * constraint rules solve their large color batches in parallel.
+		 */
+		void BuildIslandBatches();
+
+		/** Log the islands of the last step and write them to a csv file in the profiling directory */
+		void DumpIslandStats() const;
+
 		TPBDRigidClustering<FPBDRigidsEvolutionGBF, TPBDCollisionConstraints<FReal, 3>, FReal, 3> Clustering;
 
 		FGravityForces GravityForces;
@@ -212,5 +241,10 @@ namespace Chaos
 		FPBDRigidsEvolutionIslandCallback PostApplyCallback;
 		FPBDRigidsEvolutionIslandCallback PostApplyPushOutCallback;
 		FPBDRigidsEvolutionInternalHandleCallback InternalParticleInitilization;
+
+		TArray<FIslandSolveStats> IslandStats;
+		/** Islands of all tasks in solve order, and where the islands of each task start with one past the end last */
+		TArray<int32> IslandBatchIslands;
+		TArray<int32> IslandBatchStarts;
 	};
 }
@@ -90,11 +90,14 @@ private:
 	volatile int8 Block;
 };
 
+CHAOS_API extern int32 Chaos_Particles_SleepingColdStorage;
+
 template <typename T, int d>
 class TPBDRigidsSOAs
 {
 public:
 	TPBDRigidsSOAs()
+		: bSleepingColdStorage(Chaos_Particles_SleepingColdStorage != 0)
 	{
 #if CHAOS_DETERMINISTIC
 		BiggestParticleID = 0;
@@ -108,6 +111,7 @@ public:
 
 		DynamicDisabledParticles = MakeUnique<TPBDRigidParticles<T, d>>();
 		DynamicParticles = MakeUnique<TPBDRigidParticles<T, d>>();
+		DynamicSleepingParticles = MakeUnique<TPBDRigidParticles<T, d>>();
 		DynamicKinematicParticles = MakeUnique<TPBDRigidParticles<T, d>>();
 
 		ClusteredParticles = MakeUnique< TPBDRigidClusteredParticles<T, d>>();
@@ -142,7 +146,8 @@ public:
 	}
 	TArray<TPBDRigidParticleHandle<T, d>*> CreateDynamicParticles(int32 NumParticles, const FUniqueIdx* ExistingIndices = nullptr,  const TPBDRigidParticleParameters<T, d>& Params = TPBDRigidParticleParameters<T, d>())
 	{
-		auto Results = CreateParticlesHelper<TPBDRigidParticleHandle<T, d>>(NumParticles, ExistingIndices, Params.bDisabled ? DynamicDisabledParticles : DynamicParticles, Params);;
+		TUniquePtr<TPBDRigidParticles<T, d>>& EnabledParticles = Params.bStartSleeping && bSleepingColdStorage ? DynamicSleepingParticles : DynamicParticles;
+		auto Results = CreateParticlesHelper<TPBDRigidParticleHandle<T, d>>(NumParticles, ExistingIndices, Params.bDisabled ? DynamicDisabledParticles : EnabledParticles, Params);
 
 		if (!Params.bStartSleeping)
 		{
@@ -208,6 +213,7 @@ public:
 		{
 			// Check for sleep events referencing this particle
 			// TODO think about this case more
+			GatherSleepData();
 			GetDynamicParticles().GetSleepDataLock().WriteLock();
 			auto& SleepData = GetDynamicParticles().GetSleepData();
 
@@ -330,8 +336,13 @@ public:
 
 	/**
 	 * Wake a sleeping dynamic non-disabled particle.
+	 *
+	 * If \p DeferUpdateViews is \c true, then it's assumed this function
+	 * is being called in a loop and it won't update the SOA view arrays.
 	 */
-	void ActivateParticle(TGeometryParticleHandle<T, d>* Particle)
+	void ActivateParticle(
+		TGeometryParticleHandle<T, d>* Particle,
+		const bool DeferUpdateViews=false)
 	{
 		if (auto PBDRigid = Particle->CastToRigidParticle())
 		{
@@ -340,11 +351,16 @@ public:
 			{
 				if (ensure(!PBDRigid->Disabled()))
 				{
+					// Back to the awake particles first, so that the sleep event is recorded with the other ones
+					if (!Particle->CastToClustered())
+					{
+						Particle->MoveToSOA(*DynamicParticles);
+					}
+
 					// Sleeping state is currently expressed in 2 places...
 					PBDRigid->SetSleeping(false);
 					PBDRigid->SetObjectState(EObjectStateType::Dynamic);
 		
-					bool bUpdateGeometryCollection = false;
 					if (auto PBDRigidClustered = Particle->CastToClustered())
 					{
 						if (Particle->GetParticleType() == Chaos::EParticleType::GeometryCollection)
@@ -366,7 +382,11 @@ public:
 							ActiveParticlesToIndex, ActiveParticlesArray);
 					}
 
-					UpdateViews();
+					if (!DeferUpdateViews)
+					{
+						GatherSleepData();
+						UpdateViews();
+					}
 				}
 			}
 		}
@@ -374,22 +394,18 @@ public:
 
 	/**
 	 * Wake multiple dynamic non-disabled particles.
+	 *
+	 * Prefer this to ActivateParticle in a loop: the views are only rebuilt once.
 	 */
 	void ActivateParticles(const TArray<TGeometryParticleHandle<T, d>*>& Particles)
 	{
-		bool bUpdateGeometryCollection = false;
 		for (auto Particle : Particles)
 		{
-			bUpdateGeometryCollection |= ActivateParticle(Particle);
-		}
-		if (bUpdateGeometryCollection)
-		{
-			UpdateGeometryCollectionViews();
-		}
-		else
-		{
-			UpdateViews();
+			ActivateParticle(Particle, true);
 		}
+		GatherSleepData();
+		UpdateIfNeeded();
+		UpdateViews();
 	}
 
 	/**
@@ -429,6 +445,12 @@ public:
 					{
 						RemoveFromMapAndArray(PBDRigid, 
 							ActiveParticlesToIndex, ActiveParticlesArray);
+
+						// Out of the way of the awake particles until it wakes up
+						if (bSleepingColdStorage)
+						{
+							Particle->MoveToSOA(*DynamicSleepingParticles);
+						}
 					}
 
 					if (!DeferUpdateViews)
@@ -478,20 +500,54 @@ public:
 			Particle->MoveToSOA(*DynamicParticles);
 			break;
 
+		case EObjectStateType::Sleeping:
+			Particle->MoveToSOA(bSleepingColdStorage ? *DynamicSleepingParticles : *DynamicParticles);
+			break;
+
 		default:
-			// TODO: Special SOAs for sleeping and static particles?
+			// TODO: Special SOA for static particles?
 			Particle->MoveToSOA(*DynamicParticles);
 			break;
 		}
 
+		GatherSleepData();
 		UpdateViews();
 	}
 
+	/**
+	 * Sleep events are reported from the dynamic particles. Move there the ones recorded
+	 * by particles whose state changed while they were in the sleeping particles.
+	 */
+	void GatherSleepData()
+	{
+		if (DynamicSleepingParticles->GetSleepData().Num() == 0)
+		{
+			return;
+		}
+
+		DynamicSleepingParticles->GetSleepDataLock().WriteLock();
+		DynamicParticles->GetSleepDataLock().WriteLock();
+		DynamicParticles->GetSleepData().Append(DynamicSleepingParticles->GetSleepData());
+		DynamicSleepingParticles->GetSleepData().Reset();
+		DynamicParticles->GetSleepDataLock().WriteUnlock();
+		DynamicSleepingParticles->GetSleepDataLock().WriteUnlock();
+	}
+
 	void Serialize(FChaosArchive& Ar)
 	{
 		static const FName SOAsName = TEXT("PBDRigidsSOAs");
 		FChaosArchiveScopedMemory ScopedMemory(Ar, SOAsName, false);
 
+		if (Ar.IsSaving())
+		{
+			// Sleeping particles are saved with the awake ones, they move back to the sleeping particles when they next fall asleep
+			GatherSleepData();
+			while (DynamicSleepingParticles->Size())
+			{
+				DynamicSleepingParticles->Handle(DynamicSleepingParticles->Size() - 1)->MoveToSOA(*DynamicParticles);
+			}
+		}
+
 		ParticleHandles.Serialize(Ar);
 
 		Ar << StaticParticles;
@@ -568,6 +624,9 @@ public:
 	const TPBDRigidParticles<T, d>& GetDynamicParticles() const { return *DynamicParticles; }
 	TPBDRigidParticles<T, d>& GetDynamicParticles() { return *DynamicParticles; }
 
+	/** Sleeping non clustered rigid particles, when they are kept apart from the awake ones */
+	const TPBDRigidParticles<T, d>& GetDynamicSleepingParticles() const { return *DynamicSleepingParticles; }
+
 	const TGeometryParticles<T, d>& GetNonDisabledStaticParticles() const { return *StaticParticles; }
 	TGeometryParticles<T, d>& GetNonDisabledStaticParticles() { return *StaticParticles; }
 
@@ -819,6 +878,7 @@ private:
 				StaticParticles.Get(), 
 				KinematicParticles.Get(), 
 				DynamicParticles.Get(),
+				DynamicSleepingParticles.Get(),
 				DynamicKinematicParticles.Get(),
 				{&NonDisabledClusteredArray},
 				{&StaticGeometryCollectionArray},
@@ -832,6 +892,7 @@ private:
 			TArray<TSOAView<TPBDRigidParticles<T, d>>> TmpArray = 
 			{ 
 				DynamicParticles.Get(), 
+				DynamicSleepingParticles.Get(),
 				{&NonDisabledClusteredArray}, 
 				{&SleepingGeometryCollectionArray},
 				{&DynamicGeometryCollectionArray}
@@ -857,6 +918,7 @@ private:
 				KinematicParticles.Get(), 
 				KinematicDisabledParticles.Get(),
 				DynamicParticles.Get(), 
+				DynamicSleepingParticles.Get(),
 				DynamicDisabledParticles.Get(), 
 				DynamicKinematicParticles.Get(), 
 				ClusteredParticles.Get(), 
@@ -892,9 +954,14 @@ private:
 	TUniquePtr<TKinematicGeometryParticles<T, d>> KinematicDisabledParticles;
 
 	TUniquePtr<TPBDRigidParticles<T, d>> DynamicParticles;
+	TUniquePtr<TPBDRigidParticles<T, d>> DynamicSleepingParticles;
 	TUniquePtr<TPBDRigidParticles<T, d>> DynamicKinematicParticles;
 	TUniquePtr<TPBDRigidParticles<T, d>> DynamicDisabledParticles;
 
+	// Whether sleeping non clustered rigid particles are moved to DynamicSleepingParticles, leaving DynamicParticles
+	// to the awake ones. Sleeping particles stay in the non disabled views either way.
+	bool bSleepingColdStorage;
+
 	TUniquePtr<TPBDRigidClusteredParticles<T, d>> ClusteredParticles;
 
 	TUniquePtr<TPBDGeometryCollectionParticles<T, d>> GeometryCollectionParticles;
@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/Core.h"
+#include "Chaos/ParticleDirtyFlags.h"
+#include "Chaos/ParticleHandleFwd.h"
+#include "Chaos/RigidParticles.h"
+#include "Containers/ArrayView.h"
+
+namespace Chaos
+{
+	class FPBDRigidsEvolutionGBF;
+
+	CHAOS_API extern int32 Chaos_Rewind_ResimAffectedIslandsOnly;
+
+	/** Authoritative state of a particle at the frame a resimulation starts from */
+	struct FRewindCorrection
+	{
+		TPBDRigidParticleHandle<FReal, 3>* Particle;
+		FVec3 X;
+		FRotation3 R;
+		FVec3 V;
+		FVec3 W;
+	};
+
+	/**
+	 * History of the dynamic particles over the last fixed steps, to rewind and resimulate them.
+	 *
+	 * A captured frame only holds the particles whose position, rotation, velocities or sleep state changed during the
+	 * step, and of those only the properties that changed, with the values they had before the step. The state after the
+	 * latest frame is the one of the particles themselves, so rewinding N frames undoes the latest N frames in reverse
+	 * order. Particles that sleep through a step take no memory in it, but capturing still compares every non-disabled
+	 * dynamic particle with its latest state, so that a particle woken up by the step is recorded from the state it slept
+	 * in. Frames older than the capacity are dropped.
+	 *
+	 * Corrections are recorded in the newest frame left after rewinding, so that rewinding past them later restores the
+	 * state from before the correction.
+	 *
+	 * Resimulation only simulates the islands of the corrected particles. The other particles are put to sleep and
+	 * follow their recorded states, so the corrected particles collide with them like with kinematics. A sleeping
+	 * particle that a resimulated island wakes up is simulated from that step on.
+	 *
+	 * Usage: CaptureFrame after each AdvanceOneTimeStep, Resimulate right after a CaptureFrame.
+	 * Particles must be removed with RemoveParticle before they are destroyed.
+	 */
+	class CHAOS_API FRewindData
+	{
+	public:
+		explicit FRewindData(const int32 InMaxFrames);
+
+		/** Record the changes of the step that just ran, of duration Dt */
+		void CaptureFrame(FPBDRigidsEvolutionGBF& Evolution, const FReal Dt);
+
+		/**
+		 * Rewind NumFramesToRewind frames, apply the corrections and replay the frames with their recorded durations.
+		 * The replayed frames replace the captured ones.
+		 * @return false, changing nothing, if fewer frames are captured
+		 */
+		bool Resimulate(FPBDRigidsEvolutionGBF& Evolution, const int32 NumFramesToRewind, TArrayView<const FRewindCorrection> Corrections);
+
+		/** Forget the particle, in all the frames */
+		void RemoveParticle(TPBDRigidParticleHandle<FReal, 3>* Particle);
+
+		/** Drop all frames, the next capture starts a new history */
+		void Reset();
+
+		int32 GetMaxFrames() const { return Frames.Num(); }
+		int32 GetNumFrames() const { return NumFrames; }
+
+		/** Memory of the frame captured FramesAgo frames before the latest one */
+		SIZE_T GetFrameAllocatedSize(const int32 FramesAgo) const;
+
+		/** Memory of the captured frames and of the latest state of the particles they refer to */
+		SIZE_T GetAllocatedSize() const;
+
+		/** Particles simulated and particles replayed from the history by the last Resimulate */
+		int32 GetLastResimNumSimulated() const { return LastResimNumSimulated; }
+		int32 GetLastResimNumReplayed() const { return LastResimNumReplayed; }
+		double GetLastResimSeconds() const { return LastResimSeconds; }
+
+	private:
+		struct FParticleState
+		{
+			FVec3 X;
+			FRotation3 R;
+			FVec3 V;
+			FVec3 W;
+			EObjectStateType ObjectState;
+		};
+
+		/** The dirty properties of a particle, stored in the arrays of the frame from the given indices */
+		struct FFrameEntry
+		{
+			TPBDRigidParticleHandle<FReal, 3>* Particle;
+			FParticleDirtyFlags Dirty;
+			int32 VectorIndex;
+			int32 RotationIndex;
+			int32 ObjectStateIndex;
+		};
+
+		struct FFrame
+		{
+			TArray<FFrameEntry> Entries;
+			TArray<FVec3> Vectors;
+			TArray<FRotation3> Rotations;
+			TArray<EObjectStateType> ObjectStates;
+			FReal Dt = 0;
+
+			void Reset();
+			void Add(TPBDRigidParticleHandle<FReal, 3>* Particle, const FParticleDirtyFlags Dirty, const FParticleState& State);
+			/** Base with the dirty properties of the entry overwritten */
+			FParticleState Apply(const FFrameEntry& Entry, const FParticleState& Base) const;
+			SIZE_T GetAllocatedSize() const;
+		};
+
+		int32 GetFrameIndex(const int32 FramesAgo) const { return (Head - FramesAgo + Frames.Num()) % Frames.Num(); }
+
+		FParticleState GetState(TPBDRigidParticleHandle<FReal, 3>* Particle) const;
+		static FParticleDirtyFlags Diff(const FParticleState& A, const FParticleState& B);
+		/** Sets all but the object state, which needs the views of the particles to be updated */
+		static void SetState(FPBDRigidsEvolutionGBF& Evolution, TPBDRigidParticleHandle<FReal, 3>& Particle, const FParticleState& State);
+
+		/** Undo the latest frames, filling the values they are undone from in RedoFrames ordered from the oldest */
+		void Rewind(FPBDRigidsEvolutionGBF& Evolution, const int32 NumFramesToRewind, TArray<FFrame>& RedoFrames);
+
+		/** Make State the latest state of the particle, keeping the replaced values in the latest frame to be undone */
+		void SetLatestState(TPBDRigidParticleHandle<FReal, 3>* Particle, const FParticleState& State);
+
+		TArray<FFrame> Frames;
+		int32 Head;
+		int32 NumFrames;
+
+		/** State of the particles after the latest frame */
+		TMap<TPBDRigidParticleHandle<FReal, 3>*, FParticleState> LatestStates;
+
+		/** During a resimulation, the recorded object state of the particles that are asleep to be replayed */
+		TMap<TPBDRigidParticleHandle<FReal, 3>*, EObjectStateType> ReplayedObjectStates;
+
+		int32 LastResimNumSimulated;
+		int32 LastResimNumReplayed;
+		double LastResimSeconds;
+	};
+}
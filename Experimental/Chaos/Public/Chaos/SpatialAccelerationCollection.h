@@ -4,6 +4,7 @@
 #include "Chaos/Box.h"
 #include "Chaos/Collision/SpatialAccelerationBroadPhase.h"
 #include "Chaos/Collision/StatsData.h"
+#include "Chaos/SpatialQueryPacket.h"
 #include "GeometryParticlesfwd.h"
 
 #include <tuple>
@@ -222,6 +223,52 @@ struct TSpatialAccelerationCollectionHelper
 		return true;
 	}
 
+	template <typename SQVisitor>
+	static void RaycastPacketFast(const Tuple& Types, TSpatialQueryPacket<SQVisitor>& Packet)
+	{
+		const auto& Accelerations = GetAccelerationsPerType<TypeIdx>(Types).Objects;
+		for (const auto& Accelerator : Accelerations)
+		{
+			if (Accelerator)
+			{
+				SpatialAccelerationRaycastPacket(*Accelerator, Packet);
+				if (Packet.ActiveLanes == 0)
+				{
+					return;
+				}
+			}
+		}
+
+		constexpr int NextType = TypeIdx + 1;
+		if (NextType < NumTypes)
+		{
+			TSpatialAccelerationCollectionHelper < NextType < NumTypes ? NextType : 0, NumTypes, Tuple, TPayloadType, T, d>::RaycastPacketFast(Types, Packet);
+		}
+	}
+
+	template <typename SQVisitor>
+	static void SweepPacketFast(const Tuple& Types, TSpatialQueryPacket<SQVisitor>& Packet)
+	{
+		const auto& Accelerations = GetAccelerationsPerType<TypeIdx>(Types).Objects;
+		for (const auto& Accelerator : Accelerations)
+		{
+			if (Accelerator)
+			{
+				SpatialAccelerationSweepPacket(*Accelerator, Packet);
+				if (Packet.ActiveLanes == 0)
+				{
+					return;
+				}
+			}
+		}
+
+		constexpr int NextType = TypeIdx + 1;
+		if (NextType < NumTypes)
+		{
+			TSpatialAccelerationCollectionHelper < NextType < NumTypes ? NextType : 0, NumTypes, Tuple, TPayloadType, T, d>::SweepPacketFast(Types, Packet);
+		}
+	}
+
 	template <typename SQVisitor>
 	static bool OverlapFast(const Tuple& Types, const TAABB<T, d> QueryBounds, SQVisitor& Visitor)
 	{
@@ -431,6 +478,22 @@ public:
 		TSpatialAccelerationCollectionHelper<0, NumTypes, decltype(Types), TPayloadType, T, d>::SweepFast(Types, Start, QueryFastData, QueryHalfExtents, Visitor);
 	}
 
+	virtual void RaycastBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const override
+	{
+		ForEachSpatialQueryPacket(Queries, [this](TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>>& Packet)
+		{
+			TSpatialAccelerationCollectionHelper<0, NumTypes, decltype(Types), TPayloadType, T, d>::RaycastPacketFast(Types, Packet);
+		});
+	}
+
+	virtual void SweepBatch(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries) const override
+	{
+		ForEachSpatialQueryPacket(Queries, [this](TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>>& Packet)
+		{
+			TSpatialAccelerationCollectionHelper<0, NumTypes, decltype(Types), TPayloadType, T, d>::SweepPacketFast(Types, Packet);
+		});
+	}
+
 	virtual void Overlap(const TAABB<T, d>& QueryBounds, ISpatialVisitor<TPayloadType, T>& Visitor) const override
 	{
 		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
@@ -0,0 +1,222 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/AABB.h"
+#include "Chaos/ISpatialAcceleration.h"
+#include "Math/VectorRegister.h"
+#include "Containers/ArrayView.h"
+
+namespace Chaos
+{
+
+/** Number of raycasts or sweeps traversed together by packet queries */
+static constexpr int32 SpatialQueryPacketWidth = 4;
+
+/** Up to SpatialQueryPacketWidth raycasts or sweeps traversed together through acceleration structures */
+template <typename SQVisitor>
+struct TSpatialQueryPacket
+{
+	int32 NumLanes = 0;
+
+	/** Bit per lane still traversing, cleared when the visitor of the lane stops its query */
+	uint32 ActiveLanes = 0;
+
+	FVec3 Starts[SpatialQueryPacketWidth];
+	FVec3 QueryHalfExtents[SpatialQueryPacketWidth];
+	FQueryFastData* CurDatas[SpatialQueryPacketWidth];
+	SQVisitor* Visitors[SpatialQueryPacketWidth];
+};
+
+/**
+ * Lanes of a packet in SIMD form, to test bounds against all of them at once.
+ * Produces the same results as TAABB::RaycastFast for every lane (with bounds inflated by the lane's half extents for sweeps).
+ */
+struct FSpatialQueryPacketLanes
+{
+	/** @param bSweep whether bounds get inflated by half extents of the lanes, raycasts ignore them */
+	template <typename SQVisitor>
+	FSpatialQueryPacketLanes(const TSpatialQueryPacket<SQVisitor>& Packet, const bool bSweep)
+	{
+		MS_ALIGN(16) float Values[9][SpatialQueryPacketWidth] GCC_ALIGN(16);
+		MS_ALIGN(16) uint32 ParallelMasks[3][SpatialQueryPacketWidth] GCC_ALIGN(16);
+
+		for (int32 Lane = 0; Lane < SpatialQueryPacketWidth; Lane++)
+		{
+			// unused lanes repeat the first one, they are masked out of the results
+			const int32 SourceLane = Lane < Packet.NumLanes ? Lane : 0;
+			const FQueryFastData& CurData = *Packet.CurDatas[SourceLane];
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				Values[Axis][Lane] = Packet.Starts[SourceLane][Axis];
+				Values[3 + Axis][Lane] = CurData.InvDir[Axis];
+				Values[6 + Axis][Lane] = bSweep ? Packet.QueryHalfExtents[SourceLane][Axis] : 0.f;
+				ParallelMasks[Axis][Lane] = CurData.bParallel[Axis] ? 0xFFFFFFFF : 0;
+			}
+		}
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Start[Axis] = VectorLoadAligned(Values[Axis]);
+			InvDir[Axis] = VectorLoadAligned(Values[3 + Axis]);
+			HalfExtents[Axis] = VectorLoadAligned(Values[6 + Axis]);
+			Parallel[Axis] = VectorLoadAligned(ParallelMasks[Axis]);
+		}
+	}
+
+	/** @return bit per lane whose segment of length Lengths hits Bounds, OutTOI gets the entry time per lane */
+	FORCEINLINE_DEBUGGABLE uint32 IntersectBounds(const TAABB<FReal, 3>& Bounds, const VectorRegister& Lengths, VectorRegister& OutTOI) const
+	{
+		const VectorRegister Zero = VectorZero();
+		const VectorRegister Max = VectorSetFloat1(FLT_MAX);
+
+		VectorRegister LatestStartTime = Zero;
+		VectorRegister EarliestEndTime = Max;
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const VectorRegister StartToMin = VectorSubtract(VectorSubtract(VectorSetFloat1(Bounds.Min()[Axis]), HalfExtents[Axis]), Start[Axis]);
+			const VectorRegister StartToMax = VectorSubtract(VectorAdd(VectorSetFloat1(Bounds.Max()[Axis]), HalfExtents[Axis]), Start[Axis]);
+
+			const VectorRegister Time1 = VectorMultiply(StartToMin, InvDir[Axis]);
+			const VectorRegister Time2 = VectorMultiply(StartToMax, InvDir[Axis]);
+
+			// parallel lanes are either always inside of the slab or never
+			const VectorRegister ParallelInside = VectorBitwiseAnd(VectorCompareLE(StartToMin, Zero), VectorCompareGE(StartToMax, Zero));
+			const VectorRegister NearTime = VectorSelect(Parallel[Axis], VectorSelect(ParallelInside, Zero, Max), VectorMin(Time1, Time2));
+			const VectorRegister FarTime = VectorSelect(Parallel[Axis], VectorSelect(ParallelInside, Max, VectorNegate(Max)), VectorMax(Time1, Time2));
+
+			LatestStartTime = VectorMax(LatestStartTime, NearTime);
+			EarliestEndTime = VectorMin(EarliestEndTime, FarTime);
+		}
+
+		OutTOI = LatestStartTime;
+		const VectorRegister Hit = VectorBitwiseAnd(VectorCompareLE(LatestStartTime, EarliestEndTime), VectorCompareLE(LatestStartTime, Lengths));
+		return (uint32)VectorMaskBits(Hit);
+	}
+
+	VectorRegister Start[3];
+	VectorRegister InvDir[3];
+	VectorRegister HalfExtents[3];
+	VectorRegister Parallel[3];
+};
+
+/** Loads current lengths of all lanes, unused lanes repeat the first one */
+template <typename SQVisitor>
+FORCEINLINE VectorRegister LoadSpatialQueryPacketLengths(const TSpatialQueryPacket<SQVisitor>& Packet)
+{
+	MS_ALIGN(16) float Lengths[SpatialQueryPacketWidth] GCC_ALIGN(16);
+	for (int32 Lane = 0; Lane < SpatialQueryPacketWidth; Lane++)
+	{
+		Lengths[Lane] = Packet.CurDatas[Lane < Packet.NumLanes ? Lane : 0]->CurrentLength;
+	}
+	return VectorLoadAligned(Lengths);
+}
+
+/** Fallback for structures without packet traversal, raycasts active lanes one at a time */
+template <typename TAcceleration, typename SQVisitor>
+void SpatialAccelerationRaycastPacket(const TAcceleration& Acceleration, TSpatialQueryPacket<SQVisitor>& Packet)
+{
+	for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+	{
+		if ((Packet.ActiveLanes & (1 << Lane)) && !Acceleration.RaycastFast(Packet.Starts[Lane], *Packet.CurDatas[Lane], *Packet.Visitors[Lane]))
+		{
+			Packet.ActiveLanes &= ~(1 << Lane);
+		}
+	}
+}
+
+/** Fallback for structures without packet traversal, sweeps active lanes one at a time */
+template <typename TAcceleration, typename SQVisitor>
+void SpatialAccelerationSweepPacket(const TAcceleration& Acceleration, TSpatialQueryPacket<SQVisitor>& Packet)
+{
+	for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+	{
+		if ((Packet.ActiveLanes & (1 << Lane)) && !Acceleration.SweepFast(Packet.Starts[Lane], *Packet.CurDatas[Lane], Packet.QueryHalfExtents[Lane], *Packet.Visitors[Lane]))
+		{
+			Packet.ActiveLanes &= ~(1 << Lane);
+		}
+	}
+}
+
+namespace SpatialQueryPacketHelpers
+{
+	/** Spreads the lowest 10 bits of Value so that there are two zero bits between all of them */
+	FORCEINLINE uint32 SpreadBits3(uint32 Value)
+	{
+		Value &= 0x3FF;
+		Value = (Value | (Value << 16)) & 0x030000FF;
+		Value = (Value | (Value << 8)) & 0x0300F00F;
+		Value = (Value | (Value << 4)) & 0x030C30C3;
+		Value = (Value | (Value << 2)) & 0x09249249;
+		return Value;
+	}
+}
+
+/**
+ * Orders queries so that packets get queries going in similar directions from nearby starts:
+ * sorted by direction octant, then by Morton code of their start quantized over the bounds of all starts.
+ */
+template <typename TPayloadType, typename T>
+void SortSpatialQueriesByCoherence(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries, TArray<int32>& OutOrder)
+{
+	TAABB<T, 3> StartBounds = TAABB<T, 3>::EmptyAABB();
+	for (const TSpatialBatchQuery<TPayloadType, T>& Query : Queries)
+	{
+		StartBounds.GrowToInclude(Query.Start);
+	}
+
+	const TVector<T, 3> Extents = StartBounds.Extents();
+	const TVector<T, 3> Scale(Extents[0] > 0 ? 1023 / Extents[0] : 0, Extents[1] > 0 ? 1023 / Extents[1] : 0, Extents[2] > 0 ? 1023 / Extents[2] : 0);
+
+	TArray<uint64> Keys;
+	Keys.Reserve(Queries.Num());
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); QueryIndex++)
+	{
+		const TSpatialBatchQuery<TPayloadType, T>& Query = Queries[QueryIndex];
+		const TVector<T, 3> Cell = (Query.Start - StartBounds.Min()) * Scale;
+		const uint32 Octant = (Query.Dir[0] < 0 ? 1 : 0) | (Query.Dir[1] < 0 ? 2 : 0) | (Query.Dir[2] < 0 ? 4 : 0);
+		const uint32 Morton = SpatialQueryPacketHelpers::SpreadBits3((uint32)Cell[0]) | (SpatialQueryPacketHelpers::SpreadBits3((uint32)Cell[1]) << 1) | (SpatialQueryPacketHelpers::SpreadBits3((uint32)Cell[2]) << 2);
+
+		// query index in low bits keeps the sort stable
+		Keys.Add(((uint64)((Octant << 30) | Morton) << 32) | (uint32)QueryIndex);
+	}
+
+	Keys.Sort();
+
+	OutOrder.Reset(Queries.Num());
+	for (const uint64 Key : Keys)
+	{
+		OutOrder.Add((int32)(Key & 0xFFFFFFFF));
+	}
+}
+
+/** Splits a batch into packets of coherent queries, PacketFunc(TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>>&) traverses a packet */
+template <typename TPayloadType, typename T, typename PacketFuncType>
+void ForEachSpatialQueryPacket(TArrayView<const TSpatialBatchQuery<TPayloadType, T>> Queries, const PacketFuncType& PacketFunc)
+{
+	TArray<int32> Order;
+	SortSpatialQueriesByCoherence(Queries, Order);
+
+	for (int32 FirstIndex = 0; FirstIndex < Order.Num(); FirstIndex += SpatialQueryPacketWidth)
+	{
+		TArray<FQueryFastData, TInlineAllocator<SpatialQueryPacketWidth>> CurDatas;
+		TArray<TSpatialVisitor<TPayloadType, T>, TInlineAllocator<SpatialQueryPacketWidth>> Visitors;
+
+		TSpatialQueryPacket<TSpatialVisitor<TPayloadType, T>> Packet;
+		Packet.NumLanes = FMath::Min(SpatialQueryPacketWidth, Order.Num() - FirstIndex);
+		Packet.ActiveLanes = (1 << Packet.NumLanes) - 1;
+
+		for (int32 Lane = 0; Lane < Packet.NumLanes; Lane++)
+		{
+			const TSpatialBatchQuery<TPayloadType, T>& Query = Queries[Order[FirstIndex + Lane]];
+			Packet.Starts[Lane] = Query.Start;
+			Packet.QueryHalfExtents[Lane] = Query.QueryHalfExtents;
+			Packet.CurDatas[Lane] = &CurDatas.Emplace_GetRef(Query.Dir, Query.Length);
+			Packet.Visitors[Lane] = &Visitors.Emplace_GetRef(*Query.Visitor);
+		}
+
+		PacketFunc(Packet);
+	}
+}
+
+}
@@ -0,0 +1,1164 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/AABBTree.h"
+#include "Chaos/Framework/Parallel.h"
+#include "Algo/Sort.h"
+#include "Math/VectorRegister.h"
+
+namespace Chaos
+{
+
+DECLARE_CYCLE_STAT(TEXT("WideAABBTreeGenerateTree"), STAT_WideAABBTreeGenerateTree, STATGROUP_Chaos);
+
+namespace WideAABBTreeBuild
+{
+	/** Number of bins along every axis evaluated by the SAH builder */
+	static constexpr int32 NumBins = 16;
+
+	/** Trees with fewer elements are built on a single thread */
+	static constexpr int32 MinParallelBuildElems = 4096;
+
+	/** Ranges with at least twice as many elements compute their bins in parallel chunks of this size */
+	static constexpr int32 BinningChunkSize = 4096;
+
+	/** Subtrees with fewer than (number of elements / ParallelSubtreesDivisor) elements are built in parallel */
+	static constexpr int32 ParallelSubtreesDivisor = 64;
+
+	/** Child bounds are quantized to [0, MaxQuantized] steps of their node bounds */
+	static constexpr int32 MaxQuantized = 255;
+}
+
+/**
+ * Node of TWideAABBTree with up to NodeWidth children.
+ * Child bounds are quantized to 8 bits per coordinate relative to the node bounds, and stored per axis so that
+ * bounds of 4 children are loaded into SIMD registers at once. Quantization rounds outwards: dequantized bounds
+ * always contain the real bounds of the child.
+ */
+template <int32 NodeWidth>
+struct TWideAABBTreeNode
+{
+	static_assert(NodeWidth == 4 || NodeWidth == 8, "Wide AABB tree nodes have 4 or 8 children");
+
+	TWideAABBTreeNode()
+		: LeafMask(0)
+		, NumChildren(0)
+	{
+		FMemory::Memzero(Origin);
+		FMemory::Memzero(Scale);
+		FMemory::Memzero(QuantizedMin);
+		FMemory::Memzero(QuantizedMax);
+		FMemory::Memzero(Children);
+		FMemory::Memzero(NumLeafElems);
+	}
+
+	/** Min of node bounds, dequantized child bounds are Origin + Quantized * Scale */
+	FReal Origin[3];
+	/** Size of a quantization step along every axis */
+	FReal Scale[3];
+	/** Child bounds in quantization steps, [Axis][Child] */
+	uint8 QuantizedMin[3][NodeWidth];
+	uint8 QuantizedMax[3][NodeWidth];
+	/** Index of child node, or index of first element of leaf children */
+	int32 Children[NodeWidth];
+	/** Number of elements of leaf children */
+	int32 NumLeafElems[NodeWidth];
+	/** Bit per leaf child */
+	uint8 LeafMask;
+	uint8 NumChildren;
+
+	bool IsLeafChild(const int32 Child) const { return (LeafMask & (1 << Child)) != 0; }
+
+	/** @return bit per child of the group of 4 starting at FirstChild */
+	uint32 GetChildMask(const int32 FirstChild) const
+	{
+		const int32 NumGroupChildren = NumChildren - FirstChild;
+		return NumGroupChildren >= 4 ? 0xF : (1 << NumGroupChildren) - 1;
+	}
+
+	void SetBounds(const TAABB<FReal, 3>& Bounds)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Origin[Axis] = Bounds.Min()[Axis];
+			Scale[Axis] = (Bounds.Max()[Axis] - Bounds.Min()[Axis]) / WideAABBTreeBuild::MaxQuantized;
+
+			// last step must reach max of the bounds after rounding
+			while (Origin[Axis] + WideAABBTreeBuild::MaxQuantized * Scale[Axis] < Bounds.Max()[Axis])
+			{
+				Scale[Axis] += FMath::Max(Scale[Axis] * KINDA_SMALL_NUMBER, FLT_MIN);
+			}
+		}
+	}
+
+	/** Quantizes bounds of a child, which must be inside of the node bounds */
+	void SetChildBounds(const int32 Child, const TAABB<FReal, 3>& ChildBounds)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const FReal InvScale = Scale[Axis] > 0 ? 1 / Scale[Axis] : 0;
+			int32 Min = FMath::Clamp(FMath::FloorToInt((ChildBounds.Min()[Axis] - Origin[Axis]) * InvScale), 0, WideAABBTreeBuild::MaxQuantized);
+			int32 Max = FMath::Clamp(FMath::CeilToInt((ChildBounds.Max()[Axis] - Origin[Axis]) * InvScale), 0, WideAABBTreeBuild::MaxQuantized);
+
+			// correct rounding errors so that dequantized bounds contain the child
+			while (Min > 0 && DequantizeCoordinate(Axis, Min) > ChildBounds.Min()[Axis])
+			{
+				Min--;
+			}
+			while (Max < WideAABBTreeBuild::MaxQuantized && DequantizeCoordinate(Axis, Max) < ChildBounds.Max()[Axis])
+			{
+				Max++;
+			}
+
+			QuantizedMin[Axis][Child] = (uint8)Min;
+			QuantizedMax[Axis][Child] = (uint8)Max;
+		}
+	}
+
+	FORCEINLINE FReal DequantizeCoordinate(const int32 Axis, const int32 Quantized) const
+	{
+		return Origin[Axis] + (FReal)Quantized * Scale[Axis];
+	}
+
+	TAABB<FReal, 3> GetChildBounds(const int32 Child) const
+	{
+		TVector<FReal, 3> Min;
+		TVector<FReal, 3> Max;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Min[Axis] = DequantizeCoordinate(Axis, QuantizedMin[Axis][Child]);
+			Max[Axis] = DequantizeCoordinate(Axis, QuantizedMax[Axis][Child]);
+		}
+		return TAABB<FReal, 3>(Min, Max);
+	}
+
+	/** Dequantizes bounds of the 4 children starting at FirstChild, same results as GetChildBounds */
+	FORCEINLINE_DEBUGGABLE void DequantizeChildBounds(const int32 FirstChild, VectorRegister OutMin[3], VectorRegister OutMax[3]) const
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const VectorRegister NodeOrigin = VectorSetFloat1(Origin[Axis]);
+			const VectorRegister NodeScale = VectorSetFloat1(Scale[Axis]);
+			OutMin[Axis] = VectorAdd(NodeOrigin, VectorMultiply(VectorLoadByte4(&QuantizedMin[Axis][FirstChild]), NodeScale));
+			OutMax[Axis] = VectorAdd(NodeOrigin, VectorMultiply(VectorLoadByte4(&QuantizedMax[Axis][FirstChild]), NodeScale));
+		}
+	}
+
+	void Serialize(FChaosArchive& Ar)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			Ar << Origin[Axis];
+			Ar << Scale[Axis];
+			for (int32 Child = 0; Child < NodeWidth; Child++)
+			{
+				Ar << QuantizedMin[Axis][Child];
+				Ar << QuantizedMax[Axis][Child];
+			}
+		}
+
+		for (int32 Child = 0; Child < NodeWidth; Child++)
+		{
+			Ar << Children[Child];
+			Ar << NumLeafElems[Child];
+		}
+
+		Ar << LeafMask;
+		Ar << NumChildren;
+	}
+};
+
+template <int32 NodeWidth>
+FChaosArchive& operator<<(FChaosArchive& Ar, TWideAABBTreeNode<NodeWidth>& Node)
+{
+	Node.Serialize(Ar);
+	return Ar;
+}
+
+/** A raycast, sweep or overlap broadcast to SIMD lanes, to test it against 4 children of a node at once */
+struct FWideAABBTreeQueryLanes
+{
+	/** Raycast, or sweep of a box with QueryHalfExtents */
+	FWideAABBTreeQueryLanes(const FVec3& Start, const FQueryFastData& CurData, const FVec3& QueryHalfExtents)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			StartOrQueryMin[Axis] = VectorSetFloat1(Start[Axis]);
+			InvDirOrQueryMax[Axis] = VectorSetFloat1(CurData.InvDir[Axis]);
+			HalfExtents[Axis] = VectorSetFloat1(QueryHalfExtents[Axis]);
+			bParallel[Axis] = CurData.bParallel[Axis];
+		}
+	}
+
+	/** Overlap of QueryBounds */
+	explicit FWideAABBTreeQueryLanes(const TAABB<FReal, 3>& QueryBounds)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			StartOrQueryMin[Axis] = VectorSetFloat1(QueryBounds.Min()[Axis]);
+			InvDirOrQueryMax[Axis] = VectorSetFloat1(QueryBounds.Max()[Axis]);
+			HalfExtents[Axis] = VectorZero();
+			bParallel[Axis] = false;
+		}
+	}
+
+	/** @return bit per lane whose bounds are hit within Length, same results as TAABB::RaycastFast. OutTOI gets the entry time per lane */
+	FORCEINLINE_DEBUGGABLE uint32 RaycastBounds(const VectorRegister Min[3], const VectorRegister Max[3], const FReal Length, VectorRegister& OutTOI) const
+	{
+		const VectorRegister Zero = VectorZero();
+		VectorRegister LatestStartTime = Zero;
+		VectorRegister EarliestEndTime = VectorSetFloat1(FLT_MAX);
+		uint32 ParallelInsideMask = 0xF;
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const VectorRegister StartToMin = VectorSubtract(VectorSubtract(Min[Axis], HalfExtents[Axis]), StartOrQueryMin[Axis]);
+			const VectorRegister StartToMax = VectorSubtract(VectorAdd(Max[Axis], HalfExtents[Axis]), StartOrQueryMin[Axis]);
+
+			if (bParallel[Axis])
+			{
+				ParallelInsideMask &= (uint32)VectorMaskBits(VectorBitwiseAnd(VectorCompareLE(StartToMin, Zero), VectorCompareGE(StartToMax, Zero)));
+			}
+			else
+			{
+				const VectorRegister Time1 = VectorMultiply(StartToMin, InvDirOrQueryMax[Axis]);
+				const VectorRegister Time2 = VectorMultiply(StartToMax, InvDirOrQueryMax[Axis]);
+				LatestStartTime = VectorMax(LatestStartTime, VectorMin(Time1, Time2));
+				EarliestEndTime = VectorMin(EarliestEndTime, VectorMax(Time1, Time2));
+			}
+		}
+
+		OutTOI = LatestStartTime;
+		const VectorRegister Hit = VectorBitwiseAnd(VectorCompareLE(LatestStartTime, EarliestEndTime), VectorCompareLE(LatestStartTime, VectorSetFloat1(Length)));
+		return (uint32)VectorMaskBits(Hit) & ParallelInsideMask;
+	}
+
+	/** @return bit per lane whose bounds intersect the query bounds, same results as TAABB::Intersects */
+	FORCEINLINE_DEBUGGABLE uint32 OverlapBounds(const VectorRegister Min[3], const VectorRegister Max[3]) const
+	{
+		VectorRegister Hit = VectorBitwiseAnd(VectorCompareLE(Min[0], InvDirOrQueryMax[0]), VectorCompareGE(Max[0], StartOrQueryMin[0]));
+		Hit = VectorBitwiseAnd(Hit, VectorBitwiseAnd(VectorCompareLE(Min[1], InvDirOrQueryMax[1]), VectorCompareGE(Max[1], StartOrQueryMin[1])));
+		Hit = VectorBitwiseAnd(Hit, VectorBitwiseAnd(VectorCompareLE(Min[2], InvDirOrQueryMax[2]), VectorCompareGE(Max[2], StartOrQueryMin[2])));
+		return (uint32)VectorMaskBits(Hit);
+	}
+
+	VectorRegister StartOrQueryMin[3];
+	VectorRegister InvDirOrQueryMax[3];
+	VectorRegister HalfExtents[3];
+	bool bParallel[3];
+};
+
+/**
+ * Bounding volume hierarchy with NodeWidth (4 or 8) children per node, an alternative to the binary TAABBTree.
+ *
+ * Nodes store quantized bounds of all their children, so a query tests every child of a node with a few SIMD
+ * instructions and visits a node per 4 or 8 children instead of one per 2. Leaves are stored in their parent node
+ * as ranges of a single element array, sorted by leaf. The tree is built top down by a binned SAH builder,
+ * with large trees built on multiple threads.
+ *
+ * Like TAABBTree, updated elements stay in their leaf while they fit in it, and are moved to a list of dirty
+ * elements (scanned linearly by queries) otherwise. Elements without bounds, or with bounds larger than
+ * MaxPayloadBounds, are kept out of the tree in the global list.
+ */
+template <typename TPayloadType, typename T, int32 NodeWidth = 4>
+class TWideAABBTree final : public ISpatialAcceleration<TPayloadType, T, 3>
+{
+public:
+	static_assert(TIsSame<T, FReal>::Value, "Wide AABB tree traversal is done in SIMD registers of FReal");
+
+	using PayloadType = TPayloadType;
+	static constexpr int D = 3;
+	using TType = T;
+	static constexpr T DefaultMaxPayloadBounds = 100000;
+	static constexpr int32 DefaultMaxChildrenInLeaf = 8;
+	static constexpr int32 DefaultMaxTreeDepth = 32;
+	static constexpr ESpatialAcceleration StaticType = NodeWidth == 4 ? ESpatialAcceleration::WideAABBTree : ESpatialAcceleration::WideAABBTree8;
+
+	TWideAABBTree()
+		: ISpatialAcceleration<TPayloadType, T, 3>(StaticType)
+		, MaxChildrenInLeaf(DefaultMaxChildrenInLeaf)
+		, MaxTreeDepth(DefaultMaxTreeDepth)
+		, MaxPayloadBounds(DefaultMaxPayloadBounds)
+	{
+	}
+
+	template <typename TParticles>
+	TWideAABBTree(const TParticles& Particles, int32 InMaxChildrenInLeaf = DefaultMaxChildrenInLeaf, int32 InMaxTreeDepth = DefaultMaxTreeDepth, T InMaxPayloadBounds = DefaultMaxPayloadBounds)
+		: ISpatialAcceleration<TPayloadType, T, 3>(StaticType)
+		, MaxChildrenInLeaf(FMath::Max(InMaxChildrenInLeaf, 1))
+		, MaxTreeDepth(FMath::Max(InMaxTreeDepth, 1))
+		, MaxPayloadBounds(InMaxPayloadBounds)
+	{
+		GenerateTree(Particles);
+	}
+
+	template <typename ParticleView>
+	void Reinitialize(const ParticleView& Particles)
+	{
+		GenerateTree(Particles);
+	}
+
+	virtual ~TWideAABBTree() {}
+
+	virtual TUniquePtr<ISpatialAcceleration<TPayloadType, T, 3>> Copy() const override
+	{
+		return TUniquePtr<ISpatialAcceleration<TPayloadType, T, 3>>(new TWideAABBTree<TPayloadType, T, NodeWidth>(*this));
+	}
+
+	virtual TArray<TPayloadType> FindAllIntersections(const TAABB<T, 3>& Box) const override
+	{
+		struct FCollectVisitor
+		{
+			FCollectVisitor(TArray<TPayloadType>& InResults) : CollectedResults(InResults) {}
+			bool VisitOverlap(const TSpatialVisitorData<TPayloadType>& Instance)
+			{
+				CollectedResults.Add(Instance.Payload);
+				return true;
+			}
+			bool VisitSweep(const TSpatialVisitorData<TPayloadType>& Instance, FQueryFastData& CurData)
+			{
+				check(false);
+				return true;
+			}
+			bool VisitRaycast(const TSpatialVisitorData<TPayloadType>& Instance, FQueryFastData& CurData)
+			{
+				check(false);
+				return true;
+			}
+
+			const void* GetQueryData() const { return nullptr; }
+
+			TArray<TPayloadType>& CollectedResults;
+		};
+
+		TArray<TPayloadType> Results;
+		FCollectVisitor Collector(Results);
+		Overlap(Box, Collector);
+		return Results;
+	}
+
+	virtual void Raycast(const TVector<T, 3>& Start, const TVector<T, 3>& Dir, const T Length, ISpatialVisitor<TPayloadType, T>& Visitor) const override
+	{
+		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
+		Raycast(Start, Dir, Length, ProxyVisitor);
+	}
+
+	template <typename SQVisitor>
+	void Raycast(const TVector<T, 3>& Start, const TVector<T, 3>& Dir, const T Length, SQVisitor& Visitor) const
+	{
+		FQueryFastData QueryFastData(Dir, Length);
+		QueryImp<EAABBQueryType::Raycast>(Start, QueryFastData, TVector<T, 3>(0), TAABB<T, 3>(), Visitor);
+	}
+
+	template <typename SQVisitor>
+	bool RaycastFast(const TVector<T, 3>& Start, FQueryFastData& CurData, SQVisitor& Visitor) const
+	{
+		return QueryImp<EAABBQueryType::Raycast>(Start, CurData, TVector<T, 3>(0), TAABB<T, 3>(), Visitor);
+	}
+
+	virtual void Sweep(const TVector<T, 3>& Start, const TVector<T, 3>& Dir, const T Length, const TVector<T, 3> QueryHalfExtents, ISpatialVisitor<TPayloadType, T>& Visitor) const override
+	{
+		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
+		Sweep(Start, Dir, Length, QueryHalfExtents, ProxyVisitor);
+	}
+
+	template <typename SQVisitor>
+	void Sweep(const TVector<T, 3>& Start, const TVector<T, 3>& Dir, const T Length, const TVector<T, 3> QueryHalfExtents, SQVisitor& Visitor) const
+	{
+		FQueryFastData QueryFastData(Dir, Length);
+		QueryImp<EAABBQueryType::Sweep>(Start, QueryFastData, QueryHalfExtents, TAABB<T, 3>(), Visitor);
+	}
+
+	template <typename SQVisitor>
+	bool SweepFast(const TVector<T, 3>& Start, FQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, SQVisitor& Visitor) const
+	{
+		return QueryImp<EAABBQueryType::Sweep>(Start, CurData, QueryHalfExtents, TAABB<T, 3>(), Visitor);
+	}
+
+	virtual void Overlap(const TAABB<T, 3>& QueryBounds, ISpatialVisitor<TPayloadType, T>& Visitor) const override
+	{
+		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
+		Overlap(QueryBounds, ProxyVisitor);
+	}
+
+	template <typename SQVisitor>
+	void Overlap(const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		OverlapFast(QueryBounds, Visitor);
+	}
+
+	template <typename SQVisitor>
+	bool OverlapFast(const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		//dummy variables to reuse templated path
+		FQueryFastDataVoid VoidData;
+		return QueryImp<EAABBQueryType::Overlap>(TVector<T, 3>(0), VoidData, TVector<T, 3>(0), QueryBounds, Visitor);
+	}
+
+	virtual void RemoveElement(const TPayloadType& Payload) override
+	{
+		if (FAABBTreePayloadInfo* PayloadInfo = PayloadToInfo.Find(Payload))
+		{
+			if (PayloadInfo->GlobalPayloadIdx != INDEX_NONE)
+			{
+				RemoveFromList(GlobalPayloads, PayloadInfo->GlobalPayloadIdx, &FAABBTreePayloadInfo::GlobalPayloadIdx);
+			}
+			else if (PayloadInfo->DirtyPayloadIdx != INDEX_NONE)
+			{
+				RemoveFromList(DirtyElements, PayloadInfo->DirtyPayloadIdx, &FAABBTreePayloadInfo::DirtyPayloadIdx);
+			}
+			else if (ensure(PayloadInfo->LeafIdx != INDEX_NONE))
+			{
+				RemoveFromLeaf(PayloadInfo->LeafIdx);
+			}
+
+			PayloadToInfo.Remove(Payload);
+		}
+	}
+
+	virtual void UpdateElement(const TPayloadType& Payload, const TAABB<T, 3>& NewBounds, bool bHasBounds) override
+	{
+		FAABBTreePayloadInfo* PayloadInfo = PayloadToInfo.Find(Payload);
+		if (PayloadInfo)
+		{
+			if (PayloadInfo->LeafIdx != INDEX_NONE)
+			{
+				//If we are still within the same leaf bounds, only update the element
+				if (bHasBounds && NewBounds.Extents().Max() <= MaxPayloadBounds)
+				{
+					const int32 LeafSlot = ElemLeafSlots[PayloadInfo->LeafIdx];
+					const TAABB<T, 3> LeafBounds = Nodes[LeafSlot / NodeWidth].GetChildBounds(LeafSlot % NodeWidth);
+					if (LeafBounds.Contains(NewBounds.Min()) && LeafBounds.Contains(NewBounds.Max()))
+					{
+						Elems[PayloadInfo->LeafIdx].Bounds = NewBounds;
+						UpdateElementHelper(Elems[PayloadInfo->LeafIdx].Payload, Payload);
+						return;
+					}
+				}
+
+				RemoveFromLeaf(PayloadInfo->LeafIdx);
+				PayloadInfo->LeafIdx = INDEX_NONE;
+			}
+		}
+		else
+		{
+			PayloadInfo = &PayloadToInfo.Add(Payload);
+		}
+
+		bool bTooBig = false;
+		if (bHasBounds && NewBounds.Extents().Max() > MaxPayloadBounds)
+		{
+			bTooBig = true;
+			bHasBounds = false;
+		}
+
+		if (bHasBounds)
+		{
+			if (PayloadInfo->DirtyPayloadIdx == INDEX_NONE)
+			{
+				PayloadInfo->DirtyPayloadIdx = DirtyElements.Add(FElement{ Payload, NewBounds });
+			}
+			else
+			{
+				DirtyElements[PayloadInfo->DirtyPayloadIdx].Bounds = NewBounds;
+				UpdateElementHelper(DirtyElements[PayloadInfo->DirtyPayloadIdx].Payload, Payload);
+			}
+
+			if (PayloadInfo->GlobalPayloadIdx != INDEX_NONE)
+			{
+				RemoveFromList(GlobalPayloads, PayloadInfo->GlobalPayloadIdx, &FAABBTreePayloadInfo::GlobalPayloadIdx);
+				PayloadInfo = PayloadToInfo.Find(Payload);
+				PayloadInfo->GlobalPayloadIdx = INDEX_NONE;
+			}
+		}
+		else
+		{
+			const TAABB<T, 3> GlobalBounds = bTooBig ? NewBounds : TAABB<T, 3>(TVector<T, 3>(TNumericLimits<T>::Lowest()), TVector<T, 3>(TNumericLimits<T>::Max()));
+			if (PayloadInfo->GlobalPayloadIdx == INDEX_NONE)
+			{
+				PayloadInfo->GlobalPayloadIdx = GlobalPayloads.Add(FElement{ Payload, GlobalBounds });
+			}
+			else
+			{
+				GlobalPayloads[PayloadInfo->GlobalPayloadIdx].Bounds = GlobalBounds;
+				UpdateElementHelper(GlobalPayloads[PayloadInfo->GlobalPayloadIdx].Payload, Payload);
+			}
+
+			if (PayloadInfo->DirtyPayloadIdx != INDEX_NONE)
+			{
+				RemoveFromList(DirtyElements, PayloadInfo->DirtyPayloadIdx, &FAABBTreePayloadInfo::DirtyPayloadIdx);
+				PayloadInfo = PayloadToInfo.Find(Payload);
+				PayloadInfo->DirtyPayloadIdx = INDEX_NONE;
+			}
+		}
+
+		if (DirtyElements.Num() > MaxDirtyElements)
+		{
+			UE_LOG(LogChaos, Verbose, TEXT("Wide AABB tree exceeded maximum dirty elements (%d dirty of max %d) and is forcing a tree rebuild."), DirtyElements.Num(), MaxDirtyElements);
+			ReoptimizeTree();
+		}
+	}
+
+	int32 NumDirtyElements() const
+	{
+		return DirtyElements.Num();
+	}
+
+	const TArray<TPayloadBoundsElement<TPayloadType, T>>& GlobalObjects() const
+	{
+		return GlobalPayloads;
+	}
+
+	/** @return number of nodes, leaves are stored in their parent node */
+	int32 NumNodes() const
+	{
+		return Nodes.Num();
+	}
+
+	/** @return memory allocated by the tree, its elements and their lookup */
+	SIZE_T GetAllocatedSize() const
+	{
+		return Nodes.GetAllocatedSize() + Elems.GetAllocatedSize() + ElemLeafSlots.GetAllocatedSize() + DirtyElements.GetAllocatedSize()
+			+ GlobalPayloads.GetAllocatedSize() + PayloadToInfo.GetAllocatedSize();
+	}
+
+#if !UE_BUILD_SHIPPING
+	virtual void DumpStats() const override
+	{
+		int32 NumLeaves = 0;
+		for (const FNode& Node : Nodes)
+		{
+			NumLeaves += FMath::CountBits(Node.LeafMask);
+		}
+
+		UE_LOG(LogChaos, Log, TEXT("Wide AABB tree (%d wide): %d nodes, %d leaves, %d elements, %d dirty, %d global, %llu bytes"),
+			NodeWidth, Nodes.Num(), NumLeaves, Elems.Num(), DirtyElements.Num(), GlobalPayloads.Num(), (uint64)GetAllocatedSize());
+	}
+#endif
+
+	virtual void Serialize(FChaosArchive& Ar) override
+	{
+		Ar << Nodes;
+		Ar << Elems;
+		Ar << ElemLeafSlots;
+		Ar << DirtyElements;
+		Ar << GlobalPayloads;
+		Ar << PayloadToInfo;
+		Ar << MaxChildrenInLeaf;
+		Ar << MaxTreeDepth;
+		Ar << MaxPayloadBounds;
+	}
+
+private:
+
+	using FElement = TPayloadBoundsElement<TPayloadType, T>;
+	using FNode = TWideAABBTreeNode<NodeWidth>;
+
+	TWideAABBTree(const TWideAABBTree<TPayloadType, T, NodeWidth>& Other) = default;
+	TWideAABBTree<TPayloadType, T, NodeWidth>& operator=(const TWideAABBTree<TPayloadType, T, NodeWidth>& Other) = default;
+
+	/** Removes an element of the global or dirty list, IdxMember is the index of the list in payload infos */
+	void RemoveFromList(TArray<FElement>& List, const int32 Idx, int32 FAABBTreePayloadInfo::* IdxMember)
+	{
+		if (Idx + 1 < List.Num())
+		{
+			PayloadToInfo.FindChecked(List.Last().Payload).*IdxMember = Idx;
+		}
+		List.RemoveAtSwap(Idx);
+	}
+
+	/** Removes an element from its leaf by moving the last element of the leaf in its place */
+	void RemoveFromLeaf(const int32 ElemIdx)
+	{
+		const int32 LeafSlot = ElemLeafSlots[ElemIdx];
+		FNode& Node = Nodes[LeafSlot / NodeWidth];
+		const int32 Child = LeafSlot % NodeWidth;
+
+		const int32 LastElemIdx = Node.Children[Child] + Node.NumLeafElems[Child] - 1;
+		if (ElemIdx != LastElemIdx)
+		{
+			Elems[ElemIdx] = Elems[LastElemIdx];
+			PayloadToInfo.FindChecked(Elems[ElemIdx].Payload).LeafIdx = ElemIdx;
+		}
+		Node.NumLeafElems[Child]--;
+	}
+
+	void ReoptimizeTree()
+	{
+		TArray<FElement> AllElements;
+		AllElements.Reserve(Elems.Num() + DirtyElements.Num() + GlobalPayloads.Num());
+		AllElements.Append(DirtyElements);
+		AllElements.Append(GlobalPayloads);
+
+		for (const FNode& Node : Nodes)
+		{
+			for (int32 Child = 0; Child < Node.NumChildren; Child++)
+			{
+				if (Node.IsLeafChild(Child))
+				{
+					AllElements.Append(Elems.GetData() + Node.Children[Child], Node.NumLeafElems[Child]);
+				}
+			}
+		}
+
+		GenerateTree(AllElements);
+	}
+
+	/** Visits elements kept out of the tree, @return false if the visitor stopped the query */
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	bool QueryGlobalAndDirtyImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3>& QueryHalfExtents, const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		const void* QueryData = Visitor.GetQueryData();
+		for (const TArray<FElement>* List : { &GlobalPayloads, &DirtyElements })
+		{
+			for (const FElement& Elem : *List)
+			{
+				if (!PrePreFilterHelper(Elem.Payload, QueryData) && !VisitElement<Query>(Elem, Start, CurData, QueryHalfExtents, QueryBounds, Visitor))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/** Tests an element and passes it to the visitor if it's hit, @return false if the visitor stopped the query */
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	FORCEINLINE_DEBUGGABLE bool VisitElement(const FElement& Elem, const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3>& QueryHalfExtents, const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		TVector<T, 3> TmpPosition;
+		T TOI = 0;
+		if (TAABBTreeIntersectionHelper<T, TQueryFastData, Query>::Intersects(Start, CurData, TOI, TmpPosition, Elem.Bounds, QueryBounds, QueryHalfExtents))
+		{
+			TSpatialVisitorData<TPayloadType> VisitData(Elem.Payload, true, Elem.Bounds);
+			if (Query == EAABBQueryType::Overlap)
+			{
+				return Visitor.VisitOverlap(VisitData);
+			}
+			return Query == EAABBQueryType::Sweep ? Visitor.VisitSweep(VisitData, CurData) : Visitor.VisitRaycast(VisitData, CurData);
+		}
+
+		return true;
+	}
+
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	bool QueryImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3>& QueryHalfExtents, const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		if (!QueryGlobalAndDirtyImp<Query>(Start, CurData, QueryHalfExtents, QueryBounds, Visitor))
+		{
+			return false;
+		}
+
+		if (Nodes.Num() == 0)
+		{
+			return true;
+		}
+
+		const FWideAABBTreeQueryLanes Lanes = Query == EAABBQueryType::Overlap ? FWideAABBTreeQueryLanes(QueryBounds) : FWideAABBTreeQueryLanes(Start, CurData, QueryHalfExtents);
+
+		struct FNodeQueueEntry
+		{
+			int32 NodeIdx;
+			T TOI;
+		};
+
+		TArray<FNodeQueueEntry, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(FNodeQueueEntry{ 0, 0 });
+		while (NodeStack.Num())
+		{
+			const FNodeQueueEntry NodeEntry = NodeStack.Pop(false);
+			if (Query != EAABBQueryType::Overlap)
+			{
+				if (NodeEntry.TOI > CurData.CurrentLength)
+				{
+					continue;
+				}
+			}
+
+			const FNode& Node = Nodes[NodeEntry.NodeIdx];
+
+			FNodeQueueEntry ChildEntries[NodeWidth];
+			int32 NumChildEntries = 0;
+
+			for (int32 FirstChild = 0; FirstChild < Node.NumChildren; FirstChild += 4)
+			{
+				VectorRegister ChildMin[3];
+				VectorRegister ChildMax[3];
+				Node.DequantizeChildBounds(FirstChild, ChildMin, ChildMax);
+
+				MS_ALIGN(16) float ChildTOIs[4] GCC_ALIGN(16) = { 0, 0, 0, 0 };
+				uint32 HitMask;
+				if (Query == EAABBQueryType::Overlap)
+				{
+					HitMask = Lanes.OverlapBounds(ChildMin, ChildMax);
+				}
+				else
+				{
+					VectorRegister TOIs;
+					HitMask = Lanes.RaycastBounds(ChildMin, ChildMax, CurData.CurrentLength, TOIs);
+					VectorStoreAligned(TOIs, ChildTOIs);
+				}
+
+				HitMask &= Node.GetChildMask(FirstChild);
+				while (HitMask)
+				{
+					const int32 Lane = (int32)FMath::CountTrailingZeros(HitMask);
+					HitMask &= HitMask - 1;
+
+					const int32 Child = FirstChild + Lane;
+					if (Node.IsLeafChild(Child))
+					{
+						const int32 LastElemIdx = Node.Children[Child] + Node.NumLeafElems[Child];
+						for (int32 ElemIdx = Node.Children[Child]; ElemIdx < LastElemIdx; ElemIdx++)
+						{
+							if (!VisitElement<Query>(Elems[ElemIdx], Start, CurData, QueryHalfExtents, QueryBounds, Visitor))
+							{
+								return false;
+							}
+						}
+					}
+					else
+					{
+						ChildEntries[NumChildEntries++] = FNodeQueueEntry{ Node.Children[Child], ChildTOIs[Lane] };
+					}
+				}
+			}
+
+			if (Query != EAABBQueryType::Overlap)
+			{
+				// push farthest children first, so that the nearest ones are visited first and can shorten the query
+				Algo::Sort(MakeArrayView(ChildEntries, NumChildEntries), [](const FNodeQueueEntry& A, const FNodeQueueEntry& B) { return A.TOI > B.TOI; });
+			}
+			NodeStack.Append(ChildEntries, NumChildEntries);
+		}
+
+		return true;
+	}
+
+	struct FBuildRange
+	{
+		int32 Start;
+		int32 Num;
+		TAABB<T, 3> Bounds;
+		TAABB<T, 3> CenterBounds;
+	};
+
+	struct FBuildBin
+	{
+		TAABB<T, 3> Bounds = TAABB<T, 3>::EmptyAABB();
+		TAABB<T, 3> CenterBounds = TAABB<T, 3>::EmptyAABB();
+		int32 Num = 0;
+
+		void Add(const TAABB<T, 3>& ElemBounds, const TVector<T, 3>& Center)
+		{
+			Bounds.GrowToInclude(ElemBounds);
+			CenterBounds.GrowToInclude(Center);
+			Num++;
+		}
+
+		void Add(const FBuildBin& Other)
+		{
+			if (Other.Num)
+			{
+				Bounds.GrowToInclude(Other.Bounds);
+				CenterBounds.GrowToInclude(Other.CenterBounds);
+				Num += Other.Num;
+			}
+		}
+	};
+
+	struct FBuildBins
+	{
+		FBuildBin Bins[3][WideAABBTreeBuild::NumBins];
+	};
+
+	/** Subtree built on a worker thread once the top of the tree is built */
+	struct FBuildSubtree
+	{
+		int32 ParentNodeIdx;
+		int32 ParentChild;
+		int32 Depth;
+		FBuildRange Range;
+	};
+
+	struct FBuildContext
+	{
+		const TArray<FElement>& BuildElems;
+		/** element indices, partitioned in place while building */
+		TArray<int32> Order;
+		TArray<TVector<T, 3>> Centers;
+		/** ranges with fewer elements are deferred to FBuildSubtree */
+		int32 MaxDeferredNum;
+
+		explicit FBuildContext(const TArray<FElement>& InBuildElems)
+			: BuildElems(InBuildElems)
+			, MaxDeferredNum(0)
+		{
+		}
+	};
+
+	template <typename TParticles>
+	void GenerateTree(const TParticles& Particles)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_WideAABBTreeGenerateTree);
+
+		TArray<FElement> BuildElems;
+		BuildElems.Reserve(Particles.Num());
+
+		GlobalPayloads.Reset();
+		DirtyElements.Reset();
+		PayloadToInfo.Reset();
+
+		int32 Idx = 0;
+		for (auto& Particle : Particles)
+		{
+			bool bHasBoundingBox = HasBoundingBox(Particle);
+			auto Payload = Particle.template GetPayload<TPayloadType>(Idx);
+			TAABB<T, 3> ElemBounds = ComputeWorldSpaceBoundingBox(Particle, false, (T)0);
+
+			if (bHasBoundingBox && ElemBounds.Extents().Max() <= MaxPayloadBounds)
+			{
+				BuildElems.Add(FElement{ Payload, ElemBounds });
+			}
+			else
+			{
+				if (!bHasBoundingBox)
+				{
+					ElemBounds = TAABB<T, 3>(TVector<T, 3>(TNumericLimits<T>::Lowest()), TVector<T, 3>(TNumericLimits<T>::Max()));
+				}
+
+				PayloadToInfo.Add(Payload, FAABBTreePayloadInfo{ GlobalPayloads.Num(), INDEX_NONE, INDEX_NONE });
+				GlobalPayloads.Add(FElement{ Payload, ElemBounds });
+			}
+
+			++Idx;
+		}
+
+		BuildTree(BuildElems);
+	}
+
+	void BuildTree(const TArray<FElement>& BuildElems)
+	{
+		Nodes.Reset();
+		Elems.Reset();
+		ElemLeafSlots.Reset();
+
+		const int32 NumElems = BuildElems.Num();
+		if (NumElems == 0)
+		{
+			return;
+		}
+
+		FBuildContext Context(BuildElems);
+		Context.Order.SetNumUninitialized(NumElems);
+		Context.Centers.SetNumUninitialized(NumElems);
+
+		FBuildRange RootRange{ 0, NumElems, TAABB<T, 3>::EmptyAABB(), TAABB<T, 3>::EmptyAABB() };
+		for (int32 ElemIdx = 0; ElemIdx < NumElems; ElemIdx++)
+		{
+			Context.Order[ElemIdx] = ElemIdx;
+			Context.Centers[ElemIdx] = BuildElems[ElemIdx].Bounds.Center();
+			RootRange.Bounds.GrowToInclude(BuildElems[ElemIdx].Bounds);
+			RootRange.CenterBounds.GrowToInclude(Context.Centers[ElemIdx]);
+		}
+
+		const bool bParallelBuild = NumElems >= WideAABBTreeBuild::MinParallelBuildElems;
+		if (bParallelBuild)
+		{
+			// build the top of the tree here, with parallel binning of large ranges, then its subtrees on worker threads
+			Context.MaxDeferredNum = NumElems / WideAABBTreeBuild::ParallelSubtreesDivisor;
+
+			TArray<FBuildSubtree> Subtrees;
+			BuildNode(Context, RootRange, 0, Nodes, &Subtrees);
+
+			TArray<TArray<FNode>> SubtreeNodes;
+			SubtreeNodes.SetNum(Subtrees.Num());
+			PhysicsParallelFor(Subtrees.Num(), [this, &Context, &Subtrees, &SubtreeNodes](int32 SubtreeIdx)
+			{
+				BuildNode(Context, Subtrees[SubtreeIdx].Range, Subtrees[SubtreeIdx].Depth, SubtreeNodes[SubtreeIdx], nullptr);
+			});
+
+			for (int32 SubtreeIdx = 0; SubtreeIdx < Subtrees.Num(); SubtreeIdx++)
+			{
+				const int32 NodeOffset = Nodes.Num();
+				for (FNode& Node : SubtreeNodes[SubtreeIdx])
+				{
+					for (int32 Child = 0; Child < Node.NumChildren; Child++)
+					{
+						if (!Node.IsLeafChild(Child))
+						{
+							Node.Children[Child] += NodeOffset;
+						}
+					}
+				}
+
+				Nodes.Append(SubtreeNodes[SubtreeIdx]);
+				Nodes[Subtrees[SubtreeIdx].ParentNodeIdx].Children[Subtrees[SubtreeIdx].ParentChild] = NodeOffset;
+			}
+		}
+		else
+		{
+			BuildNode(Context, RootRange, 0, Nodes, nullptr);
+		}
+
+		// store elements in leaf order
+		Elems.SetNumUninitialized(NumElems);
+		ElemLeafSlots.SetNumUninitialized(NumElems);
+		for (int32 ElemIdx = 0; ElemIdx < NumElems; ElemIdx++)
+		{
+			Elems[ElemIdx] = BuildElems[Context.Order[ElemIdx]];
+		}
+
+		for (int32 NodeIdx = 0; NodeIdx < Nodes.Num(); NodeIdx++)
+		{
+			const FNode& Node = Nodes[NodeIdx];
+			for (int32 Child = 0; Child < Node.NumChildren; Child++)
+			{
+				if (Node.IsLeafChild(Child))
+				{
+					for (int32 ElemIdx = Node.Children[Child]; ElemIdx < Node.Children[Child] + Node.NumLeafElems[Child]; ElemIdx++)
+					{
+						ElemLeafSlots[ElemIdx] = NodeIdx * NodeWidth + Child;
+						PayloadToInfo.Add(Elems[ElemIdx].Payload, FAABBTreePayloadInfo{ INDEX_NONE, INDEX_NONE, ElemIdx });
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Builds the node of Range and its subtree into OutNodes, @return index of the node.
+	 * Child nodes with ranges of at most Context.MaxDeferredNum elements are added to OutSubtrees instead, when given.
+	 */
+	int32 BuildNode(FBuildContext& Context, const FBuildRange& Range, const int32 Depth, TArray<FNode>& OutNodes, TArray<FBuildSubtree>* OutSubtrees)
+	{
+		// split the child with the largest surface until the node is full
+		FBuildRange ChildRanges[NodeWidth];
+		ChildRanges[0] = Range;
+		int32 NumChildRanges = 1;
+
+		while (NumChildRanges < NodeWidth)
+		{
+			int32 SplitChild = INDEX_NONE;
+			T SplitChildArea = -1;
+			for (int32 Child = 0; Child < NumChildRanges; Child++)
+			{
+				const T ChildArea = ChildRanges[Child].Bounds.GetArea();
+				if (ChildRanges[Child].Num > MaxChildrenInLeaf && ChildArea > SplitChildArea)
+				{
+					SplitChild = Child;
+					SplitChildArea = ChildArea;
+				}
+			}
+
+			if (SplitChild == INDEX_NONE)
+			{
+				break;
+			}
+
+			const FBuildRange SplitRange = ChildRanges[SplitChild];
+			SplitBuildRange(Context, SplitRange, ChildRanges[SplitChild], ChildRanges[NumChildRanges], OutSubtrees != nullptr);
+			NumChildRanges++;
+		}
+
+		FNode Node;
+		Node.SetBounds(Range.Bounds);
+		Node.NumChildren = (uint8)NumChildRanges;
+
+		for (int32 Child = 0; Child < NumChildRanges; Child++)
+		{
+			Node.SetChildBounds(Child, ChildRanges[Child].Bounds);
+			if (ChildRanges[Child].Num <= MaxChildrenInLeaf || Depth + 1 >= MaxTreeDepth)
+			{
+				Node.LeafMask |= 1 << Child;
+				Node.Children[Child] = ChildRanges[Child].Start;
+				Node.NumLeafElems[Child] = ChildRanges[Child].Num;
+			}
+		}
+
+		const int32 NodeIdx = OutNodes.Add(Node);
+		for (int32 Child = 0; Child < NumChildRanges; Child++)
+		{
+			if (!Node.IsLeafChild(Child))
+			{
+				if (OutSubtrees && ChildRanges[Child].Num <= Context.MaxDeferredNum)
+				{
+					OutSubtrees->Add(FBuildSubtree{ NodeIdx, Child, Depth + 1, ChildRanges[Child] });
+				}
+				else
+				{
+					const int32 ChildNodeIdx = BuildNode(Context, ChildRanges[Child], Depth + 1, OutNodes, OutSubtrees);
+					OutNodes[NodeIdx].Children[Child] = ChildNodeIdx;
+				}
+			}
+		}
+
+		return NodeIdx;
+	}
+
+	FORCEINLINE static int32 GetBinIdx(const FBuildRange& Range, const TVector<T, 3>& BinScale, const TVector<T, 3>& Center, const int32 Axis)
+	{
+		return FMath::Clamp((int32)((Center[Axis] - Range.CenterBounds.Min()[Axis]) * BinScale[Axis]), 0, WideAABBTreeBuild::NumBins - 1);
+	}
+
+	void AddToBins(const FBuildContext& Context, const FBuildRange& Range, const TVector<T, 3>& BinScale, const int32 First, const int32 Last, FBuildBins& OutBins) const
+	{
+		for (int32 OrderIdx = First; OrderIdx < Last; OrderIdx++)
+		{
+			const int32 ElemIdx = Context.Order[OrderIdx];
+			const TVector<T, 3>& Center = Context.Centers[ElemIdx];
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				OutBins.Bins[Axis][GetBinIdx(Range, BinScale, Center, Axis)].Add(Context.BuildElems[ElemIdx].Bounds, Center);
+			}
+		}
+	}
+
+	/** Splits Range in two by binned SAH, falls back to splitting it in half when all centers fall into the same bin */
+	void SplitBuildRange(FBuildContext& Context, const FBuildRange& Range, FBuildRange& OutLeft, FBuildRange& OutRight, const bool bParallelBinning) const
+	{
+		using namespace WideAABBTreeBuild;
+
+		const TVector<T, 3> CenterExtents = Range.CenterBounds.Extents();
+		TVector<T, 3> BinScale;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			BinScale[Axis] = CenterExtents[Axis] > 0 ? NumBins / CenterExtents[Axis] : 0;
+		}
+
+		FBuildBins Bins;
+		const int32 RangeEnd = Range.Start + Range.Num;
+		if (bParallelBinning && Range.Num >= 2 * BinningChunkSize)
+		{
+			const int32 NumChunks = FMath::DivideAndRoundUp(Range.Num, BinningChunkSize);
+			TArray<FBuildBins> ChunkBins;
+			ChunkBins.SetNum(NumChunks);
+			PhysicsParallelFor(NumChunks, [this, &Context, &Range, &BinScale, &ChunkBins, RangeEnd](int32 ChunkIdx)
+			{
+				const int32 First = Range.Start + ChunkIdx * BinningChunkSize;
+				AddToBins(Context, Range, BinScale, First, FMath::Min(First + BinningChunkSize, RangeEnd), ChunkBins[ChunkIdx]);
+			});
+
+			for (const FBuildBins& Chunk : ChunkBins)
+			{
+				for (int32 Axis = 0; Axis < 3; Axis++)
+				{
+					for (int32 BinIdx = 0; BinIdx < NumBins; BinIdx++)
+					{
+						Bins.Bins[Axis][BinIdx].Add(Chunk.Bins[Axis][BinIdx]);
+					}
+				}
+			}
+		}
+		else
+		{
+			AddToBins(Context, Range, BinScale, Range.Start, RangeEnd, Bins);
+		}
+
+		// cost of split after bin SplitBin is area * number of elements on both sides
+		int32 BestAxis = INDEX_NONE;
+		int32 BestSplitBin = INDEX_NONE;
+		T BestCost = TNumericLimits<T>::Max();
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			T RightCosts[NumBins];
+			FBuildBin Right;
+			for (int32 BinIdx = NumBins - 1; BinIdx > 0; BinIdx--)
+			{
+				Right.Add(Bins.Bins[Axis][BinIdx]);
+				RightCosts[BinIdx - 1] = Right.Num ? Right.Bounds.GetArea() * Right.Num : 0;
+			}
+
+			FBuildBin Left;
+			for (int32 SplitBin = 0; SplitBin < NumBins - 1; SplitBin++)
+			{
+				Left.Add(Bins.Bins[Axis][SplitBin]);
+				if (Left.Num == 0 || Left.Num == Range.Num)
+				{
+					continue;
+				}
+
+				const T Cost = Left.Bounds.GetArea() * Left.Num + RightCosts[SplitBin];
+				if (Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestAxis = Axis;
+					BestSplitBin = SplitBin;
+				}
+			}
+		}
+
+		int32* RangeOrder = Context.Order.GetData() + Range.Start;
+		int32 NumLeft = 0;
+		if (BestAxis != INDEX_NONE)
+		{
+			for (int32 Idx = 0; Idx < Range.Num; Idx++)
+			{
+				if (GetBinIdx(Range, BinScale, Context.Centers[RangeOrder[Idx]], BestAxis) <= BestSplitBin)
+				{
+					Swap(RangeOrder[Idx], RangeOrder[NumLeft]);
+					NumLeft++;
+				}
+			}
+		}
+		else
+		{
+			// centers are all in the same bin, any split is as good as another
+			NumLeft = Range.Num / 2;
+		}
+
+		OutLeft = FBuildRange{ Range.Start, NumLeft, TAABB<T, 3>::EmptyAABB(), TAABB<T, 3>::EmptyAABB() };
+		OutRight = FBuildRange{ Range.Start + NumLeft, Range.Num - NumLeft, TAABB<T, 3>::EmptyAABB(), TAABB<T, 3>::EmptyAABB() };
+		if (BestAxis != INDEX_NONE)
+		{
+			FBuildBin LeftBins;
+			FBuildBin RightBins;
+			for (int32 BinIdx = 0; BinIdx < NumBins; BinIdx++)
+			{
+				(BinIdx <= BestSplitBin ? LeftBins : RightBins).Add(Bins.Bins[BestAxis][BinIdx]);
+			}
+
+			OutLeft.Bounds = LeftBins.Bounds;
+			OutLeft.CenterBounds = LeftBins.CenterBounds;
+			OutRight.Bounds = RightBins.Bounds;
+			OutRight.CenterBounds = RightBins.CenterBounds;
+		}
+		else
+		{
+			for (FBuildRange* Half : { &OutLeft, &OutRight })
+			{
+				for (int32 OrderIdx = Half->Start; OrderIdx < Half->Start + Half->Num; OrderIdx++)
+				{
+					const int32 ElemIdx = Context.Order[OrderIdx];
+					Half->Bounds.GrowToInclude(Context.BuildElems[ElemIdx].Bounds);
+					Half->CenterBounds.GrowToInclude(Context.Centers[ElemIdx]);
+				}
+			}
+		}
+	}
+
+	/** Nodes of the tree, root first */
+	TArray<FNode> Nodes;
+	/** Elements of all leaves, every leaf owns a range of them */
+	TArray<FElement> Elems;
+	/** Leaf of every element, as NodeIdx * NodeWidth + Child */
+	TArray<int32> ElemLeafSlots;
+	TArray<FElement> DirtyElements;
+	TArray<FElement> GlobalPayloads;
+	/** LeafIdx of payload infos is the index of the element in Elems */
+	TArrayAsMap<TPayloadType, FAABBTreePayloadInfo> PayloadToInfo;
+
+	int32 MaxChildrenInLeaf;
+	int32 MaxTreeDepth;
+	T MaxPayloadBounds;
+};
+
+template <typename TPayloadType, typename T, int32 NodeWidth>
+FChaosArchive& operator<<(FChaosArchive& Ar, TWideAABBTree<TPayloadType, T, NodeWidth>& WideAABBTree)
+{
+	WideAABBTree.Serialize(Ar);
+	return Ar;
+}
+
+}
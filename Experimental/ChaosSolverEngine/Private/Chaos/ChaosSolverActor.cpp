@@ -10,6 +10,7 @@
 #include "ChaosSolversModule.h"
 #include "Chaos/ChaosGameplayEventDispatcher.h"
 #include "Chaos/Framework/DebugSubstep.h"
+#include "Chaos/Collision/SweepAndPrune.h"
 
 //DEFINE_LOG_CATEGORY_STATIC(AFA_Log, NoLogging, All);
 
@@ -202,6 +203,8 @@ AChaosSolverActor::AChaosSolverActor(const FObjectInitializer& ObjectInitializer
 	, FloorHeight(0.f)
 	, MassScale(1.f)
 	, bGenerateContactGraph(true)
+	, bOverrideUseSweepAndPrune(false)
+	, bUseSweepAndPrune(false)
 	, ChaosDebugSubstepControl()
 {
 	// @question(Benn) : Does this need to be created on the Physics thread using a queued command?
@@ -291,7 +294,9 @@ void AChaosSolverActor::BeginPlay()
 			, InHasFloor = bHasFloor
 			, InFloorHeight = FloorHeight
 			, InMassScale = MassScale
-			, InGenerateContactGraph = bGenerateContactGraph]
+			, InGenerateContactGraph = bGenerateContactGraph
+			, InOverrideUseSweepAndPrune = bOverrideUseSweepAndPrune
+			, InUseSweepAndPrune = bUseSweepAndPrune]
 		(Chaos::FPhysicsSolver* InSolver)
 		{
 #if TODO_REIMPLEMENT_SOLVER_SETTINGS_ACCESSORS
@@ -309,6 +314,10 @@ void AChaosSolverActor::BeginPlay()
 			InSolver->SetBreakingFilterSettings(InBreakingFilterSettings);
 			InSolver->SetTrailingFilterSettings(InTrailingFilterSettings);
 			InSolver->SetUseContactGraph(InGenerateContactGraph);
+			if (InOverrideUseSweepAndPrune)
+			{
+				InSolver->SetUseSweepAndPrune(InUseSweepAndPrune);
+			}
 
 #if TODO_REIMPLEMENT_SOLVER_SETTINGS_ACCESSORS
 			InSolver->SetMassScale(InMassScale);
@@ -536,6 +545,16 @@ void AChaosSolverActor::PostEditChangeProperty(struct FPropertyChangedEvent& Pro
 				{
 				});
 			}
+			else if (PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(AChaosSolverActor, bUseSweepAndPrune)
+				|| PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(AChaosSolverActor, bOverrideUseSweepAndPrune))
+			{
+				// without the override, go back to the broad phase chosen by p.Chaos.BroadPhase.SweepAndPrune
+				PhysDispatcher->EnqueueCommandImmediate(Solver, [InUseSweepAndPrune = bOverrideUseSweepAndPrune ? bUseSweepAndPrune : (Chaos::Chaos_BroadPhase_SweepAndPrune != 0)]
+				(Chaos::FPhysicsSolver* InSolver)
+				{
+					InSolver->SetUseSweepAndPrune(InUseSweepAndPrune);
+				});
+			}
 
 #if TODO_REIMPLEMENT_TIMESTEP_MULTIPLIER
 			else if (PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(AChaosSolverActor, MassScale))
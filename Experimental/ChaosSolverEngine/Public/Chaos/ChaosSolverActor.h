@@ -165,6 +165,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChaosPhysics", meta = (DisplayName = "Generate Contact Graph"))
 	bool bGenerateContactGraph;
 
+	/*
+	* Override the broad phase chosen by p.Chaos.BroadPhase.SweepAndPrune with bUseSweepAndPrune.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChaosPhysics", meta = (InlineEditConditionToggle))
+	bool bOverrideUseSweepAndPrune;
+
+	/*
+	* Find overlapping pairs with an incremental sweep and prune rather than a spatial query per moving body.
+	* Usually faster with many slowly moving bodies.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ChaosPhysics", meta = (DisplayName = "Use Sweep And Prune Broad Phase", EditCondition = "bOverrideUseSweepAndPrune"))
+	bool bUseSweepAndPrune;
+
 	/*
 	* Control to pause/step/substep the solver to the next synchronization point.
 	*/
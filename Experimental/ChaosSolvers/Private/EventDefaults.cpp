@@ -476,6 +476,7 @@ namespace Chaos
 
 			Chaos::FPBDRigidsSolver* NonConstSolver = (Chaos::FPBDRigidsSolver*)(Solver);
 
+			NonConstSolver->Particles.GatherSleepData();
 			NonConstSolver->Particles.GetDynamicParticles().GetSleepDataLock().ReadLock();
 			auto& SolverSleepingData = NonConstSolver->Particles.GetDynamicParticles().GetSleepData();
 			for(const TSleepData<float, 3>& SleepData : SolverSleepingData)
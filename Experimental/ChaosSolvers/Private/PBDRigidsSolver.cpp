@@ -28,6 +28,8 @@ int32 ChaosSolverDrawCollisions = 0;
 int32 ChaosSolverDrawBPBounds = 0;
 FAutoConsoleVariableRef CVarChaosSolverDrawCollisions(TEXT("p.Chaos.Solver.DebugDrawCollisions"), ChaosSolverDrawCollisions, TEXT("Draw Collisions (0 = never; 1 = end of frame)."));
 FAutoConsoleVariableRef CVarChaosSolverDrawBPBounds(TEXT("p.Chaos.Solver.DrawBPBounds"), ChaosSolverDrawBPBounds, TEXT("Draw bounding volumes inside the broadphase (0 = never; 1 = end of frame)."));
+int32 ChaosSolverDrawIslands = 0;
+FAutoConsoleVariableRef CVarChaosSolverDrawIslands(TEXT("p.Chaos.Solver.DebugDrawIslands"), ChaosSolverDrawIslands, TEXT("Draw the bounds of the islands with their size, estimated cost, solver task and solve time (0 = never; 1 = end of frame). Times need p.Chaos.Solver.IslandStats."));
 #endif
 
 bool ChaosSolverUseParticlePool = true;
@@ -134,6 +136,11 @@ namespace Chaos
 					}
 
 					MSolver->GetEvolution()->AdvanceOneTimeStep(DeltaTime);
+
+					if (FRewindData* RewindData = MSolver->GetRewindData())
+					{
+						RewindData->CaptureFrame(*MSolver->GetEvolution(), DeltaTime);
+					}
 				}
 
 #if CHAOS_CHECKED
@@ -442,6 +449,14 @@ namespace Chaos
 
 			Solver->MParticleToProxy.Remove(Handle);
 
+			if (Solver->MRewindData)
+			{
+				if (TPBDRigidParticleHandle<float, 3>* RigidHandle = Handle->CastToRigidParticle())
+				{
+					Solver->MRewindData->RemoveParticle(RigidHandle);
+				}
+			}
+
 			// Use the handle to destroy the particle data
 			Solver->GetEvolution()->DestroyParticle(Handle);
 
@@ -539,6 +554,10 @@ namespace Chaos
 		MMinDeltaTime = 1.e-10f;
 		MMaxSubSteps = 1;
 		MEvolution = TUniquePtr<FPBDRigidsEvolution>(new FPBDRigidsEvolution(Particles, ChaosSolverCollisionDefaultIterationsCVar, ChaosSolverCollisionDefaultPushoutIterationsCVar, BufferMode == EMultiBufferMode::Single)); 
+		if (MRewindData)
+		{
+			MRewindData->Reset();
+		}
 
 		FEventDefaults::RegisterSystemEvents(*GetEventManager());
 	}
@@ -560,6 +579,31 @@ namespace Chaos
 
 	}
 
+	void FPBDRigidsSolver::EnableRewindCapture(const int32 NumFrames)
+	{
+		if (NumFrames <= 0)
+		{
+			MRewindData.Reset();
+		}
+		else if (!MRewindData || MRewindData->GetMaxFrames() != NumFrames)
+		{
+			MRewindData = MakeUnique<FRewindData>(NumFrames);
+		}
+	}
+
+	bool FPBDRigidsSolver::RewindAndResimulate(const int32 NumFrames, TArrayView<const FRewindCorrection> Corrections)
+	{
+		if (!MRewindData || !MRewindData->Resimulate(*GetEvolution(), NumFrames, Corrections))
+		{
+			UE_LOG(LogPBDRigidsSolver, Warning, TEXT("PBDRigidsSolver::RewindAndResimulate(%d) - Not enough frames captured"), NumFrames);
+			return false;
+		}
+
+		UE_LOG(LogPBDRigidsSolver, Verbose, TEXT("PBDRigidsSolver::RewindAndResimulate(%d) - %.3f ms, %d particles simulated, %d replayed, %.1f KB of history"), NumFrames,
+			MRewindData->GetLastResimSeconds() * 1000.0, MRewindData->GetLastResimNumSimulated(), MRewindData->GetLastResimNumReplayed(), MRewindData->GetAllocatedSize() / 1024.0);
+		return true;
+	}
+
 	void FPBDRigidsSolver::SyncEvents_GameThread()
 	{
 		GetEventManager()->DispatchEvents();
@@ -934,6 +978,9 @@ namespace Chaos
 		if (ChaosSolverDrawCollisions == 1) {
 			DebugDraw::DrawCollisions(TRigidTransform<float, 3>(), GetEvolution()->GetCollisionConstraints(), 1.f);
 		}
+		if (ChaosSolverDrawIslands == 1) {
+			DebugDraw::DrawIslands(TRigidTransform<float, 3>(), GetEvolution()->GetConstraintGraph(), GetEvolution()->GetIslandStats());
+		}
 #endif
 	}
 
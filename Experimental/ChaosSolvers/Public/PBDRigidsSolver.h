@@ -13,6 +13,7 @@
 #include "Chaos/PBDJointConstraints.h"
 #include "Chaos/PBDConstraintRule.h"
 #include "Chaos/PerParticleGravity.h"
+#include "Chaos/RewindData.h"
 #include "Chaos/ParticleHandle.h"
 #include "Chaos/Transform.h"
 #include "Chaos/Framework/PhysicsProxy.h"
@@ -102,7 +103,7 @@ namespace Chaos
 		typedef TPBDRigidDynamicSpringConstraints<float, 3> FRigidDynamicSpringConstraints;
 		typedef TPBDPositionConstraints<float, 3> FPositionConstraints;
 
-		typedef TPBDConstraintIslandRule<FPBDJointConstraints> FJointConstraintsRule;
+		typedef TPBDConstraintColorBatchRule<FPBDJointConstraints> FJointConstraintsRule;
 		typedef TPBDConstraintIslandRule<FRigidDynamicSpringConstraints> FRigidDynamicSpringConstraintsRule;
 		typedef TPBDConstraintIslandRule<FPositionConstraints> FPositionConstraintsRule;
 
@@ -262,6 +263,14 @@ namespace Chaos
 		void SetPushOutIterations(const int32 InNumIterations) {  GetEvolution()->SetNumPushOutIterations(InNumIterations); }
 		void SetPushOutPairIterations(const int32 InNumIterations) {  GetEvolution()->GetCollisionConstraints().SetPushOutPairIterations(InNumIterations); }
 		void SetUseContactGraph(const bool bInUseContactGraph) { GetEvolution()->GetCollisionConstraintsRule().SetUseContactGraph(bInUseContactGraph); }
+		void SetUseSweepAndPrune(const bool bInUseSweepAndPrune) { GetEvolution()->GetCollisionDetector().GetBroadPhase().SetUseSweepAndPrune(bInUseSweepAndPrune); }
+
+		/** Keep the history of the last NumFrames steps to rewind and resimulate them, 0 to stop */
+		void EnableRewindCapture(const int32 NumFrames);
+		FRewindData* GetRewindData() { return MRewindData.Get(); }
+
+		/** Rewind NumFrames steps, apply the corrections and replay the steps, only the islands of the corrected particles are simulated */
+		bool RewindAndResimulate(const int32 NumFrames, TArrayView<const FRewindCorrection> Corrections);
 
 		/**/
 		void SetGenerateCollisionData(bool bDoGenerate) { GetEventFilters()->SetGenerateCollisionEvents(bDoGenerate); }
@@ -397,6 +406,7 @@ namespace Chaos
 		TUniquePtr<FEventManager> MEventManager;
 		TUniquePtr<FSolverEventFilters> MSolverEventFilters;
 		TUniquePtr<FActiveParticlesBuffer> MActiveParticlesBuffer;
+		TUniquePtr<FRewindData> MRewindData;
 		TMap<const Chaos::TGeometryParticleHandle<float, 3>*, TSet<IPhysicsProxyBase*> > MParticleToProxy;
 
 		//
@@ -17,6 +17,7 @@
 #include "NavMesh/RecastQueryFilter.h"
 #include "NavLinkCustomInterface.h"
 #include "VisualLogger/VisualLogger.h"
+#include "Misc/ScopeRWLock.h"
 
 
 //----------------------------------------------------------------------//
@@ -33,13 +34,13 @@ static_assert(RECAST_UNWALKABLE_POLY_COST == DT_UNWALKABLE_POLY_COST, "Unwalkabl
 
 /// Helper for accessing navigation query from different threads
 #define INITIALIZE_NAVQUERY_SIMPLE(NavQueryVariable, NumNodes)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(SharedNavQuery);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(DetourNavMesh, NumNodes);
 
 #define INITIALIZE_NAVQUERY(NavQueryVariable, NumNodes, LinkFilter)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(SharedNavQuery);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(DetourNavMesh, NumNodes, &LinkFilter);
 
 static void* DetourMalloc(int Size, dtAllocHint)
@@ -251,6 +252,122 @@ void FRecastSpeciaLinkFilter::initialize()
 	CachedOwnerOb = SearchOwner.Get();
 }
 
+//----------------------------------------------------------------------//
+// FRecastNavQueryScope
+//----------------------------------------------------------------------//
+
+namespace RecastNavQueryPool
+{
+	/** Number of released queries kept by each thread, any more are freed */
+	static const int32 MaxPooledQueries = 4;
+
+	struct FThreadPool
+	{
+		TArray<dtNavMeshQuery*, TInlineAllocator<MaxPooledQueries>> FreeQueries;
+
+		~FThreadPool()
+		{
+			for (dtNavMeshQuery* Query : FreeQueries)
+			{
+				dtFreeNavMeshQuery(Query);
+			}
+		}
+	};
+
+	static thread_local FThreadPool ThreadPool;
+}
+
+FRecastNavQueryScope::FRecastNavQueryScope(dtNavMeshQuery& GameThreadQuery)
+	: Query(&GameThreadQuery)
+	, bPooled(false)
+{
+	if (!IsInGameThread())
+	{
+		RecastNavQueryPool::FThreadPool& Pool = RecastNavQueryPool::ThreadPool;
+		Query = Pool.FreeQueries.Num() > 0 ? Pool.FreeQueries.Pop(/*bAllowShrinking=*/false) : dtAllocNavMeshQuery();
+		bPooled = true;
+	}
+}
+
+FRecastNavQueryScope::~FRecastNavQueryScope()
+{
+	if (bPooled)
+	{
+		RecastNavQueryPool::FThreadPool& Pool = RecastNavQueryPool::ThreadPool;
+		if (Pool.FreeQueries.Num() < RecastNavQueryPool::MaxPooledQueries)
+		{
+			// don't keep a dangling pointer to the scope's link filter around
+			Query->updateLinkFilter(nullptr);
+			Pool.FreeQueries.Push(Query);
+		}
+		else
+		{
+			dtFreeNavMeshQuery(Query);
+		}
+	}
+}
+
+//----------------------------------------------------------------------//
+// FRecastPathCorridorCache
+//----------------------------------------------------------------------//
+
+namespace RecastPathCorridorCache
+{
+	static thread_local FRecastPathCorridorCache* ActiveCache = nullptr;
+}
+
+FRecastPathCorridorCache::FScope::FScope(FRecastPathCorridorCache& Cache)
+	: PreviousCache(RecastPathCorridorCache::ActiveCache)
+{
+	RecastPathCorridorCache::ActiveCache = &Cache;
+}
+
+FRecastPathCorridorCache::FScope::~FScope()
+{
+	RecastPathCorridorCache::ActiveCache = PreviousCache;
+}
+
+FRecastPathCorridorCache* FRecastPathCorridorCache::GetActive()
+{
+	return RecastPathCorridorCache::ActiveCache;
+}
+
+bool FRecastPathCorridorCache::Find(const FKey& Key, dtQueryResult& OutResult, dtStatus& OutStatus) const
+{
+	FRWScopeLock ScopeLock(EntriesLock, SLT_ReadOnly);
+
+	const TUniquePtr<FEntry>* Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	OutResult.copyFrom((*Entry)->Result);
+	OutStatus = (*Entry)->Status;
+	NumHits.Increment();
+
+	return true;
+}
+
+void FRecastPathCorridorCache::Add(const FKey& Key, const dtQueryResult& Result, dtStatus Status)
+{
+	FRWScopeLock ScopeLock(EntriesLock, SLT_Write);
+
+	TUniquePtr<FEntry>& Entry = Entries.FindOrAdd(Key);
+	if (!Entry.IsValid())
+	{
+		Entry = MakeUnique<FEntry>();
+		Entry->Result.copyFrom(Result);
+		Entry->Status = Status;
+	}
+}
+
+int32 FRecastPathCorridorCache::Num() const
+{
+	FRWScopeLock ScopeLock(EntriesLock, SLT_ReadOnly);
+	return Entries.Num();
+}
+
 //----------------------------------------------------------------------//
 // FPImplRecastNavMesh
 //----------------------------------------------------------------------//
@@ -794,7 +911,7 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartL
 }
 
 // @TODONAV
-ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartLoc, const FVector& EndLoc, const float CostLimit, FNavMeshPath& Path, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner) const
+ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartLoc, const FVector& EndLoc, const float CostLimit, FNavMeshPath& Path, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner, const bool bUseClusterGraph) const
 {
 	// temporarily disabling this check due to it causing too much "crashes"
 	// @todo but it needs to be back at some point since it realy checks for a buggy setup
@@ -830,9 +947,37 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartL
 		return ENavigationQueryResult::Error;
 	}
 
-	// get path corridor
+	// get path corridor, reusing one found for the same start and end locations in the current batch of queries when possible
 	dtQueryResult PathResult;
-	const dtStatus FindPathStatus = NavQuery.findPath(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
+	dtStatus FindPathStatus = DT_FAILURE;
+
+	FRecastPathCorridorCache* CorridorCache = FRecastPathCorridorCache::GetActive();
+	FRecastPathCorridorCache::FKey CorridorKey;
+	if (CorridorCache)
+	{
+		CorridorKey.NavMesh = DetourNavMesh;
+		CorridorKey.Filter = QueryFilter;
+		CorridorKey.LinkOwner = (LinkFilter.NavSys && LinkFilter.NavSys->HasCustomLinks()) ? Owner : nullptr;
+		CorridorKey.StartPoly = StartPolyID;
+		CorridorKey.EndPoly = EndPolyID;
+		CorridorKey.StartPos = RecastStartPos;
+		CorridorKey.EndPos = RecastEndPos;
+		CorridorKey.CostLimit = CostLimit;
+		CorridorKey.MaxSearchNodes = InQueryFilter.GetMaxSearchNodes();
+		CorridorKey.bUseClusterGraph = bUseClusterGraph;
+	}
+
+	if (CorridorCache == nullptr || !CorridorCache->Find(CorridorKey, PathResult, FindPathStatus))
+	{
+		FindPathStatus = bUseClusterGraph
+			? NavQuery.findPathHierarchical(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0)
+			: NavQuery.findPath(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
+
+		if (CorridorCache && dtStatusSucceed(FindPathStatus))
+		{
+			CorridorCache->Add(CorridorKey, PathResult, FindPathStatus);
+		}
+	}
 
 	// check for special case, where path has not been found, and starting polygon
 	// was the one closest to the target
@@ -881,7 +1026,7 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartL
 	return DTStatusToNavQueryResult(FindPathStatus);
 }
 
-ENavigationQueryResult::Type FPImplRecastNavMesh::TestPath(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner, int32* NumVisitedNodes) const
+ENavigationQueryResult::Type FPImplRecastNavMesh::TestPath(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner, int32* NumVisitedNodes, const bool bUseClusterGraph) const
 {
 	const dtQueryFilter* QueryFilter = ((const FRecastQueryFilter*)(InQueryFilter.GetImplementation()))->GetAsDetourQueryFilter();
 	if (QueryFilter == NULL)
@@ -904,8 +1049,9 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::TestPath(const FVector& StartL
 	// get path corridor
 	dtQueryResult PathResult;
 	const float CostLimit = FLT_MAX;
-	const dtStatus FindPathStatus = NavQuery.findPath(StartPolyID, EndPolyID,
-		&RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
+	const dtStatus FindPathStatus = bUseClusterGraph
+		? NavQuery.findPathHierarchical(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0)
+		: NavQuery.findPath(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
 
 	if (NumVisitedNodes)
 	{
@@ -938,6 +1084,30 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::TestClusterPath(const FVector&
 	return DTStatusToNavQueryResult(status);
 }
 
+bool FPImplRecastNavMesh::MayHaveClusterPath(const FVector& StartLoc, const FVector& EndLoc) const
+{
+	if (DetourNavMesh == nullptr || NavMeshOwner == nullptr)
+	{
+		return true;
+	}
+
+	FVector RecastStartPos, RecastEndPos;
+	NavNodeRef StartPolyID, EndPolyID;
+	const dtQueryFilter* ClusterFilter = ((const FRecastQueryFilter*)NavMeshOwner->GetDefaultQueryFilterImpl())->GetAsDetourQueryFilter();
+
+	INITIALIZE_NAVQUERY_SIMPLE(ClusterQuery, NavMeshOwner->DefaultMaxHierarchicalSearchNodes);
+
+	const bool bCanSearch = InitPathfinding(StartLoc, EndLoc, ClusterQuery, ClusterFilter, RecastStartPos, StartPolyID, RecastEndPos, EndPolyID);
+	if (!bCanSearch)
+	{
+		// let the regular search report the error
+		return true;
+	}
+
+	const dtStatus Status = ClusterQuery.testClusterPath(StartPolyID, EndPolyID);
+	return dtStatusSucceed(Status) || dtStatusDetail(Status, DT_INVALID_PARAM | DT_OUT_OF_NODES);
+}
+
 bool FPImplRecastNavMesh::InitPathfinding(const FVector& UnrealStart, const FVector& UnrealEnd,
 	const dtNavMeshQuery& Query, const dtQueryFilter* Filter,
 	FVector& RecastStart, dtPolyRef& StartPoly,
@@ -8,6 +8,7 @@
 #include "Engine/Engine.h"
 #include "DrawDebugHelpers.h"
 #include "Misc/ConfigCacheIni.h"
+#include "HAL/IConsoleManager.h"
 #include "EngineUtils.h"
 #include "NavMesh/RecastHelpers.h"
 #include "NavMesh/RecastVersion.h"
@@ -33,19 +34,37 @@
 #if WITH_RECAST
 /// Helper for accessing navigation query from different threads
 #define INITIALIZE_NAVQUERY(NavQueryVariable, NumNodes)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? RecastNavMeshImpl->SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(RecastNavMeshImpl->SharedNavQuery);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(RecastNavMeshImpl->DetourNavMesh, NumNodes);
 
 #define INITIALIZE_NAVQUERY_WLINKFILTER(NavQueryVariable, NumNodes, LinkFilter)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? RecastNavMeshImpl->SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(RecastNavMeshImpl->SharedNavQuery);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(RecastNavMeshImpl->DetourNavMesh, NumNodes, &LinkFilter);
 
 #endif // WITH_RECAST
 
 static const int32 ArbitraryMaxVoxelTileSize = 1024;
 
+#if WITH_RECAST
+static float GHierarchicalPreSearchMinDistance = 0.f;
+static FAutoConsoleVariableRef CVarHierarchicalPreSearchMinDistance(
+	TEXT("ai.nav.HierarchicalPreSearchMinDistance"),
+	GHierarchicalPreSearchMinDistance,
+	TEXT("Path queries that don't allow partial paths, use the default query filter, and span at least this distance, are first tested\n")
+	TEXT("against the navmesh cluster graph, and fail without a full search when the clusters can't be connected. 0 disables (default)."),
+	ECVF_Default);
+
+static float GHierarchicalPathMinDistance = 0.f;
+static FAutoConsoleVariableRef CVarHierarchicalPathMinDistance(
+	TEXT("ai.nav.HierarchicalPathMinDistance"),
+	GHierarchicalPathMinDistance,
+	TEXT("Regular path queries that span at least this distance search the navmesh cluster graph first, and refine the cluster path\n")
+	TEXT("over polygons, like hierarchical queries do. 0 disables (default)."),
+	ECVF_Default);
+#endif // WITH_RECAST
+
 FNavMeshTileData::FNavData::~FNavData()
 {
 #if WITH_RECAST
@@ -311,7 +330,7 @@ ARecastNavMesh::ARecastNavMesh(const FObjectInitializer& ObjectInitializer)
 		INC_DWORD_STAT_BY( STAT_NavigationMemory, sizeof(*this) );
 
 		FindPathImplementation = FindPath;
-		FindHierarchicalPathImplementation = FindPath;
+		FindHierarchicalPathImplementation = FindHierarchicalPath;
 
 		TestPathImplementation = TestPath;
 		TestHierarchicalPathImplementation = TestHierarchicalPath;
@@ -1907,6 +1926,9 @@ uint32 ARecastNavMesh::LogMemUsed() const
 	const int32 headerSize = dtAlign4(sizeof(dtMeshHeader));
 
 	uint32 MemUsed = 0;
+	uint32 ClusterGraphMemUsed = 0;
+	int32 NumClusters = 0;
+	int32 NumClusterLinks = 0;
 
 	if (RecastNavMeshImpl && RecastNavMeshImpl->DetourNavMesh)
 	{
@@ -1936,15 +1958,147 @@ uint32 ARecastNavMesh::LogMemUsed() const
 					clusterSize + polyClustersSize;
 
 				MemUsed += TileDataSize;
+
+				// cluster graph: clusters and poly to cluster map stored in the tile data, and cluster links allocated when connecting tiles
+				const int32 ClusterLinksSize = sizeof(dtClusterLink) * Tile->dynamicLinksC.size();
+				ClusterGraphMemUsed += clusterSize + (H->clusterCount > 0 ? dtAlign4(sizeof(unsigned short) * H->offMeshBase) : 0) + ClusterLinksSize;
+				MemUsed += ClusterLinksSize;
+				NumClusters += H->clusterCount;
+				NumClusterLinks += Tile->dynamicLinksC.size();
 			}
 		}
 	}
 
 	UE_LOG(LogNavigation, Warning, TEXT("%s: ARecastNavMesh: %u\n    self: %d"), *GetName(), MemUsed, sizeof(ARecastNavMesh));	
+	UE_LOG(LogNavigation, Warning, TEXT("    cluster graph: %u (%.1f%%), %d clusters, %d cluster links"), ClusterGraphMemUsed,
+		MemUsed > 0 ? 100.f * ClusterGraphMemUsed / MemUsed : 0.f, NumClusters, NumClusterLinks);
 
 	return MemUsed + SuperMemUsed;
 }
 
+void ARecastNavMesh::BenchmarkHierarchicalPathfinding(int32 NumQueries, float MinDistance) const
+{
+	if (RecastNavMeshImpl == nullptr || RecastNavMeshImpl->DetourNavMesh == nullptr || NumQueries <= 0)
+	{
+		return;
+	}
+
+	struct FSearchStats
+	{
+		TArray<double> Times;
+		int64 NumVisitedNodes = 0;
+		int32 NumFound = 0;
+
+		double GetPercentile(const double Fraction) const
+		{
+			return Times.Num() > 0 ? Times[FMath::Clamp(FMath::CeilToInt(Fraction * Times.Num()) - 1, 0, Times.Num() - 1)] : 0.;
+		}
+	};
+
+	FSearchStats Stats[2];
+	const FNavigationQueryFilter& Filter = *GetDefaultQueryFilter();
+	const int32 MaxAttempts = NumQueries * 10;
+	int32 NumPairs = 0;
+
+	for (int32 Attempt = 0; Attempt < MaxAttempts && NumPairs < NumQueries; ++Attempt)
+	{
+		const FNavLocation Start = GetRandomPoint();
+		const FNavLocation End = GetRandomPoint();
+		if (FVector::DistSquared(Start.Location, End.Location) < FMath::Square(MinDistance))
+		{
+			continue;
+		}
+
+		++NumPairs;
+		for (int32 Mode = 0; Mode < 2; ++Mode)
+		{
+			int32 NumVisitedNodes = 0;
+			const double StartTime = FPlatformTime::Seconds();
+			const ENavigationQueryResult::Type Result = RecastNavMeshImpl->TestPath(Start.Location, End.Location, Filter, nullptr, &NumVisitedNodes, /*bUseClusterGraph=*/Mode == 1);
+
+			Stats[Mode].Times.Add((FPlatformTime::Seconds() - StartTime) * 1000.);
+			Stats[Mode].NumVisitedNodes += NumVisitedNodes;
+			Stats[Mode].NumFound += (Result == ENavigationQueryResult::Success) ? 1 : 0;
+		}
+	}
+
+	UE_LOG(LogNavigation, Display, TEXT("%s: hierarchical path finding benchmark, %d queries at least %.0f apart"), *GetName(), NumPairs, MinDistance);
+	for (int32 Mode = 0; Mode < 2 && NumPairs > 0; ++Mode)
+	{
+		FSearchStats& ModeStats = Stats[Mode];
+		ModeStats.Times.Sort();
+		UE_LOG(LogNavigation, Display, TEXT("  %s: %d found, avg %.1f visited nodes, p50 %.3f ms, p99 %.3f ms, max %.3f ms"),
+			Mode == 0 ? TEXT("Polygons") : TEXT("Clusters"), ModeStats.NumFound, double(ModeStats.NumVisitedNodes) / NumPairs,
+			ModeStats.GetPercentile(0.5), ModeStats.GetPercentile(0.99), ModeStats.Times.Last());
+	}
+}
+
+static void BenchmarkHierarchicalPathfindingCommand(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumQueries = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+	const float MinDistance = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10000.f;
+
+	for (TActorIterator<ARecastNavMesh> It(World); It; ++It)
+	{
+		It->BenchmarkHierarchicalPathfinding(NumQueries, MinDistance);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkHierarchicalPathfindingCmd(
+	TEXT("ai.nav.HierarchicalPathBenchmark"),
+	TEXT("Compares visited nodes and search times of path finding over polygons and using the cluster graph, on all navmeshes.\n")
+	TEXT("Usage: ai.nav.HierarchicalPathBenchmark [NumQueries=1000] [MinDistance=10000]. Memory used by the cluster graph is reported by CountNavMem."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkHierarchicalPathfindingCommand));
+
+static void TileRebuildStatsCommand(const TArray<FString>& Args, UWorld* World)
+{
+	const bool bReset = Args.Num() > 0 && Args[0] == TEXT("reset");
+
+	for (TActorIterator<ARecastNavMesh> It(World); It; ++It)
+	{
+		FRecastNavMeshGenerator* MyGenerator = static_cast<FRecastNavMeshGenerator*>(It->GetGenerator());
+		if (MyGenerator == nullptr)
+		{
+			continue;
+		}
+
+		const FRecastTileRebuildLatencyStats Stats = MyGenerator->GetTileRebuildLatencyStats();
+		UE_LOG(LogNavigation, Display, TEXT("%s: %d tiles rebuilt, latency p50 %.1f ms, p99 %.1f ms, max %.1f ms, %d pending, %d running, %d dirty areas coalesced"),
+			*It->GetName(), Stats.NumSamples, Stats.P50 * 1000.f, Stats.P99 * 1000.f, Stats.Max * 1000.f,
+			MyGenerator->GetNumRemaningBuildTasks() - MyGenerator->GetNumRunningBuildTasks(), MyGenerator->GetNumRunningBuildTasks(), Stats.NumCoalescedDirtyAreas);
+
+		if (bReset)
+		{
+			MyGenerator->ResetTileRebuildLatencyStats();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TileRebuildStatsCmd(
+	TEXT("ai.nav.TileRebuildStats"),
+	TEXT("Logs the time between navmesh tiles being marked dirty and their rebuilt data being added, for the most recent tiles of all navmeshes.\n")
+	TEXT("Usage: ai.nav.TileRebuildStats [reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(TileRebuildStatsCommand));
+
+static void TileGenerationBenchmarkCommand(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumTiles = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+
+	for (TActorIterator<ARecastNavMesh> It(World); It; ++It)
+	{
+		if (FRecastNavMeshGenerator* MyGenerator = static_cast<FRecastNavMeshGenerator*>(It->GetGenerator()))
+		{
+			MyGenerator->BenchmarkTileGeneration(NumTiles);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TileGenerationBenchmarkCmd(
+	TEXT("ai.nav.TileGenerationBenchmark"),
+	TEXT("Generates navmesh tiles with and without batched triangle culling on all navmeshes, compares timings and checks that the generated data is identical.\n")
+	TEXT("Usage: ai.nav.TileGenerationBenchmark [NumTiles=100]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(TileGenerationBenchmarkCommand));
+
 #endif // !UE_BUILD_SHIPPING
 
 uint16 ARecastNavMesh::GetDefaultForbiddenFlags() const
@@ -2073,6 +2227,19 @@ bool ARecastNavMesh::AdjustLocationWithFilter(const FVector& StartLoc, FVector&
 }
 
 FPathFindingResult ARecastNavMesh::FindPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query)
+{
+	const bool bUseClusterGraph = GHierarchicalPathMinDistance > 0.f
+		&& FVector::DistSquared(Query.StartLocation, Query.EndLocation) >= FMath::Square(GHierarchicalPathMinDistance);
+
+	return FindPathInternal(Query, bUseClusterGraph);
+}
+
+FPathFindingResult ARecastNavMesh::FindHierarchicalPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query)
+{
+	return FindPathInternal(Query, /*bUseClusterGraph=*/true);
+}
+
+FPathFindingResult ARecastNavMesh::FindPathInternal(const FPathFindingQuery& Query, bool bUseClusterGraph)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Navigation_RecastPathfinding);
 	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(Pathfinding);
@@ -2115,9 +2282,17 @@ FPathFindingResult ARecastNavMesh::FindPath(const FNavAgentProperties& AgentProp
 			Result.Path->GetPathPoints().Add(FNavPathPoint(AdjustedEndLocation));
 			Result.Result = ENavigationQueryResult::Success;
 		}
+		else if (!Query.bAllowPartialPaths && GHierarchicalPreSearchMinDistance > 0.f
+			&& Query.QueryFilter == RecastNavMesh->GetDefaultQueryFilter()
+			&& FVector::DistSquared(Query.StartLocation, AdjustedEndLocation) >= FMath::Square(GHierarchicalPreSearchMinDistance)
+			&& !RecastNavMesh->RecastNavMeshImpl->MayHaveClusterPath(Query.StartLocation, AdjustedEndLocation))
+		{
+			// unreachable goals make the regular search exhaust its node pool, without a result we could use
+			Result.Result = ENavigationQueryResult::Fail;
+		}
 		else
 		{
-			Result.Result = RecastNavMesh->RecastNavMeshImpl->FindPath(Query.StartLocation, AdjustedEndLocation, Query.CostLimit, *NavMeshPath, *NavFilter, Query.Owner.Get());
+			Result.Result = RecastNavMesh->RecastNavMeshImpl->FindPath(Query.StartLocation, AdjustedEndLocation, Query.CostLimit, *NavMeshPath, *NavFilter, Query.Owner.Get(), bUseClusterGraph);
 
 			const bool bPartialPath = Result.IsPartial();
 			if (bPartialPath)
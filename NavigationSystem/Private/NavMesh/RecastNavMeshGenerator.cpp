@@ -8,6 +8,7 @@
 #include "Serialization/MemoryWriter.h"
 #include "EngineGlobals.h"
 #include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
 #include "Engine/Engine.h"
 #include "NavigationSystem.h"
 #include "FramePro/FrameProProfiler.h"
@@ -62,6 +63,27 @@ struct dtTileCacheAlloc;
 static int32 GNavmeshSynchronousTileGeneration = 0;
 static FAutoConsoleVariableRef NavmeshVarSynchronous(TEXT("n.GNavmeshSynchronousTileGeneration"), GNavmeshSynchronousTileGeneration, TEXT(""), ECVF_Default);
 
+namespace TileRebuild
+{
+	static int32 bSplitStages = 1;
+	static FAutoConsoleVariableRef CVarSplitStages(TEXT("ai.nav.TileRebuild.SplitStages"), bSplitStages,
+		TEXT("If enabled, async tile generation runs voxelization and polygonization as separate tasks, so that no single task holds a worker for a whole tile."), ECVF_Default);
+
+	static float ApplyBudgetMs = 0.f;
+	static FAutoConsoleVariableRef CVarApplyBudgetMs(TEXT("ai.nav.TileRebuild.ApplyBudgetMs"), ApplyBudgetMs,
+		TEXT("Game thread time per frame allowed for adding generated tiles to the navmesh, in milliseconds. At least one tile is added each frame. 0 means unlimited."), ECVF_Default);
+
+	static int32 bSeedFromAgents = 1;
+	static FAutoConsoleVariableRef CVarSeedFromAgents(TEXT("ai.nav.TileRebuild.SeedFromAgents"), bSeedFromAgents,
+		TEXT("If enabled, dirty tiles close to navigation invokers and moving AI pawns are rebuilt first, in addition to the ones close to players."), ECVF_Default);
+
+	static constexpr int32 MaxLatencySamples = 1024;
+}
+
+static int32 GNavmeshBatchedTriangleCulling = 1;
+static FAutoConsoleVariableRef NavmeshVarBatchedTriangleCulling(TEXT("ai.nav.BatchedTriangleCulling"), GNavmeshBatchedTriangleCulling,
+	TEXT("If enabled, collision triangles are tested against the tile in SIMD batches of 4 before rasterization. Generated navmesh is the same either way, see ai.nav.TileGenerationBenchmark."), ECVF_Default);
+
 #if RECAST_INTERNAL_DEBUG_DATA
 static int32 GNavmeshDisplayStep = 0;
 static int32 GNavmeshDebugTileX = 1;
@@ -1860,6 +1882,7 @@ FRecastTileGenerator::FRecastTileGenerator(FRecastNavMeshGenerator& ParentGenera
 {
 	bUpdateGeometry = true;
 	bHasLowAreaModifiers = false;
+	bBatchedTriangleCulling = (GNavmeshBatchedTriangleCulling != 0);
 
 	TileX = Location.X;
 	TileY = Location.Y;
@@ -2052,6 +2075,45 @@ bool FRecastTileGenerator::DoWork()
 	return bSucceess;
 }
 
+bool FRecastTileGenerator::DoVoxelizationWork()
+{
+	TSharedPtr<FNavDataGenerator, ESPMode::ThreadSafe> ParentGenerator = ParentGeneratorWeakPtr.Pin();
+	bool bSucceess = false;
+
+	if (ParentGenerator.IsValid())
+	{
+		if (InclusionBounds.Num())
+		{
+			DoAsyncGeometryGathering();
+		}
+
+		bSucceess = GenerateTileLayers();
+	}
+
+	if (!bSucceess)
+	{
+		DumpAsyncData();
+	}
+
+	return bSucceess;
+}
+
+bool FRecastTileGenerator::DoPolygonizationWork()
+{
+	TSharedPtr<FNavDataGenerator, ESPMode::ThreadSafe> ParentGenerator = ParentGeneratorWeakPtr.Pin();
+	bool bSucceess = false;
+
+	if (ParentGenerator.IsValid())
+	{
+		FNavMeshBuildContext BuildContext(*this);
+		bSucceess = GenerateNavigationData(BuildContext);
+	}
+
+	DumpAsyncData();
+
+	return bSucceess;
+}
+
 void FRecastTileGenerator::DumpAsyncData()
 {
 	RawGeometry.Empty();
@@ -2166,11 +2228,8 @@ void FRecastTileGenerator::PrepareGeometrySources(const FRecastNavMeshGenerator&
 	NavOctree = NavOctreeInstance->AsShared();
 	bUpdateGeometry = bGeometryChanged;
 
-	for (FNavigationOctree::TConstElementBoxIterator<FNavigationOctree::DefaultStackAllocator> It(*NavOctreeInstance, ParentGenerator.GrowBoundingBox(TileBB, /*bIncludeAgentHeight*/ false));
-		It.HasPendingElements();
-		It.Advance())
+	NavOctreeInstance->FindElementsInBox(ParentGenerator.GrowBoundingBox(TileBB, /*bIncludeAgentHeight*/ false), [this, bGeometryChanged](const FNavigationOctreeElement& Element)
 	{
-		const FNavigationOctreeElement& Element = It.GetCurrentElement();
 		const bool bShouldUse = Element.ShouldUseGeometry(NavDataConfig);
 		if (bShouldUse)
 		{
@@ -2181,7 +2240,7 @@ void FRecastTileGenerator::PrepareGeometrySources(const FRecastNavMeshGenerator&
 				NavigationRelevantData.Add(Element.Data);
 			}
 		}
-	}
+	});
 }
 
 void FRecastTileGenerator::GatherGeometry(const FRecastNavMeshGenerator& ParentGenerator, bool bGeometryChanged)
@@ -2196,11 +2255,8 @@ void FRecastTileGenerator::GatherGeometry(const FRecastNavMeshGenerator& ParentG
 	}
 	const FNavDataConfig& OwnerNavDataConfig = ParentGenerator.GetOwner()->GetConfig();
 
-	for (FNavigationOctree::TConstElementBoxIterator<FNavigationOctree::DefaultStackAllocator> It(*NavigationOctree, ParentGenerator.GrowBoundingBox(TileBB, /*bIncludeAgentHeight*/ false));
-		It.HasPendingElements();
-		It.Advance())
+	NavigationOctree->FindElementsInBox(ParentGenerator.GrowBoundingBox(TileBB, /*bIncludeAgentHeight*/ false), [this, NavigationOctree, &OwnerNavDataConfig, bGeometryChanged](const FNavigationOctreeElement& Element)
 	{
-		const FNavigationOctreeElement& Element = It.GetCurrentElement();
 		const bool bShouldUse = Element.ShouldUseGeometry(OwnerNavDataConfig);
 		if (bShouldUse)
 		{
@@ -2285,7 +2341,7 @@ void FRecastTileGenerator::GatherGeometry(const FRecastNavMeshGenerator& ParentG
 				AppendModifier(ModifierInstance, Element.Data->NavDataPerInstanceTransformDelegate);
 			}
 		}
-	}
+	});
 }
 
 void FRecastTileGenerator::ApplyVoxelFilter(rcHeightfield* HF, float WalkableRadius)
@@ -2626,11 +2682,25 @@ ETimeSliceWorkResult FRecastTileGenerator::GenerateTileTimeSliced()
 
 bool FRecastTileGenerator::GenerateTile()
 {
-	FNavMeshBuildContext BuildContext(*this);
+	bool bSuccess = GenerateTileLayers();
+
+	if (bSuccess)
+	{
+		FNavMeshBuildContext BuildContext(*this);
+		bSuccess = GenerateNavigationData(BuildContext);
+	}
+
+	// it's possible to have valid generation with empty resulting tile (no navigable geometry in tile)
+	return bSuccess;
+}
+
+bool FRecastTileGenerator::GenerateTileLayers()
+{
 	bool bSuccess = true;
 
 	if (bRegenerateCompressedLayers)
 	{
+		FNavMeshBuildContext BuildContext(*this);
 		CompressedLayers.Reset();
 
 		bSuccess = GenerateCompressedLayers(BuildContext);
@@ -2642,12 +2712,6 @@ bool FRecastTileGenerator::GenerateTile()
 		}
 	}
 
-	if (bSuccess)
-	{
-		bSuccess = GenerateNavigationData(BuildContext);
-	}
-
-	// it's possible to have valid generation with empty resulting tile (no navigable geometry in tile)
 	return bSuccess;
 }
 
@@ -2745,7 +2809,7 @@ ETimeSliceWorkResult FRecastTileGenerator::RasterizeGeometryRecastTimeSliced(FNa
 		rcRasterizeTriangles(&BuildContext,
 			Coords.GetData(), NumVerts,
 			Indices.GetData(), RasterizeGeomRecastTriAreas.GetData(), NumFaces,
-			*RasterContext.SolidHF, TileConfig.walkableClimb, RasterizationFlags);
+			*RasterContext.SolidHF, TileConfig.walkableClimb, bBatchedTriangleCulling ? RasterizationFlags : (RasterizationFlags | RC_NO_BATCHED_TRIANGLE_CULLING));
 
 		RasterizeGeomRecastTriAreas.Reset();
 
@@ -2788,7 +2852,7 @@ void FRecastTileGenerator::RasterizeGeometryRecast(FNavMeshBuildContext& BuildCo
 		rcRasterizeTriangles(&BuildContext,
 			Coords.GetData(), NumVerts,
 			Indices.GetData(), RasterizeGeomRecastTriAreas.GetData(), NumFaces,
-			*RasterContext.SolidHF, TileConfig.walkableClimb, RasterizationFlags);
+			*RasterContext.SolidHF, TileConfig.walkableClimb, bBatchedTriangleCulling ? RasterizationFlags : (RasterizationFlags | RC_NO_BATCHED_TRIANGLE_CULLING));
 	}
 
 	RasterizeGeomRecastTriAreas.Reset();
@@ -4147,6 +4211,8 @@ FRecastNavMeshGenerator::FRecastNavMeshGenerator(ARecastNavMesh& InDestNavMesh)
 	, bRestrictBuildingToActiveTiles(false)
 	, bSortTilesWithSeedLocations(true)
 	, Version(0)
+	, NextTileRebuildLatencyIdx(0)
+	, NumCoalescedDirtyAreas(0)
 {
 	INC_DWORD_STAT_BY(STAT_NavigationMemory, sizeof(*this));
 }
@@ -4721,6 +4787,7 @@ void FRecastNavMeshGenerator::ReAddTiles(const TArray<FIntPoint>& Tiles)
 	dtNavMesh* DetourMesh = DestNavMesh->GetRecastNavMeshImpl()->GetRecastMesh();
 	const dtNavMeshParams* SavedNavParams = DestNavMesh->GetRecastNavMeshImpl()->DetourNavMesh->getParams();
 	const float TileDim = Config.tileSize * Config.cs;
+	const double DirtyTime = FPlatformTime::Seconds();
 
 	TSet<FPendingTileElement> DirtyTiles;
 
@@ -4730,40 +4797,13 @@ void FRecastNavMeshGenerator::ReAddTiles(const TArray<FIntPoint>& Tiles)
 		FPendingTileElement Element;
 		Element.Coord = TileCoords;
 		Element.bRebuildGeometry = true;
+		Element.DirtyTime = DirtyTime;
 		DirtyTiles.Add(Element);
 	}
 
 	int32 NumTilesMarked = DirtyTiles.Num();
 
-	// Merge all pending tiles into one container
-	for (const FPendingTileElement& Element : PendingDirtyTiles)
-	{
-		FPendingTileElement* ExistingElement = DirtyTiles.Find(Element);
-		if (ExistingElement)
-		{
-			ExistingElement->bRebuildGeometry |= Element.bRebuildGeometry;
-			// Append area bounds to existing list 
-			if (ExistingElement->bRebuildGeometry == false)
-			{
-				ExistingElement->DirtyAreas.Append(Element.DirtyAreas);
-			}
-			else
-			{
-				ExistingElement->DirtyAreas.Empty();
-			}
-		}
-		else
-		{
-			DirtyTiles.Add(Element);
-		}
-	}
-
-	// Dump results into array
-	PendingDirtyTiles.Empty(DirtyTiles.Num());
-	for (const FPendingTileElement& Element : DirtyTiles)
-	{
-		PendingDirtyTiles.Add(Element);
-	}
+	MergePendingDirtyTiles(DirtyTiles);
 
 	// Sort tiles by proximity to players 
 	if (NumTilesMarked > 0)
@@ -5206,6 +5246,68 @@ bool FRecastNavMeshGenerator::MarkNavBoundsDirty()
 	return false;
 }
 
+int32 FPendingTileElement::Merge(const FPendingTileElement& Other)
+{
+	int32 NumCoalesced = 0;
+
+	bRebuildGeometry |= Other.bRebuildGeometry;
+	DirtyTime = (DirtyTime > 0. && Other.DirtyTime > 0.) ? FMath::Min(DirtyTime, Other.DirtyTime) : FMath::Max(DirtyTime, Other.DirtyTime);
+
+	// Append area bounds to existing list 
+	if (bRebuildGeometry == false)
+	{
+		const int32 NumExistingAreas = DirtyAreas.Num();
+		for (const FBox& OtherArea : Other.DirtyAreas)
+		{
+			// repeated updates of the same object (moving obstacles, destructibles) keep dirtying the same area
+			bool bIsCovered = false;
+			for (int32 AreaIdx = 0; AreaIdx < NumExistingAreas && !bIsCovered; ++AreaIdx)
+			{
+				bIsCovered = DoesBoxContainBox(DirtyAreas[AreaIdx], OtherArea);
+			}
+
+			if (bIsCovered)
+			{
+				++NumCoalesced;
+			}
+			else
+			{
+				DirtyAreas.Add(OtherArea);
+			}
+		}
+	}
+	else
+	{
+		DirtyAreas.Empty();
+	}
+
+	return NumCoalesced;
+}
+
+void FRecastNavMeshGenerator::MergePendingDirtyTiles(TSet<FPendingTileElement>& DirtyTiles)
+{
+	// Merge all pending tiles into one container
+	for (const FPendingTileElement& Element : PendingDirtyTiles)
+	{
+		FPendingTileElement* ExistingElement = DirtyTiles.Find(Element);
+		if (ExistingElement)
+		{
+			NumCoalescedDirtyAreas += ExistingElement->Merge(Element);
+		}
+		else
+		{
+			DirtyTiles.Add(Element);
+		}
+	}
+
+	// Dump results into array
+	PendingDirtyTiles.Empty(DirtyTiles.Num());
+	for (const FPendingTileElement& Element : DirtyTiles)
+	{
+		PendingDirtyTiles.Add(Element);
+	}
+}
+
 void FRecastNavMeshGenerator::MarkDirtyTiles(const TArray<FNavigationDirtyArea>& DirtyAreas)
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_MarkDirtyTiles);
@@ -5215,6 +5317,7 @@ void FRecastNavMeshGenerator::MarkDirtyTiles(const TArray<FNavigationDirtyArea>&
 	check(TileSizeInWorldUnits > 0);
 
 	const bool bGameStaticNavMesh = IsGameStaticNavMesh(DestNavMesh);
+	const double DirtyTime = FPlatformTime::Seconds();
 		
 	// find all tiles that need regeneration
 	TSet<FPendingTileElement> DirtyTiles;
@@ -5280,6 +5383,7 @@ void FRecastNavMeshGenerator::MarkDirtyTiles(const TArray<FNavigationDirtyArea>&
 				FPendingTileElement Element;
 				Element.Coord = FIntPoint(TileX, TileY);
 				Element.bRebuildGeometry = DirtyArea.HasFlag(ENavigationDirtyFlag::Geometry) || DirtyArea.HasFlag(ENavigationDirtyFlag::NavigationBounds);
+				Element.DirtyTime = DirtyTime;
 				if (Element.bRebuildGeometry == false)
 				{
 					Element.DirtyAreas.Add(AdjustedAreaBounds);
@@ -5288,16 +5392,7 @@ void FRecastNavMeshGenerator::MarkDirtyTiles(const TArray<FNavigationDirtyArea>&
 				FPendingTileElement* ExistingElement = DirtyTiles.Find(Element);
 				if (ExistingElement)
 				{
-					ExistingElement->bRebuildGeometry|= Element.bRebuildGeometry;
-					// Append area bounds to existing list 
-					if (ExistingElement->bRebuildGeometry == false)
-					{
-						ExistingElement->DirtyAreas.Append(Element.DirtyAreas);
-					}
-					else
-					{
-						ExistingElement->DirtyAreas.Empty();
-					}
+					NumCoalescedDirtyAreas += ExistingElement->Merge(Element);
 				}
 				else
 				{
@@ -5309,35 +5404,7 @@ void FRecastNavMeshGenerator::MarkDirtyTiles(const TArray<FNavigationDirtyArea>&
 	
 	int32 NumTilesMarked = DirtyTiles.Num();
 
-	// Merge all pending tiles into one container
-	for (const FPendingTileElement& Element : PendingDirtyTiles)
-	{
-		FPendingTileElement* ExistingElement = DirtyTiles.Find(Element);
-		if (ExistingElement)
-		{
-			ExistingElement->bRebuildGeometry|= Element.bRebuildGeometry;
-			// Append area bounds to existing list 
-			if (ExistingElement->bRebuildGeometry == false)
-			{
-				ExistingElement->DirtyAreas.Append(Element.DirtyAreas);
-			}
-			else
-			{
-				ExistingElement->DirtyAreas.Empty();
-			}
-		}
-		else
-		{
-			DirtyTiles.Add(Element);
-		}
-	}
-	
-	// Dump results into array
-	PendingDirtyTiles.Empty(DirtyTiles.Num());
-	for(const FPendingTileElement& Element : DirtyTiles)
-	{
-		PendingDirtyTiles.Add(Element);
-	}
+	MergePendingDirtyTiles(DirtyTiles);
 
 	// Sort tiles by proximity to players 
 	if (NumTilesMarked > 0)
@@ -5377,6 +5444,8 @@ void FRecastNavMeshGenerator::SortPendingBuildTiles()
 		{
 			const FBox TileBox = CalculateTileBounds(Element.Coord.X, Element.Coord.Y, FVector::ZeroVector, TotalNavBounds, TileSizeInWorldUnits);
 			FVector2D TileCenter2D = FVector2D(TileBox.GetCenter());
+			// seeds move between sorts, don't keep the distance from the previous one
+			Element.SeedDistance = MAX_flt;
 			for (FVector2D SeedLocation : SeedLocations)
 			{
 				Element.SeedDistance = FMath::Min(Element.SeedDistance, FVector2D::DistSquared(TileCenter2D, SeedLocation));
@@ -5400,6 +5469,29 @@ void FRecastNavMeshGenerator::GetSeedLocations(UWorld& World, TArray<FVector2D>&
 			OutSeedLocations.Add(SeedLoc);
 		}
 	}
+
+	if (TileRebuild::bSeedFromAgents)
+	{
+		// Collect invokers, they need their tiles to have any navigation at all
+		if (const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&World))
+		{
+			for (const FNavigationInvokerRaw& Invoker : NavSys->GetInvokerLocations())
+			{
+				OutSeedLocations.Add(FVector2D(Invoker.Location));
+			}
+		}
+
+		// Collect moving AI agents, they are the ones about to query paths through rebuilt tiles
+		for (FConstControllerIterator ControllerIt = World.GetControllerIterator(); ControllerIt; ++ControllerIt)
+		{
+			const AController* Controller = ControllerIt->Get();
+			const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+			if (Pawn && !Controller->IsPlayerController() && !Pawn->GetVelocity().IsNearlyZero())
+			{
+				OutSeedLocations.Add(FVector2D(Pawn->GetActorLocation()));
+			}
+		}
+	}
 }
 
 TSharedRef<FRecastTileGenerator> FRecastNavMeshGenerator::CreateTileGenerator(const FIntPoint& Coord, const TArray<FBox>& DirtyAreas)
@@ -5454,7 +5546,7 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_ProcessTileTasks_NewTasks);
 
 		FPendingTileElement& PendingElement = PendingDirtyTiles[ElementIdx];
-		FRunningTileElement RunningElement(PendingElement.Coord);
+		FRunningTileElement RunningElement(PendingElement);
 		
 		// Make sure that we are not submitting generator for grid cell that is currently being regenerated
 		if (!RunningDirtyTiles.Contains(RunningElement))
@@ -5465,6 +5557,11 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 			// Start it in background in case it has something to build
 			if (TileTask->GetTask().TileGenerator->HasDataToBuild())
 			{
+				if (TileRebuild::bSplitStages)
+				{
+					TileTask->GetTask().Stage = ERecastTileGenerationStage::Voxelization;
+				}
+
 				RunningElement.AsyncTask = TileTask.Release();
 
 				if (!GNavmeshSynchronousTileGeneration)
@@ -5496,6 +5593,9 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 	}
 	
 	// Collect completed tasks and apply generated data to navmesh
+	const double ApplyStartTime = FPlatformTime::Seconds();
+	const double ApplyBudget = TileRebuild::ApplyBudgetMs / 1000.;
+	int32 NumAppliedTiles = 0;
 	for (int32 Idx = RunningDirtyTiles.Num() - 1; Idx >=0; --Idx)
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_ProcessTileTasks_FinishedTasks);
@@ -5505,10 +5605,33 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 
 		if (Element.AsyncTask->IsDone())
 		{
+			FRecastTileGeneratorWrapper& Task = Element.AsyncTask->GetTask();
+
+			// Voxelization is done, queue polygonization as a separate task so that other tiles can be voxelized in between
+			if (Task.Stage == ERecastTileGenerationStage::Voxelization && Task.bStageSucceeded && !Element.bShouldDiscard)
+			{
+				Task.Stage = ERecastTileGenerationStage::Polygonization;
+				if (!GNavmeshSynchronousTileGeneration)
+				{
+					Element.AsyncTask->StartBackgroundTask();
+				}
+				else
+				{
+					Element.AsyncTask->StartSynchronousTask();
+				}
+				continue;
+			}
+
 			// Add generated tiles to navmesh
 			if (!Element.bShouldDiscard)
 			{
-				FRecastTileGenerator& TileGenerator = *(Element.AsyncTask->GetTask().TileGenerator);
+				// Leave the remaining finished tiles for the next frames once the budget is used up
+				if (ApplyBudget > 0. && NumAppliedTiles > 0 && (FPlatformTime::Seconds() - ApplyStartTime) > ApplyBudget)
+				{
+					continue;
+				}
+
+				FRecastTileGenerator& TileGenerator = *(Task.TileGenerator);
 				TArray<uint32> UpdatedTileIndices = AddGeneratedTiles(TileGenerator);
 				UpdatedTiles.Append(UpdatedTileIndices);
 			
@@ -5517,6 +5640,8 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 #if RECAST_INTERNAL_DEBUG_DATA
 				StoreDebugData(TileGenerator, Element.Coord.X, Element.Coord.Y);
 #endif
+				AddTileRebuildLatencySample(Element.DirtyTime);
+				NumAppliedTiles++;
 			}
 
 			{
@@ -5531,10 +5656,133 @@ TArray<uint32> FRecastNavMeshGenerator::ProcessTileTasksAsync(const int32 NumTas
 		}
 	}
 
+	CSV_CUSTOM_STAT(NAVREGEN, NavTilesApplied, NumAppliedTiles, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(NAVREGEN, NavTilesPending, PendingDirtyTiles.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(NAVREGEN, NavTilesRunning, RunningDirtyTiles.Num(), ECsvCustomStatOp::Set);
+
 	return UpdatedTiles;
 }
 #endif
 
+void FRecastNavMeshGenerator::AddTileRebuildLatencySample(double DirtyTime)
+{
+	if (DirtyTime <= 0.)
+	{
+		return;
+	}
+
+	const float Latency = static_cast<float>(FPlatformTime::Seconds() - DirtyTime);
+	if (TileRebuildLatencies.Num() < TileRebuild::MaxLatencySamples)
+	{
+		TileRebuildLatencies.Add(Latency);
+	}
+	else
+	{
+		TileRebuildLatencies[NextTileRebuildLatencyIdx] = Latency;
+	}
+	NextTileRebuildLatencyIdx = (NextTileRebuildLatencyIdx + 1) % TileRebuild::MaxLatencySamples;
+
+	CSV_CUSTOM_STAT(NAVREGEN, NavTileRebuildLatencyMs, Latency * 1000.f, ECsvCustomStatOp::Max);
+}
+
+FRecastTileRebuildLatencyStats FRecastNavMeshGenerator::GetTileRebuildLatencyStats() const
+{
+	FRecastTileRebuildLatencyStats Stats;
+	Stats.NumCoalescedDirtyAreas = NumCoalescedDirtyAreas;
+	Stats.NumSamples = TileRebuildLatencies.Num();
+
+	if (Stats.NumSamples > 0)
+	{
+		TArray<float> SortedLatencies = TileRebuildLatencies;
+		SortedLatencies.Sort();
+
+		Stats.P50 = SortedLatencies[(Stats.NumSamples - 1) / 2];
+		Stats.P99 = SortedLatencies[FMath::Min(Stats.NumSamples - 1, (Stats.NumSamples * 99) / 100)];
+		Stats.Max = SortedLatencies.Last();
+	}
+
+	return Stats;
+}
+
+void FRecastNavMeshGenerator::ResetTileRebuildLatencyStats()
+{
+	TileRebuildLatencies.Reset();
+	NextTileRebuildLatencyIdx = 0;
+	NumCoalescedDirtyAreas = 0;
+}
+
+#if !UE_BUILD_SHIPPING
+void FRecastNavMeshGenerator::BenchmarkTileGeneration(int32 NumTiles)
+{
+	const float TileSizeInWorldUnits = Config.tileSize * Config.cs;
+	const FRcTileBox TileBox(TotalNavBounds, RcNavMeshOrigin, TileSizeInWorldUnits);
+
+	TArray<FIntPoint> Tiles;
+	for (int32 TileY = TileBox.YMin; TileY <= TileBox.YMax && Tiles.Num() < NumTiles; ++TileY)
+	{
+		for (int32 TileX = TileBox.XMin; TileX <= TileBox.XMax && Tiles.Num() < NumTiles; ++TileX)
+		{
+			const FBox TileBounds = CalculateTileBounds(TileX, TileY, RcNavMeshOrigin, TotalNavBounds, TileSizeInWorldUnits);
+			if (IsInActiveSet(FIntPoint(TileX, TileY)) && IntersectBounds(TileBounds, InclusionBounds))
+			{
+				Tiles.Add(FIntPoint(TileX, TileY));
+			}
+		}
+	}
+
+	auto IsSameData = [](const TArray<FNavMeshTileData>& A, const TArray<FNavMeshTileData>& B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return false;
+		}
+		for (int32 Idx = 0; Idx < A.Num(); ++Idx)
+		{
+			if (A[Idx].DataSize != B[Idx].DataSize || (A[Idx].DataSize > 0 && FMemory::Memcmp(A[Idx].GetData(), B[Idx].GetData(), A[Idx].DataSize) != 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	double Times[2] = { 0., 0. };
+	int32 NumBuilt = 0;
+	int32 NumMismatches = 0;
+	for (const FIntPoint& Tile : Tiles)
+	{
+		TSharedPtr<FRecastTileGenerator> Generators[2];
+		for (int32 Mode = 0; Mode < 2; ++Mode)
+		{
+			Generators[Mode] = CreateTileGenerator(Tile, TArray<FBox>());
+			Generators[Mode]->bBatchedTriangleCulling = (Mode == 1);
+			if (!Generators[Mode]->HasDataToBuild())
+			{
+				break;
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			Generators[Mode]->DoWork();
+			Times[Mode] += FPlatformTime::Seconds() - StartTime;
+		}
+
+		if (Generators[1].IsValid())
+		{
+			NumBuilt++;
+			if (!IsSameData(Generators[0]->GetCompressedLayers(), Generators[1]->GetCompressedLayers())
+				|| !IsSameData(Generators[0]->GetNavigationData(), Generators[1]->GetNavigationData()))
+			{
+				UE_LOG(LogNavigation, Warning, TEXT("%s: tile (%d,%d) differs with batched triangle culling"), *GetNameSafe(DestNavMesh), Tile.X, Tile.Y);
+				NumMismatches++;
+			}
+		}
+	}
+
+	UE_LOG(LogNavigation, Display, TEXT("%s: generated %d tiles, per tile %.3f ms one triangle at a time, %.3f ms with batched triangle culling, %d tiles differ"),
+		*GetNameSafe(DestNavMesh), NumBuilt, NumBuilt ? Times[0] * 1000. / NumBuilt : 0., NumBuilt ? Times[1] * 1000. / NumBuilt : 0., NumMismatches);
+}
+#endif // !UE_BUILD_SHIPPING
+
 #if !RECAST_ASYNC_REBUILDING
 TSharedRef<FRecastTileGenerator> FRecastNavMeshGenerator::CreateTileGeneratorFromPendingElement(FIntPoint& OutTileLocation)
 {
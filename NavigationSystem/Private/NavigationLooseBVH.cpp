@@ -0,0 +1,304 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NavigationLooseBVH.h"
+#include "Async/ParallelFor.h"
+
+namespace NavigationLooseBVH
+{
+	/** Pending elements tolerated before rebuilding, as fraction of all elements (queries scan them linearly) */
+	static constexpr int32 MinPendingForRebuild = 32;
+	static constexpr int32 PendingForRebuildDivisor = 8;
+
+	/** Smallest tree level refitted on multiple threads */
+	static constexpr int32 MinParallelRefitNodes = 64;
+}
+
+FNavigationLooseBVH::FNavigationLooseBVH(float InLooseMargin)
+	: NumStaleLeafEntries(0)
+	, NumRefittedElements(0)
+	, LooseMargin(InLooseMargin)
+{
+}
+
+FBox FNavigationLooseBVH::MakeLooseBounds(const FBox& Bounds) const
+{
+	return Bounds.ExpandBy(LooseMargin);
+}
+
+int32 FNavigationLooseBVH::Add(const FBox& Bounds)
+{
+	FElement Element;
+	Element.Bounds = Bounds;
+	Element.LooseBounds = Bounds;
+	Element.State = EElementState::Pending;
+
+	const int32 Id = Elements.Add(Element);
+	PendingIds.Add(Id);
+	return Id;
+}
+
+void FNavigationLooseBVH::AddBatch(TArrayView<const FBox> Bounds, TArray<int32>& OutIds)
+{
+	OutIds.Reset(Bounds.Num());
+	PendingIds.Reserve(PendingIds.Num() + Bounds.Num());
+	for (const FBox& ElementBounds : Bounds)
+	{
+		OutIds.Add(Add(ElementBounds));
+	}
+}
+
+void FNavigationLooseBVH::Remove(int32 Id)
+{
+	if (!Elements.IsValidIndex(Id))
+	{
+		return;
+	}
+
+	const EElementState State = Elements[Id].State;
+	if (State != EElementState::InTree)
+	{
+		PendingIds.RemoveSingleSwap(Id, false);
+	}
+	if (State != EElementState::Pending)
+	{
+		NumStaleLeafEntries++;
+	}
+
+	Elements.RemoveAt(Id);
+}
+
+void FNavigationLooseBVH::RemoveBatch(TArrayView<const int32> Ids)
+{
+	for (const int32 Id : Ids)
+	{
+		Remove(Id);
+	}
+}
+
+void FNavigationLooseBVH::Update(int32 Id, const FBox& NewBounds)
+{
+	if (!Elements.IsValidIndex(Id))
+	{
+		return;
+	}
+
+	FElement& Element = Elements[Id];
+	Element.Bounds = NewBounds;
+
+	// leaf bounds still contain element, nothing to do until it leaves them
+	if (Element.State == EElementState::InTree && !Element.LooseBounds.IsInside(NewBounds))
+	{
+		Element.State = EElementState::Escaped;
+		PendingIds.Add(Id);
+	}
+}
+
+void FNavigationLooseBVH::UpdateBatch(TArrayView<const int32> Ids, TArrayView<const FBox> NewBounds)
+{
+	check(Ids.Num() == NewBounds.Num());
+	for (int32 Index = 0; Index < Ids.Num(); Index++)
+	{
+		Update(Ids[Index], NewBounds[Index]);
+	}
+}
+
+void FNavigationLooseBVH::Reset()
+{
+	Elements.Empty();
+	PendingIds.Empty();
+	Nodes.Empty();
+	LevelStarts.Empty();
+	LeafElementIds.Empty();
+	NumStaleLeafEntries = 0;
+	NumRefittedElements = 0;
+}
+
+void FNavigationLooseBVH::Commit()
+{
+	if (PendingIds.Num() == 0)
+	{
+		return;
+	}
+
+	int32 NumNewElements = 0;
+	for (const int32 Id : PendingIds)
+	{
+		NumNewElements += (Elements[Id].State == EElementState::Pending) ? 1 : 0;
+	}
+
+	const int32 NumEscapedElements = PendingIds.Num() - NumNewElements;
+	const int32 MaxPending = FMath::Max(NavigationLooseBVH::MinPendingForRebuild, Elements.Num() / NavigationLooseBVH::PendingForRebuildDivisor);
+	const bool bShouldRebuild = (Nodes.Num() == 0 && NumNewElements > 0)
+		|| NumNewElements > MaxPending
+		|| NumStaleLeafEntries > LeafElementIds.Num() / 4
+		|| NumRefittedElements + NumEscapedElements > Elements.Num() / 4;
+
+	if (bShouldRebuild)
+	{
+		Rebuild();
+		return;
+	}
+
+	if (NumEscapedElements > 0)
+	{
+		// put escaped elements back into their leaves, new ones stay pending until next rebuild
+		for (int32 PendingIndex = PendingIds.Num() - 1; PendingIndex >= 0; PendingIndex--)
+		{
+			FElement& Element = Elements[PendingIds[PendingIndex]];
+			if (Element.State == EElementState::Escaped)
+			{
+				Element.LooseBounds = MakeLooseBounds(Element.Bounds);
+				Element.State = EElementState::InTree;
+				PendingIds.RemoveAtSwap(PendingIndex, 1, false);
+			}
+		}
+
+		NumRefittedElements += NumEscapedElements;
+		Refit();
+	}
+}
+
+void FNavigationLooseBVH::Rebuild()
+{
+	Nodes.Reset();
+	LevelStarts.Reset();
+	LeafElementIds.Reset(Elements.Num());
+	PendingIds.Reset();
+	NumStaleLeafEntries = 0;
+	NumRefittedElements = 0;
+
+	TArray<FVector> Centers;
+	Centers.Reserve(Elements.GetMaxIndex());
+	Centers.AddUninitialized(Elements.GetMaxIndex());
+
+	for (TSparseArray<FElement>::TIterator It(Elements); It; ++It)
+	{
+		It->LooseBounds = MakeLooseBounds(It->Bounds);
+		It->State = EElementState::InTree;
+		LeafElementIds.Add(It.GetIndex());
+		Centers[It.GetIndex()] = It->Bounds.GetCenter();
+	}
+
+	if (LeafElementIds.Num() == 0)
+	{
+		return;
+	}
+
+	// ranges of LeafElementIds owned by nodes, elements are partitioned in place while building breadth first
+	struct FBuildRange
+	{
+		int32 Start;
+		int32 Num;
+	};
+	TArray<FBuildRange> Ranges;
+
+	Nodes.AddUninitialized(1);
+	Ranges.Add({ 0, LeafElementIds.Num() });
+	LevelStarts.Add(0);
+	int32 LevelEnd = 1;
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		if (NodeIndex == LevelEnd)
+		{
+			LevelStarts.Add(NodeIndex);
+			LevelEnd = Nodes.Num();
+		}
+
+		const FBuildRange Range = Ranges[NodeIndex];
+		int32* RangeIds = LeafElementIds.GetData() + Range.Start;
+
+		FBox Bounds(ForceInit);
+		FBox CenterBounds(ForceInit);
+		for (int32 Index = 0; Index < Range.Num; Index++)
+		{
+			Bounds += Elements[RangeIds[Index]].LooseBounds;
+			CenterBounds += Centers[RangeIds[Index]];
+		}
+
+		Nodes[NodeIndex].Bounds = Bounds;
+
+		if (Range.Num <= MaxLeafElements)
+		{
+			Nodes[NodeIndex].FirstIndex = Range.Start;
+			Nodes[NodeIndex].NumLeafElements = Range.Num;
+			continue;
+		}
+
+		// split in the middle of the longest axis of element centers
+		const FVector CenterSize = CenterBounds.GetSize();
+		const int32 Axis = (CenterSize.X >= CenterSize.Y && CenterSize.X >= CenterSize.Z) ? 0 : (CenterSize.Y >= CenterSize.Z ? 1 : 2);
+		const float SplitPosition = CenterBounds.GetCenter()[Axis];
+
+		int32 NumLeft = 0;
+		for (int32 Index = 0; Index < Range.Num; Index++)
+		{
+			if (Centers[RangeIds[Index]][Axis] < SplitPosition)
+			{
+				Swap(RangeIds[Index], RangeIds[NumLeft]);
+				NumLeft++;
+			}
+		}
+
+		// all centers in the same spot, any split is as good as another
+		if (NumLeft == 0 || NumLeft == Range.Num)
+		{
+			NumLeft = Range.Num / 2;
+		}
+
+		const int32 FirstChild = Nodes.Num();
+		Nodes[NodeIndex].FirstIndex = FirstChild;
+		Nodes[NodeIndex].NumLeafElements = 0;
+
+		Nodes.AddUninitialized(2);
+		Ranges.Add({ Range.Start, NumLeft });
+		Ranges.Add({ Range.Start + NumLeft, Range.Num - NumLeft });
+	}
+
+	LevelStarts.Add(Nodes.Num());
+}
+
+void FNavigationLooseBVH::RefitNode(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	if (Node.IsLeaf())
+	{
+		FBox Bounds(ForceInit);
+		for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumLeafElements; Index++)
+		{
+			const int32 Id = LeafElementIds[Index];
+			if (Elements.IsValidIndex(Id) && Elements[Id].State == EElementState::InTree)
+			{
+				Bounds += Elements[Id].LooseBounds;
+			}
+		}
+		Node.Bounds = Bounds;
+	}
+	else
+	{
+		Node.Bounds = Nodes[Node.FirstIndex].Bounds + Nodes[Node.FirstIndex + 1].Bounds;
+	}
+}
+
+void FNavigationLooseBVH::Refit()
+{
+	// children are always on the next level, refit levels bottom up
+	for (int32 LevelIndex = LevelStarts.Num() - 2; LevelIndex >= 0; LevelIndex--)
+	{
+		const int32 LevelStart = LevelStarts[LevelIndex];
+		const int32 NumLevelNodes = LevelStarts[LevelIndex + 1] - LevelStart;
+
+		ParallelFor(NumLevelNodes, [this, LevelStart](int32 Index)
+		{
+			RefitNode(LevelStart + Index);
+		}, NumLevelNodes < NavigationLooseBVH::MinParallelRefitNodes);
+	}
+}
+
+void FNavigationLooseBVH::FindElementsInBox(const FBox& QueryBox, TArray<int32>& OutIds) const
+{
+	ForEachElementInBox(QueryBox, [&OutIds](int32 Id)
+	{
+		OutIds.Add(Id);
+	});
+}
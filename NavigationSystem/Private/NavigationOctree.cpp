@@ -4,6 +4,16 @@
 #include "AI/Navigation/NavRelevantInterface.h"
 #include "NavigationSystem.h"
 
+namespace FNavigationOctreeCVars
+{
+	static int32 UseBVH = 1;
+	static FAutoConsoleVariableRef CVarUseBVH(
+		TEXT("ai.nav.OctreeBVH"),
+		UseBVH,
+		TEXT("If non-zero, navigation octree elements are mirrored in a loose BVH used for gathering navmesh tile geometry.\n")
+		TEXT("Read when navigation octree is created."),
+		ECVF_Default);
+}
 
 //----------------------------------------------------------------------//
 // FNavigationOctree
@@ -12,6 +22,7 @@ FNavigationOctree::FNavigationOctree(const FVector& Origin, float Radius)
 	: TOctree<FNavigationOctreeElement, FNavigationOctreeSemantics>(Origin, Radius)
 	, DefaultGeometryGatheringMode(ENavDataGatheringMode::Instant)
 	, bGatherGeometry(false)
+	, bUseBVH(FNavigationOctreeCVars::UseBVH != 0)
 	, NodesMemory(0)
 {
 	INC_DWORD_STAT_BY( STAT_NavigationMemory, sizeof(*this) );
@@ -137,6 +148,7 @@ void FNavigationOctree::AddNode(UObject* ElementOb, INavRelevantInterface* NavEl
 	INC_MEMORY_STAT_BY(STAT_Navigation_CollisionTreeMemory, ElementMemory);
 
 	AddElement(Element);
+	AddToBVH(Element);
 }
 
 void FNavigationOctree::AppendToNode(const FOctreeElementId& Id, INavRelevantInterface* NavElement, const FBox& Bounds, FNavigationOctreeElement& Element)
@@ -166,6 +178,7 @@ void FNavigationOctree::AppendToNode(const FOctreeElementId& Id, INavRelevantInt
 
 	RemoveElement(Id);
 	AddElement(Element);
+	AddToBVH(Element);
 }
 
 void FNavigationOctree::UpdateNode(const FOctreeElementId& Id, const FBox& NewBounds)
@@ -174,6 +187,7 @@ void FNavigationOctree::UpdateNode(const FOctreeElementId& Id, const FBox& NewBo
 	RemoveElement(Id);
 	ElementCopy.Bounds = NewBounds;
 	AddElement(ElementCopy);
+	AddToBVH(ElementCopy);
 }
 
 void FNavigationOctree::RemoveNode(const FOctreeElementId& Id)
@@ -183,9 +197,98 @@ void FNavigationOctree::RemoveNode(const FOctreeElementId& Id)
 	NodesMemory -= ElementMemory;
 	DEC_MEMORY_STAT_BY(STAT_Navigation_CollisionTreeMemory, ElementMemory);
 
+	RemoveFromBVH(Element.OwnerUniqueId);
 	RemoveElement(Id);
 }
 
+void FNavigationOctree::AddToBVH(const FNavigationOctreeElement& Element)
+{
+	// registration only records the change, BVH gets all of them in batches on next CommitBVH
+	if (bUseBVH)
+	{
+		PendingBVHElements.Add(Element.OwnerUniqueId, Element);
+	}
+}
+
+void FNavigationOctree::RemoveFromBVH(uint32 OwnerUniqueId)
+{
+	if (bUseBVH)
+	{
+		PendingBVHElements.Remove(OwnerUniqueId);
+		if (ObjectToBVHId.Contains(OwnerUniqueId))
+		{
+			PendingBVHRemovals.Add(OwnerUniqueId);
+		}
+	}
+}
+
+void FNavigationOctree::CommitBVH()
+{
+	if (!bUseBVH || (!HasPendingBVHChanges() && !BVH.HasPendingChanges()))
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_NavigationOctree_CommitBVH);
+
+	if (PendingBVHRemovals.Num() > 0)
+	{
+		TArray<int32> RemovedIds;
+		RemovedIds.Reserve(PendingBVHRemovals.Num());
+		for (const uint32 OwnerUniqueId : PendingBVHRemovals)
+		{
+			int32 BVHId = INDEX_NONE;
+			if (ObjectToBVHId.RemoveAndCopyValue(OwnerUniqueId, BVHId))
+			{
+				RemovedIds.Add(BVHId);
+				BVHElements.RemoveAt(BVHId);
+			}
+		}
+
+		BVH.RemoveBatch(RemovedIds);
+		PendingBVHRemovals.Reset();
+	}
+
+	if (PendingBVHElements.Num() > 0)
+	{
+		// elements already in BVH only get their bounds updated, it's cheap while they stay within loose bounds
+		TArray<int32> UpdatedIds;
+		TArray<FBox> UpdatedBounds;
+		TArray<const FNavigationOctreeElement*> AddedElements;
+		TArray<FBox> AddedBounds;
+
+		for (const TPair<uint32, FNavigationOctreeElement>& Pair : PendingBVHElements)
+		{
+			const FNavigationOctreeElement& Element = Pair.Value;
+			if (const int32* BVHId = ObjectToBVHId.Find(Pair.Key))
+			{
+				BVHElements[*BVHId] = Element;
+				UpdatedIds.Add(*BVHId);
+				UpdatedBounds.Add(Element.Bounds.GetBox());
+			}
+			else
+			{
+				AddedElements.Add(&Element);
+				AddedBounds.Add(Element.Bounds.GetBox());
+			}
+		}
+
+		BVH.UpdateBatch(UpdatedIds, UpdatedBounds);
+
+		TArray<int32> AddedIds;
+		BVH.AddBatch(AddedBounds, AddedIds);
+		for (int32 Index = 0; Index < AddedIds.Num(); Index++)
+		{
+			BVHElements.Insert(AddedIds[Index], *AddedElements[Index]);
+			ObjectToBVHId.Add(AddedElements[Index]->OwnerUniqueId, AddedIds[Index]);
+		}
+
+		PendingBVHElements.Reset();
+	}
+
+	BVH.Commit();
+}
+
 const FNavigationRelevantData* FNavigationOctree::GetDataForID(const FOctreeElementId& Id) const
 {
 	if (Id.IsValidId() == false)
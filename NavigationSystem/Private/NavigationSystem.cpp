@@ -23,11 +23,16 @@
 #include "UObject/Package.h"
 #include "Components/PrimitiveComponent.h"
 #include "UObject/UObjectThreadContext.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 
 #if WITH_RECAST
 #include "NavMesh/RecastNavMesh.h"
 #include "NavMesh/RecastHelpers.h"
 #include "NavMesh/RecastNavMeshGenerator.h"
+#include "NavMesh/PImplRecastNavMesh.h"
 #endif // WITH_RECAST
 #if WITH_EDITOR
 #include "EditorModeManager.h"
@@ -959,6 +964,12 @@ void UNavigationSystemV1::Tick(float DeltaSeconds)
 		}
 		INC_FLOAT_STAT_BY(STAT_Navigation_CumulativeBuildTime,(float)ThisTime*1000);
 	}
+
+	if (DefaultOctreeController.NavOctree.IsValid())
+	{
+		// octree changes of this frame are applied to its BVH at once, before dirty tiles gather their geometry
+		DefaultOctreeController.NavOctree->CommitBVH();
+	}
 		
 	if (IsNavigationBuildingLocked() == false)
 	{
@@ -1122,10 +1133,328 @@ bool UNavigationSystemV1::TestPathSync(FPathFindingQuery Query, EPathFindingMode
 	return bExists;
 }
 
+//----------------------------------------------------------------------//
+// Async path finding
+//----------------------------------------------------------------------//
+namespace AsyncPathFinding
+{
+	static int32 GParallelQueries = 1;
+	static FAutoConsoleVariableRef CVarParallelQueries(
+		TEXT("ai.nav.AsyncPathfinding.Parallel"),
+		GParallelQueries,
+		TEXT("If non-zero, batches of async path finding queries are spread over the task graph worker threads."),
+		ECVF_Default);
+
+	static int32 GMinParallelQueries = 8;
+	static FAutoConsoleVariableRef CVarMinParallelQueries(
+		TEXT("ai.nav.AsyncPathfinding.MinParallelQueries"),
+		GMinParallelQueries,
+		TEXT("Smallest batch of async path finding queries that is spread over worker threads, smaller batches run on a single thread."),
+		ECVF_Default);
+
+	static int32 GShareCorridors = 1;
+	static FAutoConsoleVariableRef CVarShareCorridors(
+		TEXT("ai.nav.AsyncPathfinding.ShareCorridors"),
+		GShareCorridors,
+		TEXT("If non-zero, async path finding queries in the same batch that start and end at the same navmesh locations, with the same filter,\n")
+		TEXT("share a single corridor search. Each query still gets its own string pulled path."),
+		ECVF_Default);
+
+	static int32 GRecordQueries = 0;
+	static FAutoConsoleVariableRef CVarRecordQueries(
+		TEXT("ai.nav.AsyncPathfinding.Record"),
+		GRecordQueries,
+		TEXT("If non-zero, async path finding queries are recorded, to be saved with ai.nav.AsyncPathfinding.SaveRecording."),
+		ECVF_Default);
+
+	/** Async query as recorded for ai.nav.AsyncPathfinding.Benchmark, the query filter and owner are not recorded */
+	struct FRecordedQuery
+	{
+		uint64 Frame = 0;
+		FVector StartLocation = FVector::ZeroVector;
+		FVector EndLocation = FVector::ZeroVector;
+		float AgentRadius = 0.f;
+		float AgentHeight = 0.f;
+		float CostLimit = FLT_MAX;
+		bool bAllowPartialPaths = true;
+		bool bHierarchical = false;
+	};
+
+	/** Queries recorded since recording was enabled, or last saved. Game thread only. */
+	static TArray<FRecordedQuery> RecordedQueries;
+
+	static const TCHAR* RecordingHeader = TEXT("Frame,StartX,StartY,StartZ,EndX,EndY,EndZ,AgentRadius,AgentHeight,CostLimit,AllowPartialPaths,Hierarchical");
+
+	static FString GetRecordingFilename(const FString& Name)
+	{
+		return FPaths::ProfilingDir() / TEXT("NavPathQueries") / (Name.EndsWith(TEXT(".csv")) ? Name : Name + TEXT(".csv"));
+	}
+
+	static void RecordQuery(const FAsyncPathFindingQuery& Query)
+	{
+		FRecordedQuery& Record = RecordedQueries.AddDefaulted_GetRef();
+		Record.Frame = GFrameCounter;
+		Record.StartLocation = Query.StartLocation;
+		Record.EndLocation = Query.EndLocation;
+		Record.AgentRadius = Query.NavAgentProperties.AgentRadius;
+		Record.AgentHeight = Query.NavAgentProperties.AgentHeight;
+		Record.CostLimit = Query.CostLimit;
+		Record.bAllowPartialPaths = Query.bAllowPartialPaths;
+		Record.bHierarchical = (Query.Mode == EPathFindingMode::Hierarchical);
+	}
+
+	static bool SaveRecording(const FString& Filename)
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(RecordedQueries.Num() + 1);
+		Lines.Add(RecordingHeader);
+
+		for (const FRecordedQuery& Record : RecordedQueries)
+		{
+			Lines.Add(FString::Printf(TEXT("%llu,%f,%f,%f,%f,%f,%f,%f,%f,%f,%d,%d"), Record.Frame,
+				Record.StartLocation.X, Record.StartLocation.Y, Record.StartLocation.Z, Record.EndLocation.X, Record.EndLocation.Y, Record.EndLocation.Z,
+				Record.AgentRadius, Record.AgentHeight, Record.CostLimit, Record.bAllowPartialPaths ? 1 : 0, Record.bHierarchical ? 1 : 0));
+		}
+
+		return FFileHelper::SaveStringArrayToFile(Lines, *Filename);
+	}
+
+	static bool LoadRecording(const FString& Filename, TArray<FRecordedQuery>& OutQueries)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename) || Lines.Num() == 0 || Lines[0] != RecordingHeader)
+		{
+			return false;
+		}
+
+		TArray<FString> Values;
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			if (Lines[LineIndex].ParseIntoArray(Values, TEXT(",")) != 12)
+			{
+				continue;
+			}
+
+			FRecordedQuery& Record = OutQueries.AddDefaulted_GetRef();
+			Record.Frame = FCString::Strtoui64(*Values[0], nullptr, 10);
+			Record.StartLocation = FVector(FCString::Atof(*Values[1]), FCString::Atof(*Values[2]), FCString::Atof(*Values[3]));
+			Record.EndLocation = FVector(FCString::Atof(*Values[4]), FCString::Atof(*Values[5]), FCString::Atof(*Values[6]));
+			Record.AgentRadius = FCString::Atof(*Values[7]);
+			Record.AgentHeight = FCString::Atof(*Values[8]);
+			Record.CostLimit = FCString::Atof(*Values[9]);
+			Record.bAllowPartialPaths = FCString::Atoi(*Values[10]) != 0;
+			Record.bHierarchical = FCString::Atoi(*Values[11]) != 0;
+		}
+
+		return true;
+	}
+
+	static void QueryDone(FAsyncPathFindingQuery Query)
+	{
+		CSV_SCOPED_TIMING_STAT(NavigationSystem, AsyncNavQueryFinished);
+
+		Query.OnDoneDelegate.ExecuteIfBound(Query.QueryID, Query.Result.Result, Query.Result.Path);
+	}
+
+	/**
+	 * Runs a batch of queries, spread over worker threads when enabled, and stores their results.
+	 *
+	 * @param Queries				Queries to run
+	 * @param DefaultNavData		Navigation data used by queries that don't specify any
+	 * @param bDispatchResults		If set, each query's delegate is called on the game thread once it's done
+	 * @param OutCompletionTimes	If given, receives the time at which each query was done, in seconds
+	 * @return						Number of queries that reused a corridor found by another query in the batch
+	 */
+	static int32 RunQueries(TArrayView<FAsyncPathFindingQuery> Queries, const ANavigationData* DefaultNavData, bool bDispatchResults, TArray<double>* OutCompletionTimes)
+	{
+#if WITH_RECAST
+		FRecastPathCorridorCache CorridorCache;
+#endif // WITH_RECAST
+
+		if (OutCompletionTimes)
+		{
+			OutCompletionTimes->SetNumZeroed(Queries.Num());
+		}
+
+		const bool bSingleThreaded = (GParallelQueries == 0) || (Queries.Num() < GMinParallelQueries);
+		ParallelFor(Queries.Num(), [&](int32 QueryIndex)
+		{
+#if WITH_RECAST
+			TOptional<FRecastPathCorridorCache::FScope> CorridorCacheScope;
+			if (GShareCorridors)
+			{
+				CorridorCacheScope.Emplace(CorridorCache);
+			}
+#endif // WITH_RECAST
+
+			FAsyncPathFindingQuery& Query = Queries[QueryIndex];
+
+			// @todo this is not necessarily the safest way to use UObjects outside of main thread. 
+			//	think about something else.
+			const ANavigationData* NavData = Query.NavData.IsValid() ? Query.NavData.Get() : DefaultNavData;
+
+			// perform query
+			if (NavData)
+			{
+				if (Query.Mode == EPathFindingMode::Hierarchical)
+				{
+					Query.Result = NavData->FindHierarchicalPath(Query.NavAgentProperties, Query);
+				}
+				else
+				{
+					Query.Result = NavData->FindPath(Query.NavAgentProperties, Query);
+				}
+			}
+			else
+			{
+				Query.Result = ENavigationQueryResult::Error;
+			}
+
+			if (OutCompletionTimes)
+			{
+				(*OutCompletionTimes)[QueryIndex] = FPlatformTime::Seconds();
+			}
+
+			if (bDispatchResults)
+			{
+				// @todo make it return more informative results (bResult == false)
+				// trigger calling delegate on main thread - otherwise it may depend too much on stuff being thread safe
+				DECLARE_CYCLE_STAT(TEXT("FSimpleDelegateGraphTask.Async nav query finished"),
+					STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished,
+					STATGROUP_TaskGraphTasks);
+
+				FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(
+					FSimpleDelegateGraphTask::FDelegate::CreateStatic(QueryDone, Query),
+					GET_STATID(STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished), NULL, ENamedThreads::GameThread);
+			}
+		}, bSingleThreaded);
+
+#if WITH_RECAST
+		return CorridorCache.GetNumHits();
+#else
+		return 0;
+#endif // WITH_RECAST
+	}
+
+	static void SaveRecordingCommand(const TArray<FString>& Args, UWorld* World)
+	{
+		const FString Filename = GetRecordingFilename(Args.Num() > 0 ? Args[0] : FString::Printf(TEXT("NavPathQueries-%s"), *FDateTime::Now().ToString()));
+		const int32 NumQueries = RecordedQueries.Num();
+
+		if (SaveRecording(Filename))
+		{
+			UE_LOG(LogNavigation, Display, TEXT("Saved %d async path finding queries to %s"), NumQueries, *Filename);
+			RecordedQueries.Reset();
+		}
+		else
+		{
+			UE_LOG(LogNavigation, Warning, TEXT("Failed to save async path finding queries to %s"), *Filename);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs SaveRecordingCmd(
+		TEXT("ai.nav.AsyncPathfinding.SaveRecording"),
+		TEXT("Saves the async path finding queries recorded with ai.nav.AsyncPathfinding.Record to the profiling directory. Usage: ai.nav.AsyncPathfinding.SaveRecording [Name]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(SaveRecordingCommand));
+
+	static void BenchmarkCommand(const TArray<FString>& Args, UWorld* World)
+	{
+		UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+		if (Args.Num() < 1 || NavSys == nullptr)
+		{
+			UE_LOG(LogNavigation, Warning, TEXT("Usage: ai.nav.AsyncPathfinding.Benchmark <Name> [Iterations], in a world with a navigation system"));
+			return;
+		}
+
+		TArray<FRecordedQuery> Recording;
+		const FString Filename = GetRecordingFilename(Args[0]);
+		if (!LoadRecording(Filename, Recording) || Recording.Num() == 0)
+		{
+			UE_LOG(LogNavigation, Warning, TEXT("Failed to load async path finding queries from %s"), *Filename);
+			return;
+		}
+
+		const int32 NumIterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1;
+		const ANavigationData* DefaultNavData = NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
+
+		// queries requested in the same frame are replayed as one batch, and latency is measured from the start of the batch
+		TArray<double> Latencies;
+		TArray<double> CompletionTimes;
+		TArray<FAsyncPathFindingQuery> Batch;
+		int32 NumBatches = 0;
+		int32 NumSharedCorridors = 0;
+		double TotalTime = 0.;
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (int32 BatchStart = 0; BatchStart < Recording.Num(); )
+			{
+				Batch.Reset();
+
+				int32 RecordIndex = BatchStart;
+				for (; RecordIndex < Recording.Num() && Recording[RecordIndex].Frame == Recording[BatchStart].Frame; ++RecordIndex)
+				{
+					const FRecordedQuery& Record = Recording[RecordIndex];
+					const FNavAgentProperties AgentProperties(Record.AgentRadius, Record.AgentHeight);
+					const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties);
+					NavData = NavData ? NavData : DefaultNavData;
+
+					if (NavData)
+					{
+						FPathFindingQuery Query(nullptr, *NavData, Record.StartLocation, Record.EndLocation, NavData->GetDefaultQueryFilter(), nullptr, Record.CostLimit);
+						Query.SetAllowPartialPaths(Record.bAllowPartialPaths);
+						Query.SetNavAgentProperties(AgentProperties);
+
+						Batch.Emplace(Query, FNavPathQueryDelegate(), Record.bHierarchical ? EPathFindingMode::Hierarchical : EPathFindingMode::Regular);
+					}
+				}
+				BatchStart = RecordIndex;
+
+				const double StartTime = FPlatformTime::Seconds();
+				NumSharedCorridors += RunQueries(Batch, DefaultNavData, /*bDispatchResults=*/false, &CompletionTimes);
+				TotalTime += FPlatformTime::Seconds() - StartTime;
+				++NumBatches;
+
+				for (const double CompletionTime : CompletionTimes)
+				{
+					Latencies.Add((CompletionTime - StartTime) * 1000.);
+				}
+			}
+		}
+
+		if (Latencies.Num() == 0)
+		{
+			UE_LOG(LogNavigation, Warning, TEXT("No navigation data to replay async path finding queries from %s on"), *Filename);
+			return;
+		}
+
+		Latencies.Sort();
+		const auto Percentile = [&Latencies](const double Fraction)
+		{
+			return Latencies[FMath::Clamp(FMath::CeilToInt(Fraction * Latencies.Num()) - 1, 0, Latencies.Num() - 1)];
+		};
+
+		UE_LOG(LogNavigation, Display, TEXT("Async path finding benchmark: %s, %d queries in %d batches, parallel %d, shared corridors %d"),
+			*Filename, Latencies.Num(), NumBatches, GParallelQueries, GShareCorridors);
+		UE_LOG(LogNavigation, Display, TEXT("  Total %.2f ms, %.0f queries/s, latency p50 %.3f ms, p99 %.3f ms, max %.3f ms, %d corridors shared"),
+			TotalTime * 1000., Latencies.Num() / FMath::Max(TotalTime, SMALL_NUMBER), Percentile(0.5), Percentile(0.99), Latencies.Last(), NumSharedCorridors);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCmd(
+		TEXT("ai.nav.AsyncPathfinding.Benchmark"),
+		TEXT("Replays async path finding queries saved with ai.nav.AsyncPathfinding.SaveRecording, and reports p50/p99 latency. Usage: ai.nav.AsyncPathfinding.Benchmark <Name> [Iterations]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkCommand));
+}
+
 void UNavigationSystemV1::AddAsyncQuery(const FAsyncPathFindingQuery& Query)
 {
 	check(IsInGameThread());
 	AsyncPathFindingQueries.Add(Query);
+
+	if (AsyncPathFinding::GRecordQueries)
+	{
+		AsyncPathFinding::RecordQuery(Query);
+	}
 }
 
 uint32 UNavigationSystemV1::FindPathAsync(const FNavAgentProperties& AgentProperties, FPathFindingQuery Query, const FNavPathQueryDelegate& ResultDelegate, EPathFindingMode::Type Mode)
@@ -1186,13 +1515,6 @@ void UNavigationSystemV1::TriggerAsyncQueries(TArray<FAsyncPathFindingQuery>& Pa
 		GET_STATID(STAT_FSimpleDelegateGraphTask_NavigationSystemBatchedAsyncQueries), nullptr, CPrio_TriggerAsyncQueries.Get());
 }
 
-static void AsyncQueryDone(FAsyncPathFindingQuery Query)
-{
-	CSV_SCOPED_TIMING_STAT(NavigationSystem, AsyncNavQueryFinished);
-
-	Query.OnDoneDelegate.ExecuteIfBound(Query.QueryID, Query.Result.Result, Query.Result.Path);
-}
-
 void UNavigationSystemV1::PerformAsyncQueries(TArray<FAsyncPathFindingQuery> PathFindingQueries)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Navigation_PathfindingAsync);
@@ -1202,40 +1524,12 @@ void UNavigationSystemV1::PerformAsyncQueries(TArray<FAsyncPathFindingQuery> Pat
 	{
 		return;
 	}
-	
-	for (FAsyncPathFindingQuery& Query : PathFindingQueries)
-	{
-		// @todo this is not necessarily the safest way to use UObjects outside of main thread. 
-		//	think about something else.
-		const ANavigationData* NavData = Query.NavData.IsValid() ? Query.NavData.Get() : GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
-
-		// perform query
-		if (NavData)
-		{
-			if (Query.Mode == EPathFindingMode::Hierarchical)
-			{
-				Query.Result = NavData->FindHierarchicalPath(Query.NavAgentProperties, Query);
-			}
-			else
-			{
-				Query.Result = NavData->FindPath(Query.NavAgentProperties, Query);
-			}
-		}
-		else
-		{
-			Query.Result = ENavigationQueryResult::Error;
-		}
 
-		// @todo make it return more informative results (bResult == false)
-		// trigger calling delegate on main thread - otherwise it may depend too much on stuff being thread safe
-		DECLARE_CYCLE_STAT(TEXT("FSimpleDelegateGraphTask.Async nav query finished"),
-			STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished,
-			STATGROUP_TaskGraphTasks);
+	const ANavigationData* DefaultNavData = GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
+	const int32 NumSharedCorridors = AsyncPathFinding::RunQueries(PathFindingQueries, DefaultNavData, /*bDispatchResults=*/true, nullptr);
 
-		FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(
-			FSimpleDelegateGraphTask::FDelegate::CreateStatic(AsyncQueryDone, Query),
-			GET_STATID(STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished), NULL, ENamedThreads::GameThread);
-	}
+	CSV_CUSTOM_STAT(NavigationSystem, AsyncPathfindingQueries, PathFindingQueries.Num(), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(NavigationSystem, AsyncPathfindingSharedCorridors, NumSharedCorridors, ECsvCustomStatOp::Accumulate);
 }
 
 bool UNavigationSystemV1::GetRandomPoint(FNavLocation& ResultLocation, ANavigationData* NavData, FSharedConstNavQueryFilter QueryFilter)
@@ -0,0 +1,218 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Math/GenericOctree.h"
+#include "NavigationLooseBVH.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNavigationLooseBVHTest, "System.AI.Navigation.LooseBVH", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace NavigationLooseBVHTest
+{
+	struct FTestElement
+	{
+		FBoxCenterAndExtent Bounds;
+		int32 Id;
+	};
+
+	struct FTestOctreeSemantics
+	{
+		enum { MaxElementsPerLeaf = 16 };
+		enum { MinInclusiveElementsPerNode = 7 };
+		enum { MaxNodeDepth = 12 };
+
+		typedef FDefaultAllocator ElementAllocator;
+
+		FORCEINLINE static const FBoxCenterAndExtent& GetBoundingBox(const FTestElement& Element) { return Element.Bounds; }
+		FORCEINLINE static bool AreElementsEqual(const FTestElement& A, const FTestElement& B) { return A.Id == B.Id; }
+		FORCEINLINE static void SetElementId(const FTestElement& Element, FOctreeElementId Id) {}
+		FORCEINLINE static void ApplyOffset(FTestElement& Element, const FVector& InOffset) {}
+	};
+
+	typedef TOctree<FTestElement, FTestOctreeSemantics> FTestOctree;
+
+	static FBox MakeRandomBox(FRandomStream& Stream, float WorldExtent, float MaxBoxExtent)
+	{
+		const FVector Center(Stream.FRandRange(-WorldExtent, WorldExtent), Stream.FRandRange(-WorldExtent, WorldExtent), Stream.FRandRange(-WorldExtent, WorldExtent));
+		const FVector Extent(Stream.FRandRange(1.f, MaxBoxExtent), Stream.FRandRange(1.f, MaxBoxExtent), Stream.FRandRange(1.f, MaxBoxExtent));
+		return FBox(Center - Extent, Center + Extent);
+	}
+
+	/** Compares sets of Ids found by BVH with the ones found by an octree built from the same elements */
+	static bool CompareWithOctree(FAutomationTestBase& Test, const TCHAR* Step, const FNavigationLooseBVH& BVH, const TMap<int32, FBox>& ExpectedElements, const TArray<FBox>& QueryBoxes)
+	{
+		FTestOctree Octree(FVector::ZeroVector, 64000.f);
+		for (const TPair<int32, FBox>& Pair : ExpectedElements)
+		{
+			Octree.AddElement(FTestElement{ FBoxCenterAndExtent(Pair.Value), Pair.Key });
+		}
+
+		bool bSuccess = true;
+		for (int32 QueryIndex = 0; QueryIndex < QueryBoxes.Num(); QueryIndex++)
+		{
+			TArray<int32> OctreeIds;
+			for (FTestOctree::TConstElementBoxIterator<> It(Octree, QueryBoxes[QueryIndex]); It.HasPendingElements(); It.Advance())
+			{
+				OctreeIds.Add(It.GetCurrentElement().Id);
+			}
+
+			TArray<int32> BVHIds;
+			BVH.FindElementsInBox(QueryBoxes[QueryIndex], BVHIds);
+
+			OctreeIds.Sort();
+			BVHIds.Sort();
+
+			if (BVHIds != OctreeIds)
+			{
+				Test.AddError(FString::Printf(TEXT("%s: query %d found %d elements, octree found %d"),
+					Step, QueryIndex, BVHIds.Num(), OctreeIds.Num()));
+				bSuccess = false;
+			}
+		}
+
+		return bSuccess;
+	}
+}
+
+bool FNavigationLooseBVHTest::RunTest(const FString& Parameters)
+{
+	using namespace NavigationLooseBVHTest;
+
+	static constexpr float WorldExtent = 10000.f;
+	static constexpr int32 NumElements = 2000;
+
+	FRandomStream Stream(0x4e415642);
+	FNavigationLooseBVH BVH;
+	TMap<int32, FBox> ExpectedElements;
+
+	TArray<FBox> QueryBoxes;
+	for (int32 Index = 0; Index < 64; Index++)
+	{
+		QueryBoxes.Add(MakeRandomBox(Stream, WorldExtent, 2000.f));
+	}
+
+	// batched add, queried from pending list and from the tree
+	{
+		TArray<FBox> Bounds;
+		for (int32 Index = 0; Index < NumElements; Index++)
+		{
+			Bounds.Add(MakeRandomBox(Stream, WorldExtent, 300.f));
+		}
+
+		TArray<int32> Ids;
+		BVH.AddBatch(Bounds, Ids);
+		for (int32 Index = 0; Index < Ids.Num(); Index++)
+		{
+			ExpectedElements.Add(Ids[Index], Bounds[Index]);
+		}
+
+		CompareWithOctree(*this, TEXT("Add"), BVH, ExpectedElements, QueryBoxes);
+		BVH.Commit();
+		TestFalse(TEXT("No pending changes after commit"), BVH.HasPendingChanges());
+		CompareWithOctree(*this, TEXT("Add, committed"), BVH, ExpectedElements, QueryBoxes);
+	}
+
+	// small moves stay within loose bounds, large ones escape them
+	{
+		TArray<int32> Ids;
+		TArray<FBox> NewBounds;
+		for (const TPair<int32, FBox>& Pair : ExpectedElements)
+		{
+			if (Stream.FRand() < 0.1f)
+			{
+				const float MaxOffset = Stream.FRand() < 0.5f ? 20.f : 1000.f;
+				Ids.Add(Pair.Key);
+				NewBounds.Add(Pair.Value.ShiftBy(Stream.GetUnitVector() * Stream.FRandRange(0.f, MaxOffset)));
+			}
+		}
+
+		BVH.UpdateBatch(Ids, NewBounds);
+		for (int32 Index = 0; Index < Ids.Num(); Index++)
+		{
+			ExpectedElements.Add(Ids[Index], NewBounds[Index]);
+		}
+
+		CompareWithOctree(*this, TEXT("Update"), BVH, ExpectedElements, QueryBoxes);
+		BVH.Commit();
+		CompareWithOctree(*this, TEXT("Update, committed"), BVH, ExpectedElements, QueryBoxes);
+	}
+
+	// removals leave stale leaf entries, Ids of removed elements are reused by new ones
+	{
+		TArray<int32> RemovedIds;
+		for (const TPair<int32, FBox>& Pair : ExpectedElements)
+		{
+			if (Stream.FRand() < 0.05f)
+			{
+				RemovedIds.Add(Pair.Key);
+			}
+		}
+
+		BVH.RemoveBatch(RemovedIds);
+		for (const int32 Id : RemovedIds)
+		{
+			ExpectedElements.Remove(Id);
+		}
+
+		CompareWithOctree(*this, TEXT("Remove"), BVH, ExpectedElements, QueryBoxes);
+
+		for (int32 Index = 0; Index < RemovedIds.Num() / 2; Index++)
+		{
+			const FBox Bounds = MakeRandomBox(Stream, WorldExtent, 300.f);
+			ExpectedElements.Add(BVH.Add(Bounds), Bounds);
+		}
+
+		CompareWithOctree(*this, TEXT("Remove and add"), BVH, ExpectedElements, QueryBoxes);
+		BVH.Commit();
+		CompareWithOctree(*this, TEXT("Remove and add, committed"), BVH, ExpectedElements, QueryBoxes);
+	}
+
+	// many frames of mixed changes, going through both refits and rebuilds
+	for (int32 Frame = 0; Frame < 20; Frame++)
+	{
+		TArray<int32> Ids;
+		ExpectedElements.GenerateKeyArray(Ids);
+
+		for (int32 Change = 0; Change < 100; Change++)
+		{
+			const int32 Id = Ids[Stream.RandHelper(Ids.Num())];
+			if (!ExpectedElements.Contains(Id))
+			{
+				continue;
+			}
+
+			const float Action = Stream.FRand();
+			if (Action < 0.6f)
+			{
+				const FBox NewBounds = ExpectedElements[Id].ShiftBy(Stream.GetUnitVector() * Stream.FRandRange(0.f, 200.f));
+				BVH.Update(Id, NewBounds);
+				ExpectedElements.Add(Id, NewBounds);
+			}
+			else if (Action < 0.8f)
+			{
+				BVH.Remove(Id);
+				ExpectedElements.Remove(Id);
+			}
+			else
+			{
+				const FBox Bounds = MakeRandomBox(Stream, WorldExtent, 300.f);
+				ExpectedElements.Add(BVH.Add(Bounds), Bounds);
+			}
+		}
+
+		BVH.Commit();
+	}
+
+	TestEqual(TEXT("Number of elements"), BVH.Num(), ExpectedElements.Num());
+	CompareWithOctree(*this, TEXT("Mixed changes"), BVH, ExpectedElements, QueryBoxes);
+
+	BVH.Reset();
+	ExpectedElements.Reset();
+	CompareWithOctree(*this, TEXT("Reset"), BVH, ExpectedElements, QueryBoxes);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
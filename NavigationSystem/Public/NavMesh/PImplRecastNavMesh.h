@@ -14,6 +14,8 @@
 #include "AI/Navigation/NavigationTypes.h"
 #include "NavMesh/RecastNavMesh.h"
 #include "NavMesh/RecastQueryFilter.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
 
 #if RECAST_INTERNAL_DEBUG_DATA
 #include "NavMesh/RecastInternalDebugData.h"
@@ -30,6 +32,102 @@ class FRecastNavMeshGenerator;
 
 #define RECAST_VERY_SMALL_AGENT_RADIUS 0.0f
 
+/**
+ * Provides a dtNavMeshQuery for the lifetime of the scope: the shared query on the game thread, and a query taken from
+ * a per thread pool on any other thread. Pooled queries keep their node pools between uses, so that path finding on
+ * worker threads doesn't allocate for every query. Nested scopes on a worker thread get distinct queries, while all
+ * scopes on the game thread use the shared query, as the game thread did before pooling.
+ */
+class NAVIGATIONSYSTEM_API FRecastNavQueryScope
+{
+public:
+	explicit FRecastNavQueryScope(dtNavMeshQuery& GameThreadQuery);
+	~FRecastNavQueryScope();
+
+	dtNavMeshQuery& Get() const { return *Query; }
+
+private:
+	dtNavMeshQuery* Query;
+	bool bPooled;
+};
+
+/**
+ * Path corridors found by FPImplRecastNavMesh::FindPath, shared between queries with the same start and end locations.
+ * The corridor and its per polygon costs depend on where the query starts and ends within its polygons, not only on them.
+ * Only used by path finding on threads where a FScope is active, usually for the duration of a single batch of async
+ * queries, since the cached polygon refs are only valid for as long as navmesh tiles don't change. Thread safe.
+ */
+class NAVIGATIONSYSTEM_API FRecastPathCorridorCache
+{
+public:
+	struct FKey
+	{
+		const dtNavMesh* NavMesh = nullptr;
+		const dtQueryFilter* Filter = nullptr;
+		/** Only set when custom links are registered, since they can allow or deny path finding per querier */
+		const UObject* LinkOwner = nullptr;
+		dtPolyRef StartPoly = 0;
+		dtPolyRef EndPoly = 0;
+		/** Recast space locations the query starts and ends at, projected on StartPoly and EndPoly */
+		FVector StartPos = FVector::ZeroVector;
+		FVector EndPos = FVector::ZeroVector;
+		float CostLimit = FLT_MAX;
+		int32 MaxSearchNodes = 0;
+		bool bUseClusterGraph = false;
+
+		bool operator==(const FKey& Other) const
+		{
+			return NavMesh == Other.NavMesh && Filter == Other.Filter && LinkOwner == Other.LinkOwner && StartPoly == Other.StartPoly
+				&& EndPoly == Other.EndPoly && StartPos == Other.StartPos && EndPos == Other.EndPos && CostLimit == Other.CostLimit && MaxSearchNodes == Other.MaxSearchNodes && bUseClusterGraph == Other.bUseClusterGraph;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.StartPoly), GetTypeHash(Key.EndPoly));
+			Hash = HashCombine(Hash, HashCombine(GetTypeHash(Key.StartPos), GetTypeHash(Key.EndPos)));
+			Hash = HashCombine(Hash, HashCombine(PointerHash(Key.NavMesh), PointerHash(Key.Filter)));
+			Hash = HashCombine(Hash, HashCombine(PointerHash(Key.LinkOwner), GetTypeHash(Key.CostLimit)));
+			return HashCombine(Hash, GetTypeHash(Key.MaxSearchNodes) ^ (Key.bUseClusterGraph ? 1u : 0u));
+		}
+	};
+
+	/** Makes the cache available to path finding on the calling thread, for the lifetime of the scope */
+	struct NAVIGATIONSYSTEM_API FScope
+	{
+		explicit FScope(FRecastPathCorridorCache& Cache);
+		~FScope();
+
+	private:
+		FRecastPathCorridorCache* PreviousCache;
+	};
+
+	/** Returns the cache made available to the calling thread, if any */
+	static FRecastPathCorridorCache* GetActive();
+
+	/** Copies a previously found corridor into OutResult, returns false if there is none for the key */
+	bool Find(const FKey& Key, dtQueryResult& OutResult, dtStatus& OutStatus) const;
+
+	/** Stores a corridor, unless one was already stored for the key */
+	void Add(const FKey& Key, const dtQueryResult& Result, dtStatus Status);
+
+	/** Number of corridors stored */
+	int32 Num() const;
+
+	/** Number of path finding queries that were served from the cache */
+	int32 GetNumHits() const { return NumHits.GetValue(); }
+
+private:
+	struct FEntry
+	{
+		dtQueryResult Result;
+		dtStatus Status = 0;
+	};
+
+	TMap<FKey, TUniquePtr<FEntry>> Entries;
+	mutable FRWLock EntriesLock;
+	mutable FThreadSafeCounter NumHits;
+};
+
 /** Engine Private! - Private Implementation details of ARecastNavMesh */
 class NAVIGATIONSYSTEM_API FPImplRecastNavMesh
 {
@@ -79,15 +177,20 @@ public:
 	UE_DEPRECATED(4.25, "Use the version with the added CostLimit parameter (FLT_MAX can be used as default).")
 	ENavigationQueryResult::Type FindPath(const FVector& StartLoc, const FVector& EndLoc, FNavMeshPath& Path, const FNavigationQueryFilter& Filter, const UObject* Owner) const;
 	
-	/** Generates path from the given query. Synchronous. */
-	ENavigationQueryResult::Type FindPath(const FVector& StartLoc, const FVector& EndLoc, const float CostLimit, FNavMeshPath& Path, const FNavigationQueryFilter& Filter, const UObject* Owner) const;
+	/** Generates path from the given query. Synchronous.
+	 *	@param bUseClusterGraph - search the cluster graph first, and refine the cluster path over polygons (see dtNavMeshQuery::findPathHierarchical) */
+	ENavigationQueryResult::Type FindPath(const FVector& StartLoc, const FVector& EndLoc, const float CostLimit, FNavMeshPath& Path, const FNavigationQueryFilter& Filter, const UObject* Owner, const bool bUseClusterGraph = false) const;
 
 	/** Check if path exists */
-	ENavigationQueryResult::Type TestPath(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& Filter, const UObject* Owner, int32* NumVisitedNodes = 0) const;
+	ENavigationQueryResult::Type TestPath(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& Filter, const UObject* Owner, int32* NumVisitedNodes = 0, const bool bUseClusterGraph = false) const;
 
 	/** Check if path exists using cluster graph */
 	ENavigationQueryResult::Type TestClusterPath(const FVector& StartLoc, const FVector& EndLoc, int32* NumVisitedNodes = 0) const;
 
+	/** Searches the cluster graph only. Returns false if it proves there is no path between the given points, and true
+	 *	otherwise, including when clusters have not been built or the search runs out of nodes. */
+	bool MayHaveClusterPath(const FVector& StartLoc, const FVector& EndLoc) const;
+
 	/** Checks if the whole segment is in navmesh */
 	void Raycast(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner,
 		ARecastNavMesh::FRaycastResult& RaycastResult, NavNodeRef StartNode = INVALID_NAVNODEREF) const;
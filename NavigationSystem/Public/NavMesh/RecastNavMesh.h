@@ -834,6 +834,10 @@ public:
 
 #if !UE_BUILD_SHIPPING
 	virtual uint32 LogMemUsed() const override;
+
+	/** Runs path searches between random pairs of navmesh points at least MinDistance apart, both over polygons only and using
+	 *	the cluster graph first, and logs visited node counts and search times of both */
+	void BenchmarkHierarchicalPathfinding(int32 NumQueries, float MinDistance) const;
 #endif // !UE_BUILD_SHIPPING
 
 	void UpdateNavMeshDrawing();
@@ -984,6 +988,8 @@ public:
 	
 	// @todo docuement
 	static FPathFindingResult FindPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query);
+	/** Same as FindPath, but searches the navmesh cluster graph first, and then refines the cluster path over polygons */
+	static FPathFindingResult FindHierarchicalPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query);
 	static bool TestPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query, int32* NumVisitedNodes);
 	static bool TestHierarchicalPath(const FNavAgentProperties& AgentProperties, const FPathFindingQuery& Query, int32* NumVisitedNodes);
 	static bool NavMeshRaycast(const ANavigationData* Self, const FVector& RayStart, const FVector& RayEnd, FVector& HitLocation, FSharedConstNavQueryFilter QueryFilter, const UObject* Querier, FRaycastResult& Result);
@@ -1046,6 +1052,8 @@ protected:
 private:
 	friend FRecastNavMeshGenerator;
 	friend class FPImplRecastNavMesh;
+	/** shared implementation of FindPath and FindHierarchicalPath */
+	static FPathFindingResult FindPathInternal(const FPathFindingQuery& Query, bool bUseClusterGraph);
 	// destroys FPImplRecastNavMesh instance if it has been created 
 	void DestroyRecastPImpl();
 	// @todo docuement
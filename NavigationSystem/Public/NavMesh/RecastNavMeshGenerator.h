@@ -299,6 +299,11 @@ public:
 	ETimeSliceWorkResult DoWorkTimeSliced();
 	/** Does the work involved with regenerating this tile */
 	bool DoWork();
+	/** Does the part of DoWork that gathers geometry and voxelizes it into compressed layers.
+	 *	@return true if DoPolygonizationWork needs to be called to finish the tile */
+	bool DoVoxelizationWork();
+	/** Does the part of DoWork that builds navigation data from the compressed layers, must follow DoVoxelizationWork */
+	bool DoPolygonizationWork();
 
 	FORCEINLINE int32 GetTileX() const { return TileX; }
 	FORCEINLINE int32 GetTileY() const { return TileY; }
@@ -348,6 +353,8 @@ protected:
 	 *	@return false if failed or no need to generate (still valid).
 	 */
 	bool GenerateTile();
+	/** Rasterizes geometry into CompressedLayers if they need to be regenerated, first part of GenerateTile */
+	bool GenerateTileLayers();
 
 	void Setup(const FRecastNavMeshGenerator& ParentGenerator, const TArray<FBox>& DirtyAreas);
 	
@@ -415,6 +422,8 @@ protected:
 	uint32 bFullyEncapsulatedByInclusionBounds : 1;
 	uint32 bUpdateGeometry : 1;
 	uint32 bHasLowAreaModifiers : 1;
+	/** Whether triangles are culled against the tile in SIMD batches before rasterization, see ai.nav.BatchedTriangleCulling */
+	uint32 bBatchedTriangleCulling : 1;
 
 	/** Start time slicing variables */
 	ERasterizeGeomRecastTimeSlicedState RasterizeGeomRecastState;
@@ -481,18 +490,45 @@ protected:
 #endif
 };
 
+/** Part of the tile generation performed by a single run of FRecastTileGeneratorTask */
+enum class ERecastTileGenerationStage : uint8
+{
+	/** Whole tile in one go */
+	Full,
+	/** Geometry gathering and rasterization into compressed layers */
+	Voxelization,
+	/** Building navigation data from compressed layers */
+	Polygonization,
+};
+
 struct NAVIGATIONSYSTEM_API FRecastTileGeneratorWrapper : public FNonAbandonableTask
 {
 	TSharedRef<FRecastTileGenerator> TileGenerator;
+	ERecastTileGenerationStage Stage;
+	/** Result of the last completed stage */
+	bool bStageSucceeded;
 
 	FRecastTileGeneratorWrapper(TSharedRef<FRecastTileGenerator> InTileGenerator)
 		: TileGenerator(InTileGenerator)
+		, Stage(ERecastTileGenerationStage::Full)
+		, bStageSucceeded(false)
 	{
 	}
 	
 	void DoWork()
 	{
-		TileGenerator->DoWork();
+		switch (Stage)
+		{
+		case ERecastTileGenerationStage::Voxelization:
+			bStageSucceeded = TileGenerator->DoVoxelizationWork();
+			break;
+		case ERecastTileGenerationStage::Polygonization:
+			bStageSucceeded = TileGenerator->DoPolygonizationWork();
+			break;
+		default:
+			bStageSucceeded = TileGenerator->DoWork();
+			break;
+		}
 	}
 
 	FORCEINLINE TStatId GetStatId() const
@@ -516,14 +552,21 @@ struct FPendingTileElement
 	 *  In case geometry is changed cached layers data will be fully regenerated without using dirty areas list
 	 */
 	TArray<FBox> DirtyAreas;
+	/** Time the tile was first marked dirty since it was last built, used for rebuild latency stats */
+	double DirtyTime;
 
 	FPendingTileElement()
 		: Coord(FIntPoint::NoneValue)
 		, SeedDistance(MAX_flt)
 		, bRebuildGeometry(false)
+		, DirtyTime(0.)
 	{
 	}
 
+	/** Merges another pending request for the same tile into this one, dropping dirty areas already covered by others.
+	 *	@return number of dirty areas that were coalesced */
+	int32 Merge(const FPendingTileElement& Other);
+
 	bool operator == (const FIntPoint& Location) const
 	{
 		return Coord == Location;
@@ -561,6 +604,14 @@ struct FRunningTileElement
 	{
 	}
 
+	FRunningTileElement(const FPendingTileElement& PendingElement)
+		: Coord(PendingElement.Coord)
+		, bShouldDiscard(false)
+		, DirtyTime(PendingElement.DirtyTime)
+		, AsyncTask(nullptr)
+	{
+	}
+
 	bool operator == (const FRunningTileElement& Other) const
 	{
 		return Coord == Other.Coord;
@@ -570,9 +621,22 @@ struct FRunningTileElement
 	FIntPoint					Coord;
 	/** whether generated results should be discarded */
 	bool						bShouldDiscard; 
+	/** time the tile was marked dirty, copied from FPendingTileElement */
+	double						DirtyTime = 0.;
 	FRecastTileGeneratorTask*	AsyncTask;
 };
 
+/** Latency between tiles being marked dirty and their regenerated data being added to the navmesh, in seconds */
+struct FRecastTileRebuildLatencyStats
+{
+	int32 NumSamples = 0;
+	float P50 = 0.f;
+	float P99 = 0.f;
+	float Max = 0.f;
+	/** Number of dirty areas dropped because they were covered by other dirty areas of the same tile */
+	int32 NumCoalescedDirtyAreas = 0;
+};
+
 struct FTileTimestamp
 {
 	uint32 TileIdx;
@@ -760,6 +824,15 @@ public:
 
 	static void CalcPolyRefBits(ARecastNavMesh* NavMeshOwner, int32& MaxTileBits, int32& MaxPolyBits);
 
+	/** Returns latency stats of the recently rebuilt tiles */
+	FRecastTileRebuildLatencyStats GetTileRebuildLatencyStats() const;
+	void ResetTileRebuildLatencyStats();
+
+#if !UE_BUILD_SHIPPING
+	/** Generates up to NumTiles tiles with and without batched triangle culling, logs the timings and checks that the results are identical */
+	void BenchmarkTileGeneration(int32 NumTiles);
+#endif // !UE_BUILD_SHIPPING
+
 protected:
 	bool IsInActiveSet(const FIntPoint& Tile) const;
 	virtual void RestrictBuildingToActiveTiles(bool InRestrictBuildingToActiveTiles);
@@ -778,6 +851,11 @@ protected:
 
 	void AddGeneratedTileLayer(int32 LayerIndex, FRecastTileGenerator& TileGenerator, const TMap<int32, dtPolyRef>& OldLayerTileIdMap, TArray<uint32>& OutResultTileIndices);
 
+	/** Merges DirtyTiles with PendingDirtyTiles and stores the result in PendingDirtyTiles */
+	void MergePendingDirtyTiles(TSet<FPendingTileElement>& DirtyTiles);
+
+	void AddTileRebuildLatencySample(double DirtyTime);
+
 protected:
 	friend ARecastNavMesh;
 
@@ -816,6 +894,11 @@ protected:
 	/** List of tiles that were recently regenerated */
 	TNavStatArray<FTileTimestamp> RecentlyBuiltTiles;
 #endif// WITH_EDITOR
+
+	/** Rebuild latencies of recently added tiles, used as a ring buffer */
+	TArray<float> TileRebuildLatencies;
+	int32 NextTileRebuildLatencyIdx;
+	int32 NumCoalescedDirtyAreas;
 	
 	TArray<FIntPoint> ActiveTiles;
 
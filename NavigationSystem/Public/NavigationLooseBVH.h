@@ -0,0 +1,168 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Loose bounding volume hierarchy over boxes, built for sets of elements that change in bulk.
+ *
+ * Leaves store elements with bounds expanded by LooseMargin, so elements moving within that margin don't change
+ * the tree. Changes are batched: new elements are kept in a pending list (scanned linearly by queries) until Commit
+ * rebuilds the tree, removed elements are skipped until the next rebuild, and elements moved outside of their loose
+ * bounds are put back into the tree by a parallel refit. Queries always see all changes made so far, Commit only
+ * restores query performance.
+ *
+ * Nodes are stored in breadth first order, so every level of the tree is a contiguous range refitted in parallel.
+ * Queries can be run from multiple threads, as long as the tree is not modified at the same time.
+ */
+class NAVIGATIONSYSTEM_API FNavigationLooseBVH
+{
+public:
+	explicit FNavigationLooseBVH(float InLooseMargin = 50.f);
+
+	/** Adds an element, @return its Id */
+	int32 Add(const FBox& Bounds);
+
+	/** Adds elements, OutIds receive their Ids in the same order */
+	void AddBatch(TArrayView<const FBox> Bounds, TArray<int32>& OutIds);
+
+	/** Removes an element */
+	void Remove(int32 Id);
+
+	/** Removes elements */
+	void RemoveBatch(TArrayView<const int32> Ids);
+
+	/** Updates bounds of an element */
+	void Update(int32 Id, const FBox& NewBounds);
+
+	/** Updates bounds of elements, NewBounds must have the same number of entries as Ids */
+	void UpdateBatch(TArrayView<const int32> Ids, TArrayView<const FBox> NewBounds);
+
+	/** Applies batched changes: rebuilds the tree when it got too many pending or removed elements, refits it otherwise */
+	void Commit();
+
+	/** Removes all elements */
+	void Reset();
+
+	/** @return true if there are changes waiting for Commit */
+	bool HasPendingChanges() const { return PendingIds.Num() > 0; }
+
+	/** @return number of elements */
+	int32 Num() const { return Elements.Num(); }
+
+	/** @return bounds of an element */
+	const FBox& GetBounds(int32 Id) const { return Elements[Id].Bounds; }
+
+	/** Calls Func with Id of every element intersecting QueryBox */
+	template<typename FuncType>
+	void ForEachElementInBox(const FBox& QueryBox, const FuncType& Func) const;
+
+	/** Collects Ids of elements intersecting QueryBox */
+	void FindElementsInBox(const FBox& QueryBox, TArray<int32>& OutIds) const;
+
+	/** Maximum number of elements stored in a single leaf */
+	static constexpr int32 MaxLeafElements = 8;
+
+private:
+	enum class EElementState : uint8
+	{
+		/** added after last rebuild, not in any leaf */
+		Pending,
+		/** in leaf, contained by loose bounds */
+		InTree,
+		/** in leaf, but moved outside of loose bounds (pending until refit) */
+		Escaped,
+	};
+
+	struct FElement
+	{
+		FBox Bounds;
+		FBox LooseBounds;
+		EElementState State;
+	};
+
+	struct FNode
+	{
+		FBox Bounds;
+		/** index of first child (always two, stored next to each other), or first entry in LeafElementIds */
+		int32 FirstIndex;
+		/** number of entries in LeafElementIds, 0 for inner nodes */
+		int32 NumLeafElements;
+
+		bool IsLeaf() const { return NumLeafElements > 0; }
+	};
+
+	void Rebuild();
+	void Refit();
+	void RefitNode(int32 NodeIndex);
+	FBox MakeLooseBounds(const FBox& Bounds) const;
+
+	/** element storage, Ids are indices in sparse array */
+	TSparseArray<FElement> Elements;
+
+	/** Ids of elements not in the tree */
+	TArray<int32> PendingIds;
+
+	/** nodes in breadth first order */
+	TArray<FNode> Nodes;
+
+	/** first node of every tree level, with extra entry for end of last level */
+	TArray<int32> LevelStarts;
+
+	/** element Ids referenced by leaves, may contain removed or reused Ids until next rebuild */
+	TArray<int32> LeafElementIds;
+
+	/** number of entries in LeafElementIds referencing removed elements */
+	int32 NumStaleLeafEntries;
+
+	/** number of elements put back into the tree by refits since last rebuild, refits make the tree looser */
+	int32 NumRefittedElements;
+
+	/** expansion of element bounds stored in leaves */
+	float LooseMargin;
+};
+
+template<typename FuncType>
+void FNavigationLooseBVH::ForEachElementInBox(const FBox& QueryBox, const FuncType& Func) const
+{
+	if (Nodes.Num() > 0)
+	{
+		TArray<int32, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(0);
+
+		while (NodeStack.Num() > 0)
+		{
+			const FNode& Node = Nodes[NodeStack.Pop(false)];
+			if (!Node.Bounds.Intersect(QueryBox))
+			{
+				continue;
+			}
+
+			if (Node.IsLeaf())
+			{
+				for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumLeafElements; Index++)
+				{
+					const int32 Id = LeafElementIds[Index];
+					if (Elements.IsValidIndex(Id) && Elements[Id].State == EElementState::InTree && Elements[Id].Bounds.Intersect(QueryBox))
+					{
+						Func(Id);
+					}
+				}
+			}
+			else
+			{
+				NodeStack.Add(Node.FirstIndex);
+				NodeStack.Add(Node.FirstIndex + 1);
+			}
+		}
+	}
+
+	for (const int32 Id : PendingIds)
+	{
+		if (Elements[Id].Bounds.Intersect(QueryBox))
+		{
+			Func(Id);
+		}
+	}
+}
@@ -11,6 +11,7 @@
 #include "AI/NavigationModifier.h"
 #include "AI/Navigation/NavRelevantInterface.h"
 #include "Math/GenericOctree.h"
+#include "NavigationLooseBVH.h"
 
 class INavRelevantInterface;
 class FNavigationOctree;
@@ -162,16 +163,65 @@ public:
 		return Object.GetUniqueID();
 	}
 
+	/** Applies element changes batched since last call to the loose BVH used by FindElementsInBox */
+	void CommitBVH();
+
+	/** @return true if FindElementsInBox is served by the loose BVH instead of the octree */
+	bool IsUsingBVH() const { return bUseBVH; }
+
+	/** @return true if there are element changes not yet applied to the loose BVH */
+	bool HasPendingBVHChanges() const { return PendingBVHElements.Num() > 0 || PendingBVHRemovals.Num() > 0; }
+
+	/** Calls Func with every element intersecting QueryBox, same elements as TConstElementBoxIterator would visit (in any order).
+	 *  Falls back to the octree while element changes are waiting for CommitBVH. */
+	template<typename FuncType>
+	void FindElementsInBox(const FBox& QueryBox, const FuncType& Func) const
+	{
+		if (bUseBVH && !HasPendingBVHChanges())
+		{
+			BVH.ForEachElementInBox(QueryBox, [this, &Func](int32 BVHId)
+			{
+				Func(BVHElements[BVHId]);
+			});
+		}
+		else
+		{
+			for (TConstElementBoxIterator<DefaultStackAllocator> It(*this, QueryBox); It.HasPendingElements(); It.Advance())
+			{
+				Func(It.GetCurrentElement());
+			}
+		}
+	}
+
 protected:
 	friend struct FNavigationOctreeController;
 	friend struct FNavigationOctreeSemantics;
 
 	void SetElementIdImpl(const uint32 OwnerUniqueId, FOctreeElementId Id);
 
+	void AddToBVH(const FNavigationOctreeElement& Element);
+	void RemoveFromBVH(uint32 OwnerUniqueId);
+
 	TMap<uint32, FOctreeElementId> ObjectToOctreeId;
 	ENavDataGatheringMode DefaultGeometryGatheringMode;
 	uint32 bGatherGeometry : 1;
+	/** mirror elements in BVH, read once at construction from ai.nav.OctreeBVH */
+	uint32 bUseBVH : 1;
 	uint32 NodesMemory;
+
+	/** loose BVH mirroring octree elements, changes are committed once per navigation system tick */
+	FNavigationLooseBVH BVH;
+
+	/** copies of octree elements, indexed by BVH Id */
+	TSparseArray<FNavigationOctreeElement> BVHElements;
+
+	TMap<uint32, int32> ObjectToBVHId;
+
+	/** elements added or updated since last CommitBVH, by owner */
+	TMap<uint32, FNavigationOctreeElement> PendingBVHElements;
+
+	/** owners removed since last CommitBVH, applied before PendingBVHElements */
+	TSet<uint32> PendingBVHRemovals;
 };
 
 template<>
@@ -675,6 +675,9 @@ public:
 	/** find custom link by unique ID */
 	INavLinkCustomInterface* GetCustomLink(uint32 UniqueLinkId) const;
 
+	/** returns true if any custom links are registered */
+	bool HasCustomLinks() const { return CustomLinksMap.Num() > 0; }
+
 	/** updates custom link for all active navigation data instances */
 	void UpdateCustomLink(const INavLinkCustomInterface* CustomLink);
 
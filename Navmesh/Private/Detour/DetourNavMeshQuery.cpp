@@ -177,6 +177,17 @@ void dtQueryResult::copyFlags(unsigned int* flags, int nmax)
 	}
 }
 
+//@UE4 BEGIN
+void dtQueryResult::copyFrom(const dtQueryResult& src)
+{
+	data.resize(src.size());
+	for (int i = 0; i < src.size(); i++)
+	{
+		data[i] = src.data[i];
+	}
+}
+//@UE4 END
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 /// @class dtNavMeshQuery
@@ -201,6 +212,8 @@ dtNavMeshQuery::dtNavMeshQuery() :
 	m_tinyNodePool(0),
 	m_nodePool(0),
 	m_openList(0),
+	m_clusterPath(0),
+	m_maxClusterPath(0),
 	m_queryNodes(0)
 {
 	memset(&m_query, 0, sizeof(dtQueryData));
@@ -217,6 +230,7 @@ dtNavMeshQuery::~dtNavMeshQuery()
 	dtFree(m_tinyNodePool);
 	dtFree(m_nodePool);
 	dtFree(m_openList);
+	dtFree(m_clusterPath);
 }
 
 /// @par 
@@ -284,6 +298,19 @@ dtStatus dtNavMeshQuery::init(const dtNavMesh* nav, const int maxNodes, dtQueryS
 		{
 			m_openList->clear();
 		}
+
+//@UE4 BEGIN
+		// the cluster path can't be longer than the number of nodes its search can visit
+		if (!m_clusterPath || m_maxClusterPath < maxNodes)
+		{
+			dtFree(m_clusterPath);
+			m_maxClusterPath = 0;
+			m_clusterPath = (dtClusterRef*)dtAlloc(sizeof(dtClusterRef) * maxNodes, DT_ALLOC_PERM);
+			if (!m_clusterPath)
+				return DT_FAILURE | DT_OUT_OF_MEMORY;
+			m_maxClusterPath = maxNodes;
+		}
+//@UE4 END
 	}
 	
 	return DT_SUCCESS;
@@ -1425,6 +1452,224 @@ dtStatus dtNavMeshQuery::findPath(dtPolyRef startRef, dtPolyRef endRef,
 								  const float* startPos, const float* endPos,
 								  const float costLimit, const dtQueryFilter* filter, //@UE4
 								  dtQueryResult& result, float* totalCost) const
+{
+	return findPathInClusters(startRef, endRef, startPos, endPos, costLimit, filter, 0, 0, result, totalCost);
+}
+
+//@UE4 BEGIN
+static bool dtContainsClusterRef(const dtClusterRef* clusters, const int clusterCount, const dtClusterRef ref)
+{
+	int lo = 0;
+	int hi = clusterCount - 1;
+	while (lo <= hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if (clusters[mid] == ref)
+			return true;
+		if (clusters[mid] < ref)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return false;
+}
+
+static int dtCompareClusterRefs(const void* a, const void* b)
+{
+	const dtClusterRef refA = *(const dtClusterRef*)a;
+	const dtClusterRef refB = *(const dtClusterRef*)b;
+	return refA < refB ? -1 : (refA > refB ? 1 : 0);
+}
+
+dtStatus dtNavMeshQuery::findClusterPath(dtPolyRef startRef, dtPolyRef endRef,
+										 dtClusterRef* path, int* pathCount, const int maxPath) const
+{
+	dtAssert(m_nav);
+	dtAssert(m_nodePool);
+	dtAssert(m_openList);
+
+	*pathCount = 0;
+	m_queryNodes = 0;
+
+	if (!path || maxPath < 1)
+		return DT_FAILURE | DT_INVALID_PARAM;
+
+	dtClusterRef startCRef = 0;
+	dtClusterRef endCRef = 0;
+	if (dtStatusFailed(getPolyCluster(startRef, startCRef)) || dtStatusFailed(getPolyCluster(endRef, endCRef)))
+	{
+		// the hierarchical graph has not been built, or one of the polys is an off-mesh connection
+		return DT_FAILURE | DT_INVALID_PARAM;
+	}
+
+	if (startCRef == endCRef)
+	{
+		path[0] = startCRef;
+		*pathCount = 1;
+		return DT_SUCCESS;
+	}
+
+	const dtMeshTile* endTile = m_nav->getTileByRef(endRef);
+	const dtCluster& endCluster = endTile->clusters[m_nav->decodeClusterIdCluster(endCRef)];
+	const dtMeshTile* startTile = m_nav->getTileByRef(startRef);
+	const dtCluster& startCluster = startTile->clusters[m_nav->decodeClusterIdCluster(startCRef)];
+
+	m_nodePool->clear();
+	m_openList->clear();
+
+	dtNode* startNode = m_nodePool->getNode(startCRef);
+	dtVcopy(startNode->pos, startCluster.center);
+	startNode->pidx = 0;
+	startNode->cost = 0;
+	startNode->total = dtVdist(startCluster.center, endCluster.center);
+	startNode->id = startCRef;
+	startNode->flags = DT_NODE_OPEN;
+	m_openList->push(startNode);
+	m_queryNodes++;
+
+	dtNode* endNode = 0;
+	dtStatus status = DT_SUCCESS;
+
+	while (!m_openList->empty())
+	{
+		dtNode* bestNode = m_openList->pop();
+		bestNode->flags &= ~DT_NODE_OPEN;
+		bestNode->flags |= DT_NODE_CLOSED;
+
+		if (bestNode->id == endCRef)
+		{
+			endNode = bestNode;
+			break;
+		}
+
+		const dtClusterRef bestRef = bestNode->id;
+		const dtMeshTile* bestTile = m_nav->getTileByRef(bestRef);
+		const dtCluster* bestCluster = &bestTile->clusters[m_nav->decodeClusterIdCluster(bestRef)];
+		const dtClusterRef parentRef = (bestNode->pidx) ? m_nodePool->getNodeAtIdx(bestNode->pidx)->id : 0;
+
+		unsigned int i = bestCluster->firstLink;
+		while (i != DT_NULL_LINK)
+		{
+			const dtClusterLink& link = m_nav->getClusterLink(bestTile, i);
+			i = link.next;
+
+			const dtClusterRef neighbourRef = link.ref;
+			if (!neighbourRef || neighbourRef == parentRef || (link.flags & DT_CLINK_VALID_FWD) == 0)
+				continue;
+
+			const dtMeshTile* neighbourTile = m_nav->getTileByRef(neighbourRef);
+			const dtCluster* neighbourCluster = &neighbourTile->clusters[m_nav->decodeClusterIdCluster(neighbourRef)];
+
+			dtNode* neighbourNode = m_nodePool->getNode(neighbourRef);
+			if (!neighbourNode)
+			{
+				status |= DT_OUT_OF_NODES;
+				continue;
+			}
+
+			// unlike testClusterPath, accumulate the distance between cluster centers so that the cluster path is short
+			const float cost = bestNode->cost + dtVdist(bestNode->pos, neighbourCluster->center);
+			const float heuristic = (neighbourRef != endCRef) ? dtVdist(neighbourCluster->center, endCluster.center) : 0.0f;
+			const float total = cost + heuristic;
+
+			if ((neighbourNode->flags & DT_NODE_OPEN) && total >= neighbourNode->total)
+				continue;
+			if ((neighbourNode->flags & DT_NODE_CLOSED) && total >= neighbourNode->total)
+				continue;
+
+			neighbourNode->pidx = m_nodePool->getNodeIdx(bestNode);
+			neighbourNode->id = neighbourRef;
+			neighbourNode->flags = (neighbourNode->flags & ~DT_NODE_CLOSED);
+			neighbourNode->cost = cost;
+			neighbourNode->total = total;
+			dtVcopy(neighbourNode->pos, neighbourCluster->center);
+
+			if (neighbourNode->flags & DT_NODE_OPEN)
+			{
+				m_openList->modify(neighbourNode);
+			}
+			else
+			{
+				neighbourNode->flags |= DT_NODE_OPEN;
+				m_openList->push(neighbourNode);
+				m_queryNodes++;
+			}
+		}
+	}
+
+	if (endNode == 0)
+	{
+		return DT_FAILURE | (status & DT_STATUS_DETAIL_MASK);
+	}
+
+	// count and store the path, from end to start
+	int n = 0;
+	for (const dtNode* node = endNode; node; node = m_nodePool->getNodeAtIdx(node->pidx))
+	{
+		n++;
+	}
+
+	if (n > maxPath)
+	{
+		return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+	}
+
+	int idx = n - 1;
+	for (const dtNode* node = endNode; node; node = m_nodePool->getNodeAtIdx(node->pidx))
+	{
+		path[idx--] = node->id;
+	}
+
+	*pathCount = n;
+	return status;
+}
+
+dtStatus dtNavMeshQuery::findPathHierarchical(dtPolyRef startRef, dtPolyRef endRef,
+											  const float* startPos, const float* endPos,
+											  const float costLimit, const dtQueryFilter* filter,
+											  dtQueryResult& result, float* totalCost) const
+{
+	dtAssert(m_nav);
+	dtAssert(m_nodePool);
+	dtAssert(m_clusterPath);
+
+	if (!startRef || !endRef || !m_nav->isValidPolyRef(startRef) || !m_nav->isValidPolyRef(endRef))
+		return DT_FAILURE | DT_INVALID_PARAM;
+
+	int clusterCount = 0;
+	const dtStatus clusterStatus = findClusterPath(startRef, endRef, m_clusterPath, &clusterCount, m_maxClusterPath);
+	int visitedNodes = m_queryNodes;
+
+	if (dtStatusSucceed(clusterStatus))
+	{
+		qsort(m_clusterPath, clusterCount, sizeof(dtClusterRef), dtCompareClusterRefs);
+
+		dtQueryResult refinedResult;
+		const dtStatus status = findPathInClusters(startRef, endRef, startPos, endPos, costLimit, filter, m_clusterPath, clusterCount, refinedResult, totalCost);
+		visitedNodes += m_queryNodes;
+
+		// the cluster graph doesn't know about area costs and filters, so the restricted search may not get through
+		if (dtStatusSucceed(status) && !dtStatusDetail(status, DT_PARTIAL_RESULT))
+		{
+			result.copyFrom(refinedResult);
+			m_queryNodes = visitedNodes;
+			return status;
+		}
+	}
+
+	// no cluster path, or it didn't reach the end polygon: regular search over the whole navmesh
+	const dtStatus status = findPath(startRef, endRef, startPos, endPos, costLimit, filter, result, totalCost);
+	m_queryNodes += visitedNodes;
+	return status;
+}
+
+//@UE4 END
+
+dtStatus dtNavMeshQuery::findPathInClusters(dtPolyRef startRef, dtPolyRef endRef,
+											const float* startPos, const float* endPos,
+											const float costLimit, const dtQueryFilter* filter,
+											const dtClusterRef* clusters, const int clusterCount, //@UE4
+											dtQueryResult& result, float* totalCost) const
 {
 	dtAssert(m_nav);
 	dtAssert(m_nodePool);
@@ -1532,6 +1777,15 @@ dtStatus dtNavMeshQuery::findPath(dtPolyRef startRef, dtPolyRef endRef,
 			if (!filter->passFilter(neighbourRef, neighbourTile, neighbourPoly) || !passLinkFilterByRef(neighbourTile, neighbourRef))
 				continue;
 
+//@UE4 BEGIN
+			if (clusters)
+			{
+				dtClusterRef neighbourCluster = 0;
+				if (dtStatusSucceed(getPolyCluster(neighbourRef, neighbourCluster)) && !dtContainsClusterRef(clusters, clusterCount, neighbourCluster))
+					continue;
+			}
+//@UE4 END
+
 			dtNode* neighbourNode = m_nodePool->getNode(neighbourRef);
 			if (!neighbourNode)
 			{
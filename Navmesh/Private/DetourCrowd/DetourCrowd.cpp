@@ -23,6 +23,7 @@
 #include "DetourCrowd/DetourProximityGrid.h"
 #define _USE_MATH_DEFINES
 #include "Detour/DetourAssert.h"
+#include "Async/ParallelFor.h"
 
 
 dtCrowd* dtAllocCrowd()
@@ -181,8 +182,8 @@ static int addNeighbour(const int idx, const float dist,
 }
 
 static int getNeighbours(const float* pos, const float height, const float range,
-						 const dtCrowdAgent* skip, dtCrowdNeighbour* result, const int maxResult,
-						 dtCrowdAgent** agents, const int /*nagents*/, dtProximityGrid* grid)
+						 const dtCrowdAgent* skip, const int skipIdx, dtCrowdNeighbour* result, const int maxResult,
+						 const dtCrowdProximityItem* items, const int /*nagents*/, const dtProximityGrid* grid)
 {
 	int n = 0;
 	
@@ -194,14 +195,14 @@ static int getNeighbours(const float* pos, const float height, const float range
 	
 	for (int i = 0; i < nids; ++i)
 	{
-		const dtCrowdAgent* ag = agents[ids[i]];
-		
-		if (ag == skip) continue;
+		// [UE4] read from compact proximity items instead of agents
+		if (ids[i] == skipIdx) continue;
+		const dtCrowdProximityItem* item = &items[ids[i]];
 		
 		// Check for overlap.
 		float diff[3];
-		dtVsub(diff, pos, ag->npos);
-		if (fabsf(diff[1]) >= (height+ag->params.height)/2.0f)
+		dtVsub(diff, pos, item->pos);
+		if (fabsf(diff[1]) >= (height+item->height)/2.0f)
 			continue;
 		diff[1] = 0;
 		const float distSqr = dtVlenSqr(diff);
@@ -209,7 +210,7 @@ static int getNeighbours(const float* pos, const float height, const float range
 			continue;
 
 		// [UE4] add only when avoidance group allows it
-		const bool bDontAvoid = (skip->params.groupsToIgnore & ag->params.avoidanceGroup) || !(skip->params.groupsToAvoid & ag->params.avoidanceGroup);
+		const bool bDontAvoid = (skip->params.groupsToIgnore & item->avoidanceGroup) || !(skip->params.groupsToAvoid & item->avoidanceGroup);
 		if (bDontAvoid)
 			continue;
 		
@@ -345,7 +346,16 @@ dtCrowd::dtCrowd() :
 	m_navquery(0),
 	m_raycastSingleArea(0),
 	m_keepOffmeshConnections(0),
-	m_earlyReachTest(0)
+	m_earlyReachTest(0),
+	m_proximityItems(0),
+	m_maxUpdateWorkers(1),
+	m_minAgentsPerBatch(64),
+	m_workerNavQueries(0),
+	m_workerObstacleQueries(0),
+	m_numWorkerQueries(0),
+	m_maxAvoidedNeighbors(0),
+	m_maxAvoidedWalls(0),
+	m_maxAvoidancePatterns(0)
 {
 }
 
@@ -375,6 +385,12 @@ void dtCrowd::purge()
 	dtFreeProximityGrid(m_grid);
 	m_grid = 0;
 
+	dtFree(m_proximityItems);
+	m_proximityItems = 0;
+
+	// parallel update settings are kept, worker queries are recreated by init
+	freeWorkerQueries();
+
 	dtFreeObstacleAvoidanceQuery(m_obstacleQuery);
 	m_obstacleQuery = 0;
 	
@@ -401,6 +417,10 @@ bool dtCrowd::init(const int maxAgents, const float maxAgentRadius, dtNavMesh* n
 	if (!m_grid->init(m_maxAgents*4, maxAgentRadius*3))
 		return false;
 
+	m_proximityItems = (dtCrowdProximityItem*)dtAlloc(sizeof(dtCrowdProximityItem)*m_maxAgents, DT_ALLOC_PERM);
+	if (!m_proximityItems)
+		return false;
+
 	// [UE4] moved avoidance query init to separate function
 
 	// Allocate temp buffer for merging paths.
@@ -452,7 +472,7 @@ bool dtCrowd::init(const int maxAgents, const float maxAgentRadius, dtNavMesh* n
 	m_sharedBoundary.Initialize();
 	m_separationDirFilter = -1.0f;
 
-	return true;
+	return initWorkerQueries();
 }
 
 bool dtCrowd::initAvoidance(const int maxNeighbors, const int maxWalls, const int maxCustomPatterns)
@@ -463,6 +483,10 @@ bool dtCrowd::initAvoidance(const int maxNeighbors, const int maxWalls, const in
 	if (!m_obstacleQuery->init(maxNeighbors, maxWalls, maxCustomPatterns))
 		return false;
 
+	m_maxAvoidedNeighbors = maxNeighbors;
+	m_maxAvoidedWalls = maxWalls;
+	m_maxAvoidancePatterns = maxCustomPatterns;
+
 	// Init obstacle query params.
 	memset(m_obstacleQueryParams, 0, sizeof(m_obstacleQueryParams));
 	for (int i = 0; i < DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS; ++i)
@@ -480,7 +504,7 @@ bool dtCrowd::initAvoidance(const int maxNeighbors, const int maxWalls, const in
 		params->adaptiveDepth = 5;
 	}
 
-	return true;
+	return initWorkerQueries();
 }
 
 void dtCrowd::setObstacleAvoidanceParams(const int idx, const dtObstacleAvoidanceParams* params)
@@ -499,6 +523,115 @@ const dtObstacleAvoidanceParams* dtCrowd::getObstacleAvoidanceParams(const int i
 void dtCrowd::setObstacleAvoidancePattern(int idx, const float* angles, const float* radii, int nsamples)
 {
 	m_obstacleQuery->setCustomSamplingPattern(idx, angles, radii, nsamples);
+
+	for (int i = 0; i < m_numWorkerQueries; ++i)
+	{
+		if (m_workerObstacleQueries[i])
+			m_workerObstacleQueries[i]->setCustomSamplingPattern(idx, angles, radii, nsamples);
+	}
+}
+
+// [UE4] parallel agent update
+bool dtCrowd::setParallelUpdate(const int maxWorkers, const int minAgentsPerBatch)
+{
+	m_minAgentsPerBatch = dtMax(minAgentsPerBatch, 1);
+
+	const int numWorkers = dtMax(maxWorkers, 1);
+	if (numWorkers == m_maxUpdateWorkers)
+		return (m_numWorkerQueries + 1 == m_maxUpdateWorkers) || !m_navquery;
+
+	m_maxUpdateWorkers = numWorkers;
+	return initWorkerQueries();
+}
+
+bool dtCrowd::initWorkerQueries()
+{
+	freeWorkerQueries();
+
+	// wait for init, it will call this again
+	const int numQueries = m_maxUpdateWorkers - 1;
+	if (numQueries <= 0 || !m_navquery)
+		return true;
+
+	m_workerNavQueries = (dtNavMeshQuery**)dtAlloc(sizeof(dtNavMeshQuery*)*numQueries, DT_ALLOC_PERM);
+	m_workerObstacleQueries = (dtObstacleAvoidanceQuery**)dtAlloc(sizeof(dtObstacleAvoidanceQuery*)*numQueries, DT_ALLOC_PERM);
+	if (!m_workerNavQueries || !m_workerObstacleQueries)
+	{
+		freeWorkerQueries();
+		return false;
+	}
+
+	memset(m_workerNavQueries, 0, sizeof(dtNavMeshQuery*)*numQueries);
+	memset(m_workerObstacleQueries, 0, sizeof(dtObstacleAvoidanceQuery*)*numQueries);
+	m_numWorkerQueries = numQueries;
+
+	float angles[DT_MAX_CUSTOM_SAMPLES];
+	float radii[DT_MAX_CUSTOM_SAMPLES];
+	for (int i = 0; i < numQueries; ++i)
+	{
+		m_workerNavQueries[i] = dtAllocNavMeshQuery();
+		if (!m_workerNavQueries[i] || dtStatusFailed(m_workerNavQueries[i]->init(m_navquery->getAttachedNavMesh(), MAX_COMMON_NODES)))
+		{
+			freeWorkerQueries();
+			return false;
+		}
+
+		if (m_obstacleQuery)
+		{
+			m_workerObstacleQueries[i] = dtAllocObstacleAvoidanceQuery();
+			if (!m_workerObstacleQueries[i] || !m_workerObstacleQueries[i]->init(m_maxAvoidedNeighbors, m_maxAvoidedWalls, m_maxAvoidancePatterns))
+			{
+				freeWorkerQueries();
+				return false;
+			}
+
+			for (int patternIdx = 0; patternIdx < m_maxAvoidancePatterns; ++patternIdx)
+			{
+				int nsamples = 0;
+				if (m_obstacleQuery->getCustomSamplingPattern(patternIdx, angles, radii, &nsamples) && nsamples > 0)
+				{
+					m_workerObstacleQueries[i]->setCustomSamplingPattern(patternIdx, angles, radii, nsamples);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void dtCrowd::freeWorkerQueries()
+{
+	for (int i = 0; i < m_numWorkerQueries; ++i)
+	{
+		dtFreeNavMeshQuery(m_workerNavQueries[i]);
+		dtFreeObstacleAvoidanceQuery(m_workerObstacleQueries[i]);
+	}
+
+	dtFree(m_workerNavQueries);
+	m_workerNavQueries = 0;
+	dtFree(m_workerObstacleQueries);
+	m_workerObstacleQueries = 0;
+	m_numWorkerQueries = 0;
+}
+
+int dtCrowd::getUpdateBatchCount() const
+{
+	return dtClamp(m_numActiveAgents / m_minAgentsPerBatch, 1, m_numWorkerQueries + 1);
+}
+
+/// Runs func over contiguous ranges of active agents, batch index selects the queries used by the range.
+static void forEachAgentBatch(const int nagents, const int nbatches, TFunctionRef<void(const int batchIdx, const int beginIdx, const int endIdx)> func)
+{
+	if (nbatches <= 1)
+	{
+		func(0, 0, nagents);
+		return;
+	}
+
+	ParallelFor(nbatches, [nagents, nbatches, &func](int32 batchIdx)
+	{
+		func(batchIdx, (int)(((int64)nagents * batchIdx) / nbatches), (int)(((int64)nagents * (batchIdx + 1)) / nbatches));
+	});
 }
 
 bool dtCrowd::getObstacleAvoidancePattern(int idx, float* angles, float* radii, int* nsamples)
@@ -1251,6 +1384,11 @@ void dtCrowd::updateStepProximityData(const float dt, dtCrowdAgentDebugInfo* deb
 		const float* p = ag->npos;
 		const float r = ag->params.radius;
 		m_grid->addItem((unsigned short)i, p[0] - r, p[2] - r, p[0] + r, p[2] + r);
+
+		dtCrowdProximityItem* item = &m_proximityItems[i];
+		dtVcopy(item->pos, p);
+		item->height = ag->params.height;
+		item->avoidanceGroup = ag->params.avoidanceGroup;
 	}
 
 	m_sharedBoundary.Tick(dt);
@@ -1301,13 +1439,24 @@ void dtCrowd::updateStepProximityData(const float dt, dtCrowdAgentDebugInfo* deb
 				ag->corridor.getPath(), m_raycastSingleArea ? ag->corridor.getPathCount() : 0,
 				moveDir, m_navquery, &m_filters[ag->params.filter]);
 		}
-		// Query neighbour agents
-		ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
-			ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
-			m_activeAgents, m_numActiveAgents, m_grid);
-		for (int j = 0; j < ag->nneis; j++)
-			ag->neis[j].idx = getAgentIndex(m_activeAgents[ag->neis[j].idx]);
 	}
+
+	// [UE4] Query neighbour agents, boundaries above share cached data and stay serial.
+	forEachAgentBatch(m_numActiveAgents, getUpdateBatchCount(), [this](const int, const int beginIdx, const int endIdx)
+	{
+		for (int i = beginIdx; i < endIdx; ++i)
+		{
+			dtCrowdAgent* ag = m_activeAgents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+
+			ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
+				ag, i, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
+				m_proximityItems, m_numActiveAgents, m_grid);
+			for (int j = 0; j < ag->nneis; j++)
+				ag->neis[j].idx = getAgentIndex(m_activeAgents[ag->neis[j].idx]);
+		}
+	});
 }
 
 void dtCrowd::updateStepNextMovePoint(const float dt, dtCrowdAgentDebugInfo* debug)
@@ -1428,103 +1577,107 @@ void dtCrowd::updateStepNextMovePoint(const float dt, dtCrowdAgentDebugInfo* deb
 
 void dtCrowd::updateStepSteering(const float dt, dtCrowdAgentDebugInfo*)
 {
-	// Calculate steering.
-	for (int i = 0; i < m_numActiveAgents; ++i)
+	// [UE4] agents write only their own desired velocity, batches can run in parallel
+	forEachAgentBatch(m_numActiveAgents, getUpdateBatchCount(), [this](const int, const int beginIdx, const int endIdx)
 	{
-		dtCrowdAgent* ag = m_activeAgents[i];
-
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE)
-			continue;
-
-		float dvel[3] = { 0, 0, 0 };
-
-		if (ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-		{
-			dtVcopy(dvel, ag->targetPos);
-			ag->desiredSpeed = dtVlen(ag->targetPos);
-		}
-		else
+		// Calculate steering.
+		for (int i = beginIdx; i < endIdx; ++i)
 		{
-			// Calculate steering direction.
-			if (ag->params.updateFlags & DT_CROWD_ANTICIPATE_TURNS)
-				calcSmoothSteerDirection(ag, dvel);
-			else
-				calcStraightSteerDirection(ag, dvel);
+			dtCrowdAgent* ag = m_activeAgents[i];
+
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE)
+				continue;
 
-			float speedScale = 1.0f;
+			float dvel[3] = { 0, 0, 0 };
 
-			if (ag->params.updateFlags & DT_CROWD_SLOWDOWN_AT_GOAL)
+			if (ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
 			{
-				// Calculate speed scale, which tells the agent to slowdown at the end of the path.
-				const float slowDownRadius = ag->params.radius * 2;	// TODO: make less hacky.
-				speedScale = getDistanceToGoal(ag, slowDownRadius) / slowDownRadius;
+				dtVcopy(dvel, ag->targetPos);
+				ag->desiredSpeed = dtVlen(ag->targetPos);
 			}
+			else
+			{
+				// Calculate steering direction.
+				if (ag->params.updateFlags & DT_CROWD_ANTICIPATE_TURNS)
+					calcSmoothSteerDirection(ag, dvel);
+				else
+					calcStraightSteerDirection(ag, dvel);
 
-			ag->desiredSpeed = ag->params.maxSpeed;
-			dtVscale(dvel, dvel, ag->desiredSpeed * speedScale);
-		}
+				float speedScale = 1.0f;
 
-		// Separation
-		if (ag->params.updateFlags & DT_CROWD_SEPARATION)
-		{
-			const float separationDist = ag->params.collisionQueryRange;
-			const float invSeparationDist = 1.0f / separationDist;
-			const float separationWeight = ag->params.separationWeight;
-			const float upDir[3] = { 0, 1.0f, 0 };
+				if (ag->params.updateFlags & DT_CROWD_SLOWDOWN_AT_GOAL)
+				{
+					// Calculate speed scale, which tells the agent to slowdown at the end of the path.
+					const float slowDownRadius = ag->params.radius * 2;	// TODO: make less hacky.
+					speedScale = getDistanceToGoal(ag, slowDownRadius) / slowDownRadius;
+				}
 
-			float w = 0;
-			float disp[3] = { 0, 0, 0 };
+				ag->desiredSpeed = ag->params.maxSpeed;
+				dtVscale(dvel, dvel, ag->desiredSpeed * speedScale);
+			}
 
-			for (int j = 0; j < ag->nneis; ++j)
+			// Separation
+			if (ag->params.updateFlags & DT_CROWD_SEPARATION)
 			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+				const float separationDist = ag->params.collisionQueryRange;
+				const float invSeparationDist = 1.0f / separationDist;
+				const float separationWeight = ag->params.separationWeight;
+				const float upDir[3] = { 0, 1.0f, 0 };
 
-				float diff[3];
-				dtVsub(diff, ag->npos, nei->npos);
-				diff[1] = 0;
-				
-				const float distSqr = dtVlenSqr(diff);
-				if (distSqr < 0.00001f)
-					continue;
-				if (distSqr > dtSqr(separationDist))
-					continue;
-				const float dist = sqrtf(distSqr);
-				const float weight = separationWeight * (1.0f - dtSqr(dist*invSeparationDist));
+				float w = 0;
+				float disp[3] = { 0, 0, 0 };
 
-				float sepDot = dtVdot(diff, dvel);
-				if (sepDot < m_separationDirFilter)
+				for (int j = 0; j < ag->nneis; ++j)
 				{
-					// [UE4]: clamp to right/left vector, depending on which side nei is
-					float testDir[3] = { 0, 0, 0 };
-					dtVcross(testDir, dvel, diff);
-					const bool bRightSide = (testDir[1] > 0);
-
-					dtVcross(diff, upDir, dvel);
-					dtVnormalize(diff);
-					dtVscale(diff, diff, bRightSide ? dist : -dist);
+					const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+
+					float diff[3];
+					dtVsub(diff, ag->npos, nei->npos);
+					diff[1] = 0;
+				
+					const float distSqr = dtVlenSqr(diff);
+					if (distSqr < 0.00001f)
+						continue;
+					if (distSqr > dtSqr(separationDist))
+						continue;
+					const float dist = sqrtf(distSqr);
+					const float weight = separationWeight * (1.0f - dtSqr(dist*invSeparationDist));
+
+					float sepDot = dtVdot(diff, dvel);
+					if (sepDot < m_separationDirFilter)
+					{
+						// [UE4]: clamp to right/left vector, depending on which side nei is
+						float testDir[3] = { 0, 0, 0 };
+						dtVcross(testDir, dvel, diff);
+						const bool bRightSide = (testDir[1] > 0);
+
+						dtVcross(diff, upDir, dvel);
+						dtVnormalize(diff);
+						dtVscale(diff, diff, bRightSide ? dist : -dist);
+					}
+
+					dtVmad(disp, disp, diff, weight / dist);
+					w += 1.0f;
 				}
 
-				dtVmad(disp, disp, diff, weight / dist);
-				w += 1.0f;
+				if (w > 0.0001f)
+				{
+					// Adjust desired velocity.
+					dtVmad(dvel, dvel, disp, 1.0f / w);
+					// Clamp desired velocity to desired speed.
+					const float speedSqr = dtVlenSqr(dvel);
+					const float desiredSqr = dtSqr(ag->desiredSpeed);
+					if (speedSqr > desiredSqr)
+						dtVscale(dvel, dvel, desiredSqr / speedSqr);
+				}
 			}
 
-			if (w > 0.0001f)
-			{
-				// Adjust desired velocity.
-				dtVmad(dvel, dvel, disp, 1.0f / w);
-				// Clamp desired velocity to desired speed.
-				const float speedSqr = dtVlenSqr(dvel);
-				const float desiredSqr = dtSqr(ag->desiredSpeed);
-				if (speedSqr > desiredSqr)
-					dtVscale(dvel, dvel, desiredSqr / speedSqr);
-			}
+			// Set the desired velocity.
+			dtVcopy(ag->dvel, dvel);
 		}
-
-		// Set the desired velocity.
-		dtVcopy(ag->dvel, dvel);
-	}
+	});
 }
 
 void dtCrowd::updateStepAvoidance(const float dt, dtCrowdAgentDebugInfo* debug)
@@ -1532,53 +1685,62 @@ void dtCrowd::updateStepAvoidance(const float dt, dtCrowdAgentDebugInfo* debug)
 	const int debugIdx = debug ? debug->idx : -1;
 	m_velocitySampleCount = 0;
 
-	// Velocity planning.	
-	for (int i = 0; i < m_numActiveAgents; ++i)
+	// [UE4] agents write only their own new velocity, each batch samples with its own obstacle query
+	forEachAgentBatch(m_numActiveAgents, getUpdateBatchCount(), [this, debug, debugIdx](const int batchIdx, const int beginIdx, const int endIdx)
 	{
-		dtCrowdAgent* ag = m_activeAgents[i];
-
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
+		dtObstacleAvoidanceQuery* obstacleQuery = getWorkerObstacleQuery(batchIdx);
+		int velocitySampleCount = 0;
 
-		if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
+		// Velocity planning.	
+		for (int i = beginIdx; i < endIdx; ++i)
 		{
-			m_obstacleQuery->reset();
+			dtCrowdAgent* ag = m_activeAgents[i];
 
-			// Add neighbours as obstacles.
-			for (int j = 0; j < ag->nneis; ++j)
-			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
-				m_obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
-			}
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
 
-			// Append neighbour segments as obstacles.
-			for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+			if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
 			{
-				const float* s = ag->boundary.getSegment(j);
-				if (dtTriArea2D(ag->npos, s, s + 3) < 0.0f)
-					continue;
-				m_obstacleQuery->addSegment(s, s + 3, ag->boundary.getSegmentFlags(j));
-			}
+				obstacleQuery->reset();
 
-			dtObstacleAvoidanceDebugData* vod = 0;
-			const int agIndex = getAgentIndex(ag);
-			if (debug && debugIdx == agIndex)
-				vod = debug->vod;
+				// Add neighbours as obstacles.
+				for (int j = 0; j < ag->nneis; ++j)
+				{
+					const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+					obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
+				}
 
-			// Sample new safe velocity.
-			const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
-			const int ns = m_obstacleQuery->sampleVelocity(ag->npos, ag->params.radius,
-					ag->desiredSpeed, ag->params.avoidanceQueryMultiplier,
-					ag->vel, ag->dvel, ag->nvel, params, vod);
+				// Append neighbour segments as obstacles.
+				for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+				{
+					const float* s = ag->boundary.getSegment(j);
+					if (dtTriArea2D(ag->npos, s, s + 3) < 0.0f)
+						continue;
+					obstacleQuery->addSegment(s, s + 3, ag->boundary.getSegmentFlags(j));
+				}
 
-			m_velocitySampleCount += ns;
-		}
-		else
-		{
-			// If not using velocity planning, new velocity is directly the desired velocity.
-			dtVcopy(ag->nvel, ag->dvel);
+				dtObstacleAvoidanceDebugData* vod = 0;
+				const int agIndex = getAgentIndex(ag);
+				if (debug && debugIdx == agIndex)
+					vod = debug->vod;
+
+				// Sample new safe velocity.
+				const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
+				const int ns = obstacleQuery->sampleVelocity(ag->npos, ag->params.radius,
+						ag->desiredSpeed, ag->params.avoidanceQueryMultiplier,
+						ag->vel, ag->dvel, ag->nvel, params, vod);
+
+				velocitySampleCount += ns;
+			}
+			else
+			{
+				// If not using velocity planning, new velocity is directly the desired velocity.
+				dtVcopy(ag->nvel, ag->dvel);
+			}
 		}
-	}
+
+		FPlatformAtomics::InterlockedAdd(&m_velocitySampleCount, velocitySampleCount);
+	});
 }
 
 void dtCrowd::updateStepMove(const float dt, dtCrowdAgentDebugInfo*)
@@ -1662,27 +1824,33 @@ void dtCrowd::updateStepMove(const float dt, dtCrowdAgentDebugInfo*)
 
 void dtCrowd::updateStepCorridor(const float dt, dtCrowdAgentDebugInfo*)
 {
-	for (int i = 0; i < m_numActiveAgents; ++i)
+	// [UE4] corridors are independent, each batch moves them with its own navmesh query
+	forEachAgentBatch(m_numActiveAgents, getUpdateBatchCount(), [this](const int batchIdx, const int beginIdx, const int endIdx)
 	{
-		dtCrowdAgent* ag = m_activeAgents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
+		dtNavMeshQuery* navquery = getWorkerNavQuery(batchIdx);
 
-		// Move along navmesh.
-		m_navquery->updateLinkFilter(ag->params.linkFilter.Get());
-		const bool bMoved = ag->corridor.movePosition(ag->npos, m_navquery, &m_filters[ag->params.filter]);
-		if (bMoved)
+		for (int i = beginIdx; i < endIdx; ++i)
 		{
-			// Get valid constrained position back.
-			dtVcopy(ag->npos, ag->corridor.getPos());
-		}
+			dtCrowdAgent* ag = m_activeAgents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
 
-		// If not using path, truncate the corridor to just one poly.
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-		{
-			ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
+			// Move along navmesh.
+			navquery->updateLinkFilter(ag->params.linkFilter.Get());
+			const bool bMoved = ag->corridor.movePosition(ag->npos, navquery, &m_filters[ag->params.filter]);
+			if (bMoved)
+			{
+				// Get valid constrained position back.
+				dtVcopy(ag->npos, ag->corridor.getPos());
+			}
+
+			// If not using path, truncate the corridor to just one poly.
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+			{
+				ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
+			}
 		}
-	}
+	});
 }
 
 void dtCrowd::updateStepOffMeshAnim(const float dt, dtCrowdAgentDebugInfo*)
@@ -994,6 +994,102 @@ void rcRasterizeTriangle(rcContext* ctx, const float* v0, const float* v1, const
 	ctx->stopTimer(RC_TIMER_RASTERIZE_TRIANGLES);
 }
 
+//@UE4 BEGIN
+/// Tests 4 triangles with the same conditions as the early outs of rasterizeTri, and returns
+/// a bit mask of the triangles that don't touch the heightfield and can be skipped.
+/// Triangles too far away to convert their footprint to cells are never skipped, rasterizeTri
+/// deals with them, so the result of the rasterization doesn't depend on the batching.
+static int rejectTriangles4(const float* const* tv, const float* bmin, const float ics, const float by, const int w, const int h)
+{
+	const VectorRegister MinX = VectorSetFloat1(bmin[0]);
+	const VectorRegister MinY = VectorSetFloat1(bmin[1]);
+	const VectorRegister MinZ = VectorSetFloat1(bmin[2]);
+	const VectorRegister InvCellSize = VectorSetFloat1(ics);
+	const VectorRegister MaxCellCoord = VectorSetFloat1(1.0e9f);
+
+	VectorRegister FootMinX = VectorSetFloat1(MAX_flt), FootMinZ = FootMinX, SpanMin = FootMinX;
+	VectorRegister FootMaxX = VectorSetFloat1(-MAX_flt), FootMaxZ = FootMaxX, SpanMax = FootMaxX;
+	VectorRegister InRange = VectorCompareEQ(MinX, MinX);
+	for (int j = 0; j < 3; ++j)
+	{
+		const VectorRegister X = VectorSet(tv[j][0], tv[3 + j][0], tv[6 + j][0], tv[9 + j][0]);
+		const VectorRegister Y = VectorSet(tv[j][1], tv[3 + j][1], tv[6 + j][1], tv[9 + j][1]);
+		const VectorRegister Z = VectorSet(tv[j][2], tv[3 + j][2], tv[6 + j][2], tv[9 + j][2]);
+
+		// same operations as the footprint calculation in rasterizeTri, before flooring
+		const VectorRegister CellX = VectorMultiply(VectorSubtract(X, MinX), InvCellSize);
+		const VectorRegister CellZ = VectorMultiply(VectorSubtract(Z, MinZ), InvCellSize);
+
+		// also false for NaNs
+		InRange = VectorBitwiseAnd(InRange, VectorBitwiseAnd(VectorCompareLT(VectorAbs(CellX), MaxCellCoord), VectorCompareLT(VectorAbs(CellZ), MaxCellCoord)));
+		InRange = VectorBitwiseAnd(InRange, VectorCompareEQ(Y, Y));
+
+		FootMinX = VectorMin(FootMinX, CellX);
+		FootMaxX = VectorMax(FootMaxX, CellX);
+		FootMinZ = VectorMin(FootMinZ, CellZ);
+		FootMaxZ = VectorMax(FootMaxZ, CellZ);
+		SpanMin = VectorMin(SpanMin, Y);
+		SpanMax = VectorMax(SpanMax, Y);
+	}
+	SpanMin = VectorSubtract(SpanMin, MinY);
+	SpanMax = VectorSubtract(SpanMax, MinY);
+
+	// floor(a) < 0 <=> a < 0 and floor(a) >= n <=> a >= n for integer n
+	const VectorRegister Zero = VectorZero();
+	VectorRegister Outside = VectorBitwiseOr(VectorCompareLT(FootMaxX, Zero), VectorCompareGE(FootMinX, VectorSetFloat1((float)w)));
+	Outside = VectorBitwiseOr(Outside, VectorBitwiseOr(VectorCompareLT(FootMaxZ, Zero), VectorCompareGE(FootMinZ, VectorSetFloat1((float)h))));
+	Outside = VectorBitwiseOr(Outside, VectorBitwiseOr(VectorCompareLT(SpanMax, Zero), VectorCompareGT(SpanMin, VectorSetFloat1(by))));
+
+	return VectorMaskBits(VectorBitwiseAnd(Outside, InRange));
+}
+
+/// Rasterizes triangles in order, skipping batches of triangles outside of the heightfield early.
+/// Triangles are read from @p tris when set, or consecutively from @p verts otherwise.
+template<typename IndexType>
+static void rasterizeTris(const float* verts, const IndexType* tris, const unsigned char* areas, const int nt,
+						  rcHeightfield& solid, const int flagMergeThr, const int rasterizationFlags)
+{
+	const float ics = 1.0f/solid.cs;
+	const float ich = 1.0f/solid.ch;
+	const float by = solid.bmax[1] - solid.bmin[1];
+
+	int i = 0;
+	if ((rasterizationFlags & RC_NO_BATCHED_TRIANGLE_CULLING) == 0)
+	{
+		const float* tv[12];
+		for (; i + 4 <= nt; i += 4)
+		{
+			for (int k = 0; k < 12; ++k)
+			{
+				tv[k] = tris ? &verts[tris[i*3+k]*3] : &verts[(i*3+k)*3];
+			}
+
+			const int rejected = rejectTriangles4(tv, solid.bmin, ics, by, solid.width, solid.height);
+			if (rejected == 0xf)
+			{
+				continue;
+			}
+
+			for (int k = 0; k < 4; ++k)
+			{
+				if ((rejected & (1 << k)) == 0)
+				{
+					rasterizeTri(tv[k*3+0], tv[k*3+1], tv[k*3+2], areas[i+k], solid, solid.bmin, solid.bmax, solid.cs, ics, ich, flagMergeThr, rasterizationFlags);
+				}
+			}
+		}
+	}
+
+	for (; i < nt; ++i)
+	{
+		const float* v0 = tris ? &verts[tris[i*3+0]*3] : &verts[(i*3+0)*3];
+		const float* v1 = tris ? &verts[tris[i*3+1]*3] : &verts[(i*3+1)*3];
+		const float* v2 = tris ? &verts[tris[i*3+2]*3] : &verts[(i*3+2)*3];
+		rasterizeTri(v0, v1, v2, areas[i], solid, solid.bmin, solid.bmax, solid.cs, ics, ich, flagMergeThr, rasterizationFlags);
+	}
+}
+//@UE4 END
+
 /// @par
 ///
 /// Spans will only be added for triangles that overlap the heightfield grid.
@@ -1006,17 +1102,7 @@ void rcRasterizeTriangles(rcContext* ctx, const float* verts, const int /*nv*/,
 	if (ctx)
 		ctx->startTimer(RC_TIMER_RASTERIZE_TRIANGLES);
 	
-	const float ics = 1.0f/solid.cs;
-	const float ich = 1.0f/solid.ch;
-	// Rasterize triangles.
-	for (int i = 0; i < nt; ++i)
-	{
-		const float* v0 = &verts[tris[i*3+0]*3];
-		const float* v1 = &verts[tris[i*3+1]*3];
-		const float* v2 = &verts[tris[i*3+2]*3];
-		// Rasterize.
-		rasterizeTri(v0, v1, v2, areas[i], solid, solid.bmin, solid.bmax, solid.cs, ics, ich, flagMergeThr, rasterizationFlags); //UE4
-	}
+	rasterizeTris(verts, tris, areas, nt, solid, flagMergeThr, rasterizationFlags); //UE4
 	
 	if (ctx)
 		ctx->stopTimer(RC_TIMER_RASTERIZE_TRIANGLES);
@@ -1034,17 +1120,7 @@ void rcRasterizeTriangles(rcContext* ctx, const float* verts, const int /*nv*/,
 	if (ctx)
 		ctx->startTimer(RC_TIMER_RASTERIZE_TRIANGLES);
 	
-	const float ics = 1.0f/solid.cs;
-	const float ich = 1.0f/solid.ch;
-	// Rasterize triangles.
-	for (int i = 0; i < nt; ++i)
-	{
-		const float* v0 = &verts[tris[i*3+0]*3];
-		const float* v1 = &verts[tris[i*3+1]*3];
-		const float* v2 = &verts[tris[i*3+2]*3];
-		// Rasterize.
-		rasterizeTri(v0, v1, v2, areas[i], solid, solid.bmin, solid.bmax, solid.cs, ics, ich, flagMergeThr, rasterizationFlags); //UE4
-	}
+	rasterizeTris(verts, tris, areas, nt, solid, flagMergeThr, rasterizationFlags); //UE4
 	
 	if (ctx)
 		ctx->stopTimer(RC_TIMER_RASTERIZE_TRIANGLES);
@@ -1061,17 +1137,7 @@ void rcRasterizeTriangles(rcContext* ctx, const float* verts, const unsigned cha
 	if (ctx)
 		ctx->startTimer(RC_TIMER_RASTERIZE_TRIANGLES);
 	
-	const float ics = 1.0f/solid.cs;
-	const float ich = 1.0f/solid.ch;
-	// Rasterize triangles.
-	for (int i = 0; i < nt; ++i)
-	{
-		const float* v0 = &verts[(i*3+0)*3];
-		const float* v1 = &verts[(i*3+1)*3];
-		const float* v2 = &verts[(i*3+2)*3];
-		// Rasterize.
-		rasterizeTri(v0, v1, v2, areas[i], solid, solid.bmin, solid.bmax, solid.cs, ics, ich, flagMergeThr, rasterizationFlags); //UE4
-	}
+	rasterizeTris(verts, (const int*)0, areas, nt, solid, flagMergeThr, rasterizationFlags); //UE4
 	
 	if (ctx)
 		ctx->stopTimer(RC_TIMER_RASTERIZE_TRIANGLES);
@@ -303,6 +303,10 @@ struct NAVMESH_API dtQueryResult
 	void copyPos(float* pos, int nmax);
 	void copyFlags(unsigned char* flags, int nmax);
 	void copyFlags(unsigned int* flags, int nmax);
+//@UE4 BEGIN
+	/// Replaces the contents with a copy of another result.
+	void copyFrom(const dtQueryResult& src);
+//@UE4 END
 
 protected:
 	dtChunkArray<dtQueryResultPack> data;
@@ -359,6 +363,27 @@ public:
 	///  @param[in]		endRef				The reference id of the end polygon.
 	dtStatus testClusterPath(dtPolyRef startRef, dtPolyRef endRef) const; 
 
+//@UE4 BEGIN
+	/// Finds a path from the start polygon to the end polygon using the cluster graph first, and then refining
+	/// the cluster path with a polygon search that is restricted to the clusters along it.
+	/// Falls back to findPath when the cluster graph has not been built, or the refined search doesn't reach the end polygon.
+	/// Parameters are the same as for findPath.
+	dtStatus findPathHierarchical(dtPolyRef startRef, dtPolyRef endRef,
+								  const float* startPos, const float* endPos, const float costLimit,
+								  const dtQueryFilter* filter,
+								  dtQueryResult& result, float* totalCost) const;
+
+	/// Finds the path over the cluster graph from the cluster of the start polygon to the cluster of the end polygon.
+	///  @param[in]		startRef	The reference id of the start polygon.
+	///  @param[in]		endRef		The reference id of the end polygon.
+	///  @param[out]	path		Cluster references, ordered from start to end. [(clusterRef) * @p pathCount]
+	///  @param[out]	pathCount	The number of clusters returned.
+	///  @param[in]		maxPath		The maximum number of clusters the @p path array can hold. [Limit: >= 1]
+	/// @returns The status flags for the query.
+	dtStatus findClusterPath(dtPolyRef startRef, dtPolyRef endRef,
+							 dtClusterRef* path, int* pathCount, const int maxPath) const;
+//@UE4 END
+
 	/// Finds the straight path from the start to the end position within the polygon corridor.
 	///  @param[in]		startPos			Path start position. [(x, y, z)]
 	///  @param[in]		endPos				Path end position. [(x, y, z)]
@@ -748,6 +773,15 @@ public:
 private:
 	//@UE4 END
 
+	//@UE4 BEGIN
+	// Polygon A*, optionally restricted to polygons in a sorted set of clusters (off-mesh connections are never restricted)
+	dtStatus findPathInClusters(dtPolyRef startRef, dtPolyRef endRef,
+								const float* startPos, const float* endPos, const float costLimit,
+								const dtQueryFilter* filter,
+								const dtClusterRef* clusters, const int clusterCount,
+								dtQueryResult& result, float* totalCost) const;
+	//@UE4 END
+
 	// Appends vertex to a straight path
 	dtStatus appendVertex(const float* pos, const unsigned char flags, const dtPolyRef ref,
 						  dtQueryResult& result) const;
@@ -790,6 +824,11 @@ private:
 	class dtNodePool* m_nodePool;		///< Pointer to node pool.
 	class dtNodeQueue* m_openList;		///< Pointer to open list queue.
 
+	//@UE4 BEGIN
+	dtClusterRef* m_clusterPath;		///< Cluster path of findPathHierarchical, sized to the node pool.
+	int m_maxClusterPath;				///< Capacity of m_clusterPath.
+	//@UE4 END
+
 	mutable int m_queryNodes;
 };
 
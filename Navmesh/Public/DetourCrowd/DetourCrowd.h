@@ -223,6 +223,15 @@ struct NAVMESH_API dtCrowdAgentDebugInfo
 	TMap<int32, FString> agentLog;
 };
 
+// [UE4] Compact copy of the agent data read by neighbour queries, rebuilt together with the proximity grid.
+// Indexed the same way as the active agents, so neighbour search doesn't touch the full agent structs.
+struct dtCrowdProximityItem
+{
+	float pos[3];
+	float height;
+	unsigned int avoidanceGroup;
+};
+
 /// Provides local steering behaviors for a group of agents. 
 /// @ingroup crowd
 class NAVMESH_API dtCrowd
@@ -270,6 +279,23 @@ class NAVMESH_API dtCrowd
 	// [UE4] if set, crowd agents will use early reach test
 	bool m_earlyReachTest;
 
+	// [UE4] per active agent data for neighbour queries
+	dtCrowdProximityItem* m_proximityItems;
+
+	// [UE4] parallel agent update: requested number of agent batches and minimum batch size
+	int m_maxUpdateWorkers;
+	int m_minAgentsPerBatch;
+
+	// [UE4] queries used by the additional batches, batch 0 always uses m_navquery and m_obstacleQuery
+	dtNavMeshQuery** m_workerNavQueries;
+	dtObstacleAvoidanceQuery** m_workerObstacleQueries;
+	int m_numWorkerQueries;
+
+	// [UE4] avoidance query setup, used to initialize the worker queries
+	int m_maxAvoidedNeighbors;
+	int m_maxAvoidedWalls;
+	int m_maxAvoidancePatterns;
+
 	void updateTopologyOptimization(dtCrowdAgent** agents, const int nagents, const float dt);
 	void updateMoveRequest(const float dt);
 	void checkPathValidity(dtCrowdAgent** agents, const int nagents, const float dt);
@@ -277,6 +303,12 @@ class NAVMESH_API dtCrowd
 	bool requestMoveTargetReplan(const int idx, dtPolyRef ref, const float* pos);
 
 	void purge();
+
+	bool initWorkerQueries();
+	void freeWorkerQueries();
+	int getUpdateBatchCount() const;
+	dtNavMeshQuery* getWorkerNavQuery(const int batchIdx) const { return batchIdx ? m_workerNavQueries[batchIdx - 1] : m_navquery; }
+	dtObstacleAvoidanceQuery* getWorkerObstacleQuery(const int batchIdx) const { return batchIdx ? m_workerObstacleQueries[batchIdx - 1] : m_obstacleQuery; }
 	
 public:
 	dtCrowd();
@@ -480,6 +512,16 @@ public:
 	/// [UE4] Set separation filter param
 	void setSeparationFilter(float InFilter);
 
+	/// [UE4] Split the per agent work of the proximity, steering, avoidance and corridor steps
+	/// into batches updated in parallel on task graph workers. Results don't depend on the batch count.
+	///  @param[in]		maxWorkers			The maximum number of batches, 1 to update serially.
+	///  @param[in]		minAgentsPerBatch	The minimum number of agents in a batch.
+	/// @return True if the worker queries were allocated.
+	bool setParallelUpdate(const int maxWorkers, const int minAgentsPerBatch);
+
+	/// [UE4] Gets the maximum number of agent batches updated in parallel.
+	inline int getParallelUpdateWorkers() const { return m_numWorkerQueries + 1; }
+
 	/// [UE4] Check if agent moved away from its path corridor
 	bool isOutsideCorridor(const int idx) const;
 
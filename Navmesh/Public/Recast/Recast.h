@@ -617,6 +617,7 @@ enum rcFilterLowAreaFlags
 enum rcRasterizationFlags
 {
 	RC_PROJECT_TO_BOTTOM = 1 << 0,		///< Will create spans from the triangle surface to the bottom of the heightfield
+	RC_NO_BATCHED_TRIANGLE_CULLING = 1 << 1,	///< Tests triangles against the heightfield one at a time instead of in SIMD batches, the result is the same
 };
 
 /// Applied to the region id field of contour vertices in order to extract the region id.
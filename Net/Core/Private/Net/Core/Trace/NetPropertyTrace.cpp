@@ -0,0 +1,313 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/Core/Trace/NetPropertyTrace.h"
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/Core/Misc/NetCoreLog.h"
+#include "Net/Core/Trace/NetTrace.h"
+#include "Net/Core/Trace/Reporters/NetTraceReporter.h"
+
+namespace NetPropertyTracePrivate
+{
+	typedef TMap<FNetPropertyTraceKey, FNetPropertyTraceStats> FStatsMap;
+
+	/** Stats accumulated since the last EndFrame */
+	static FStatsMap FrameStats;
+
+	/** Stats accumulated since the last Reset, excluding the current frame */
+	static FStatsMap SessionStats;
+
+	static const TCHAR* GetTypeName(ENetPropertyTraceType Type)
+	{
+		switch (Type)
+		{
+			case ENetPropertyTraceType::Property:		return TEXT("Property");
+			case ENetPropertyTraceType::SentRPC:		return TEXT("SentRPC");
+			case ENetPropertyTraceType::ReceivedRPC:	return TEXT("ReceivedRPC");
+		}
+
+		return TEXT("Unknown");
+	}
+
+	static uint64 GetSortValue(const FNetPropertyTraceStats& Stats, ENetPropertyTraceSortBy SortBy)
+	{
+		switch (SortBy)
+		{
+			case ENetPropertyTraceSortBy::Bits:				return Stats.Bits;
+			case ENetPropertyTraceSortBy::Count:			return Stats.Count;
+			case ENetPropertyTraceSortBy::CompareTime:		return Stats.CompareCycles;
+			case ENetPropertyTraceSortBy::SerializeTime:	return Stats.SerializeCycles;
+			case ENetPropertyTraceSortBy::ProcessTime:		return Stats.ProcessCycles;
+			case ENetPropertyTraceSortBy::TotalTime:		return Stats.CompareCycles + Stats.SerializeCycles + Stats.ProcessCycles;
+		}
+
+		return 0;
+	}
+
+	static void OnEnabledChanged(IConsoleVariable* Var)
+	{
+		FNetPropertyTrace::SetEnabled(Var->GetBool());
+	}
+
+	static int32 CVarEnabledValue = 0;
+	static FAutoConsoleVariableRef CVarNetPropertyTraceEnable(
+		TEXT("net.PropertyTrace.Enable"),
+		CVarEnabledValue,
+		TEXT("When enabled, replication cost (bits, compare, serialize and RPC time) is attributed to individual classes and properties. See Net.PropertyTrace.Report."),
+		FConsoleVariableDelegate::CreateStatic(&OnEnabledChanged));
+
+	static void WriteReport(const TArray<FString>& Args)
+	{
+		ENetPropertyTraceSortBy SortBy = ENetPropertyTraceSortBy::TotalTime;
+
+		if (Args.Num() > 0 && !FNetPropertyTrace::ParseSortBy(*Args[0], SortBy))
+		{
+			UE_LOG(LogNetCore, Warning, TEXT("Net.PropertyTrace.Report: Unknown sort column '%s', expected Bits, Count, CompareTime, SerializeTime, ProcessTime or TotalTime"), *Args[0]);
+			return;
+		}
+
+		const FString Filename = Args.Num() > 1 ? Args[1] :
+									FPaths::ProfilingDir() / TEXT("NetPropertyTrace") / FString::Printf(TEXT("PropertyTrace_%s.csv"), *FDateTime::Now().ToString());
+
+		FStatsMap Stats;
+		FNetPropertyTrace::GetSessionStats(Stats);
+
+		if (FFileHelper::SaveStringToFile(FNetPropertyTrace::BuildReport(Stats, SortBy), *Filename))
+		{
+			UE_LOG(LogNetCore, Display, TEXT("Net.PropertyTrace.Report: Wrote %d entries to %s"), Stats.Num(), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogNetCore, Warning, TEXT("Net.PropertyTrace.Report: Failed to write %s"), *Filename);
+		}
+
+		// Summary of the most expensive entries, for quick inspection from a server console
+		UE_LOG(LogNetCore, Display, TEXT("%s"), *FNetPropertyTrace::BuildReport(Stats, SortBy, 20));
+	}
+
+	static FAutoConsoleCommand CmdNetPropertyTraceReport(
+		TEXT("Net.PropertyTrace.Report"),
+		TEXT("Writes the replication cost per class and property, accumulated while net.PropertyTrace.Enable is set, to a CSV file." \
+			 "\nUsage:" \
+			 "\nNet.PropertyTrace.Report [Bits|Count|CompareTime|SerializeTime|ProcessTime|TotalTime] [File]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&WriteReport));
+
+	static FAutoConsoleCommand CmdNetPropertyTraceReset(
+		TEXT("Net.PropertyTrace.Reset"),
+		TEXT("Discards the replication cost accumulated by net.PropertyTrace.Enable."),
+		FConsoleCommandDelegate::CreateStatic(&FNetPropertyTrace::Reset));
+}
+
+bool FNetPropertyTrace::bIsEnabled = false;
+
+void FNetPropertyTrace::SetEnabled(bool bEnabled)
+{
+	if (bIsEnabled != bEnabled)
+	{
+		bIsEnabled = bEnabled;
+		NetPropertyTracePrivate::CVarEnabledValue = bEnabled ? 1 : 0;
+
+		UE_LOG(LogNetCore, Log, TEXT("Net property trace %s"), bEnabled ? TEXT("enabled") : TEXT("disabled"));
+	}
+}
+
+FNetPropertyTraceStats& FNetPropertyTrace::FindOrAdd(FName ClassName, FName PropertyName, ENetPropertyTraceType Type)
+{
+	FNetPropertyTraceKey Key;
+	Key.ClassName = ClassName;
+	Key.PropertyName = PropertyName;
+	Key.Type = Type;
+
+	return NetPropertyTracePrivate::FrameStats.FindOrAdd(Key);
+}
+
+void FNetPropertyTrace::TraceCompare(FName ClassName, FName PropertyName, uint64 Cycles)
+{
+	FindOrAdd(ClassName, PropertyName, ENetPropertyTraceType::Property).CompareCycles += Cycles;
+}
+
+void FNetPropertyTrace::TraceSerialize(FName ClassName, FName PropertyName, uint64 Bits, uint64 Cycles)
+{
+	FNetPropertyTraceStats& Stats = FindOrAdd(ClassName, PropertyName, ENetPropertyTraceType::Property);
+
+	Stats.Count++;
+	Stats.Bits += Bits;
+	Stats.SerializeCycles += Cycles;
+}
+
+void FNetPropertyTrace::TraceSentRPC(FName ClassName, FName FunctionName, uint64 Bits, uint64 SerializeCycles)
+{
+	FNetPropertyTraceStats& Stats = FindOrAdd(ClassName, FunctionName, ENetPropertyTraceType::SentRPC);
+
+	Stats.Count++;
+	Stats.Bits += Bits;
+	Stats.SerializeCycles += SerializeCycles;
+}
+
+void FNetPropertyTrace::TraceReceivedRPC(FName ClassName, FName FunctionName, uint64 Bits, uint64 SerializeCycles, uint64 ProcessCycles)
+{
+	FNetPropertyTraceStats& Stats = FindOrAdd(ClassName, FunctionName, ENetPropertyTraceType::ReceivedRPC);
+
+	Stats.Count++;
+	Stats.Bits += Bits;
+	Stats.SerializeCycles += SerializeCycles;
+	Stats.ProcessCycles += ProcessCycles;
+}
+
+void FNetPropertyTrace::EndFrame()
+{
+	using namespace NetPropertyTracePrivate;
+
+	// Every driver ends the frame from its TickFlush, only the first one does any work
+	static uint64 LastFrameCounter = 0;
+
+	if (FrameStats.Num() == 0 || LastFrameCounter == GFrameCounter)
+	{
+		return;
+	}
+
+	LastFrameCounter = GFrameCounter;
+
+#if UE_NET_TRACE_ENABLED
+	const bool bShouldReport = FNetTrace::IsEnabled();
+#endif
+
+	for (TPair<FNetPropertyTraceKey, FNetPropertyTraceStats>& It : FrameStats)
+	{
+		if (It.Value.IsEmpty())
+		{
+			continue;
+		}
+
+#if UE_NET_TRACE_ENABLED
+		if (bShouldReport)
+		{
+			const FNetPropertyTraceStats& Stats = It.Value;
+
+			FNetTraceReporter::ReportPropertyStats(FNetTrace::TraceName(It.Key.ClassName), FNetTrace::TraceName(It.Key.PropertyName), (uint8)It.Key.Type,
+				(uint32)Stats.Count, Stats.Bits, Stats.CompareCycles, Stats.SerializeCycles, Stats.ProcessCycles);
+		}
+#endif
+
+		SessionStats.FindOrAdd(It.Key) += It.Value;
+
+		// Keep the entries around, most properties are touched every frame
+		It.Value = FNetPropertyTraceStats();
+	}
+}
+
+void FNetPropertyTrace::Reset()
+{
+	NetPropertyTracePrivate::FrameStats.Reset();
+	NetPropertyTracePrivate::SessionStats.Reset();
+}
+
+void FNetPropertyTrace::GetSessionStats(TMap<FNetPropertyTraceKey, FNetPropertyTraceStats>& OutStats)
+{
+	using namespace NetPropertyTracePrivate;
+
+	OutStats = SessionStats;
+
+	for (const TPair<FNetPropertyTraceKey, FNetPropertyTraceStats>& It : FrameStats)
+	{
+		if (!It.Value.IsEmpty())
+		{
+			OutStats.FindOrAdd(It.Key) += It.Value;
+		}
+	}
+}
+
+FString FNetPropertyTrace::BuildReport(const TMap<FNetPropertyTraceKey, FNetPropertyTraceStats>& Stats, ENetPropertyTraceSortBy SortBy, int32 MaxRows)
+{
+	using namespace NetPropertyTracePrivate;
+
+	typedef TPair<FNetPropertyTraceKey, FNetPropertyTraceStats> FEntry;
+
+	TArray<FEntry> Entries;
+	Entries.Reserve(Stats.Num());
+
+	for (const FEntry& It : Stats)
+	{
+		Entries.Add(It);
+	}
+
+	Entries.Sort([SortBy](const FEntry& A, const FEntry& B)
+	{
+		const uint64 ValueA = GetSortValue(A.Value, SortBy);
+		const uint64 ValueB = GetSortValue(B.Value, SortBy);
+
+		if (ValueA != ValueB)
+		{
+			return ValueA > ValueB;
+		}
+
+		// Stable order for equal values, so reports can be diffed
+		if (A.Key.ClassName != B.Key.ClassName)
+		{
+			return A.Key.ClassName.LexicalLess(B.Key.ClassName);
+		}
+
+		if (A.Key.PropertyName != B.Key.PropertyName)
+		{
+			return A.Key.PropertyName.LexicalLess(B.Key.PropertyName);
+		}
+
+		return A.Key.Type < B.Key.Type;
+	});
+
+	if (MaxRows > 0 && Entries.Num() > MaxRows)
+	{
+		Entries.SetNum(MaxRows);
+	}
+
+	FString Report = TEXT("Class,Property,Type,Count,Bits,AvgBits,CompareMS,SerializeMS,ProcessMS,TotalMS\n");
+
+	for (const FEntry& Entry : Entries)
+	{
+		const FNetPropertyTraceStats& EntryStats = Entry.Value;
+
+		const double CompareMS = FPlatformTime::ToMilliseconds64(EntryStats.CompareCycles);
+		const double SerializeMS = FPlatformTime::ToMilliseconds64(EntryStats.SerializeCycles);
+		const double ProcessMS = FPlatformTime::ToMilliseconds64(EntryStats.ProcessCycles);
+		const double AvgBits = EntryStats.Count > 0 ? (double)EntryStats.Bits / (double)EntryStats.Count : 0.0;
+
+		Report += FString::Printf(TEXT("%s,%s,%s,%llu,%llu,%.1f,%.3f,%.3f,%.3f,%.3f\n"),
+			*Entry.Key.ClassName.ToString(), *Entry.Key.PropertyName.ToString(), GetTypeName(Entry.Key.Type),
+			EntryStats.Count, EntryStats.Bits, AvgBits, CompareMS, SerializeMS, ProcessMS, CompareMS + SerializeMS + ProcessMS);
+	}
+
+	return Report;
+}
+
+bool FNetPropertyTrace::ParseSortBy(const TCHAR* Name, ENetPropertyTraceSortBy& OutSortBy)
+{
+	static const TPair<const TCHAR*, ENetPropertyTraceSortBy> Columns[] =
+	{
+		{ TEXT("Bits"), ENetPropertyTraceSortBy::Bits },
+		{ TEXT("Count"), ENetPropertyTraceSortBy::Count },
+		{ TEXT("CompareTime"), ENetPropertyTraceSortBy::CompareTime },
+		{ TEXT("SerializeTime"), ENetPropertyTraceSortBy::SerializeTime },
+		{ TEXT("ProcessTime"), ENetPropertyTraceSortBy::ProcessTime },
+		{ TEXT("TotalTime"), ENetPropertyTraceSortBy::TotalTime },
+	};
+
+	for (const TPair<const TCHAR*, ENetPropertyTraceSortBy>& Column : Columns)
+	{
+		if (FCString::Stricmp(Name, Column.Key) == 0)
+		{
+			OutSortBy = Column.Value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#endif // UE_NET_PROPERTY_TRACE_ENABLED
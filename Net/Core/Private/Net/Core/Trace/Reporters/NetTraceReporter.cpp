@@ -14,6 +14,7 @@
 uint32 FNetTraceReporter::NetTraceReporterVersion = 1;
 
 UE_TRACE_CHANNEL_DEFINE(NetChannel)
+UE_TRACE_CHANNEL_DEFINE(NetPropertyChannel)
 
 // We always output this event first to make sure we have a version number for backwards compatibility
 UE_TRACE_EVENT_BEGIN(NetTrace, InitEvent)
@@ -82,6 +83,19 @@ UE_TRACE_EVENT_BEGIN(NetTrace, PacketDroppedEvent)
 	UE_TRACE_EVENT_FIELD(uint8, PacketType)
 UE_TRACE_EVENT_END()
 
+// Per frame replication cost of a class/property pair, see FNetPropertyTrace
+UE_TRACE_EVENT_BEGIN(NetTrace, PropertyStatsEvent)
+	UE_TRACE_EVENT_FIELD(uint64, Timestamp)
+	UE_TRACE_EVENT_FIELD(uint64, Bits)
+	UE_TRACE_EVENT_FIELD(uint64, CompareCycles)
+	UE_TRACE_EVENT_FIELD(uint64, SerializeCycles)
+	UE_TRACE_EVENT_FIELD(uint64, ProcessCycles)
+	UE_TRACE_EVENT_FIELD(uint32, Count)
+	UE_TRACE_EVENT_FIELD(uint16, ClassNameId)
+	UE_TRACE_EVENT_FIELD(uint16, PropertyNameId)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+UE_TRACE_EVENT_END()
+
 void FNetTraceReporter::ReportInitEvent(uint32 NetTraceVersion)
 {
 	UE_TRACE_LOG(NetTrace, InitEvent, NetChannel)
@@ -256,4 +270,18 @@ void FNetTraceReporter::ReportObjectDestroyed(uint32 GameInstanceId, uint32 NetO
 		<< ObjectDestroyedEvent.GameInstanceId(GameInstanceId);
 }
 
+void FNetTraceReporter::ReportPropertyStats(FNetDebugNameId ClassNameId, FNetDebugNameId PropertyNameId, uint8 Type, uint32 Count, uint64 Bits, uint64 CompareCycles, uint64 SerializeCycles, uint64 ProcessCycles)
+{
+	UE_TRACE_LOG(NetTrace, PropertyStatsEvent, NetPropertyChannel)
+		<< PropertyStatsEvent.Timestamp(FPlatformTime::Cycles64())
+		<< PropertyStatsEvent.Bits(Bits)
+		<< PropertyStatsEvent.CompareCycles(CompareCycles)
+		<< PropertyStatsEvent.SerializeCycles(SerializeCycles)
+		<< PropertyStatsEvent.ProcessCycles(ProcessCycles)
+		<< PropertyStatsEvent.Count(Count)
+		<< PropertyStatsEvent.ClassNameId(ClassNameId)
+		<< PropertyStatsEvent.PropertyNameId(PropertyNameId)
+		<< PropertyStatsEvent.Type(Type);
+}
+
 #endif
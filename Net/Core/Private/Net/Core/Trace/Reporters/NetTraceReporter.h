@@ -20,6 +20,7 @@ struct FNetTraceReporter
 	static void ReportConnectionCreated(uint32 GameInstanceId, uint32 ConnectionId);
 	static void ReportConnectionClosed(uint32 GameInstanceId, uint32 ConnectionId);
 	static void ReportInstanceDestroyed(uint32 GameInstanceId);
+	static void ReportPropertyStats(FNetDebugNameId ClassNameId, FNetDebugNameId PropertyNameId, uint8 Type, uint32 Count, uint64 Bits, uint64 CompareCycles, uint64 SerializeCycles, uint64 ProcessCycles);
 };
 
 #endif
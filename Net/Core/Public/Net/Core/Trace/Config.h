@@ -32,4 +32,13 @@ namespace ENetTraceVerbosity
 #	endif
 #else
 #	define UE_NET_TRACE_COMPILETIME_VERBOSITY ENetTraceVerbosity::None
-#endif
\ No newline at end of file
+#endif
+
+// Per class/property replication profiling (bits sent, compare, serialize and RPC time), see NetPropertyTrace.h
+#if !defined(UE_NET_PROPERTY_TRACE_ENABLED)
+#	if !UE_BUILD_SHIPPING
+#		define UE_NET_PROPERTY_TRACE_ENABLED 1
+#	else
+#		define UE_NET_PROPERTY_TRACE_ENABLED 0
+#	endif
+#endif
@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Core/Trace/Config.h"
+
+/** What a property trace entry measures */
+enum class ENetPropertyTraceType : uint8
+{
+	/** A replicated property */
+	Property = 0,
+
+	/** An RPC being sent, the parameters are attributed to the function */
+	SentRPC,
+
+	/** An RPC being received, including the time spent executing it */
+	ReceivedRPC,
+};
+
+/** Accumulated cost of a single class/property (or class/function) pair */
+struct FNetPropertyTraceStats
+{
+	/** Number of times the property was sent, or the RPC was sent or received */
+	uint64 Count = 0;
+
+	/** Total number of bits written (or read, for received RPCs) */
+	uint64 Bits = 0;
+
+	/** Total time spent comparing the property against its shadow state, in cycles */
+	uint64 CompareCycles = 0;
+
+	/** Total time spent serializing (or deserializing) the property, in cycles */
+	uint64 SerializeCycles = 0;
+
+	/** Total time spent executing received RPCs, in cycles */
+	uint64 ProcessCycles = 0;
+
+	bool IsEmpty() const
+	{
+		return (Count | CompareCycles) == 0;
+	}
+
+	FNetPropertyTraceStats& operator+=(const FNetPropertyTraceStats& Other)
+	{
+		Count += Other.Count;
+		Bits += Other.Bits;
+		CompareCycles += Other.CompareCycles;
+		SerializeCycles += Other.SerializeCycles;
+		ProcessCycles += Other.ProcessCycles;
+		return *this;
+	}
+};
+
+/** Key used to aggregate property trace stats */
+struct FNetPropertyTraceKey
+{
+	FName ClassName;
+	FName PropertyName;
+	ENetPropertyTraceType Type = ENetPropertyTraceType::Property;
+
+	bool operator==(const FNetPropertyTraceKey& Other) const
+	{
+		return ClassName == Other.ClassName && PropertyName == Other.PropertyName && Type == Other.Type;
+	}
+
+	friend uint32 GetTypeHash(const FNetPropertyTraceKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.ClassName), GetTypeHash(Key.PropertyName)), (uint32)Key.Type);
+	}
+};
+
+/** Column used to order a property trace report */
+enum class ENetPropertyTraceSortBy : uint8
+{
+	Bits,
+	Count,
+	CompareTime,
+	SerializeTime,
+	ProcessTime,
+	TotalTime,
+};
+
+#if UE_NET_PROPERTY_TRACE_ENABLED
+
+/**
+ * Attributes replication cost to individual classes and properties.
+ *
+ * While enabled (net.PropertyTrace.Enable), the replication system reports compare time, serialize time and bits per
+ * class/property, and send/receive cost per RPC. Costs are accumulated for the current frame, and folded into the session
+ * totals by EndFrame. When net tracing is active, EndFrame also emits the frame totals as NetTrace PropertyStatsEvents
+ * on the NetProperty trace channel, so that they can be aggregated from a .utrace offline.
+ *
+ * The session totals can be written as a sortable CSV report with Net.PropertyTrace.Report, which works on headless
+ * builds without any trace tooling. Game thread only.
+ */
+struct FNetPropertyTrace
+{
+	/** Returns true if property tracing is enabled */
+	static bool IsEnabled() { return bIsEnabled; }
+
+	/** Enables or disables property tracing */
+	NETCORE_API static void SetEnabled(bool bEnabled);
+
+	/** Adds the time spent comparing a property */
+	NETCORE_API static void TraceCompare(FName ClassName, FName PropertyName, uint64 Cycles);
+
+	/** Adds a property write */
+	NETCORE_API static void TraceSerialize(FName ClassName, FName PropertyName, uint64 Bits, uint64 Cycles);
+
+	/** Adds a sent RPC */
+	NETCORE_API static void TraceSentRPC(FName ClassName, FName FunctionName, uint64 Bits, uint64 SerializeCycles);
+
+	/** Adds a received RPC */
+	NETCORE_API static void TraceReceivedRPC(FName ClassName, FName FunctionName, uint64 Bits, uint64 SerializeCycles, uint64 ProcessCycles);
+
+	/** Folds the current frame into the session totals, and emits the frame to NetTrace if it is active */
+	NETCORE_API static void EndFrame();
+
+	/** Discards all accumulated stats */
+	NETCORE_API static void Reset();
+
+	/** Returns the session totals, including the current frame */
+	NETCORE_API static void GetSessionStats(TMap<FNetPropertyTraceKey, FNetPropertyTraceStats>& OutStats);
+
+	/**
+	 * Builds a CSV report of the given stats, one row per class/property, in descending order of the sort column.
+	 *
+	 * @param Stats		Stats to report, usually from GetSessionStats
+	 * @param SortBy	Column to sort on
+	 * @param MaxRows	Maximum number of rows to include, or 0 for all
+	 */
+	NETCORE_API static FString BuildReport(const TMap<FNetPropertyTraceKey, FNetPropertyTraceStats>& Stats, ENetPropertyTraceSortBy SortBy, int32 MaxRows = 0);
+
+	/** Parses a sort column name, as used by Net.PropertyTrace.Report. Returns false if the name is not recognized. */
+	NETCORE_API static bool ParseSortBy(const TCHAR* Name, ENetPropertyTraceSortBy& OutSortBy);
+
+private:
+	static FNetPropertyTraceStats& FindOrAdd(FName ClassName, FName PropertyName, ENetPropertyTraceType Type);
+
+	NETCORE_API static bool bIsEnabled;
+};
+
+/**
+ * Measures cycles for the lifetime of the scope, when property tracing was enabled at construction
+ */
+class FNetPropertyTraceScopedCycles
+{
+public:
+	FNetPropertyTraceScopedCycles(uint64& InOutCycles)
+		: OutCycles(InOutCycles)
+		, StartCycles(FNetPropertyTrace::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FNetPropertyTraceScopedCycles()
+	{
+		if (StartCycles != 0)
+		{
+			OutCycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+	}
+
+private:
+	uint64& OutCycles;
+	uint64 StartCycles;
+};
+
+#endif // UE_NET_PROPERTY_TRACE_ENABLED
@@ -12,7 +12,11 @@
 #include "Engine/World.h"
 #include "UObject/CoreOnline.h"
 #include "Serialization/LargeMemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "Misc/ConfigCacheIni.h"
+#include "Misc/Compression.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogLocalFileReplay, Log, All);
 
@@ -55,6 +59,7 @@ namespace LocalFileReplay
 		HISTORY_STREAM_CHUNK_TIMES				= 4,
 		HISTORY_FRIENDLY_NAME_ENCODING			= 5,
 		HISTORY_ENCRYPTION						= 6,
+		HISTORY_CHUNK_INDEX						= 7,
 
 		// -----<new versions can be added before this line>-------------------------------------------------
 		HISTORY_PLUS_ONE,
@@ -65,9 +70,133 @@ namespace LocalFileReplay
 	TAutoConsoleVariable<int32> CVarMaxBufferedStreamChunks(TEXT("localReplay.MaxBufferedStreamChunks"), 10, TEXT(""));
 	TAutoConsoleVariable<int32> CVarAllowLiveStreamDelete(TEXT("localReplay.AllowLiveStreamDelete"), 1, TEXT(""));
 	TAutoConsoleVariable<float> CVarChunkUploadDelayInSeconds(TEXT("localReplay.ChunkUploadDelayInSeconds"), 20.0f, TEXT(""));
+	TAutoConsoleVariable<FString> CVarCompressionFormat(TEXT("localReplay.CompressionFormat"), TEXT("LZ4"), TEXT("Compression format used for stream and checkpoint chunks (e.g. LZ4, Zlib, Oodle), or None to store them uncompressed."));
+	TAutoConsoleVariable<int32> CVarWriteChunkIndex(TEXT("localReplay.WriteChunkIndex"), 1, TEXT("When enabled, an index of all chunks is appended to replays when recording stops, so they can be opened and scrubbed without scanning the file."));
+	TAutoConsoleVariable<int32> CVarUseMappedFiles(TEXT("localReplay.UseMappedFiles"), 1, TEXT("When enabled, replay files are memory mapped for reading (when the platform supports it), rather than read through a buffered file handle."));
+
+	/** Size of the trailer at the end of the index chunk: the offset of the index chunk, followed by the index magic */
+	static const int64 IndexTrailerSize = sizeof(int64) + sizeof(uint32);
+
+	/** Read only archive over a memory mapped file, used to read replays in place */
+	class FMappedFileReader : public FLargeMemoryReader
+	{
+	public:
+		static TSharedPtr<FArchive> Create(const FString& Filename)
+		{
+			TUniquePtr<IMappedFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+			if (!Handle.IsValid() || Handle->GetFileSize() <= 0)
+			{
+				return nullptr;
+			}
+
+			TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion());
+			if (!Region.IsValid())
+			{
+				return nullptr;
+			}
+
+			return MakeShareable(new FMappedFileReader(MoveTemp(Handle), MoveTemp(Region), Filename));
+		}
+
+	private:
+		FMappedFileReader(TUniquePtr<IMappedFileHandle>&& InHandle, TUniquePtr<IMappedFileRegion>&& InRegion, const FString& Filename)
+			: FLargeMemoryReader(InRegion->GetMappedPtr(), InRegion->GetMappedSize(), ELargeMemoryReaderFlags::None, FName(*Filename))
+			, Handle(MoveTemp(InHandle))
+			, Region(MoveTemp(InRegion))
+		{
+		}
+
+		// The region must be released before the handle
+		TUniquePtr<IMappedFileHandle> Handle;
+		TUniquePtr<IMappedFileRegion> Region;
+	};
+
+	/** Validates an element count read from an index, given the minimum serialized size of an element */
+	static bool SerializeIndexCount(FArchive& Ar, int32& Num, int32 Count, int64 MinElementSize)
+	{
+		Num = Count;
+		Ar << Num;
+
+		return !Ar.IsError() && (Num >= 0) && (!Ar.IsLoading() || (Num * MinElementSize <= Ar.TotalSize() - Ar.Tell()));
+	}
+
+	static bool SerializeIndexEvents(FArchive& Ar, TArray<FLocalFileEventInfo>& Events)
+	{
+		int32 NumEvents = 0;
+		if (!SerializeIndexCount(Ar, NumEvents, Events.Num(), 7 * sizeof(int32) + sizeof(int64)))
+		{
+			return false;
+		}
+
+		Events.SetNum(NumEvents);
+
+		for (FLocalFileEventInfo& Event : Events)
+		{
+			Ar << Event.ChunkIndex;
+			Ar << Event.Id;
+			Ar << Event.Group;
+			Ar << Event.Metadata;
+			Ar << Event.Time1;
+			Ar << Event.Time2;
+			Ar << Event.SizeInBytes;
+			Ar << Event.EventDataOffset;
+		}
+
+		return !Ar.IsError();
+	}
+
+	/** Serializes the chunk metadata of a replay to or from an index chunk */
+	static bool SerializeIndex(FArchive& Ar, FLocalFileReplayInfo& Info)
+	{
+		int32 NumChunks = 0;
+		if (!SerializeIndexCount(Ar, NumChunks, Info.Chunks.Num(), sizeof(uint32) + sizeof(int32) + 2 * sizeof(int64)))
+		{
+			return false;
+		}
+
+		Info.Chunks.SetNum(NumChunks);
+
+		for (FLocalFileChunkInfo& Chunk : Info.Chunks)
+		{
+			Ar << Chunk.ChunkType;
+			Ar << Chunk.SizeInBytes;
+			Ar << Chunk.TypeOffset;
+			Ar << Chunk.DataOffset;
+		}
+
+		Ar << Info.HeaderChunkIndex;
+		Ar << Info.TotalDataSizeInBytes;
+
+		if (!SerializeIndexEvents(Ar, Info.Checkpoints) || !SerializeIndexEvents(Ar, Info.Events))
+		{
+			return false;
+		}
+
+		int32 NumDataChunks = 0;
+		if (!SerializeIndexCount(Ar, NumDataChunks, Info.DataChunks.Num(), 5 * sizeof(int32) + 2 * sizeof(int64)))
+		{
+			return false;
+		}
+
+		Info.DataChunks.SetNum(NumDataChunks);
+
+		for (FLocalFileReplayDataInfo& DataChunk : Info.DataChunks)
+		{
+			Ar << DataChunk.ChunkIndex;
+			Ar << DataChunk.Time1;
+			Ar << DataChunk.Time2;
+			Ar << DataChunk.SizeInBytes;
+			Ar << DataChunk.MemorySizeInBytes;
+			Ar << DataChunk.ReplayDataOffset;
+			Ar << DataChunk.StreamOffset;
+		}
+
+		return !Ar.IsError();
+	}
 };
 
 const uint32 FLocalFileNetworkReplayStreamer::FileMagic = 0x1CA2E27F;
+const uint32 FLocalFileNetworkReplayStreamer::IndexMagic = 0x1CA2E2DF;
 const uint32 FLocalFileNetworkReplayStreamer::MaxFriendlyNameLen = 256;
 const uint32 FLocalFileNetworkReplayStreamer::LatestVersion = LocalFileReplay::HISTORY_LATEST;
 
@@ -272,6 +401,15 @@ bool FLocalFileNetworkReplayStreamer::ReadReplayInfo(FArchive& Archive, FLocalFi
 
 			int64 TotalSize = Archive.TotalSize();
 
+			// finished replays end with an index of all chunks, so there is no need to scan them
+			if ((FileVersion >= LocalFileReplay::HISTORY_CHUNK_INDEX) && !Info.bIsLive && !EnumHasAnyFlags(Flags, EReadReplayInfoFlags::SkipIndex))
+			{
+				if (ReadReplayIndex(Archive, Info, Archive.Tell()))
+				{
+					Archive.Seek(TotalSize);
+				}
+			}
+
 			// now look for all chunks
 			while (!Archive.AtEnd())
 			{
@@ -418,6 +556,9 @@ bool FLocalFileNetworkReplayStreamer::ReadReplayInfo(FArchive& Archive, FLocalFi
 					}
 				}
 				break;
+				case ELocalFileChunkType::Index:
+					UE_LOG(LogLocalFileReplay, Verbose, TEXT("ReadReplayInfo: Skipping index chunk"));
+					break;
 				case ELocalFileChunkType::Unknown:
 					UE_LOG(LogLocalFileReplay, Verbose, TEXT("ReadReplayInfo: Skipping unknown (cleared) chunk"));
 					break;
@@ -507,6 +648,148 @@ bool FLocalFileNetworkReplayStreamer::ReadReplayInfo(FArchive& Archive, FLocalFi
 	return false;
 }
 
+bool FLocalFileNetworkReplayStreamer::ReadReplayIndex(FArchive& Archive, FLocalFileReplayInfo& Info, const int64 ChunksOffset) const
+{
+	const int64 TotalSize = Archive.TotalSize();
+	const int64 ChunkHeaderSize = sizeof(ELocalFileChunkType) + sizeof(int32);
+
+	if ((TotalSize - ChunksOffset) < (ChunkHeaderSize + LocalFileReplay::IndexTrailerSize))
+	{
+		return false;
+	}
+
+	Archive.Seek(TotalSize - LocalFileReplay::IndexTrailerSize);
+
+	int64 IndexOffset = 0;
+	Archive << IndexOffset;
+
+	uint32 MagicNumber = 0;
+	Archive << MagicNumber;
+
+	// the index is only valid if it is the last chunk, if anything was appended after it, the file needs to be scanned
+	if ((MagicNumber != FLocalFileNetworkReplayStreamer::IndexMagic) || (IndexOffset < ChunksOffset) || (IndexOffset > (TotalSize - ChunkHeaderSize - LocalFileReplay::IndexTrailerSize)))
+	{
+		UE_LOG(LogLocalFileReplay, Verbose, TEXT("ReadReplayIndex: No index found, scanning chunks"));
+		Archive.Seek(ChunksOffset);
+		return false;
+	}
+
+	Archive.Seek(IndexOffset);
+
+	ELocalFileChunkType ChunkType;
+	Archive << ChunkType;
+
+	int32 SizeInBytes = 0;
+	Archive << SizeInBytes;
+
+	const int64 IndexDataOffset = Archive.Tell();
+
+	if ((ChunkType != ELocalFileChunkType::Index) || ((IndexDataOffset + SizeInBytes) != TotalSize))
+	{
+		UE_LOG(LogLocalFileReplay, Warning, TEXT("ReadReplayIndex: Invalid index chunk, scanning chunks"));
+		Archive.Seek(ChunksOffset);
+		return false;
+	}
+
+	TArray<uint8> IndexData;
+	IndexData.SetNumUninitialized(SizeInBytes - LocalFileReplay::IndexTrailerSize);
+	Archive.Serialize(IndexData.GetData(), IndexData.Num());
+
+	FMemoryReader IndexReader(IndexData);
+
+	FLocalFileReplayInfo IndexInfo;
+	bool bIsValidIndex = LocalFileReplay::SerializeIndex(IndexReader, IndexInfo) && !Archive.IsError();
+
+	if (bIsValidIndex)
+	{
+		auto IsValidRange = [ChunksOffset, IndexOffset](int64 Offset, int64 Size)
+		{
+			return (Size >= 0) && (Offset >= ChunksOffset) && ((Offset + Size) <= IndexOffset);
+		};
+
+		for (const FLocalFileChunkInfo& Chunk : IndexInfo.Chunks)
+		{
+			bIsValidIndex &= IsValidRange(Chunk.TypeOffset, 0) && IsValidRange(Chunk.DataOffset, Chunk.SizeInBytes);
+		}
+
+		for (const FLocalFileEventInfo& Checkpoint : IndexInfo.Checkpoints)
+		{
+			bIsValidIndex &= IndexInfo.Chunks.IsValidIndex(Checkpoint.ChunkIndex) && IsValidRange(Checkpoint.EventDataOffset, Checkpoint.SizeInBytes);
+		}
+
+		for (const FLocalFileEventInfo& Event : IndexInfo.Events)
+		{
+			bIsValidIndex &= IndexInfo.Chunks.IsValidIndex(Event.ChunkIndex) && IsValidRange(Event.EventDataOffset, Event.SizeInBytes);
+		}
+
+		for (const FLocalFileReplayDataInfo& DataChunk : IndexInfo.DataChunks)
+		{
+			bIsValidIndex &= IndexInfo.Chunks.IsValidIndex(DataChunk.ChunkIndex) && IsValidRange(DataChunk.ReplayDataOffset, DataChunk.SizeInBytes) && (DataChunk.MemorySizeInBytes >= 0);
+		}
+
+		bIsValidIndex &= (IndexInfo.HeaderChunkIndex == INDEX_NONE) || IndexInfo.Chunks.IsValidIndex(IndexInfo.HeaderChunkIndex);
+	}
+
+	if (!bIsValidIndex)
+	{
+		UE_LOG(LogLocalFileReplay, Warning, TEXT("ReadReplayIndex: Corrupt index chunk, scanning chunks"));
+		Archive.Seek(ChunksOffset);
+		return false;
+	}
+
+	Info.Chunks = MoveTemp(IndexInfo.Chunks);
+	Info.Checkpoints = MoveTemp(IndexInfo.Checkpoints);
+	Info.Events = MoveTemp(IndexInfo.Events);
+	Info.DataChunks = MoveTemp(IndexInfo.DataChunks);
+	Info.HeaderChunkIndex = IndexInfo.HeaderChunkIndex;
+	Info.TotalDataSizeInBytes = IndexInfo.TotalDataSizeInBytes;
+
+	// include the index itself, so the chunk list matches what a scan would produce
+	FLocalFileChunkInfo& IndexChunk = Info.Chunks.AddDefaulted_GetRef();
+	IndexChunk.ChunkType = ELocalFileChunkType::Index;
+	IndexChunk.SizeInBytes = SizeInBytes;
+	IndexChunk.TypeOffset = IndexOffset;
+	IndexChunk.DataOffset = IndexDataOffset;
+
+	return true;
+}
+
+bool FLocalFileNetworkReplayStreamer::WriteReplayIndex(const FString& StreamName, const FLocalFileReplayInfo& ReplayInfo)
+{
+	TArray<uint8> IndexData;
+	FMemoryWriter IndexWriter(IndexData);
+
+	if (!LocalFileReplay::SerializeIndex(IndexWriter, const_cast<FLocalFileReplayInfo&>(ReplayInfo)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FArchive> LocalFileAr = CreateLocalFileWriter(GetDemoFullFilename(StreamName));
+	if (LocalFileAr.IsValid())
+	{
+		int64 IndexOffset = LocalFileAr->TotalSize();
+		LocalFileAr->Seek(IndexOffset);
+
+		// trailer, so readers can find the index from the end of the file
+		IndexWriter << IndexOffset;
+
+		uint32 MagicNumber = FLocalFileNetworkReplayStreamer::IndexMagic;
+		IndexWriter << MagicNumber;
+
+		ELocalFileChunkType ChunkType = ELocalFileChunkType::Index;
+		*LocalFileAr << ChunkType;
+
+		int32 ChunkSize = IndexData.Num();
+		*LocalFileAr << ChunkSize;
+
+		LocalFileAr->Serialize(IndexData.GetData(), IndexData.Num());
+
+		return !LocalFileAr->IsError();
+	}
+
+	return false;
+}
+
 bool FLocalFileNetworkReplayStreamer::WriteReplayInfo(const FString& StreamName, const FLocalFileReplayInfo& InReplayInfo)
 {
 	SCOPE_CYCLE_COUNTER(STAT_LocalReplay_WriteReplayInfo);
@@ -593,7 +876,7 @@ bool FLocalFileNetworkReplayStreamer::WriteReplayInfo(FArchive& Archive, const F
 
 	if (SerializationInfo.FileVersion >= LocalFileReplay::HISTORY_COMPRESSION)
 	{
-		uint32 Compressed = SupportsCompression() ? 1 : 0;
+		uint32 Compressed = InReplayInfo.bCompressed ? 1 : 0;
 		Archive << Compressed;
 	}
 
@@ -793,6 +1076,7 @@ void FLocalFileNetworkReplayStreamer::StartStreaming(const FStartStreamingParame
 				RequestData.ReplayInfo.Changelist = Params.ReplayVersion.Changelist;
 				RequestData.ReplayInfo.FriendlyName = Params.FriendlyName;
 				RequestData.ReplayInfo.bIsLive = true;
+				RequestData.ReplayInfo.bCompressed = SupportsCompression();
 				RequestData.ReplayInfo.Timestamp = FDateTime::Now();
 				RequestData.ReplayInfo.EncryptionKey = EncryptionKey;
 
@@ -881,6 +1165,11 @@ void FLocalFileNetworkReplayStreamer::StopStreaming()
 					ReplayInfo.EncryptionKey = CurrentReplayInfo.EncryptionKey;
 
 					WriteReplayInfo(CurrentStreamName, ReplayInfo);
+
+					if (LocalFileReplay::CVarWriteChunkIndex.GetValueOnAnyThread() && !WriteReplayIndex(CurrentStreamName, ReplayInfo))
+					{
+						UE_LOG(LogLocalFileReplay, Warning, TEXT("FLocalFileNetworkReplayStreamer::StopStreaming - Failed to write replay index"));
+					}
 				}
 			},
 			[this](FLocalFileReplayInfo& ReplayInfo)
@@ -2514,10 +2803,18 @@ TSharedPtr<FArchive> FLocalFileNetworkReplayStreamer::CreateLocalFileReader(cons
 		const TArray<uint8>& Data = GetCachedFileContents(InFilename);
 		return (Data.Num() > 0) ? MakeShareable(new FLargeMemoryReader((uint8*)Data.GetData(), Data.Num())) : nullptr;
 	}
-	else
+
+	// Files being recorded are still growing, and need to be opened for writing, so they are never mapped
+	if (LocalFileReplay::CVarUseMappedFiles.GetValueOnAnyThread() && (StreamerState != EStreamerState::Recording))
 	{
-		return MakeShareable(IFileManager::Get().CreateFileReader(*InFilename, FILEREAD_AllowWrite));
+		TSharedPtr<FArchive> MappedAr = LocalFileReplay::FMappedFileReader::Create(InFilename);
+		if (MappedAr.IsValid())
+		{
+			return MappedAr;
+		}
 	}
+
+	return MakeShareable(IFileManager::Get().CreateFileReader(*InFilename, FILEREAD_AllowWrite));
 }
 
 TSharedPtr<FArchive> FLocalFileNetworkReplayStreamer::CreateLocalFileWriter(const FString& InFilename) const
@@ -3238,6 +3535,218 @@ int32 FLocalFileNetworkReplayStreamer::GetDecompressedSize(FArchive& InCompresse
 }
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
+bool FLocalFileNetworkReplayStreamer::CompressBuffer(const TArray<uint8>& InBuffer, TArray<uint8>& OutCompressed) const
+{
+	FName FormatName(*LocalFileReplay::CVarCompressionFormat.GetValueOnAnyThread());
+
+	if ((FormatName != NAME_None) && !FCompression::IsFormatValid(FormatName))
+	{
+		UE_LOG(LogLocalFileReplay, Warning, TEXT("FLocalFileNetworkReplayStreamer::CompressBuffer - Unknown compression format %s, storing chunk uncompressed"), *FormatName.ToString());
+		FormatName = NAME_None;
+	}
+
+	int32 UncompressedSize = InBuffer.Num();
+
+	// each buffer starts with the format and uncompressed size, so it can be decompressed regardless of the current settings
+	if (FormatName != NAME_None)
+	{
+		OutCompressed.Reset();
+
+		FMemoryWriter Writer(OutCompressed);
+
+		FString FormatString = FormatName.ToString();
+		Writer << FormatString;
+		Writer << UncompressedSize;
+
+		const int32 HeaderSize = OutCompressed.Num();
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, UncompressedSize);
+		OutCompressed.SetNumUninitialized(HeaderSize + CompressedSize);
+
+		if (FCompression::CompressMemory(FormatName, OutCompressed.GetData() + HeaderSize, CompressedSize, InBuffer.GetData(), UncompressedSize) && (CompressedSize < UncompressedSize))
+		{
+			OutCompressed.SetNum(HeaderSize + CompressedSize, false);
+			return true;
+		}
+	}
+
+	// store incompressible data as is
+	OutCompressed.Reset();
+
+	FMemoryWriter Writer(OutCompressed);
+
+	FString FormatString = FName(NAME_None).ToString();
+	Writer << FormatString;
+	Writer << UncompressedSize;
+
+	Writer.Serialize(const_cast<uint8*>(InBuffer.GetData()), UncompressedSize);
+
+	return !Writer.IsError();
+}
+
+bool FLocalFileNetworkReplayStreamer::DecompressBuffer(const TArray<uint8>& InCompressed, TArray<uint8>& OutBuffer) const
+{
+	FMemoryReader Reader(InCompressed);
+
+	FString FormatString;
+	Reader << FormatString;
+
+	int32 UncompressedSize = 0;
+	Reader << UncompressedSize;
+
+	if (Reader.IsError() || (UncompressedSize < 0))
+	{
+		UE_LOG(LogLocalFileReplay, Error, TEXT("FLocalFileNetworkReplayStreamer::DecompressBuffer - Invalid compressed buffer header"));
+		return false;
+	}
+
+	const int32 HeaderSize = (int32)Reader.Tell();
+	const int32 CompressedSize = InCompressed.Num() - HeaderSize;
+	const FName FormatName(*FormatString);
+
+	OutBuffer.SetNumUninitialized(UncompressedSize);
+
+	if (FormatName == NAME_None)
+	{
+		if (CompressedSize != UncompressedSize)
+		{
+			UE_LOG(LogLocalFileReplay, Error, TEXT("FLocalFileNetworkReplayStreamer::DecompressBuffer - Uncompressed buffer size mismatch: %d, expected %d"), CompressedSize, UncompressedSize);
+			return false;
+		}
+
+		FMemory::Memcpy(OutBuffer.GetData(), InCompressed.GetData() + HeaderSize, UncompressedSize);
+		return true;
+	}
+
+	if (!FCompression::IsFormatValid(FormatName))
+	{
+		UE_LOG(LogLocalFileReplay, Error, TEXT("FLocalFileNetworkReplayStreamer::DecompressBuffer - Unsupported compression format: %s"), *FormatString);
+		return false;
+	}
+
+	return FCompression::UncompressMemory(FormatName, OutBuffer.GetData(), UncompressedSize, InCompressed.GetData() + HeaderSize, CompressedSize);
+}
+
+void FLocalFileNetworkReplayStreamer::BenchmarkReplay(const FString& StreamName, int32 NumSeeks)
+{
+	FLocalFileNetworkReplayStreamer Streamer;
+
+	const FString Filename = Streamer.GetDemoFullFilename(StreamName);
+	const int64 FileSize = IFileManager::Get().FileSize(*Filename);
+
+	if (FileSize <= 0)
+	{
+		UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: Replay not found: %s"), *Filename);
+		return;
+	}
+
+	// opening the replay, with and without the index
+	double ScanTime = 0.0;
+	double IndexTime = 0.0;
+
+	FLocalFileReplayInfo Info;
+
+	{
+		FScopedDurationTimer Timer(ScanTime);
+		Streamer.ReadReplayInfo(StreamName, Info, EReadReplayInfoFlags::SkipIndex);
+	}
+
+	{
+		FScopedDurationTimer Timer(IndexTime);
+		Streamer.ReadReplayInfo(StreamName, Info, EReadReplayInfoFlags::None);
+	}
+
+	if (!Info.bIsValid)
+	{
+		UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: Failed to read replay info: %s"), *Filename);
+		return;
+	}
+
+	const bool bHasIndex = Info.Chunks.ContainsByPredicate([](const FLocalFileChunkInfo& Chunk) { return Chunk.ChunkType == ELocalFileChunkType::Index; });
+
+	int64 StreamSizeOnDisk = 0;
+	for (const FLocalFileReplayDataInfo& DataChunk : Info.DataChunks)
+	{
+		StreamSizeOnDisk += DataChunk.SizeInBytes;
+	}
+
+	UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: %s, Length: %.1fs, File size: %.2f MB, Stream: %.2f MB on disk, %.2f MB in memory (%s), Checkpoints: %d"),
+		*Filename, Info.LengthInMS / 1000.0f, FileSize / (1024.0 * 1024.0), StreamSizeOnDisk / (1024.0 * 1024.0), Info.TotalDataSizeInBytes / (1024.0 * 1024.0),
+		Info.bCompressed ? TEXT("compressed") : TEXT("uncompressed"), Info.Checkpoints.Num());
+
+	UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: Open time, scan: %.3f ms, index: %.3f ms%s"),
+		ScanTime * 1000.0, IndexTime * 1000.0, bHasIndex ? TEXT("") : TEXT(" (no index, replay was scanned)"));
+
+	if ((Info.Checkpoints.Num() == 0) || (NumSeeks <= 0))
+	{
+		return;
+	}
+
+	if (Info.bEncrypted)
+	{
+		UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: Replay is encrypted, skipping seek benchmark"));
+		return;
+	}
+
+	// seeking to a random checkpoint: reopening the replay, and loading the checkpoint data
+	FRandomStream RandomStream(FPlatformTime::Cycles());
+
+	double TotalSeekTime = 0.0;
+	double MaxSeekTime = 0.0;
+
+	for (int32 SeekIdx = 0; SeekIdx < NumSeeks; ++SeekIdx)
+	{
+		double SeekTime = 0.0;
+
+		{
+			FScopedDurationTimer Timer(SeekTime);
+
+			FLocalFileReplayInfo SeekInfo;
+			Streamer.ReadReplayInfo(StreamName, SeekInfo);
+
+			const FLocalFileEventInfo& Checkpoint = Info.Checkpoints[RandomStream.RandHelper(Info.Checkpoints.Num())];
+
+			TSharedPtr<FArchive> LocalFileAr = Streamer.CreateLocalFileReader(Filename);
+			if (LocalFileAr.IsValid())
+			{
+				TArray<uint8> CheckpointData;
+				CheckpointData.SetNumUninitialized(Checkpoint.SizeInBytes);
+
+				LocalFileAr->Seek(Checkpoint.EventDataOffset);
+				LocalFileAr->Serialize(CheckpointData.GetData(), CheckpointData.Num());
+
+				if (Info.bCompressed)
+				{
+					TArray<uint8> UncompressedData;
+					Streamer.DecompressBuffer(CheckpointData, UncompressedData);
+				}
+			}
+		}
+
+		TotalSeekTime += SeekTime;
+		MaxSeekTime = FMath::Max(MaxSeekTime, SeekTime);
+	}
+
+	UE_LOG(LogLocalFileReplay, Display, TEXT("localReplay.Benchmark: Checkpoint seek time over %d seeks, average: %.3f ms, max: %.3f ms"),
+		NumSeeks, (TotalSeekTime / NumSeeks) * 1000.0, MaxSeekTime * 1000.0);
+}
+
+static FAutoConsoleCommand LocalReplayBenchmarkCommand(
+	TEXT("localReplay.Benchmark"),
+	TEXT("Measures open and checkpoint seek times of a local replay, and reports its size. Usage: localReplay.Benchmark <ReplayName> [NumSeeks]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogLocalFileReplay, Display, TEXT("Usage: localReplay.Benchmark <ReplayName> [NumSeeks]"));
+			return;
+		}
+
+		const int32 NumSeeks = (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 100;
+
+		FLocalFileNetworkReplayStreamer::BenchmarkReplay(Args[0], NumSeeks);
+	}));
+
 IMPLEMENT_MODULE(FLocalFileNetworkReplayStreamingFactory, LocalFileNetworkReplayStreaming)
 
 TSharedPtr<INetworkReplayStreamer> FLocalFileNetworkReplayStreamingFactory::CreateReplayStreamer() 
@@ -22,6 +22,7 @@ enum class ELocalFileChunkType : uint32
 	ReplayData,
 	Checkpoint,
 	Event,
+	Index,
 	Unknown = 0xFFFFFFFF
 };
 
@@ -29,6 +30,7 @@ enum class EReadReplayInfoFlags : uint32
 {
 	None = 0,
 	SkipHeaderChunkTest = 1,
+	SkipIndex = 2,
 };
 
 ENUM_CLASS_FLAGS(EReadReplayInfoFlags);
@@ -461,13 +463,17 @@ public:
 
 	virtual bool IsCheckpointTypeSupported(EReplayCheckpointType CheckpointType) const override;
 
-	virtual bool SupportsCompression() const { return false; }
+	/**
+	 * By default, stream and checkpoint chunks are compressed with FCompression, using the format set by localReplay.CompressionFormat.
+	 * The format is stored with each chunk, so replays remain readable if the setting changes.
+	 */
+	virtual bool SupportsCompression() const { return true; }
 
 	UE_DEPRECATED(4.25, "No longer used")
 	virtual int32 GetDecompressedSize(FArchive& InCompressed) const;
 
-	virtual bool DecompressBuffer(const TArray<uint8>& InCompressed, TArray<uint8>& OutBuffer) const { return false; }
-	virtual bool CompressBuffer(const TArray<uint8>& InBuffer, TArray<uint8>& OutCompressed) const { return false; }
+	virtual bool DecompressBuffer(const TArray<uint8>& InCompressed, TArray<uint8>& OutBuffer) const;
+	virtual bool CompressBuffer(const TArray<uint8>& InBuffer, TArray<uint8>& OutCompressed) const;
 
 	virtual bool SupportsEncryption() const { return false; }
 	virtual void GenerateEncryptionKey(TArray<uint8>& EncryptionKey) {}
@@ -609,6 +615,15 @@ protected:
 	bool WriteReplayInfo(FArchive& Archive, const FLocalFileReplayInfo& ReplayInfo);
 	bool WriteReplayInfo(FArchive& Archive, const FLocalFileReplayInfo& InReplayInfo, struct FLocalFileSerializationInfo& SerializationInfo);
 
+	/**
+	 * Appends an index chunk describing every chunk in the replay, so that finished replays can be opened without scanning the file.
+	 * The index chunk ends with a trailer pointing back to it, and must be the last chunk in the file.
+	 */
+	bool WriteReplayIndex(const FString& StreamName, const FLocalFileReplayInfo& ReplayInfo);
+
+	/** Reads the chunk metadata from the index chunk, if the file ends with a valid one. Leaves the archive untouched on failure. */
+	bool ReadReplayIndex(FArchive& Archive, FLocalFileReplayInfo& Info, const int64 ChunksOffset) const;
+
 	void FixupFriendlyNameLength(const FString& UnfixedName, FString& FixedName) const;
 
 	bool IsNamedStreamLive(const FString& StreamName) const;
@@ -669,8 +684,15 @@ public:
 	static const FString& GetDefaultDemoSavePath();
 
 	static const uint32 FileMagic;
+	static const uint32 IndexMagic;
 	static const uint32 MaxFriendlyNameLen;
 	static const uint32 LatestVersion;
+
+	/**
+	 * Measures how long it takes to open a replay (with and without its index) and to load random checkpoints, and reports the file size
+	 * and compression ratio. Used by localReplay.Benchmark.
+	 */
+	static void BenchmarkReplay(const FString& StreamName, int32 NumSeeks);
 };
 
 class LOCALFILENETWORKREPLAYSTREAMING_API FLocalFileNetworkReplayStreamingFactory : public INetworkReplayStreamingFactory, public FTickableGameObject
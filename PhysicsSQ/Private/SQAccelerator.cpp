@@ -377,6 +377,37 @@ void FChaosSQAccelerator::Raycast(const FVector& Start, const FVector& Dir, cons
 	HitBuffer.DecFlushCount();
 }
 
+void FChaosSQAccelerator::RaycastBatch(TArrayView<const FChaosSQBatchRaycast> Raycasts, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams) const
+{
+	using namespace Chaos;
+	using namespace ChaosInterface;
+	using FRaycastVisitor = TSQVisitor<TSphere<float, 3>, TAccelerationStructureHandle<float, 3>, FRaycastHit>;
+
+	// visitors are referenced by queries, reserve so they never move
+	TArray<FRaycastVisitor> Visitors;
+	Visitors.Reserve(Raycasts.Num());
+	TArray<TSpatialBatchQuery<TAccelerationStructureHandle<float, 3>, float>> Queries;
+	Queries.Reserve(Raycasts.Num());
+
+	for (const FChaosSQBatchRaycast& Raycast : Raycasts)
+	{
+		TSpatialBatchQuery<TAccelerationStructureHandle<float, 3>, float>& Query = Queries.AddDefaulted_GetRef();
+		Query.Start = Raycast.Start;
+		Query.Dir = Raycast.Dir;
+		Query.Length = Raycast.DeltaMagnitude;
+		Query.Visitor = &Visitors.Emplace_GetRef(Raycast.Start, Raycast.Dir, *Raycast.HitBuffer, OutputFlags, QueryFilterData, QueryCallback, DebugParams);
+
+		Raycast.HitBuffer->IncFlushCount();
+	}
+
+	SpatialAcceleration.RaycastBatch(Queries);
+
+	for (const FChaosSQBatchRaycast& Raycast : Raycasts)
+	{
+		Raycast.HitBuffer->DecFlushCount();
+	}
+}
+
 template <typename QueryGeomType>
 void SweepHelper(const QueryGeomType& QueryGeom,const Chaos::ISpatialAcceleration<Chaos::TAccelerationStructureHandle<float,3>,float,3>& SpatialAcceleration,const FTransform& StartTM,const FVector& Dir,const float DeltaMagnitude,ChaosInterface::FSQHitBuffer<ChaosInterface::FSweepHit>& HitBuffer,EHitFlags OutputFlags,const FQueryFilterData& QueryFilterData,ICollisionQueryFilterCallbackBase& QueryCallback,const FQueryDebugParams& DebugParams)
 {
@@ -407,6 +438,57 @@ void FChaosSQAccelerator::Sweep(const Chaos::FImplicitObject& QueryGeom, const F
 	return Chaos::Utilities::CastHelper(QueryGeom, StartTM, [&](const auto& Downcast, const FTransform& StartFullTM) { return SweepHelper(Downcast, SpatialAcceleration, StartFullTM, Dir, DeltaMagnitude, HitBuffer, OutputFlags, QueryFilterData, QueryCallback, DebugParams); });
 }
 
+template <typename QueryGeomType>
+void SweepBatchHelper(const QueryGeomType& QueryGeom, const FTransform& QueryGeomTM, const Chaos::ISpatialAcceleration<Chaos::TAccelerationStructureHandle<float, 3>, float, 3>& SpatialAcceleration, TArrayView<const FChaosSQBatchSweep> Sweeps, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams)
+{
+	using namespace Chaos;
+	using namespace ChaosInterface;
+	using FSweepVisitor = TSQVisitor<QueryGeomType, TAccelerationStructureHandle<float, 3>, FSweepHit>;
+
+	// visitors are referenced by queries, reserve so they never move
+	TArray<FSweepVisitor> Visitors;
+	Visitors.Reserve(Sweeps.Num());
+	TArray<TSpatialBatchQuery<TAccelerationStructureHandle<float, 3>, float>> Queries;
+	Queries.Reserve(Sweeps.Num());
+
+	for (const FChaosSQBatchSweep& Sweep : Sweeps)
+	{
+		const FTransform StartTM = QueryGeomTM * Sweep.StartTM;
+		const TAABB<float, 3> Bounds = QueryGeom.BoundingBox().TransformedAABB(StartTM);
+		FSweepVisitor& SweepVisitor = Visitors.Emplace_GetRef(StartTM, Sweep.Dir, *Sweep.HitBuffer, OutputFlags, QueryFilterData, QueryCallback, QueryGeom, DebugParams);
+
+		Sweep.HitBuffer->IncFlushCount();
+
+		if (Sweep.DeltaMagnitude == 0)
+		{
+			//fallback to overlap
+			SpatialAcceleration.Overlap(Bounds, SweepVisitor);
+		}
+		else
+		{
+			TSpatialBatchQuery<TAccelerationStructureHandle<float, 3>, float>& Query = Queries.AddDefaulted_GetRef();
+			Query.Start = Bounds.GetCenter();
+			Query.Dir = Sweep.Dir;
+			Query.Length = Sweep.DeltaMagnitude;
+			Query.QueryHalfExtents = Bounds.Extents() * 0.5f;
+			Query.Visitor = &SweepVisitor;
+		}
+	}
+
+	SpatialAcceleration.SweepBatch(Queries);
+
+	for (const FChaosSQBatchSweep& Sweep : Sweeps)
+	{
+		Sweep.HitBuffer->DecFlushCount();
+	}
+}
+
+void FChaosSQAccelerator::SweepBatch(const Chaos::FImplicitObject& QueryGeom, TArrayView<const FChaosSQBatchSweep> Sweeps, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams) const
+{
+	// cast once for the whole batch, transform of the cast geometry is applied to each sweep
+	return Chaos::Utilities::CastHelper(QueryGeom, FTransform::Identity, [&](const auto& Downcast, const FTransform& QueryGeomTM) { return SweepBatchHelper(Downcast, QueryGeomTM, SpatialAcceleration, Sweeps, OutputFlags, QueryFilterData, QueryCallback, DebugParams); });
+}
+
 template <typename QueryGeomType>
 void OverlapHelper(const QueryGeomType& QueryGeom, const Chaos::ISpatialAcceleration<Chaos::TAccelerationStructureHandle<float, 3>, float, 3>& SpatialAcceleration, const FTransform& GeomPose, ChaosInterface::FSQHitBuffer<ChaosInterface::FOverlapHit>& HitBuffer, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams)
 {
@@ -36,6 +36,24 @@ struct FCollisionQueryParams;
 struct FCollisionQueryParams;
 class ICollisionQueryFilterCallbackBase;
 
+/** A raycast of FChaosSQAccelerator::RaycastBatch */
+struct FChaosSQBatchRaycast
+{
+	FVector Start;
+	FVector Dir;
+	float DeltaMagnitude;
+	ChaosInterface::FSQHitBuffer<ChaosInterface::FRaycastHit>* HitBuffer;
+};
+
+/** A sweep of FChaosSQAccelerator::SweepBatch */
+struct FChaosSQBatchSweep
+{
+	FTransform StartTM;
+	FVector Dir;
+	float DeltaMagnitude;
+	ChaosInterface::FSQHitBuffer<ChaosInterface::FSweepHit>* HitBuffer;
+};
+
 class PHYSICSSQ_API FChaosSQAccelerator
 {
 public:
@@ -47,6 +65,12 @@ public:
 	void Sweep(const Chaos::FImplicitObject& QueryGeom, const FTransform& StartTM, const FVector& Dir, const float DeltaMagnitude, ChaosInterface::FSQHitBuffer<ChaosInterface::FSweepHit>& HitBuffer, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams = FQueryDebugParams()) const;
 	void Overlap(const Chaos::FImplicitObject& QueryGeom, const FTransform& GeomPose, ChaosInterface::FSQHitBuffer<ChaosInterface::FOverlapHit>& HitBuffer, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams = FQueryDebugParams()) const;
 
+	/** Raycasts sharing filtering, same results as calling Raycast for each of them but coherent rays are traversed together */
+	void RaycastBatch(TArrayView<const FChaosSQBatchRaycast> Raycasts, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams = FQueryDebugParams()) const;
+
+	/** Sweeps of the same geometry sharing filtering, same results as calling Sweep for each of them but coherent sweeps are traversed together */
+	void SweepBatch(const Chaos::FImplicitObject& QueryGeom, TArrayView<const FChaosSQBatchSweep> Sweeps, EHitFlags OutputFlags, const FQueryFilterData& QueryFilterData, ICollisionQueryFilterCallbackBase& QueryCallback, const FQueryDebugParams& DebugParams = FQueryDebugParams()) const;
+
 private:
 	const Chaos::ISpatialAcceleration<Chaos::TAccelerationStructureHandle<float, 3>, float, 3>& SpatialAcceleration;
 